@@ -0,0 +1,217 @@
+/*
+ * evlog_decode.c
+ *
+ * Sıkıştırılmış olay logunu (event_log.h) firmware'in kendi çözücüsüyle
+ * CSV'ye çevirir. IMU kayıtları ham sayımlardan sürücünün çevrimiyle
+ * (MPU6050_FromRaw) fiziksel birimlere döner; zaman logdaki ilk bloğa göre.
+ * -t ile bloklar anahtar karelerden aranır: yalnız o andan sonrası çözülür.
+ *
+ * Girdi: UART yakalaması (menü 9, "EL" satırları; araya giren diğer
+ * satırlar atlanır) veya ham görüntü (tunnel_sim -E, blok dizisi).
+ *
+ * Kullanım: evlog_decode [-t saniye] log > olaylar.csv
+ * Çıkış kodu: 0 tüm bloklar çözüldü, 1 bozuk/eksik blok, 2 kullanım/dosya hatası
+ */
+
+#include "event_log.h"
+#include "sensors/imu.h"
+#include "telemetry.h"
+#include "optical_sensor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DECODE_MAX_INPUT   (4U * 1024U * 1024U)
+#define DECODE_IMAGE_MAX   (EVLOG_BLOCKS * EVLOG_BLOCK_SIZE)
+
+static uint8_t image[DECODE_IMAGE_MAX];
+static uint32_t image_size = 0;
+
+typedef struct {
+    uint32_t t0;           // İlk bloğun zamanı
+    uint32_t from;         // -t: bu andan önceki kayıtlar yazılmaz
+    uint32_t imu;
+    uint32_t events;
+} DecodeCtx_t;
+
+static int HexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// "EL oooo <hex> cccc" satırları; flight_replay'deki "FR" ayrıştırmasıyla aynı kurallar
+static uint8_t ParseText(char *text) {
+    static uint8_t seen[DECODE_IMAGE_MAX];
+    uint8_t begun = 0, ended = 0;
+    uint32_t bad_lines = 0;
+
+    for (char *line = strtok(text, "\r\n"); line != NULL; line = strtok(NULL, "\r\n")) {
+        char *el = strstr(line, "EL ");
+        if (el == NULL) continue;
+
+        unsigned long value;
+        if (sscanf(el, "EL BEGIN %lu", &value) == 1) {
+            if (value % EVLOG_BLOCK_SIZE != 0U || value > sizeof(image)) {
+                fprintf(stderr, "Geçersiz log boyu: %lu\n", value);
+                return 1;
+            }
+            image_size = (uint32_t)value;
+            memset(seen, 0, sizeof(seen));
+            begun = 1;
+            ended = 0;
+            bad_lines = 0;
+            continue;
+        }
+        if (strncmp(el, "EL END", 6) == 0) {
+            ended = begun;
+            continue;
+        }
+        if (!begun) continue;
+
+        char hex[2U * EVLOG_DUMP_CHUNK + 1U];
+        unsigned crc;
+        if (sscanf(el, "EL %lx %64s %x", &value, hex, &crc) != 3 || strlen(hex) % 2U != 0) {
+            bad_lines++;
+            continue;
+        }
+        uint8_t chunk[EVLOG_DUMP_CHUNK];
+        uint32_t len = (uint32_t)strlen(hex) / 2U;
+        uint8_t ok = value + len <= image_size;
+        for (uint32_t i = 0; ok && i < len; i++) {
+            int hi = HexNibble(hex[2 * i]), lo = HexNibble(hex[2 * i + 1]);
+            ok = hi >= 0 && lo >= 0;
+            chunk[i] = (uint8_t)((hi << 4) | lo);
+        }
+        if (!ok || Telemetry_Crc16(chunk, (uint16_t)len) != crc) {
+            bad_lines++;
+            continue;
+        }
+        memcpy(&image[value], chunk, len);
+        memset(&seen[value], 1, len);
+    }
+
+    if (!begun) {
+        fprintf(stderr, "Girdide \"EL BEGIN\" satırı yok\n");
+        return 1;
+    }
+    uint32_t missing = 0;
+    for (uint32_t i = 0; i < image_size; i++) missing += !seen[i];
+    if (!ended || missing > 0 || bad_lines > 0) {
+        fprintf(stderr, "Döküm eksik: %u byte yok, %u bozuk satır%s\n", (unsigned)missing,
+                (unsigned)bad_lines, ended ? "" : ", \"EL END\" yok");
+        return 1;
+    }
+    return 0;
+}
+
+static void Discard(const EventLogRecord_t *rec, void *ctx) {
+    (void)rec;
+    (void)ctx;
+}
+
+static uint8_t Load(const char *path) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return 2;
+    }
+    char *buf = malloc(DECODE_MAX_INPUT + 1U);
+    size_t n = fread(buf, 1, DECODE_MAX_INPUT, in);
+    fclose(in);
+    buf[n] = '\0';
+
+    // Ham görüntünün sihirli sayısı yok: blok boyunun katıysa ve ilk blok
+    // çözülüyorsa ham, değilse UART metni
+    uint8_t status = 0;
+    if (n > 0 && n % EVLOG_BLOCK_SIZE == 0U && n <= sizeof(image) &&
+        EventLog_DecodeBlock((const uint8_t *)buf, Discard, NULL) == EVLOG_OK) {
+        memcpy(image, buf, n);
+        image_size = (uint32_t)n;
+    } else {
+        // Fren logu ve döküm satırları 0x00 ile biter (telemetri ayracı)
+        for (size_t i = 0; i < n; i++) {
+            if (buf[i] == '\0') buf[i] = '\n';
+        }
+        status = ParseText(buf);
+    }
+    free(buf);
+    return status;
+}
+
+static void WriteRecord(const EventLogRecord_t *rec, void *arg) {
+    DecodeCtx_t *ctx = arg;
+    if ((int32_t)(rec->time - ctx->from) < 0) return;
+
+    double t = (double)(rec->time - ctx->t0) / OPTICAL_IC_TICK_HZ;
+    if (rec->type == EVLOG_REC_IMU) {
+        IMU_Data_t d;
+        MPU6050_FromRaw(rec->raw, &d);
+        printf("%u,%.6f,imu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.3f,\n", (unsigned)rec->seq, t,
+               Q16_TO_FLOAT(d.accel_x_g), Q16_TO_FLOAT(d.accel_y_g), Q16_TO_FLOAT(d.accel_z_g),
+               Q16_TO_FLOAT(d.gyro_x_dps), Q16_TO_FLOAT(d.gyro_y_dps), Q16_TO_FLOAT(d.gyro_z_dps),
+               Q16_TO_FLOAT(d.temp_c));
+        ctx->imu++;
+    } else {
+        printf("%u,%.6f,%s,,,,,,,,%d\n", (unsigned)rec->seq, t,
+               rec->type == EVLOG_EV_EDGE ? "edge" : "event", (int)rec->value);
+        ctx->events++;
+    }
+}
+
+static void Usage(const char *prog) {
+    fprintf(stderr, "Kullanım: %s [-t saniye] log > olaylar.csv\n"
+                    "  log: UART yakalaması (\"EL\" satırları) veya ham blok görüntüsü\n"
+                    "  -t   ilk bloğa göre bu andan itibaren çöz (anahtar kareden arar)\n", prog);
+}
+
+int main(int argc, char **argv) {
+    double from_s = 0.0;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:h")) != -1) {
+        switch (opt) {
+            case 't': from_s = atof(optarg); break;
+            default: Usage(argv[0]); return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    uint8_t status = Load(argv[optind]);
+    if (status != 0) return status;
+
+    uint32_t blocks = image_size / EVLOG_BLOCK_SIZE;
+    if (blocks == 0) {
+        fprintf(stderr, "Log boş\n");
+        return 1;
+    }
+    DecodeCtx_t ctx = {0};
+    ctx.t0 = ((const EventLogBlock_t *)image)->time;
+    ctx.from = ctx.t0 + (uint32_t)(from_s * OPTICAL_IC_TICK_HZ);
+    uint32_t first = EventLog_Seek(image, blocks, ctx.from);
+
+    printf("seq,t_s,type,accel_x_g,accel_y_g,accel_z_g,gyro_x_dps,gyro_y_dps,gyro_z_dps,temp_c,value\n");
+    uint32_t bad = 0, next_seq = 0;
+    for (uint32_t i = first; i < blocks; i++) {
+        const EventLogBlock_t *hdr = (const EventLogBlock_t *)(image + i * EVLOG_BLOCK_SIZE);
+        if (i > first && hdr->seq != next_seq) {
+            fprintf(stderr, "Blok %u: sıra %u, beklenen %u\n", (unsigned)i, (unsigned)hdr->seq, (unsigned)next_seq);
+            bad++;
+        }
+        if (EventLog_DecodeBlock(image + i * EVLOG_BLOCK_SIZE, WriteRecord, &ctx) != EVLOG_OK) {
+            fprintf(stderr, "Blok %u çözülemedi\n", (unsigned)i);
+            bad++;
+        }
+        next_seq = hdr->seq + hdr->records;
+    }
+
+    fprintf(stderr, "Olay logu: %u blok (%u. bloktan) | IMU %u, olay %u | %.2f byte/örnek\n",
+            (unsigned)blocks, (unsigned)first, (unsigned)ctx.imu, (unsigned)ctx.events,
+            ctx.imu > 0 ? (double)((blocks - first) * EVLOG_BLOCK_SIZE) / ctx.imu : 0.0);
+    return bad > 0 ? 1 : 0;
+}
@@ -0,0 +1,299 @@
+/*
+ * flight_replay.c
+ *
+ * Uçuş kaydını (flight_recorder.h) firmware'in kendi optical_sensor.c /
+ * strip_decoder.c koduyla yeniden oynatır. Kayıttaki harita kurulur, her
+ * kenar ve şerit zaman aşımı kaydedildiği sırayla verilir, fren
+ * denetçisinin durum geçişleri ve kapıya verdiği fren modeli uygulanır; her kayıttan sonra konum, reflektör
+ * sayısı ve sistem durumu kayıttakiyle bit bit karşılaştırılır. Gerçek bir
+ * koşunun kaydı böylece post-mortem ve regresyon testi olarak kullanılabilir:
+ * optik navigasyon kodu değiştiyse ilk farklı kayıt raporlanır. Füzyon ve
+ * fren denetçisi oynatılmaz (tam hızda girdileri kayıtta yok, bkz.
+ * flight_recorder.h); denetçinin kararları kayıttan uygulanır, IMU kayıtları
+ * yalnız CSV'de incelenir.
+ *
+ * Girdi: UART yakalaması (menü 7, "FR" satırları; araya giren diğer
+ * satırlar atlanır) veya flash'tan okunmuş ham görüntü (menü 8, ör.
+ * st-flash read kayit.bin 0x0800EC00 4096).
+ *
+ * Kullanım: flight_replay [-c kayıtlar.csv] kayıt
+ * Çıkış kodu: 0 oynatma kayıtla aynı, 1 fark veya bozuk/eksik kayıt, 2 kullanım/dosya hatası
+ */
+
+#include "sim_hal.h"
+#include "flight_recorder.h"
+#include "optical_sensor.h"
+#include "strip_decoder.h"
+#include "shared_data.h"
+#include "telemetry.h"
+#include "tunnel_map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define REPLAY_MAX_INPUT   (4U * 1024U * 1024U)
+
+static uint8_t image[FLIGHTREC_IMAGE_MAX];
+static uint32_t image_size = 0;
+
+static const char *const type_names[] = { "?", "edge", "strip", "state", "imu", "brake" };
+
+static int HexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// "FR oooo <hex> cccc" satırları. Son BEGIN'den sonrakiler geçerli; her satır
+// kendi CRC'siyle doğrulanır, eksik byte kalırsa görüntü reddedilir.
+static uint8_t ParseText(char *text) {
+    static uint8_t seen[FLIGHTREC_IMAGE_MAX];
+    uint8_t begun = 0, ended = 0;
+    uint32_t bad_lines = 0;
+
+    for (char *line = strtok(text, "\r\n"); line != NULL; line = strtok(NULL, "\r\n")) {
+        char *fr = strstr(line, "FR ");
+        if (fr == NULL) continue;
+
+        unsigned long value;
+        if (sscanf(fr, "FR BEGIN %lu", &value) == 1) {
+            if (value < sizeof(FlightRecHeader_t) || value > sizeof(image)) {
+                fprintf(stderr, "Geçersiz kayıt boyu: %lu\n", value);
+                return 1;
+            }
+            image_size = (uint32_t)value;
+            memset(seen, 0, sizeof(seen));
+            begun = 1;
+            ended = 0;
+            bad_lines = 0;
+            continue;
+        }
+        if (strncmp(fr, "FR END", 6) == 0) {
+            ended = begun;
+            continue;
+        }
+        if (!begun) continue;
+
+        char hex[2U * FLIGHTREC_DUMP_CHUNK + 1U];
+        unsigned crc;
+        if (sscanf(fr, "FR %lx %64s %x", &value, hex, &crc) != 3 || strlen(hex) % 2U != 0) {
+            bad_lines++;
+            continue;
+        }
+        uint8_t chunk[FLIGHTREC_DUMP_CHUNK];
+        uint32_t len = (uint32_t)strlen(hex) / 2U;
+        uint8_t ok = value + len <= image_size;
+        for (uint32_t i = 0; ok && i < len; i++) {
+            int hi = HexNibble(hex[2 * i]), lo = HexNibble(hex[2 * i + 1]);
+            ok = hi >= 0 && lo >= 0;
+            chunk[i] = (uint8_t)((hi << 4) | lo);
+        }
+        if (!ok || Telemetry_Crc16(chunk, (uint16_t)len) != crc) {
+            bad_lines++;
+            continue;
+        }
+        memcpy(&image[value], chunk, len);
+        memset(&seen[value], 1, len);
+    }
+
+    if (!begun) {
+        fprintf(stderr, "Girdide \"FR BEGIN\" satırı yok\n");
+        return 1;
+    }
+    uint32_t missing = 0;
+    for (uint32_t i = 0; i < image_size; i++) missing += !seen[i];
+    if (!ended || missing > 0 || bad_lines > 0) {
+        fprintf(stderr, "Döküm eksik: %u byte yok, %u bozuk satır%s\n", (unsigned)missing,
+                (unsigned)bad_lines, ended ? "" : ", \"FR END\" yok");
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t Load(const char *path) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return 2;
+    }
+    char *buf = malloc(REPLAY_MAX_INPUT + 1U);
+    size_t n = fread(buf, 1, REPLAY_MAX_INPUT, in);
+    fclose(in);
+    buf[n] = '\0';
+
+    uint8_t status = 0;
+    uint32_t magic = FLIGHTREC_MAGIC;
+    if (n >= sizeof(magic) && memcmp(buf, &magic, sizeof(magic)) == 0) {
+        // Ham görüntü (flash okuması sayfa sonuna kadar 0xFF içerebilir)
+        const FlightRecHeader_t *h = (const FlightRecHeader_t *)buf;
+        image_size = (n >= sizeof(*h)) ? sizeof(*h) + (uint32_t)h->count * sizeof(FlightRecord_t) : 0;
+        if (image_size == 0 || image_size > n || image_size > sizeof(image)) {
+            fprintf(stderr, "Ham görüntü kısa veya bozuk (%zu byte)\n", n);
+            status = 1;
+        } else {
+            memcpy(image, buf, image_size);
+        }
+    } else {
+        // Fren logu ve döküm satırları 0x00 ile biter (telemetri ayracı)
+        for (size_t i = 0; i < n; i++) {
+            if (buf[i] == '\0') buf[i] = '\n';
+        }
+        status = ParseText(buf);
+    }
+    free(buf);
+    return status;
+}
+
+static uint8_t Validate(const FlightRecHeader_t *h) {
+    if (h->magic != FLIGHTREC_MAGIC || h->version != FLIGHTREC_VERSION ||
+        h->record_size != sizeof(FlightRecord_t) ||
+        image_size != sizeof(*h) + (uint32_t)h->count * sizeof(FlightRecord_t)) {
+        fprintf(stderr, "Kayıt başlığı uyumsuz (sürüm %u, kayıt boyu %u)\n", h->version, h->record_size);
+        return 1;
+    }
+    uint16_t crc = Telemetry_Crc16(image, offsetof(FlightRecHeader_t, crc));
+    crc = Telemetry_Crc16Update(crc, image + sizeof(*h), (uint16_t)(image_size - sizeof(*h)));
+    if (crc != h->crc) {
+        fprintf(stderr, "Kayıt CRC hatası (0x%04X, beklenen 0x%04X)\n", crc, h->crc);
+        return 1;
+    }
+    return 0;
+}
+
+static void Usage(const char *prog) {
+    fprintf(stderr, "Kullanım: %s [-c kayıtlar.csv] kayıt\n"
+                    "  kayıt: UART yakalaması (\"FR\" satırları) veya flash'tan okunmuş ham görüntü\n"
+                    "  -c     kayıtları CSV olarak yaz (inceleme için)\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *csv_path = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:h")) != -1) {
+        switch (opt) {
+            case 'c': csv_path = optarg; break;
+            default: Usage(argv[0]); return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    uint8_t status = Load(argv[optind]);
+    if (status != 0) return status;
+
+    FlightRecHeader_t hdr;
+    memcpy(&hdr, image, sizeof(hdr));
+    if (Validate(&hdr) != 0) return 1;
+    const FlightRecord_t *rec = (const FlightRecord_t *)(image + sizeof(hdr));
+
+    if (csv_path) {
+        FILE *csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return 2;
+        }
+        fprintf(csv, "index,t_s,type,arg,aux,value,value_q16\n");
+        for (uint32_t i = 0; i < hdr.count; i++) {
+            const FlightRecord_t *r = &rec[i];
+            fprintf(csv, "%u,%.6f,%s,%u,%u,%d,%.6f\n", (unsigned)i,
+                    (double)(r->time - hdr.start_time) / OPTICAL_IC_TICK_HZ,
+                    type_names[r->type < FLIGHTREC_TYPES ? r->type : 0], r->arg, r->aux, (int)r->value,
+                    r->value / 65536.0);
+        }
+        fclose(csv);
+    }
+
+    printf("Kayıt: %u kayıt, %u byte | ezilen %u | IMU 1/%u\n", (unsigned)hdr.count, (unsigned)image_size,
+           (unsigned)hdr.dropped, (unsigned)hdr.imu_div);
+    if (hdr.dropped > 0) {
+        // Optik durum koşu başından kurulur; başı eksik kayıt sadece incelenebilir
+        printf("SONUÇ: OYNATILAMADI (kaydın başı ezilmiş)\n");
+        return 1;
+    }
+
+    // Kayıttaki pist: flash'taki blok da derlenmiş varsayılan da buradan kurulur
+    TunnelParams_t map = hdr.map;
+    TunnelMap_Seal(&map);
+    if (TunnelMap_Init(&map) != TUNNEL_MAP_OK) {
+        printf("SONUÇ: OYNATILAMADI (kayıttaki harita geçersiz)\n");
+        return 1;
+    }
+
+    SimHAL_Reset();
+    SimHAL_UART_SetSink(NULL);
+    OpticalSensor_Init();
+
+    uint32_t counts[FLIGHTREC_TYPES] = {0};
+    for (uint32_t i = 0; i < hdr.count; i++) {
+        const FlightRecord_t *r = &rec[i];
+        counts[r->type < FLIGHTREC_TYPES ? r->type : 0]++;
+
+        uint8_t closed = 1;
+        switch (r->type) {
+            case FLIGHTREC_EDGE:
+                OpticalSensor_ReplayEdge(r->time);
+                break;
+            case FLIGHTREC_STRIP:
+                closed = OpticalSensor_ReplayStrip(r->time);
+                break;
+            case FLIGHTREC_STATE:
+                // Navigasyonun kendi geçişi sıradaki kenarda yeniden oluşur
+                if ((r->aux >> 8) != FLIGHTREC_SRC_OPTICAL) {
+                    uint32_t key = SharedData_WriteBegin();
+                    VehicleState.system_status = r->arg;
+                    SharedData_WriteEnd(key);
+                }
+                continue;
+            case FLIGHTREC_BRAKE:
+                OpticalSensor_SetBraking(r->time, r->value);
+                continue;
+            default:
+                continue;
+        }
+
+        if (!closed || VehicleState.current_position != r->value ||
+            (uint16_t)VehicleState.reflector_count != r->aux || VehicleState.system_status != r->arg) {
+            printf("FARK: kayıt %u (%s, t=%.6f s)%s\n", (unsigned)i, type_names[r->type],
+                   (double)(r->time - hdr.start_time) / OPTICAL_IC_TICK_HZ, closed ? "" : " grup kapanmadı");
+            printf("  kayıt:    konum %.6f m (0x%08X) | reflektör %u | durum %u\n", r->value / 65536.0,
+                   (unsigned)r->value, r->aux, r->arg);
+            printf("  oynatma:  konum %.6f m (0x%08X) | reflektör %u | durum %u\n",
+                   Q16_TO_FLOAT(VehicleState.current_position), (unsigned)VehicleState.current_position,
+                   (unsigned)VehicleState.reflector_count, VehicleState.system_status);
+            printf("SONUÇ: FARKLI\n");
+            return 1;
+        }
+    }
+
+    OpticalMarkerStats_t marker;
+    StripDecoderStats_t strip;
+    OpticalSensor_GetMarkerStats(&marker);
+    StripDecoder_GetStats(&strip);
+    double duration = hdr.count > 0 ? (double)(rec[hdr.count - 1U].time - hdr.start_time) / OPTICAL_IC_TICK_HZ : 0.0;
+    printf("Oynatılan: %.3f s | kenar %u, şerit zaman aşımı %u, durum %u, fren %u, IMU %u\n", duration,
+           (unsigned)counts[FLIGHTREC_EDGE], (unsigned)counts[FLIGHTREC_STRIP],
+           (unsigned)counts[FLIGHTREC_STATE], (unsigned)counts[FLIGHTREC_BRAKE],
+           (unsigned)counts[FLIGHTREC_IMU]);
+    printf("Kenar kapısı: kabul %u | red %u | çıkarılan reflektör %u | yeniden yakalama %u\n",
+           (unsigned)marker.gate_accepted, (unsigned)marker.gate_rejected, (unsigned)marker.gate_inferred,
+           (unsigned)marker.gate_reacquired);
+    printf("Şerit çözücü: grup %u, çözülen %u, reddedilen %u | hizalama %u\n", (unsigned)strip.bursts,
+           (unsigned)strip.decoded, (unsigned)strip.rejected, (unsigned)marker.strip_resyncs);
+    printf("Son durum: konum %.6f m | hız %.6f m/s | reflektör %u\n", Q16_TO_FLOAT(VehicleState.current_position),
+           Q16_TO_FLOAT(VehicleState.current_velocity), (unsigned)VehicleState.reflector_count);
+
+    if (VehicleState.current_position != hdr.final_position || VehicleState.current_velocity != hdr.final_velocity ||
+        VehicleState.reflector_count != hdr.final_reflectors) {
+        printf("  kayıt:    konum %.6f m | hız %.6f m/s | reflektör %u\n", hdr.final_position / 65536.0,
+               hdr.final_velocity / 65536.0, (unsigned)hdr.final_reflectors);
+        printf("SONUÇ: FARKLI (son durum)\n");
+        return 1;
+    }
+    printf("SONUÇ: AYNI (optik navigasyon; füzyon ve fren denetçisi oynatılmaz)\n");
+    return 0;
+}
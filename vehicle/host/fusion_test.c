@@ -0,0 +1,38 @@
+/*
+ * fusion_test.c
+ *
+ * Füzyonun (fusion.c) inovasyon kapısı testi: durağan filtreye 4 m'lik
+ * (bir reflektör aralığı) sıçrayan düzeltme iki kez atılmalı, üçüncüsü
+ * kapısız uygulanmalı; sonra tutarlı düzeltme kapıdan geçmeli.
+ *
+ * Kullanım: fusion_test
+ * Çıkış kodu: 0 geçti, 1 başarısız
+ */
+
+#include "fusion.h"
+#include "shared_data.h"
+
+#include <stdio.h>
+#include <math.h>
+
+int main(void) {
+    IMU_Data_t still = {0};
+    const uint32_t ms = FUSION_TICK_HZ / 1000U;
+    const q16_t fixes[] = { Q16_FROM_FLOAT(0.0f), Q16_FROM_FLOAT(4.0f), Q16_FROM_FLOAT(4.0f),
+                            Q16_FROM_FLOAT(4.0f), Q16_FROM_FLOAT(4.05f) };
+    Fusion_Init(0, 0);
+    for (uint32_t t = 1; t <= 1000U; t++) {
+        Fusion_ImuSample(&still, t * ms);
+        if (t % 200U == 0U) {
+            Fusion_PositionFix(FUSION_SRC_EXTERNAL, fixes[t / 200U - 1U], FUSION_INFERRED_STD, t * ms);
+        }
+    }
+    FusionStats_t st;
+    Fusion_GetStats(&st);
+    uint8_t ok = st.rejected_fixes == 2U && st.forced_gate == 1U && st.fixes == 3U &&
+                 fabs(Q16_TO_FLOAT(VehicleState.nav.position) - 4.0) < 0.1;
+    printf("Füzyon kapısı: atılan %u, kapısız %u, uygulanan %u | son konum %.3f m%s\n",
+           (unsigned)st.rejected_fixes, (unsigned)st.forced_gate, (unsigned)st.fixes,
+           (double)Q16_TO_FLOAT(VehicleState.nav.position), ok ? "" : "  <-- HATALI");
+    return ok ? 0 : 1;
+}
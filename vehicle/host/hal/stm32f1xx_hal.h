@@ -0,0 +1,524 @@
+/*
+ * stm32f1xx_hal.h (HOST)
+ *
+ * Linux üzerinde firmware kaynaklarını derleyebilmek için STM32F1 HAL'in
+ * küçük bir alt kümesi. Fonksiyonların gövdesi sim_hal.c içinde; zaman
+ * sanal saatten gelir, çevre birimleri simülatör tarafından sürülür.
+ * Sadece firmware'in gerçekten kullandığı tipler/sabitler burada tanımlıdır.
+ */
+
+#ifndef STM32F1XX_HAL_H
+#define STM32F1XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// --- Genel ---
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY      0xFFFFFFFFU
+
+#define __DMB()            __sync_synchronize()
+#define __disable_irq()    SimHAL_DisableIRQ()
+#define __enable_irq()     SimHAL_EnableIRQ()
+
+#define __get_PRIMASK()    SimHAL_GetPRIMASK()
+#define __set_PRIMASK(x)   SimHAL_SetPRIMASK(x)
+#define __WFI()            SimHAL_WFI()
+
+void SimHAL_DisableIRQ(void);
+void SimHAL_EnableIRQ(void);
+uint32_t SimHAL_GetPRIMASK(void);
+void SimHAL_SetPRIMASK(uint32_t primask);
+void SimHAL_WFI(void);
+
+// --- NVIC ---
+typedef enum {
+    DMA1_Channel1_IRQn = 11,
+    DMA1_Channel7_IRQn = 17,
+    EXTI9_5_IRQn       = 23,
+    TIM1_UP_IRQn       = 25,
+    TIM2_IRQn          = 28,
+    TIM3_IRQn          = 29,
+    USART2_IRQn        = 38
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+HAL_StatusTypeDef HAL_Init(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+// --- RCC ---
+#define RCC_OSCILLATORTYPE_HSE   0x00000001U
+#define RCC_HSE_ON               0x00000001U
+#define RCC_HSE_PREDIV_DIV1      0x00000000U
+#define RCC_HSI_ON               0x00000001U
+#define RCC_PLL_ON               0x00000002U
+#define RCC_PLLSOURCE_HSE        0x00010000U
+#define RCC_PLL_MUL9             0x001C0000U
+#define RCC_CLOCKTYPE_SYSCLK     0x00000001U
+#define RCC_CLOCKTYPE_HCLK       0x00000002U
+#define RCC_CLOCKTYPE_PCLK1      0x00000004U
+#define RCC_CLOCKTYPE_PCLK2      0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK  0x00000002U
+#define RCC_SYSCLK_DIV1          0x00000000U
+#define RCC_HCLK_DIV1            0x00000000U
+#define RCC_HCLK_DIV2            0x00000400U
+#define FLASH_LATENCY_2          0x00000002U
+
+typedef struct {
+    uint32_t PLLState;
+    uint32_t PLLSource;
+    uint32_t PLLMUL;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+    uint32_t OscillatorType;
+    uint32_t HSEState;
+    uint32_t HSEPredivValue;
+    uint32_t HSIState;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency);
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_ADC1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM2_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM3_CLK_ENABLE()    ((void)0)
+
+#define RCC_PERIPHCLK_ADC        0x00000002U
+#define RCC_ADCPCLK2_DIV6        0x00008000U
+
+typedef struct {
+    uint32_t PeriphClockSelection;
+    uint32_t AdcClockSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit);
+
+// --- FLASH ---
+// STM32F103C8: 64 KB, 1 KB sayfa. Host'ta sim_hal içindeki bir dizi
+#define FLASH_BASE               0x08000000U
+#define FLASH_SIZE               0x00010000U
+#define FLASH_PAGE_SIZE          0x00000400U
+#define FLASH_TYPEERASE_PAGES    0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define FLASH_TYPEPROGRAM_WORD   0x02U
+#define FLASH_BANK_1             1U
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t PageAddress;
+    uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+
+// --- DMA ---
+typedef struct {
+    uint32_t id;
+} DMA_Channel_TypeDef;
+
+extern DMA_Channel_TypeDef SimDMA1_Channel1, SimDMA1_Channel7;
+#define DMA1_Channel1 (&SimDMA1_Channel1)
+#define DMA1_Channel7 (&SimDMA1_Channel7)
+
+#define DMA_MEMORY_TO_PERIPH     0x00000010U
+#define DMA_PERIPH_TO_MEMORY     0x00000000U
+#define DMA_PINC_DISABLE         0x00000000U
+#define DMA_MINC_ENABLE          0x00000080U
+#define DMA_PDATAALIGN_BYTE      0x00000000U
+#define DMA_MDATAALIGN_BYTE      0x00000000U
+#define DMA_PDATAALIGN_HALFWORD  0x00000100U
+#define DMA_MDATAALIGN_HALFWORD  0x00000400U
+#define DMA_NORMAL               0x00000000U
+#define DMA_CIRCULAR             0x00000020U
+#define DMA_PRIORITY_LOW         0x00000000U
+#define DMA_PRIORITY_MEDIUM      0x00001000U
+#define DMA_PRIORITY_HIGH        0x00002000U
+
+typedef struct {
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct {
+    DMA_Channel_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+    void *Parent;
+} DMA_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+    do { (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__); (__DMA_HANDLE__).Parent = (__HANDLE__); } while (0)
+
+// --- ADC ---
+typedef struct {
+    uint8_t  running;
+    uint8_t  nbr;           // Tarama sırasındaki dönüşüm sayısı
+    uint32_t rank_channel[16];
+    uint32_t sample_time[18];  // Kanal başına ADC_SAMPLETIME_*
+} ADC_TypeDef;
+
+extern ADC_TypeDef SimADC1;
+#define ADC1 (&SimADC1)
+
+#define ADC_CLOCK_HZ                12000000U  // PCLK2 72 MHz / 6
+#define ADC_DATAALIGN_RIGHT         0x00000000U
+#define ADC_SCAN_ENABLE             0x00000100U
+#define ADC_SCAN_DISABLE            0x00000000U
+#define ADC_SOFTWARE_START          0x000E0000U
+#define ENABLE                      1U
+#define DISABLE                     0U
+
+#define ADC_CHANNEL_0               0U
+#define ADC_CHANNEL_1               1U
+#define ADC_CHANNEL_2               2U
+#define ADC_CHANNEL_3               3U
+#define ADC_CHANNEL_4               4U
+#define ADC_CHANNEL_5               5U
+#define ADC_CHANNEL_6               6U
+#define ADC_CHANNEL_7               7U
+#define ADC_CHANNEL_8               8U
+#define ADC_CHANNEL_9               9U
+
+#define ADC_REGULAR_RANK_1          1U
+
+#define ADC_SAMPLETIME_1CYCLE_5     0U
+#define ADC_SAMPLETIME_7CYCLES_5    1U
+#define ADC_SAMPLETIME_13CYCLES_5   2U
+#define ADC_SAMPLETIME_28CYCLES_5   3U
+#define ADC_SAMPLETIME_41CYCLES_5   4U
+#define ADC_SAMPLETIME_55CYCLES_5   5U
+#define ADC_SAMPLETIME_71CYCLES_5   6U
+#define ADC_SAMPLETIME_239CYCLES_5  7U
+
+typedef struct {
+    uint32_t DataAlign;
+    uint32_t ScanConvMode;
+    uint32_t ContinuousConvMode;
+    uint32_t NbrOfConversion;
+    uint32_t DiscontinuousConvMode;
+    uint32_t ExternalTrigConv;
+} ADC_InitTypeDef;
+
+typedef struct {
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+} ADC_ChannelConfTypeDef;
+
+typedef struct {
+    ADC_TypeDef *Instance;
+    ADC_InitTypeDef Init;
+    DMA_HandleTypeDef *DMA_Handle;
+} ADC_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+// --- GPIO ---
+typedef struct {
+    uint16_t IDR;        // Giriş seviyeleri (simülatör sürer)
+    uint16_t ODR;        // Çıkış seviyeleri
+    uint16_t it_rising;  // EXTI yükselen kenar maskesi
+    uint16_t it_falling; // EXTI düşen kenar maskesi
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef SimGPIOA, SimGPIOB, SimGPIOC;
+#define GPIOA (&SimGPIOA)
+#define GPIOB (&SimGPIOB)
+#define GPIOC (&SimGPIOC)
+
+#define GPIO_PIN_0    ((uint16_t)0x0001)
+#define GPIO_PIN_1    ((uint16_t)0x0002)
+#define GPIO_PIN_2    ((uint16_t)0x0004)
+#define GPIO_PIN_3    ((uint16_t)0x0008)
+#define GPIO_PIN_4    ((uint16_t)0x0010)
+#define GPIO_PIN_5    ((uint16_t)0x0020)
+#define GPIO_PIN_6    ((uint16_t)0x0040)
+#define GPIO_PIN_7    ((uint16_t)0x0080)
+#define GPIO_PIN_8    ((uint16_t)0x0100)
+#define GPIO_PIN_9    ((uint16_t)0x0200)
+#define GPIO_PIN_10   ((uint16_t)0x0400)
+#define GPIO_PIN_11   ((uint16_t)0x0800)
+#define GPIO_PIN_12   ((uint16_t)0x1000)
+#define GPIO_PIN_13   ((uint16_t)0x2000)
+#define GPIO_PIN_14   ((uint16_t)0x4000)
+#define GPIO_PIN_15   ((uint16_t)0x8000)
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_MODE_INPUT              0x00000000U
+#define GPIO_MODE_OUTPUT_PP          0x00000001U
+#define GPIO_MODE_OUTPUT_OD          0x00000011U
+#define GPIO_MODE_AF_PP              0x00000002U
+#define GPIO_MODE_AF_INPUT           0x00000003U
+#define GPIO_MODE_IT_RISING          0x10110000U
+#define GPIO_MODE_IT_FALLING         0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING  0x10310000U
+
+#define GPIO_NOPULL          0x00000000U
+#define GPIO_PULLUP          0x00000001U
+#define GPIO_PULLDOWN        0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW     0x00000002U
+#define GPIO_SPEED_FREQ_MEDIUM  0x00000001U
+#define GPIO_SPEED_FREQ_HIGH    0x00000003U
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+// --- TIM ---
+typedef struct {
+    uint8_t  running;
+    uint8_t  update_it;
+    uint64_t start_ns;   // Sayaç sıfırdan başladığı sanal zaman
+    uint64_t next_update_ns;
+    uint32_t psc;
+    uint32_t arr;
+    uint32_t ccr[4];     // Giriş yakalama register'ları
+    uint8_t  ic_it;      // Kanal başına yakalama kesmesi maskesi
+    uint8_t  ic_polarity[4];
+    uint32_t ic_filter[4];
+    uint32_t clock_division;
+} TIM_TypeDef;
+
+extern TIM_TypeDef SimTIM1, SimTIM2, SimTIM3;
+#define TIM1 (&SimTIM1)
+#define TIM2 (&SimTIM2)
+#define TIM3 (&SimTIM3)
+
+#define TIM_COUNTERMODE_UP                 0x00000000U
+#define TIM_CLOCKDIVISION_DIV1             0x00000000U
+#define TIM_CLOCKDIVISION_DIV2             0x00000100U
+#define TIM_CLOCKDIVISION_DIV4             0x00000200U
+#define TIM_AUTORELOAD_PRELOAD_DISABLE     0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_ENABLE      0x00000080U
+#define TIM_CLOCKSOURCE_INTERNAL           0x00001000U
+#define TIM_TRGO_RESET                     0x00000000U
+#define TIM_MASTERSLAVEMODE_DISABLE        0x00000000U
+
+#define TIM_CHANNEL_1                      0x00000000U
+#define TIM_CHANNEL_2                      0x00000004U
+#define TIM_CHANNEL_3                      0x00000008U
+#define TIM_CHANNEL_4                      0x0000000CU
+#define TIM_CHANNEL_ALL                    0x0000003CU
+#define TIM_ICPOLARITY_RISING              0x00000000U
+#define TIM_ICPOLARITY_FALLING             0x00000002U
+#define TIM_ICPOLARITY_BOTHEDGE            0x0000000AU
+#define TIM_ICSELECTION_DIRECTTI           0x00000001U
+#define TIM_ICPSC_DIV1                     0x00000000U
+#define TIM_FLAG_UPDATE                    0x00000001U
+#define TIM_IT_UPDATE                      0x00000001U
+#define TIM_ENCODERMODE_TI12               0x00000003U
+
+typedef enum {
+    HAL_TIM_ACTIVE_CHANNEL_1 = 0x01U,
+    HAL_TIM_ACTIVE_CHANNEL_2 = 0x02U,
+    HAL_TIM_ACTIVE_CHANNEL_3 = 0x04U,
+    HAL_TIM_ACTIVE_CHANNEL_4 = 0x08U,
+    HAL_TIM_ACTIVE_CHANNEL_CLEARED = 0x00U
+} HAL_TIM_ActiveChannel;
+
+typedef struct {
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    TIM_Base_InitTypeDef Init;
+    HAL_TIM_ActiveChannel Channel;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    uint32_t ICPolarity;
+    uint32_t ICSelection;
+    uint32_t ICPrescaler;
+    uint32_t ICFilter;
+} TIM_IC_InitTypeDef;
+
+typedef struct {
+    uint32_t ClockSource;
+    uint32_t ClockPolarity;
+    uint32_t ClockPrescaler;
+    uint32_t ClockFilter;
+} TIM_ClockConfigTypeDef;
+
+typedef struct {
+    uint32_t MasterOutputTrigger;
+    uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *htim, TIM_ClockConfigTypeDef *sClockSourceConfig);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *sMasterConfig);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *sConfig, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_IC_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+
+// Enkoder modu: sadece derleme için; simülatör sayacı sürmez, host
+// testleri Encoder_Sample'a sentetik sayım verir
+typedef struct {
+    uint32_t EncoderMode;
+    uint32_t IC1Polarity;
+    uint32_t IC1Selection;
+    uint32_t IC1Prescaler;
+    uint32_t IC1Filter;
+    uint32_t IC2Polarity;
+    uint32_t IC2Selection;
+    uint32_t IC2Prescaler;
+    uint32_t IC2Filter;
+} TIM_Encoder_InitTypeDef;
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim, TIM_Encoder_InitTypeDef *sConfig);
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim);
+
+#define __HAL_TIM_GET_COUNTER(__HANDLE__)  SimHAL_TIM_GetCounter((__HANDLE__)->Instance)
+#define __HAL_TIM_GET_FLAG(__HANDLE__, __FLAG__)  SimHAL_TIM_GetFlag((__HANDLE__)->Instance, (__FLAG__))
+#define __HAL_TIM_CLEAR_FLAG(__HANDLE__, __FLAG__)  ((void)(__HANDLE__))
+#define __HAL_TIM_ENABLE_IT(__HANDLE__, __IT__)     ((__HANDLE__)->Instance->update_it = 1U)
+#define __HAL_TIM_IS_TIM_COUNTING_DOWN(__HANDLE__)  0U
+uint32_t SimHAL_TIM_GetCounter(TIM_TypeDef *tim);
+uint8_t SimHAL_TIM_GetFlag(TIM_TypeDef *tim, uint32_t flag);
+
+// --- UART ---
+typedef struct {
+    uint32_t tx_bytes;   // Simülatörün saydığı gönderilen byte sayısı
+} USART_TypeDef;
+
+extern USART_TypeDef SimUSART2;
+#define USART2 (&SimUSART2)
+
+#define UART_WORDLENGTH_8B     0x00000000U
+#define UART_STOPBITS_1        0x00000000U
+#define UART_PARITY_NONE       0x00000000U
+#define UART_MODE_TX_RX        0x0000000CU
+#define UART_HWCONTROL_NONE    0x00000000U
+#define UART_OVERSAMPLING_16   0x00000000U
+
+typedef struct {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    DMA_HandleTypeDef *hdmatx;
+    uint8_t tx_busy;     // DMA gönderimi sürüyor
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void HAL_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+
+// --- I2C ---
+typedef struct {
+    uint8_t busy;        // Transfer sürüyor mu
+} I2C_TypeDef;
+
+extern I2C_TypeDef SimI2C1;
+#define I2C1 (&SimI2C1)
+
+typedef struct {
+    I2C_TypeDef *Instance;
+    uint32_t ErrorCode;  // HAL_I2C_ERROR_*, her transfer başında temizlenir
+} I2C_HandleTypeDef;
+
+#define I2C_MEMADD_SIZE_8BIT     0x00000001U
+
+#define HAL_I2C_ERROR_NONE       0x00000000U
+#define HAL_I2C_ERROR_BERR       0x00000001U
+#define HAL_I2C_ERROR_ARLO       0x00000002U
+#define HAL_I2C_ERROR_AF         0x00000004U
+#define HAL_I2C_ERROR_TIMEOUT    0x00000020U
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+#endif
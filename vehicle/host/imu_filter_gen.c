@@ -0,0 +1,150 @@
+/*
+ * imu_filter_gen.c
+ *
+ * imu_filter_coef.c üreticisi: imu_filter.h'daki kesim frekansları ve
+ * seyreltme ayarıyla Butterworth alçak geçiren biquad katsayılarını (çift
+ * doğrusal dönüşüm, ön bükme) Q2.30'a yuvarlar. Orta katsayı DC kazancı tam
+ * 1 olacak şekilde ayarlanır. Üretilen dosyanın başına yuvarlanmış
+ * katsayılarla hesaplanan tepki yazılır (CIC dahil): kesimdeki kazanç, 4x
+ * kesimde zayıflatma, DC grup gecikmesi ve beyaz gürültünün RMS oranı.
+ * Makefile imu_filter.h ya da bu dosya değişince tabloyu yeniden üretir.
+ *
+ * Kullanım: imu_filter_gen > ../src/sensors/imu_filter_coef.c
+ */
+
+#include "imu_filter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <complex.h>
+#include <math.h>
+
+#define COEF_ONE           ((double)(1L << IMU_FILTER_COEF_SHIFT))
+#define NOISE_STEPS        20000U   // Gürültü integralinin adımı
+
+static const char *const group_names[IMU_FILTER_GROUPS] = { "ivme", "jiroskop" };
+static const int group_hz[IMU_FILTER_GROUPS] = { IMU_FILTER_ACCEL_HZ, IMU_FILTER_GYRO_HZ };
+
+static void Design(double fc, ImuBiquad_t *out) {
+    double fs = IMU_FILTER_OUT_HZ;
+    if (fc <= 0.0 || fc >= 0.45 * fs) {
+        fprintf(stderr, "Kesim frekansı %.1f Hz, çıkış hızı %.0f Hz için geçersiz\n", fc, fs);
+        exit(1);
+    }
+    double k = tan(M_PI * fc / fs);
+
+    for (uint32_t s = 0; s < IMU_FILTER_SECTIONS; s++) {
+        // 2S dereceli Butterworth'un s. kutup çifti
+        double q = 1.0 / (2.0 * cos((2.0 * s + 1.0) * M_PI / (4.0 * IMU_FILTER_SECTIONS)));
+        double norm = 1.0 / (1.0 + k / q + k * k);
+        double b0 = k * k * norm;
+        double a1 = 2.0 * (k * k - 1.0) * norm;
+        double a2 = (1.0 - k / q + k * k) * norm;
+
+        ImuBiquad_t *c = &out[s];
+        c->b0 = (int32_t)lround(b0 * COEF_ONE);
+        c->b2 = c->b0;
+        c->a1 = (int32_t)lround(-a1 * COEF_ONE);
+        c->a2 = (int32_t)lround(-a2 * COEF_ONE);
+        // Σb + Σa = 2^30: sabit girişte çıkış girişe tam eşit
+        c->b1 = (int32_t)((1L << IMU_FILTER_COEF_SHIFT) - c->a1 - c->a2 - 2L * c->b0);
+        if (fabs(-a1) >= 2.0 || fabs(2.0 * b0) >= 2.0) {
+            fprintf(stderr, "Katsayı Q2.30 aralığı dışında (%.1f Hz)\n", fc);
+            exit(1);
+        }
+    }
+}
+
+// Çıkış hızındaki açısal frekansta biquad zincirinin tepkisi
+static double complex Biquad_Response(const ImuBiquad_t *c, double w) {
+    double complex z1 = cexp(-I * w), z2 = cexp(-2.0 * I * w);
+    double complex h = 1.0;
+    for (uint32_t s = 0; s < IMU_FILTER_SECTIONS; s++) {
+        double complex num = (c[s].b0 + c[s].b1 * z1 + c[s].b2 * z2) / COEF_ONE;
+        double complex den = 1.0 - (c[s].a1 * z1 + c[s].a2 * z2) / COEF_ONE;
+        h *= num / den;
+    }
+    return h;
+}
+
+// Giriş hızındaki açısal frekansta CIC genliği (DC = 1)
+static double Cic_Gain(double w) {
+    if (IMU_FILTER_DECIM == 1U || fabs(sin(w / 2.0)) < 1e-12) return 1.0;
+    return pow(fabs(sin(w * IMU_FILTER_DECIM / 2.0) / (IMU_FILTER_DECIM * sin(w / 2.0))), IMU_FILTER_CIC_ORDER);
+}
+
+// Giriş hızında f Hz'lik sinüsün zincir sonundaki genliği (kesim çıkış
+// Nyquist'inin altında olduğu için örtüşmeyen bileşen)
+static double Chain_Gain(const ImuBiquad_t *c, double f) {
+    double w_in = 2.0 * M_PI * f / IMU_FILTER_RATE_HZ;
+    return Cic_Gain(w_in) * cabs(Biquad_Response(c, w_in * IMU_FILTER_DECIM));
+}
+
+// Beyaz giriş gürültüsünün çıkıştaki RMS oranı: seyreltmede katlanan CIC
+// tepkisi x biquad tepkisi, çıkış bandında ortalanır
+static double Chain_NoiseGain(const ImuBiquad_t *c) {
+    double sum = 0.0;
+    for (uint32_t i = 0; i < NOISE_STEPS; i++) {
+        double w = M_PI * (i + 0.5) / NOISE_STEPS;
+        double folded = 0.0;
+        for (uint32_t k = 0; k < IMU_FILTER_DECIM; k++) {
+            double g = Cic_Gain((w + 2.0 * M_PI * k) / IMU_FILTER_DECIM);
+            folded += g * g;
+        }
+        double h = cabs(Biquad_Response(c, w));
+        sum += h * h * folded / IMU_FILTER_DECIM;
+    }
+    return sqrt(sum / NOISE_STEPS);
+}
+
+// DC grup gecikmesi, ms: her biquad için Σ n b_n / Σ b_n - Σ n a_n / Σ a_n
+static double Chain_DelayMs(const ImuBiquad_t *c) {
+    double samples = 0.0;
+    for (uint32_t s = 0; s < IMU_FILTER_SECTIONS; s++) {
+        double b = (double)c[s].b0 + c[s].b1 + c[s].b2;
+        double a = COEF_ONE - c[s].a1 - c[s].a2;
+        samples += ((double)c[s].b1 + 2.0 * c[s].b2) / b - (-(double)c[s].a1 - 2.0 * c[s].a2) / a;
+    }
+    double cic_ms = IMU_FILTER_CIC_ORDER * (IMU_FILTER_DECIM - 1.0) / 2.0 * 1000.0 / IMU_FILTER_RATE_HZ;
+    return (IMU_FILTER_DECIM > 1U ? cic_ms : 0.0) + samples * 1000.0 / IMU_FILTER_OUT_HZ;
+}
+
+int main(void) {
+    ImuBiquad_t coef[IMU_FILTER_GROUPS][IMU_FILTER_SECTIONS];
+    for (uint32_t g = 0; g < IMU_FILTER_GROUPS; g++) {
+        Design(group_hz[g], coef[g]);
+    }
+
+    printf("// imu_filter_coef.c\n");
+    printf("// ÜRETİLMİŞ DOSYA, elle düzenlemeyin: make -C vehicle/host (host/imu_filter_gen.c)\n");
+    printf("// Giriş %u Hz", IMU_FILTER_RATE_HZ);
+    if (IMU_FILTER_DECIM > 1U) {
+        printf(" -> CIC (%u kademe, R=%u)", IMU_FILTER_CIC_ORDER, IMU_FILTER_DECIM);
+    }
+    printf(" -> %u. derece Butterworth, %u Hz çıkış\n", 2U * IMU_FILTER_SECTIONS, IMU_FILTER_OUT_HZ);
+    for (uint32_t g = 0; g < IMU_FILTER_GROUPS; g++) {
+        double fc = group_hz[g];
+        printf("// %-8s %3d Hz: kesimde %.2f dB, %.0f Hz'de %.1f dB | gecikme %.2f ms | beyaz gürültü RMS x%.3f\n",
+               group_names[g], group_hz[g], 20.0 * log10(Chain_Gain(coef[g], fc)), 4.0 * fc,
+               20.0 * log10(Chain_Gain(coef[g], fmin(4.0 * fc, IMU_FILTER_RATE_HZ / 2.0 - 1.0))),
+               Chain_DelayMs(coef[g]), Chain_NoiseGain(coef[g]));
+    }
+    printf("#include \"imu_filter.h\"\n\n");
+    printf("#if IMU_FILTER_DECIM != %u || IMU_FILTER_SECTIONS != %u || IMU_FILTER_ACCEL_HZ != %d || "
+           "IMU_FILTER_GYRO_HZ != %d\n",
+           IMU_FILTER_DECIM, IMU_FILTER_SECTIONS, IMU_FILTER_ACCEL_HZ, IMU_FILTER_GYRO_HZ);
+    printf("#error \"imu_filter_coef.c imu_filter.h ile uyuşmuyor: make -C vehicle/host ile yeniden üretin\"\n");
+    printf("#endif\n\n");
+    printf("// { b0, b1, b2, a1, a2 }, Q2.30, %u Hz'de\n", IMU_FILTER_OUT_HZ);
+    printf("const ImuBiquad_t imu_filter_coef[IMU_FILTER_GROUPS][IMU_FILTER_SECTIONS] = {\n");
+    for (uint32_t g = 0; g < IMU_FILTER_GROUPS; g++) {
+        printf("    {   // %s\n", group_names[g]);
+        for (uint32_t s = 0; s < IMU_FILTER_SECTIONS; s++) {
+            const ImuBiquad_t *c = &coef[g][s];
+            printf("        { %11d, %11d, %11d, %11d, %11d },\n", c->b0, c->b1, c->b2, c->a1, c->a2);
+        }
+        printf("    },\n");
+    }
+    printf("};\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * mc_hal.c
+ *
+ * Hafif Monte Carlo koşusunun HAL'i (mc_hal.h). Saat ve kesme maskesi iş
+ * parçacığı başına; GPIO/TIM/UART/I2C/flash çağrıları hiçbir şey yapmaz.
+ * Kenarlar sürücüye OpticalSensor_ReplayEdge ile, IMU örnekleri doğrudan
+ * filtreye verildiği için bu çağrılar koşunun sonucunu etkilemez.
+ */
+
+#include "mc_hal.h"
+#include "fw_state.h"
+
+#define MC_NS_PER_MS  1000000ULL
+
+// Firmware yalnız adreslerini kullanır (HAL_GPIO_TogglePin(GPIOC, ...))
+GPIO_TypeDef SimGPIOA, SimGPIOB, SimGPIOC;
+
+FW_STATE uint64_t now_ns = 0;
+FW_STATE uint32_t primask = 0;
+
+void McHal_SetTime(uint64_t t_ns) {
+    now_ns = t_ns;
+}
+
+uint32_t HAL_GetTick(void) {
+    return (uint32_t)(now_ns / MC_NS_PER_MS);
+}
+
+// Kesme yok: maske yalnız kaydedilir (SharedData yazma bölgeleri dengeli kalır)
+void SimHAL_DisableIRQ(void) {
+    primask = 1U;
+}
+
+void SimHAL_EnableIRQ(void) {
+    primask = 0U;
+}
+
+uint32_t SimHAL_GetPRIMASK(void) {
+    return primask;
+}
+
+void SimHAL_SetPRIMASK(uint32_t mask) {
+    primask = mask ? 1U : 0U;
+}
+
+// --- GPIO ---
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    (void)GPIOx;
+    (void)GPIO_Pin;
+    return GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    (void)GPIOx;
+    (void)GPIO_Pin;
+    (void)PinState;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    (void)GPIOx;
+    (void)GPIO_Pin;
+}
+
+// --- TIM: giriş yakalama başlatılmaz, zaman damgası HAL_GetTick'ten ---
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim) {
+    (void)htim;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    (void)htim;
+    (void)Channel;
+    return HAL_ERROR;
+}
+
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    (void)htim;
+    (void)Channel;
+    return 0;
+}
+
+uint32_t SimHAL_TIM_GetCounter(TIM_TypeDef *tim) {
+    (void)tim;
+    return 0;
+}
+
+uint8_t SimHAL_TIM_GetFlag(TIM_TypeDef *tim, uint32_t flag) {
+    (void)tim;
+    (void)flag;
+    return 0;
+}
+
+// --- UART: log satırları halkada kalır (UartLog_Init(NULL)) ---
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    (void)huart;
+    (void)pData;
+    (void)Size;
+    return HAL_ERROR;
+}
+
+// --- I2C: MPU6050 sürücüsü bağlanır (MPU6050_FromRaw) ama hat kullanılmaz ---
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+    return HAL_ERROR;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+    return 0;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    (void)hi2c;
+    (void)DevAddress;
+    (void)MemAddress;
+    (void)MemAddSize;
+    (void)pData;
+    (void)Size;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    (void)hi2c;
+    (void)DevAddress;
+    (void)MemAddress;
+    (void)MemAddSize;
+    (void)pData;
+    (void)Size;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    (void)hi2c;
+    (void)DevAddress;
+    (void)MemAddress;
+    (void)MemAddSize;
+    (void)pData;
+    (void)Size;
+    return HAL_ERROR;
+}
+
+// --- Flash: uçuş kaydı kaydedilmez ---
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError) {
+    (void)pEraseInit;
+    (void)PageError;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data) {
+    (void)TypeProgram;
+    (void)Address;
+    (void)Data;
+    return HAL_ERROR;
+}
@@ -0,0 +1,20 @@
+/*
+ * mc_hal.h
+ *
+ * Monte Carlo koşucusunun (tunnel_mc) HAL'i: yalnız iş parçacığı başına
+ * sanal saat. Çevre birimi modeli yok; hafif koşunun çağırmadığı HAL
+ * fonksiyonları bağlantı için vardır ve hata döner. sim_hal.c yerine
+ * FW_STATE_PER_THREAD ile derlenmiş firmware'e bağlanır.
+ */
+
+#ifndef MC_HAL_H
+#define MC_HAL_H
+
+#include "stm32f1xx_hal.h"
+
+/**
+ * @brief Bu iş parçacığının sanal saatini ayarlar (HAL_GetTick buradan).
+ */
+void McHal_SetTime(uint64_t t_ns);
+
+#endif
@@ -0,0 +1,399 @@
+/*
+ * mc_run.c
+ *
+ * Hafif Monte Carlo koşusu (mc_run.h). Kapsül analitik: kalkış beklemesi,
+ * sabit ivme, seyir, fren komutundan gecikme kadar sonra sabit yavaşlama.
+ * Kenar anları parça parça sabit ivmeli hareketten çözülür (tunnel_sim
+ * 10 kHz adımla entegre eder). Ana döngü 1 kHz: o milisaniyede yakalanan
+ * kenarlar yakalama anlarıyla sürücüye (OpticalSensor_ReplayEdge), sonra
+ * şerit yoklaması, IMU örneği (sayımlar -> MPU6050_FromRaw ->
+ * ImuFilter_Process -> füzyon), kapsül dururken sıfır hız düzeltmesi
+ * (enkoderin duruş tespiti yerine) ve fren denetçisi.
+ *
+ * Rastgelelik koşunun kendi üretecinden (rand() yok): iş parçacıkları
+ * birbirinin akışını bozmaz. Senaryo aynı, gürültü örnekleri tunnel_sim'den
+ * farklıdır; sonuçlar dağılım olarak karşılaştırılır.
+ */
+
+#include "mc_run.h"
+#include "mc_hal.h"
+#include "sim_result.h"
+#include "optical_sensor.h"
+#include "sensors/imu.h"
+#include "sensors/imu_filter.h"
+#include "shared_data.h"
+#include "uart_log.h"
+#include "fusion.h"
+#include "tunnel_map.h"
+#include "strip_decoder.h"
+#include "brake_supervisor.h"
+#include "encoder.h"
+
+#include <math.h>
+#include <string.h>
+
+#define MC_STEP_TICKS       (OPTICAL_IC_TICK_HZ / 1000U)  // Ana döngü ve IMU örneklemesi 1 kHz
+#define MC_NS_PER_S         1000000000.0
+#define MC_LAUNCH_HOLD_S    1.0       // Kalkıştan önce kapsül alanında bekleme (tunnel_sim ile aynı)
+#define MC_TIME_LIMIT_MS    120000U
+#define MC_MAX_EDGES        (2U * TUNNEL_MAP_MAX_MARKERS)  // İşaretler + parlamalar
+#define MC_PENDING          8U        // Yakalanıp ana döngüyü bekleyen kenar (2'nin kuvveti)
+#define MC_STILL_S          ((double)ENCODER_STILL_TICKS / ENCODER_TICK_HZ)
+
+typedef struct {
+    double pos;
+    int32_t marker;          // Harita indeksi, -1: parlama
+} McEdge_t;
+
+typedef struct {
+    double t;                // Yakalama anı (s)
+    double v;                // Kapsülün geçişteki hızı
+    int32_t marker;
+} McCapture_t;
+
+typedef struct {
+    const McScenario_t *s;
+    uint64_t rng;
+
+    // Kapsül
+    double t, x, v, a;
+    double brake_cmd_t;      // <0: henüz fren komutu yok
+    double brake_cmd_x;
+    double still_since;      // Son hareket anı
+    uint8_t stopped;
+
+    // Pist
+    McEdge_t edges[MC_MAX_EDGES];
+    uint32_t edge_total;
+    uint32_t edge_next;
+    McCapture_t pending[MC_PENDING];
+    uint32_t pending_head;
+    uint32_t pending_tail;
+    uint8_t reflector_dropped[TUNNEL_MAP_MAX_MARKERS];
+    uint32_t glints_passed;
+    int32_t last_marker_seen;  // Sensörün gördüğü son gerçek işaret
+
+    // Hatalar
+    double vel_err_sq;
+    double vel_err_max;
+    uint32_t vel_err_n;
+    double fus_err_sq;
+    uint32_t fus_in_3sigma;
+    uint32_t fus_n;
+} McRun_t;
+
+// xorshift64*: koşu başına akış
+static uint64_t McRun_Next(McRun_t *r) {
+    r->rng ^= r->rng >> 12;
+    r->rng ^= r->rng << 25;
+    r->rng ^= r->rng >> 27;
+    return r->rng * 0x2545F4914F6CDD1DULL;
+}
+
+static double McRun_Uniform(McRun_t *r) {
+    return (double)(McRun_Next(r) >> 11) / 9007199254740992.0;
+}
+
+static uint8_t McRun_Chance(McRun_t *r, double p) {
+    return p > 0.0 && McRun_Uniform(r) < p;
+}
+
+static double McRun_Gauss(McRun_t *r) {
+    double u1 = ((double)(McRun_Next(r) >> 11) + 1.0) / 9007199254740993.0;
+    double u2 = McRun_Uniform(r);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// IMU gürültüsü: tek çekilişin dört 16 bitlik düzgün parçasının toplamı
+// (yaklaşık normal; örnek başına yedi eksen, Box-Muller'den ucuz)
+static int32_t McRun_Noise(McRun_t *r, double sigma) {
+    uint64_t z = McRun_Next(r);
+    int32_t sum = (int32_t)((z & 0xFFFFU) + ((z >> 16) & 0xFFFFU) + ((z >> 32) & 0xFFFFU) + (z >> 48));
+    return (int32_t)lrint((sum - 131070.0) * sigma * (1.7320508075688772 / 65536.0));
+}
+
+static int16_t McRun_Count(int32_t value) {
+    if (value > 32767) value = 32767;
+    if (value < -32768) value = -32768;
+    return (int16_t)value;
+}
+
+static uint32_t McRun_Ticks(double t) {
+    return (uint32_t)(t * OPTICAL_IC_TICK_HZ);
+}
+
+// tunnel_sim Track_Build ile aynı kurallar: yükselen kenarlar yakalanır
+static void McRun_AddEdge(McRun_t *r, double pos, int32_t marker) {
+    if (r->edge_total >= MC_MAX_EDGES) return;
+    r->edges[r->edge_total].pos = pos;
+    r->edges[r->edge_total].marker = marker;
+    r->edge_total++;
+}
+
+static void McRun_Track(McRun_t *r) {
+    const McScenario_t *s = r->s;
+    uint16_t count = TunnelMap_Count();
+    uint8_t dropped[TUNNEL_MAP_MAX_MARKERS];
+
+    for (uint16_t i = 0; i < count; i++) {
+        const TunnelMarker_t *m = TunnelMap_Marker(i);
+        dropped[i] = 0;
+        if (m->type == TUNNEL_MARKER_STRIP && McRun_Chance(r, s->strip_miss)) {
+            dropped[i] = 1;
+        }
+        if (m->type == TUNNEL_MARKER_REFLECTOR && i >= SIM_GATE_WARMUP && i + 1U < count &&
+            McRun_Chance(r, s->refl_miss)) {
+            dropped[i] = 1;
+            r->reflector_dropped[i] = 1;
+        }
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        const TunnelMarker_t *m = TunnelMap_Marker(i);
+        const TunnelMarker_t *next = TunnelMap_Marker(i + 1U);
+        if (!dropped[i]) {
+            McRun_AddEdge(r, Q16_TO_FLOAT(m->position), i);
+        }
+        if (i + 1U >= SIM_GATE_WARMUP && m->type == TUNNEL_MARKER_REFLECTOR && !dropped[i] &&
+            next != NULL && next->type == TUNNEL_MARKER_REFLECTOR && !dropped[i + 1U] &&
+            McRun_Chance(r, s->glint)) {
+            double u = McRun_Uniform(r);
+            McRun_AddEdge(r, Q16_TO_FLOAT(m->position) + SIM_GLINT_MIN + u * (SIM_GLINT_MAX - SIM_GLINT_MIN), -1);
+        }
+    }
+}
+
+// [t, t_end] sabit ivmeyle: geçilen işaretlerin yakalama anları kuyruğa
+static void McRun_Segment(McRun_t *r, double a, double t_end) {
+    double dt = t_end - r->t;
+    double x1 = r->x + (r->v + 0.5 * a * dt) * dt;
+
+    while (r->edge_next < r->edge_total && r->edges[r->edge_next].pos <= x1) {
+        const McEdge_t *e = &r->edges[r->edge_next++];
+        double d = e->pos - r->x;
+        double tau = 0.0;
+        if (d > 0.0) {
+            // x(tau) = d'nin kökü; v^2 + 2ad >= 0 (işaret bu parçada geçiliyor)
+            double disc = r->v * r->v + 2.0 * a * d;
+            tau = 2.0 * d / (r->v + sqrt(disc > 0.0 ? disc : 0.0));
+        }
+        // -J: sensörün tepki süresi kenardan kenara değişir
+        double jitter = r->s->jitter_us > 0.0 ? r->s->jitter_us * 1e-6 * fabs(McRun_Gauss(r)) : 0.0;
+        McCapture_t *c = &r->pending[r->pending_head++ & (MC_PENDING - 1U)];
+        c->t = r->t + tau + jitter;
+        c->v = r->v + a * tau;
+        c->marker = e->marker;
+    }
+
+    r->x = x1;
+    r->v += a * dt;
+    r->t = t_end;
+    r->a = a;
+}
+
+// Kapsül t_end'e kadar: kalkış beklemesi, ivmelenme, seyir, frenleme
+static void McRun_Plant(McRun_t *r, double t_end) {
+    const McScenario_t *s = r->s;
+    while (!r->stopped && r->t < t_end) {
+        double brake_on = r->brake_cmd_t >= 0.0 ? r->brake_cmd_t + s->latency : INFINITY;
+        double seg_end = t_end;
+        double a;
+        uint8_t cruise = 0, stop = 0;
+
+        if (r->t >= brake_on) {
+            a = -s->decel;
+            double t_stop = r->t + r->v / s->decel;
+            if (t_stop <= seg_end) {
+                seg_end = t_stop;
+                stop = 1;
+            }
+        } else {
+            if (brake_on < seg_end) seg_end = brake_on;
+            if (r->t < MC_LAUNCH_HOLD_S) {
+                a = 0.0;
+                if (MC_LAUNCH_HOLD_S < seg_end) seg_end = MC_LAUNCH_HOLD_S;
+            } else if (r->v < s->speed) {
+                a = s->accel;
+                double t_cruise = r->t + (s->speed - r->v) / s->accel;
+                if (t_cruise < seg_end) {
+                    seg_end = t_cruise;
+                    cruise = 1;
+                }
+            } else {
+                a = 0.0;
+            }
+        }
+
+        McRun_Segment(r, a, seg_end);
+        if (cruise) r->v = s->speed;
+        if (stop) {
+            r->v = 0.0;
+            r->stopped = 1;
+        }
+    }
+}
+
+// Yakalanan kenar: sürücüye, sonra kenar hız hatası (tunnel_sim Edge_Record)
+static void McRun_Edge(McRun_t *r, const McCapture_t *c) {
+    McHal_SetTime((uint64_t)(c->t * MC_NS_PER_S));
+    if (c->marker >= 0) {
+        r->last_marker_seen = c->marker;
+    } else {
+        r->glints_passed++;
+    }
+    OpticalSensor_ReplayEdge(McRun_Ticks(c->t));
+
+    // İlk işarette hız kestirimi yok (iki nokta da 0): kestirim hatası sayılmaz
+    OpticalVelocity_t vel;
+    OpticalSensor_GetVelocity(&vel);
+    if (vel.two_point != 0) {
+        double err = Q16_TO_FLOAT(VehicleState.current_velocity) - c->v;
+        r->vel_err_sq += err * err;
+        if (fabs(err) > r->vel_err_max) r->vel_err_max = fabs(err);
+        r->vel_err_n++;
+    }
+}
+
+// IMU örneği sensör sayımlarından: sürücünün çevrimi ve filtresi, füzyon
+// filtreli çıkışı örnek anıyla alır
+static void McRun_Imu(McRun_t *r, uint32_t now) {
+    const McScenario_t *s = r->s;
+    double accel_sigma = SIM_IMU_ACCEL_NOISE * s->noise;
+    double gyro_sigma = SIM_IMU_GYRO_NOISE * s->noise;
+    int16_t counts[MPU6050_RAW_AXES];
+    IMU_Data_t raw, filtered;
+
+    counts[0] = McRun_Count((int32_t)lrint((r->a + s->bias) / SIM_G * MPU6050_ACCEL_LSB_PER_G) +
+                            McRun_Noise(r, accel_sigma));
+    counts[1] = McRun_Count(McRun_Noise(r, accel_sigma));
+    counts[2] = McRun_Count(MPU6050_ACCEL_LSB_PER_G + McRun_Noise(r, accel_sigma));
+    counts[3] = (int16_t)lrint((30.0 - MPU6050_TEMP_OFFSET_C) * MPU6050_TEMP_LSB_PER_C);
+    counts[4] = McRun_Count(McRun_Noise(r, gyro_sigma));
+    counts[5] = McRun_Count(McRun_Noise(r, gyro_sigma));
+    counts[6] = McRun_Count(McRun_Noise(r, gyro_sigma));
+
+    MPU6050_FromRaw(counts, &raw);
+    if (ImuFilter_Process(&raw, &filtered)) {
+        Fusion_ImuSample(&filtered, now);
+    }
+}
+
+static double McRun_FusedPosition(const NavEstimate_t *nav, uint32_t now) {
+    // Tahmin son IMU örneğinin anına ait; şimdiye hızla taşı
+    int32_t age = (int32_t)(now - nav->timestamp);
+    return Q16_TO_FLOAT(nav->position) + Q16_TO_FLOAT(nav->velocity) * (double)age / FUSION_TICK_HZ;
+}
+
+void McRun_Run(const McScenario_t *s, McResult_t *res) {
+    static const McRun_t zero;
+    McRun_t r = zero;
+    r.s = s;
+    uint64_t seed = ((uint64_t)s->seed << 1) | 1U;
+    r.rng = seed * 0x9E3779B97F4A7C15ULL;
+    r.brake_cmd_t = -1.0;
+    r.last_marker_seen = -1;
+
+    // Modüller baştan: iş parçacığının önceki koşusundan kalan durum burada silinir
+    McHal_SetTime(0);
+    SharedData_Reset();
+    UartLog_Init(NULL);
+    OpticalSensor_Init();
+    Fusion_Init(TunnelMap_Params()->start_offset, 0);
+    ImuFilter_Init();
+    BrakeSupervisor_Init();
+
+    McRun_Track(&r);
+    r.x = Q16_TO_FLOAT(TunnelMap_Params()->start_offset);
+    double tunnel_end = Q16_TO_FLOAT(TunnelMap_Params()->end_position);
+    uint8_t overrun = 0;
+
+    for (uint32_t k = 1; !r.stopped && k <= MC_TIME_LIMIT_MS; k++) {
+        double t = k * 1e-3;
+        uint32_t now = k * MC_STEP_TICKS;
+        McRun_Plant(&r, t);
+
+        // Bu milisaniyede yakalananlar (titreşimle gecikenler sonraki turda)
+        while (r.pending_tail != r.pending_head && r.pending[r.pending_tail & (MC_PENDING - 1U)].t <= t) {
+            McRun_Edge(&r, &r.pending[r.pending_tail++ & (MC_PENDING - 1U)]);
+        }
+
+        McHal_SetTime((uint64_t)k * 1000000ULL);
+        OpticalSensor_ReplayStrip(now);
+        McRun_Imu(&r, now);
+        if (r.v > 0.0) {
+            r.still_since = t;
+        } else if (t - r.still_since >= MC_STILL_S) {
+            Fusion_ZeroVelocity();
+        }
+
+        const NavEstimate_t *nav = &VehicleState.nav;
+        double err = McRun_FusedPosition(nav, now) - r.x;
+        r.fus_err_sq += err * err;
+        if (fabs(err) <= 3.0 * sqrt(nav->cov[0])) r.fus_in_3sigma++;
+        r.fus_n++;
+
+        // Fren komutu firmware'den; kapsül aktüatör gecikmesinden sonra yavaşlar
+        BrakeSupervisor_Update(now);
+        if (r.brake_cmd_t < 0.0 && VehicleState.system_status == SYS_BRAKING) {
+            r.brake_cmd_t = t;
+            r.brake_cmd_x = r.x;
+        }
+        if (r.x >= tunnel_end) {
+            overrun = 1;
+            break;
+        }
+    }
+    uint32_t end = McRun_Ticks(r.t);
+
+    // Kontroller tunnel_sim'deki gibi (yalnız bu koşunun kapsadıkları)
+    BrakeLog_t brake;
+    BrakeSupervisor_GetLog(&brake);
+    double stop_limit = Q16_TO_FLOAT(TunnelMap_StopLimit());
+    uint8_t plant_nominal = s->decel >= Q16_TO_FLOAT(BRAKE_DECEL_NOMINAL) &&
+                            s->latency * BRAKE_TICK_HZ <= BRAKE_ACTUATOR_LATENCY;
+    uint8_t brake_ok = r.brake_cmd_t >= 0.0 && !overrun &&
+                       (!plant_nominal || r.x <= stop_limit + SIM_BRAKE_STOP_TOL);
+
+    // Kayıp reflektör arkasından görülen işaretle çıkarılır (tunnel_sim Track_DroppedBefore)
+    uint32_t reflectors_dropped = 0;
+    for (int32_t i = 0; i < r.last_marker_seen; i++) {
+        reflectors_dropped += r.reflector_dropped[i];
+    }
+    OpticalMarkerStats_t marker_stats;
+    OpticalSensor_GetMarkerStats(&marker_stats);
+    uint8_t gate_ok = marker_stats.gate_rejected == r.glints_passed &&
+                      marker_stats.gate_inferred == reflectors_dropped && marker_stats.gate_reacquired == 0;
+
+    StripDecoderStats_t strip_stats;
+    StripDecoder_GetStats(&strip_stats);
+    const TunnelMarker_t *last_marker = r.last_marker_seen >= 0 ? TunnelMap_Marker((uint16_t)r.last_marker_seen) : NULL;
+    uint8_t strips_ok = (s->strip_miss > 0.0 || strip_stats.decoded == TunnelMap_Params()->zone_count) &&
+                        last_marker != NULL && VehicleState.current_position == last_marker->position &&
+                        VehicleState.reflector_count == last_marker->reflector_seq;
+
+    FusionStats_t fus_stats;
+    Fusion_GetStats(&fus_stats);
+    double fus_rms = sqrt(r.fus_err_sq / r.fus_n);
+    double bias_est = Q16_TO_FLOAT(VehicleState.nav.accel_bias);
+    uint8_t fusion_ok = fus_rms <= SIM_FUSION_POS_RMS_MAX &&
+                        (double)r.fus_in_3sigma / r.fus_n >= SIM_FUSION_3SIGMA_MIN &&
+                        fabs(bias_est - s->bias) <= SIM_FUSION_BIAS_TOL && fus_stats.forced_gate == 0;
+
+    *res = (McResult_t){
+        .seed = s->seed,
+        .speed = s->speed,
+        .accel = s->accel,
+        .decel = s->decel,
+        .latency = s->latency,
+        .pos_err = Q16_TO_FLOAT(VehicleState.current_position) - r.x,
+        .fused_err = McRun_FusedPosition(&VehicleState.nav, end) - r.x,
+        .brake_point_err = r.brake_cmd_t >= 0.0 ? Q16_TO_FLOAT(brake.command_position) - r.brake_cmd_x : NAN,
+        .stop_pred_err = r.x - Q16_TO_FLOAT(brake.predicted_stop),
+        .stop_margin = stop_limit - r.x,
+        .vel_rms = r.vel_err_n > 0 ? sqrt(r.vel_err_sq / r.vel_err_n) : 0.0,
+        .vel_max = r.vel_err_max,
+        .fusion_rms = fus_rms,
+        .fail = (brake_ok ? 0U : SIM_FAIL_BRAKE) | (gate_ok ? 0U : SIM_FAIL_GATE) |
+                (strips_ok ? 0U : SIM_FAIL_STRIPS) | (fusion_ok ? 0U : SIM_FAIL_FUSION),
+    };
+}
@@ -0,0 +1,41 @@
+/*
+ * mc_run.h
+ *
+ * tunnel_mc'nin hafif koşusu: tek senaryoyu navigasyon ve fren kodundan
+ * geçirir (optik sürücü, şerit çözücü, hız uydurma, IMU filtresi, füzyon,
+ * fren denetçisi). Çevre birimi modeli, zamanlayıcı, telemetri ve
+ * doğrulama tabloları yok; sonuç alanları ve kontrol bitleri tunnel_sim
+ * -R ile aynı (sim_result.h).
+ *
+ * Firmware FW_STATE_PER_THREAD ile derlenir (fw_state.h): her iş parçacığı
+ * kendi modül durumunda koşar, McRun_Run her koşuda modülleri yeniden kurar.
+ */
+
+#ifndef MC_RUN_H
+#define MC_RUN_H
+
+#include <stdint.h>
+
+typedef struct {
+    unsigned seed;
+    double speed, accel, decel, latency;   // m/s, m/s^2, m/s^2, s
+    double strip_miss, refl_miss, glint;   // Olasılık
+    double jitter_us, noise, bias;         // Kenar titreşimi, IMU gürültü ölçeği, ivme sapması (m/s^2)
+} McScenario_t;
+
+// Sonuç alanları (sim_result.h sırasıyla)
+typedef struct {
+    unsigned seed;
+    double speed, accel, decel, latency;
+    double pos_err, fused_err, brake_point_err, stop_pred_err, stop_margin;
+    double vel_rms, vel_max, fusion_rms;
+    unsigned fail;                         // SIM_FAIL_*
+} McResult_t;
+
+/**
+ * @brief Senaryoyu çağıran iş parçacığında koşturur. Sonuç yalnız
+ * senaryodan belirlenir: iş parçacığında önceki koşulara bağlı değildir.
+ */
+void McRun_Run(const McScenario_t *s, McResult_t *r);
+
+#endif
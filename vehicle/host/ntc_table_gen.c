@@ -0,0 +1,76 @@
+/*
+ * ntc_table_gen.c
+ *
+ * ntc_table.c üreticisi: ntc.h'daki termistör/bölücü değerleriyle 16 bit
+ * aşırı örneklenmiş ADC kodundan °C'ye tabloyu β denklemiyle hesaplar.
+ * Makefile ntc.h ya da bu dosya değişince tabloyu yeniden üretir; üretilen
+ * dosya depoda durur, hedef derleme (CubeIDE) onu olduğu gibi kullanır.
+ *
+ * Kullanım: ntc_table_gen > ../src/sensors/ntc_table.c
+ */
+
+#include "ntc.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#define KELVIN_0C   273.15
+#define T25_K       (25.0 + KELVIN_0C)
+
+// Kod -> °C (tam formül). ADC sonucu aşağı yuvarlar: N örneğin ortalaması
+// gerçek değerin yarım LSB altında kalır, 16 bit kodda bu 8 birim
+static double Ntc_Exact(double code) {
+    double x = (code + 8.0) / 65536.0;
+    if (x <= 0.0) return NTC_TEMP_MAX_C;
+    if (x >= 1.0) return NTC_TEMP_MIN_C;
+
+    double r = NTC_R_SERIES_OHM * x / (1.0 - x);
+    double t = 1.0 / (1.0 / T25_K + log(r / NTC_R25_OHM) / NTC_BETA_K) - KELVIN_0C;
+    if (t > NTC_TEMP_MAX_C) t = NTC_TEMP_MAX_C;
+    if (t < NTC_TEMP_MIN_C) t = NTC_TEMP_MIN_C;
+    return t;
+}
+
+int main(void) {
+    q16_t table[NTC_TABLE_SIZE];
+    for (uint32_t i = 0; i < NTC_TABLE_SIZE; i++) {
+        double t = Ntc_Exact((double)(i << NTC_TABLE_SHIFT));
+        table[i] = (q16_t)lround(t * 65536.0);
+    }
+
+    // Firmware'in ara değer hesabının tam formüle göre hatası (çalışma aralığında)
+    double err_max = 0.0;
+    for (uint32_t code = NTC_CODE_SHORT; code <= NTC_CODE_OPEN; code++) {
+        double exact = Ntc_Exact((double)code);
+        if (exact < -40.0 || exact > 125.0) continue;
+
+        uint32_t i = code >> NTC_TABLE_SHIFT;
+        int32_t frac = (int32_t)(code & ((1U << NTC_TABLE_SHIFT) - 1U));
+        int32_t dt = table[i + 1U] - table[i];
+        q16_t t = table[i] + (int32_t)(((int64_t)dt * frac) >> NTC_TABLE_SHIFT);
+        double err = fabs(t / 65536.0 - exact);
+        if (err > err_max) err_max = err;
+    }
+
+    printf("// ntc_table.c\n");
+    printf("// ÜRETİLMİŞ DOSYA, elle düzenlemeyin: make -C vehicle/host (host/ntc_table_gen.c)\n");
+    printf("// R25 %d ohm, beta %d K, seri direnç %d ohm, %u parça\n",
+           NTC_R25_OHM, NTC_BETA_K, NTC_R_SERIES_OHM, 1U << NTC_TABLE_BITS);
+    printf("// Ara değer hatası (-40..125 °C): en çok %.3f °C\n", err_max);
+    printf("#include \"ntc.h\"\n\n");
+    printf("#if NTC_R25_OHM != %d || NTC_BETA_K != %d || NTC_R_SERIES_OHM != %d || NTC_TABLE_BITS != %d\n",
+           NTC_R25_OHM, NTC_BETA_K, NTC_R_SERIES_OHM, NTC_TABLE_BITS);
+    printf("#error \"ntc_table.c ntc.h ile uyuşmuyor: make -C vehicle/host ile yeniden üretin\"\n");
+    printf("#endif\n\n");
+    printf("// Eleman i: 16 bit kod i << %u, °C (Q16.16)\n", NTC_TABLE_SHIFT);
+    printf("const q16_t ntc_table[NTC_TABLE_SIZE] = {\n");
+    for (uint32_t i = 0; i < NTC_TABLE_SIZE; i += 8) {
+        printf("    /* %3u */", i);
+        for (uint32_t j = i; j < i + 8 && j < NTC_TABLE_SIZE; j++) {
+            printf(" %9d,", table[j]);
+        }
+        printf("\n");
+    }
+    printf("};\n");
+    return 0;
+}
@@ -0,0 +1,36 @@
+// sim_encoder.c
+#include "sim_encoder.h"
+#include "sim_hal.h"
+
+#include <math.h>
+
+double SimEncoder_MetersPerCount(void) {
+    return Q16_TO_FLOAT(ENCODER_WHEEL_CIRC) / ENCODER_CPR;
+}
+
+void SimEncoder_Move(SimEncoder_t *e, double c1, uint64_t t0, uint64_t t1) {
+    double c0 = e->count;
+    if (c1 > c0) {
+        double k = floor(c1 / ENCODER_COUNTS_PER_EDGE) * ENCODER_COUNTS_PER_EDGE;
+        if (k > c0) {
+            e->edge_count = (int64_t)k;
+            e->edge_ns = t0 + (uint64_t)((k - c0) / (c1 - c0) * (double)(t1 - t0));
+        }
+    } else if (c1 < c0) {
+        double k = ceil(c1 / ENCODER_COUNTS_PER_EDGE) * ENCODER_COUNTS_PER_EDGE;
+        if (k < c0) {
+            e->edge_count = (int64_t)k;
+            e->edge_ns = t0 + (uint64_t)((c0 - k) / (c0 - c1) * (double)(t1 - t0));
+        }
+    }
+    e->count = c1;
+}
+
+void SimEncoder_Raw(const SimEncoder_t *e, uint32_t now, uint64_t now_ns, EncoderRaw_t *raw) {
+    int64_t c = (int64_t)floor(e->count);
+    raw->wraps = (int32_t)floor((double)c / 65536.0);
+    raw->count = (uint16_t)c;
+    raw->edge_count = (uint16_t)e->edge_count;
+    raw->edge_time = (uint16_t)(now - (uint32_t)((now_ns - e->edge_ns) * ENCODER_TICK_HZ / SIM_NS_PER_S));
+    raw->now = now;
+}
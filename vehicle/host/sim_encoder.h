@@ -0,0 +1,38 @@
+/*
+ * sim_encoder.h
+ *
+ * Tekerlek enkoderinin host modeli: kesirli sayım hareketten ilerletilir,
+ * son A yükselen kenarının sayımı ve sanal zamanı tutulur; donanımın
+ * (TIM1 CNT/CCR1, TIM2 CCR2) o anda göstereceği değerler buradan üretilip
+ * Encoder_Sample'a verilir. tunnel_sim koşuda, encoder_test sentetik
+ * sayım dizilerinde kullanır.
+ */
+
+#ifndef SIM_ENCODER_H
+#define SIM_ENCODER_H
+
+#include "encoder.h"
+
+typedef struct {
+    double count;         // Kesirli sayım (mesafe x CPR / çevre)
+    int64_t edge_count;   // Son A yükselen kenarındaki sayım
+    uint64_t edge_ns;     // ve sanal zamanı
+} SimEncoder_t;
+
+/**
+ * @brief Bir sayımın karşılığı (m).
+ */
+double SimEncoder_MetersPerCount(void);
+
+/**
+ * @brief Sayım t0..t1 içinde c1'e gelir; geçilen son A kenarı (4'ün katı)
+ * doğrusal aradeğerlemeyle zamanlanır.
+ */
+void SimEncoder_Move(SimEncoder_t *e, double c1, uint64_t t0, uint64_t t1);
+
+/**
+ * @brief Donanımın now (TIM2, 32 bit) / now_ns anında göstereceği değerler.
+ */
+void SimEncoder_Raw(const SimEncoder_t *e, uint32_t now, uint64_t now_ns, EncoderRaw_t *raw);
+
+#endif
@@ -0,0 +1,994 @@
+/*
+ * sim_hal.c
+ *
+ * STM32F1 HAL fonksiyonlarının sanal saat üzerinde çalışan karşılıkları.
+ * Kesmeler (EXTI, TIM update, I2C/ADC DMA bitişi) zamanlanmış olay olarak
+ * modellenir ve sadece SimHAL_RunUntil / HAL_Delay içinde çalışır; yani
+ * firmware kodu bir fonksiyonun ortasında kesilmez.
+ */
+
+#include "sim_hal.h"
+#include <string.h>
+
+// --- Çevre birimi örnekleri ---
+GPIO_TypeDef SimGPIOA, SimGPIOB, SimGPIOC;
+TIM_TypeDef SimTIM1, SimTIM2, SimTIM3;
+USART_TypeDef SimUSART2;
+I2C_TypeDef SimI2C1;
+ADC_TypeDef SimADC1;
+DMA_Channel_TypeDef SimDMA1_Channel1, SimDMA1_Channel7;
+
+// --- Olay kuyruğu ---
+typedef struct {
+    uint64_t t_ns;
+    uint64_t seq;       // Aynı zamanlı olaylarda kayıt sırası korunur
+    SimEventFn fn;
+    void *arg;
+} SimEvent_t;
+
+static SimEvent_t events[SIM_MAX_EVENTS];
+static uint32_t event_count = 0;
+static uint64_t event_seq = 0;
+static uint64_t now_ns = 0;
+static uint32_t irq_disable_depth = 0;
+static uint8_t (*wake_hook)(void) = NULL;
+
+// --- Sahte MPU6050 ---
+static uint8_t mpu_regs[128];
+static uint8_t mpu_present = 1;
+static uint8_t mpu_fifo[1024];
+static uint16_t mpu_fifo_head = 0;
+static uint16_t mpu_fifo_count = 0;
+static GPIO_TypeDef *mpu_int_port = NULL;
+static uint16_t mpu_int_pin = 0;
+
+// Kesmeli/DMA'lı I2C transferi sürerken hedef bilgileri
+typedef struct {
+    I2C_HandleTypeDef *handle;
+    uint8_t write;
+    uint8_t fault;          // SIM_I2C_FAULT_*
+    uint16_t addr;
+    uint16_t reg;
+    uint8_t *data;
+    uint16_t size;
+} SimI2CXfer_t;
+
+static SimI2CXfer_t i2c_xfer;
+static uint32_t i2c_gen = 0;                // DeInit bekleyen bitiş olayını geçersiz kılar
+static uint8_t (*i2c_fault_hook)(uint16_t addr);
+static uint8_t i2c_sda_stuck = 0;
+static uint8_t i2c_scl_pulses = 0;          // Takılıyken sayılan SCL yükselen kenarı
+static uint16_t i2c_aux_addr = 0;
+static uint8_t *i2c_aux_regs = NULL;
+static uint16_t i2c_aux_size = 0;
+
+static FILE *uart_sink = NULL;
+
+// Flash: silme/yazma anlık (gerçekte sayfa silme ~20 ms CPU'yu durdurur)
+static uint8_t flash_mem[FLASH_SIZE];
+static uint8_t flash_locked = 1;
+
+// ADC tarama + dairesel DMA
+static ADC_HandleTypeDef *adc_dma_handle;
+static uint16_t *adc_dma_buf;
+static uint32_t adc_dma_len;
+static uint8_t adc_dma_second;     // Sıradaki olay tamponun ikinci yarısını doldurur
+static uint16_t (*adc_source)(uint32_t channel);
+
+// --- TIM giriş yakalama (filtre gecikmesi boyunca bekleyen kenarlar) ---
+typedef struct {
+    TIM_TypeDef *tim;
+    uint32_t ch;
+    uint64_t edge_ns;
+    uint8_t level;
+} SimCapture_t;
+
+static SimCapture_t capture_slots[8];
+static uint32_t capture_slot_next = 0;
+static uint64_t pa_last_change_ns[4];
+
+static void TIM_RouteEdge(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level);
+static void I2C_SclEdge(uint16_t was, uint16_t now_odr);
+
+void SimHAL_Reset(void) {
+    event_count = 0;
+    event_seq = 0;
+    now_ns = 0;
+    irq_disable_depth = 0;
+    wake_hook = NULL;
+
+    memset(&SimGPIOA, 0, sizeof(SimGPIOA));
+    memset(&SimGPIOB, 0, sizeof(SimGPIOB));
+    memset(&SimGPIOC, 0, sizeof(SimGPIOC));
+    memset(&SimTIM1, 0, sizeof(SimTIM1));
+    memset(&SimTIM2, 0, sizeof(SimTIM2));
+    memset(&SimTIM3, 0, sizeof(SimTIM3));
+    memset(&SimUSART2, 0, sizeof(SimUSART2));
+    memset(&SimI2C1, 0, sizeof(SimI2C1));
+    memset(&SimADC1, 0, sizeof(SimADC1));
+    adc_dma_handle = NULL;
+    adc_source = NULL;
+
+    memset(mpu_regs, 0, sizeof(mpu_regs));
+    mpu_regs[0x75] = 0x68;  // WHO_AM_I
+    mpu_regs[0x6B] = 0x40;  // PWR_MGMT_1: reset sonrası uyku modunda
+    mpu_present = 1;
+    mpu_fifo_head = 0;
+    mpu_fifo_count = 0;
+    mpu_int_port = NULL;
+    mpu_int_pin = 0;
+    memset(&i2c_xfer, 0, sizeof(i2c_xfer));
+    i2c_gen++;
+    i2c_fault_hook = NULL;
+    i2c_sda_stuck = 0;
+    i2c_aux_regs = NULL;
+    SimGPIOB.IDR |= GPIO_PIN_6 | GPIO_PIN_7;   // I2C1 SCL/SDA: harici pull-up
+
+    memset(pa_last_change_ns, 0, sizeof(pa_last_change_ns));
+    capture_slot_next = 0;
+
+    uart_sink = stdout;
+
+    memset(flash_mem, 0xFF, sizeof(flash_mem));
+    flash_locked = 1;
+}
+
+uint64_t SimHAL_Now_ns(void) {
+    return now_ns;
+}
+
+uint8_t SimHAL_Schedule(uint64_t t_ns, SimEventFn fn, void *arg) {
+    if (event_count >= SIM_MAX_EVENTS) return 1;
+    if (t_ns < now_ns) t_ns = now_ns;
+
+    events[event_count].t_ns = t_ns;
+    events[event_count].seq = event_seq++;
+    events[event_count].fn = fn;
+    events[event_count].arg = arg;
+    event_count++;
+    return 0;
+}
+
+// t_ns'e kadar olan en erken olayı çalıştırır. 0: böyle olay yok
+static uint8_t SimHAL_RunNext(uint64_t t_ns) {
+    if (event_count == 0) return 0;
+
+    // En erken olayı bul (kuyruk küçük, doğrusal tarama yeterli)
+    uint32_t best = 0;
+    for (uint32_t i = 1; i < event_count; i++) {
+        if (events[i].t_ns < events[best].t_ns ||
+            (events[i].t_ns == events[best].t_ns && events[i].seq < events[best].seq)) {
+            best = i;
+        }
+    }
+    if (events[best].t_ns > t_ns) return 0;
+
+    SimEvent_t ev = events[best];
+    events[best] = events[--event_count];
+
+    now_ns = ev.t_ns;
+    ev.fn(ev.arg);
+    return 1;
+}
+
+void SimHAL_RunUntil(uint64_t t_ns) {
+    while (SimHAL_RunNext(t_ns)) {
+    }
+    if (t_ns > now_ns) now_ns = t_ns;
+}
+
+void SimHAL_SetWakeHook(uint8_t (*hook)(void)) {
+    wake_hook = hook;
+}
+
+void SimHAL_WFI(void) {
+    uint64_t systick_ns = (now_ns / SIM_NS_PER_MS + 1U) * SIM_NS_PER_MS;
+    while (SimHAL_RunNext(systick_ns)) {
+        if (wake_hook != NULL && wake_hook()) return;
+    }
+    now_ns = systick_ns;
+}
+
+void SimHAL_DisableIRQ(void) {
+    irq_disable_depth++;
+}
+
+void SimHAL_EnableIRQ(void) {
+    if (irq_disable_depth > 0) irq_disable_depth--;
+}
+
+uint32_t SimHAL_GetPRIMASK(void) {
+    return irq_disable_depth ? 1U : 0U;
+}
+
+void SimHAL_SetPRIMASK(uint32_t primask) {
+    irq_disable_depth = primask ? 1U : 0U;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+    (void)IRQn;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) {
+    (void)hdma;
+    return HAL_OK;
+}
+
+// ============= GENEL =============
+HAL_StatusTypeDef HAL_Init(void) {
+    return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void) {
+    return (uint32_t)(now_ns / SIM_NS_PER_MS);
+}
+
+void HAL_Delay(uint32_t Delay) {
+    SimHAL_RunUntil(now_ns + (uint64_t)Delay * SIM_NS_PER_MS);
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct) {
+    (void)RCC_OscInitStruct;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency) {
+    (void)RCC_ClkInitStruct;
+    (void)FLatency;
+    return HAL_OK;
+}
+
+// ============= FLASH =============
+const uint8_t *SimHAL_Flash(uint32_t addr) {
+    if (addr < FLASH_BASE || addr >= FLASH_BASE + FLASH_SIZE) return NULL;
+    return &flash_mem[addr - FLASH_BASE];
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+    flash_locked = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+    flash_locked = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError) {
+    *PageError = 0xFFFFFFFFU;
+    if (flash_locked || pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES) return HAL_ERROR;
+    uint32_t addr = pEraseInit->PageAddress & ~(FLASH_PAGE_SIZE - 1U);
+    for (uint32_t i = 0; i < pEraseInit->NbPages; i++, addr += FLASH_PAGE_SIZE) {
+        if (SimHAL_Flash(addr) == NULL) {
+            *PageError = addr;
+            return HAL_ERROR;
+        }
+        memset(&flash_mem[addr - FLASH_BASE], 0xFF, FLASH_PAGE_SIZE);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data) {
+    uint32_t size = (TypeProgram == FLASH_TYPEPROGRAM_WORD) ? 4U : 2U;
+    if (flash_locked || (Address & 1U) || SimHAL_Flash(Address + size - 1U) == NULL ||
+        SimHAL_Flash(Address) == NULL) {
+        return HAL_ERROR;
+    }
+    // F1 yarım kelime yazar; silinmemiş (0xFFFF olmayan) yere yazma hatadır
+    for (uint32_t i = 0; i < size; i += 2U) {
+        uint8_t *p = &flash_mem[Address - FLASH_BASE + i];
+        if (p[0] != 0xFF || p[1] != 0xFF) return HAL_ERROR;
+        p[0] = (uint8_t)(Data >> (8U * i));
+        p[1] = (uint8_t)(Data >> (8U * i + 8U));
+    }
+    return HAL_OK;
+}
+
+// ============= GPIO =============
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init) {
+    uint16_t pins = (uint16_t)GPIO_Init->Pin;
+
+    GPIOx->it_rising &= (uint16_t)~pins;
+    GPIOx->it_falling &= (uint16_t)~pins;
+    if (GPIO_Init->Mode == GPIO_MODE_IT_RISING || GPIO_Init->Mode == GPIO_MODE_IT_RISING_FALLING) {
+        GPIOx->it_rising |= pins;
+    }
+    if (GPIO_Init->Mode == GPIO_MODE_IT_FALLING || GPIO_Init->Mode == GPIO_MODE_IT_RISING_FALLING) {
+        GPIOx->it_falling |= pins;
+    }
+
+    // Pull-up'lı girişler boşta '1' okunur
+    if (GPIO_Init->Pull == GPIO_PULLUP) {
+        GPIOx->IDR |= pins;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    uint16_t was = GPIOx->ODR;
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= (uint16_t)~GPIO_Pin;
+    }
+    if (GPIOx == GPIOB) I2C_SclEdge(was, GPIOx->ODR);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+void SimHAL_GPIO_Drive(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    uint8_t was_set = (GPIOx->IDR & GPIO_Pin) != 0;
+
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->IDR |= GPIO_Pin;
+    } else {
+        GPIOx->IDR &= (uint16_t)~GPIO_Pin;
+    }
+
+    if (was_set != (PinState == GPIO_PIN_SET)) {
+        TIM_RouteEdge(GPIOx, GPIO_Pin, PinState == GPIO_PIN_SET);
+    }
+
+    if (!was_set && PinState == GPIO_PIN_SET && (GPIOx->it_rising & GPIO_Pin)) {
+        HAL_GPIO_EXTI_Callback(GPIO_Pin);
+    } else if (was_set && PinState == GPIO_PIN_RESET && (GPIOx->it_falling & GPIO_Pin)) {
+        HAL_GPIO_EXTI_Callback(GPIO_Pin);
+    }
+}
+
+__attribute__((weak)) void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    (void)GPIO_Pin;
+}
+
+// ============= TIM =============
+static uint64_t TIM_PeriodNs(const TIM_TypeDef *tim) {
+    return ((uint64_t)(tim->psc + 1U) * (uint64_t)(tim->arr + 1U) * SIM_NS_PER_S) / SIM_TIMCLK_HZ;
+}
+
+static TIM_HandleTypeDef *tim_it_handles[2];
+
+static TIM_HandleTypeDef **TIM_Slot(TIM_TypeDef *tim) {
+    return (tim == TIM2) ? &tim_it_handles[0] : &tim_it_handles[1];
+}
+
+static void TIM_UpdateEvent(void *arg) {
+    TIM_TypeDef *tim = (TIM_TypeDef *)arg;
+    if (!tim->running || !tim->update_it) return;
+
+    // Durdurulup yeniden başlatılmış bir sayacın eski olaylarını yok say
+    if (now_ns != tim->next_update_ns) return;
+
+    tim->next_update_ns = now_ns + TIM_PeriodNs(tim);
+    SimHAL_Schedule(tim->next_update_ns, TIM_UpdateEvent, tim);
+    HAL_TIM_PeriodElapsedCallback(*TIM_Slot(tim));
+}
+
+uint8_t SimHAL_TIM_GetFlag(TIM_TypeDef *tim, uint32_t flag) {
+    // Update bayrağı: taşma zamanı geldi ama kesmesi henüz işlenmedi
+    if (flag == TIM_FLAG_UPDATE) {
+        return (tim->running && tim->update_it && now_ns >= tim->next_update_ns) ? 1U : 0U;
+    }
+    return 0U;
+}
+
+uint32_t SimHAL_TIM_GetCounter(TIM_TypeDef *tim) {
+    if (!tim->running) return 0;
+    unsigned __int128 ticks = (unsigned __int128)(now_ns - tim->start_ns) * SIM_TIMCLK_HZ
+                              / ((uint64_t)(tim->psc + 1U) * SIM_NS_PER_S);
+    return (uint32_t)(ticks % (tim->arr + 1U));
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim) {
+    htim->Instance->psc = htim->Init.Prescaler;
+    htim->Instance->arr = htim->Init.Period;
+    htim->Instance->clock_division = htim->Init.ClockDivision;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim) {
+    return HAL_TIM_Base_Init(htim);
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef *htim, TIM_IC_InitTypeDef *sConfig, uint32_t Channel) {
+    uint32_t ch = Channel >> 2;
+    htim->Instance->ic_polarity[ch] = (uint8_t)sConfig->ICPolarity;
+    htim->Instance->ic_filter[ch] = sConfig->ICFilter;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    TIM_TypeDef *tim = htim->Instance;
+    if (!tim->running) {
+        tim->running = 1;
+        tim->start_ns = now_ns;
+    }
+    tim->ic_it |= (uint8_t)(1U << (Channel >> 2));
+    *TIM_Slot(tim) = htim;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    // Kesmesiz yakalama: CCR güncellenir, callback çağrılmaz
+    TIM_TypeDef *tim = htim->Instance;
+    (void)Channel;
+    if (!tim->running) {
+        tim->running = 1;
+        tim->start_ns = now_ns;
+    }
+    *TIM_Slot(tim) = htim;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim, TIM_Encoder_InitTypeDef *sConfig) {
+    (void)sConfig;
+    htim->Instance->psc = htim->Init.Prescaler;
+    htim->Instance->arr = htim->Init.Period;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    (void)htim;
+    (void)Channel;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    htim->Instance->ic_it &= (uint8_t)~(1U << (Channel >> 2));
+    return HAL_OK;
+}
+
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef *htim, uint32_t Channel) {
+    return htim->Instance->ccr[Channel >> 2];
+}
+
+__attribute__((weak)) void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    (void)htim;
+}
+
+// Giriş filtresi: ICF değeri için (fSAMPLING bölücüsü, N) çiftleri (RM0008, TIMx_CCMR1)
+static const uint8_t ic_filter_div[16] = { 0, 1, 1, 1, 2, 2, 4, 4, 8, 8, 16, 16, 16, 32, 32, 32 };
+static const uint8_t ic_filter_n[16]   = { 0, 2, 4, 8, 6, 8, 6, 8, 6, 8, 5, 6, 8, 5, 6, 8 };
+
+static uint64_t TIM_FilterNs(const TIM_TypeDef *tim, uint32_t ch) {
+    uint32_t icf = tim->ic_filter[ch] & 0x0F;
+    if (icf == 0) return 0;
+    uint64_t ckd = (tim->clock_division == TIM_CLOCKDIVISION_DIV4) ? 4 :
+                   (tim->clock_division == TIM_CLOCKDIVISION_DIV2) ? 2 : 1;
+    // icf 1..3 tCK_INT ile örnekler, diğerleri tDTS/bölücü ile
+    uint64_t sample_clk_div = (icf <= 3) ? 1 : ckd * ic_filter_div[icf];
+    return sample_clk_div * ic_filter_n[icf] * SIM_NS_PER_S / SIM_TIMCLK_HZ;
+}
+
+static void TIM_CaptureEvent(void *arg) {
+    SimCapture_t *cap = (SimCapture_t *)arg;
+    TIM_TypeDef *tim = cap->tim;
+
+    // Filtre süresi dolmadan seviye tekrar değiştiyse darbe yutulur
+    if (pa_last_change_ns[cap->ch] != cap->edge_ns) return;
+    if (!tim->running || !(tim->ic_it & (1U << cap->ch))) return;
+
+    tim->ccr[cap->ch] = SimHAL_TIM_GetCounter(tim);
+    TIM_HandleTypeDef *htim = *TIM_Slot(tim);
+    htim->Channel = (HAL_TIM_ActiveChannel)(1U << cap->ch);
+    HAL_TIM_IC_CaptureCallback(htim);
+    htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+}
+
+// PA0..PA3 = TIM2_CH1..CH4 (remap yok)
+static void TIM_RouteEdge(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, uint8_t level) {
+    if (GPIOx != GPIOA || GPIO_Pin > GPIO_PIN_3) return;
+
+    uint32_t ch = 0;
+    while ((1U << ch) != GPIO_Pin) ch++;
+    pa_last_change_ns[ch] = now_ns;
+
+    TIM_TypeDef *tim = TIM2;
+    if (!(tim->ic_it & (1U << ch))) return;
+
+    uint8_t pol = tim->ic_polarity[ch];
+    if (pol == TIM_ICPOLARITY_RISING && !level) return;
+    if (pol == TIM_ICPOLARITY_FALLING && level) return;
+
+    SimCapture_t *cap = &capture_slots[capture_slot_next++ % 8];
+    cap->tim = tim;
+    cap->ch = ch;
+    cap->edge_ns = now_ns;
+    cap->level = level;
+    SimHAL_Schedule(now_ns + TIM_FilterNs(tim, ch), TIM_CaptureEvent, cap);
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim) {
+    TIM_TypeDef *tim = htim->Instance;
+    tim->running = 1;
+    tim->update_it = 1;
+    tim->start_ns = now_ns;
+    *TIM_Slot(tim) = htim;
+    tim->next_update_ns = now_ns + TIM_PeriodNs(tim);
+    SimHAL_Schedule(tim->next_update_ns, TIM_UpdateEvent, tim);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim) {
+    htim->Instance->running = 0;
+    htim->Instance->update_it = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *htim, TIM_ClockConfigTypeDef *sClockSourceConfig) {
+    (void)htim;
+    (void)sClockSourceConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *sMasterConfig) {
+    (void)htim;
+    (void)sMasterConfig;
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    (void)htim;
+}
+
+// ============= UART =============
+void SimHAL_UART_SetSink(FILE *sink) {
+    uart_sink = sink;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart) {
+    (void)huart;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    (void)Timeout;
+    huart->Instance->tx_bytes += Size;
+    if (uart_sink) fwrite(pData, 1, Size, uart_sink);
+
+    // Bloklayan gönderim: hat üzerindeki süre kadar zaman geçer (10 bit/karakter),
+    // bu sırada gelen kesmeler de çalışır
+    uint64_t bits = (uint64_t)Size * 10U;
+    SimHAL_RunUntil(now_ns + bits * SIM_NS_PER_S / (huart->Init.BaudRate ? huart->Init.BaudRate : 115200U));
+    return HAL_OK;
+}
+
+// DMA gönderimi: veri hat hızında çıkar; ilk yarı half-transfer anında,
+// kalan kısım transfer sonunda sink'e yazılır. Böylece tampon, DMA henüz
+// okumadan üzerine yazılırsa çıktıda bozulma olarak görünür.
+static UART_HandleTypeDef *uart_dma_handle;
+static uint8_t *uart_dma_data;
+static uint16_t uart_dma_size;
+
+static uint64_t UART_ByteNs(const UART_HandleTypeDef *huart) {
+    return 10U * SIM_NS_PER_S / (huart->Init.BaudRate ? huart->Init.BaudRate : 115200U);
+}
+
+static void UART_DMA_Half(void *arg) {
+    (void)arg;
+    UART_HandleTypeDef *huart = uart_dma_handle;
+    if (uart_sink) fwrite(uart_dma_data, 1, uart_dma_size / 2U, uart_sink);
+    HAL_UART_TxHalfCpltCallback(huart);
+}
+
+static void UART_DMA_Complete(void *arg) {
+    (void)arg;
+    UART_HandleTypeDef *huart = uart_dma_handle;
+    uint16_t half = uart_dma_size / 2U;
+    if (uart_sink) fwrite(uart_dma_data + half, 1, uart_dma_size - half, uart_sink);
+    huart->Instance->tx_bytes += uart_dma_size;
+    huart->tx_busy = 0;
+    HAL_UART_TxCpltCallback(huart);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size) {
+    if (huart->tx_busy) return HAL_BUSY;
+    if (Size == 0) return HAL_ERROR;
+
+    huart->tx_busy = 1;
+    uart_dma_handle = huart;
+    uart_dma_data = pData;
+    uart_dma_size = Size;
+
+    uint64_t byte_ns = UART_ByteNs(huart);
+    SimHAL_Schedule(now_ns + byte_ns * (Size / 2U), UART_DMA_Half, NULL);
+    SimHAL_Schedule(now_ns + byte_ns * Size, UART_DMA_Complete, NULL);
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    (void)huart;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    (void)huart;
+    (void)pData;
+    (void)Size;
+    HAL_Delay(Timeout);
+    return HAL_TIMEOUT;
+}
+
+// ============= ADC =============
+// Dönüşüm süresi = örnekleme + 12.5 ADC saati (yarım saat biriminde tablo)
+static const uint16_t adc_sample_half_cycles[8] = { 3, 15, 27, 57, 83, 111, 143, 479 };
+
+void SimHAL_ADC_SetSource(uint16_t (*source)(uint32_t channel)) {
+    adc_source = source;
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *PeriphClkInit) {
+    (void)PeriphClkInit;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc) {
+    uint32_t n = hadc->Init.ScanConvMode == ADC_SCAN_ENABLE ? hadc->Init.NbrOfConversion : 1U;
+    hadc->Instance->nbr = (uint8_t)((n == 0 || n > 16) ? 1U : n);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig) {
+    if (sConfig->Rank < 1 || sConfig->Rank > 16 || sConfig->Channel >= 18) return HAL_ERROR;
+    hadc->Instance->rank_channel[sConfig->Rank - 1U] = sConfig->Channel;
+    hadc->Instance->sample_time[sConfig->Channel] = sConfig->SamplingTime & 7U;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc) {
+    (void)hadc;
+    return HAL_OK;
+}
+
+// Bir tarama sırasının süresi
+static uint64_t ADC_SequenceNs(const ADC_TypeDef *adc) {
+    uint64_t half_cycles = 0;
+    for (uint8_t r = 0; r < adc->nbr; r++) {
+        half_cycles += adc_sample_half_cycles[adc->sample_time[adc->rank_channel[r]]] + 25U;
+    }
+    return half_cycles * SIM_NS_PER_S / (2ULL * ADC_CLOCK_HZ);
+}
+
+// Yarım tampon dolduğu an: o yarının tüm dönüşümleri şimdiki girişten alınır
+static void ADC_DMA_Event(void *arg) {
+    ADC_HandleTypeDef *hadc = (ADC_HandleTypeDef *)arg;
+    ADC_TypeDef *adc = hadc->Instance;
+    if (!adc->running || hadc != adc_dma_handle) return;
+
+    uint32_t half = adc_dma_len / 2U;
+    uint32_t start = adc_dma_second ? half : 0U;
+    uint32_t end = adc_dma_second ? adc_dma_len : half;
+    for (uint32_t i = start; i < end; i++) {
+        uint32_t ch = adc->rank_channel[i % adc->nbr];
+        adc_dma_buf[i] = adc_source ? (uint16_t)(adc_source(ch) & 0x0FFFU) : 0U;
+    }
+
+    uint8_t second = adc_dma_second;
+    adc_dma_second = !adc_dma_second;
+    SimHAL_Schedule(now_ns + ADC_SequenceNs(adc) * half / adc->nbr, ADC_DMA_Event, hadc);
+    if (second) {
+        HAL_ADC_ConvCpltCallback(hadc);
+    } else {
+        HAL_ADC_ConvHalfCpltCallback(hadc);
+    }
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length) {
+    ADC_TypeDef *adc = hadc->Instance;
+    if (adc->running) return HAL_BUSY;
+    if (Length < 2U || Length % (2U * adc->nbr) != 0) return HAL_ERROR;
+
+    adc->running = 1;
+    adc_dma_handle = hadc;
+    adc_dma_buf = (uint16_t *)pData;   // Yarım kelime hizalı DMA
+    adc_dma_len = Length;
+    adc_dma_second = 0;
+    SimHAL_Schedule(now_ns + ADC_SequenceNs(adc) * (Length / 2U) / adc->nbr, ADC_DMA_Event, hadc);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc) {
+    hadc->Instance->running = 0;
+    adc_dma_handle = NULL;
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+    (void)hadc;
+}
+
+__attribute__((weak)) void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+    (void)hadc;
+}
+
+// ============= I2C / MPU6050 =============
+uint8_t *SimHAL_MPU6050_Regs(void) {
+    return mpu_regs;
+}
+
+void SimHAL_MPU6050_SetPresent(uint8_t present) {
+    mpu_present = present;
+}
+
+void SimHAL_MPU6050_SetIntPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    mpu_int_port = GPIOx;
+    mpu_int_pin = GPIO_Pin;
+}
+
+static void MPU6050_FifoPush(uint8_t byte) {
+    if (mpu_fifo_count == sizeof(mpu_fifo)) {
+        // Taşma: en eski byte'ın üzerine yazılır, örnek hizası kayar
+        mpu_fifo_head = (uint16_t)((mpu_fifo_head + 1U) % sizeof(mpu_fifo));
+        mpu_fifo_count--;
+        mpu_regs[0x3A] |= 0x10;  // FIFO_OFLOW_INT
+    }
+    mpu_fifo[(mpu_fifo_head + mpu_fifo_count) % sizeof(mpu_fifo)] = byte;
+    mpu_fifo_count++;
+}
+
+static void MPU6050_IntRelease(void *arg) {
+    (void)arg;
+    SimHAL_GPIO_Drive(mpu_int_port, mpu_int_pin, GPIO_PIN_RESET);
+}
+
+uint8_t SimHAL_MPU6050_Sample(void) {
+    // FIFO_EN bitleri register sırasıyla: ACCEL(0x08) TEMP(0x80) XG(0x40) YG(0x20) ZG(0x10)
+    static const struct { uint8_t mask, reg, len; } fifo_src[] = {
+        {0x08, 0x3B, 6}, {0x80, 0x41, 2}, {0x40, 0x43, 2}, {0x20, 0x45, 2}, {0x10, 0x47, 2}
+    };
+
+    if (mpu_regs[0x6A] & 0x40) {
+        for (uint8_t s = 0; s < sizeof(fifo_src) / sizeof(fifo_src[0]); s++) {
+            if (!(mpu_regs[0x23] & fifo_src[s].mask)) continue;
+            for (uint8_t i = 0; i < fifo_src[s].len; i++) {
+                MPU6050_FifoPush(mpu_regs[fifo_src[s].reg + i]);
+            }
+        }
+    }
+    mpu_regs[0x3A] |= 0x01;  // DATA_RDY_INT
+
+    // INT: aktif yüksek 50 us darbe
+    if ((mpu_regs[0x38] & 0x01) && mpu_int_port != NULL) {
+        SimHAL_GPIO_Drive(mpu_int_port, mpu_int_pin, GPIO_PIN_SET);
+        SimHAL_Schedule(now_ns + 50000ULL, MPU6050_IntRelease, NULL);
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t MPU6050_ReadByte(uint16_t reg) {
+    switch (reg) {
+    case 0x3A: {  // INT_STATUS okununca temizlenir
+        uint8_t v = mpu_regs[0x3A];
+        mpu_regs[0x3A] = 0;
+        return v;
+    }
+    case 0x72: return (uint8_t)(mpu_fifo_count >> 8);
+    case 0x73: return (uint8_t)mpu_fifo_count;
+    case 0x74: {
+        if (mpu_fifo_count == 0) return 0;  // Boş FIFO: anlamsız veri
+        uint8_t v = mpu_fifo[mpu_fifo_head];
+        mpu_fifo_head = (uint16_t)((mpu_fifo_head + 1U) % sizeof(mpu_fifo));
+        mpu_fifo_count--;
+        return v;
+    }
+    default:
+        return mpu_regs[reg & 0x7F];
+    }
+}
+
+static void MPU6050_ReadRegs(uint16_t reg, uint8_t *dst, uint16_t size) {
+    for (uint16_t i = 0; i < size; i++) {
+        // FIFO_R_W adres artırmaz, art arda okumalar FIFO'yu boşaltır
+        dst[i] = MPU6050_ReadByte(reg == 0x74 ? reg : (uint16_t)((reg + i) & 0x7F));
+    }
+}
+
+static void MPU6050_WriteRegs(uint16_t reg, const uint8_t *src, uint16_t size) {
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t r = (reg + i) & 0x7F;
+        if (r == 0x6A && (src[i] & 0x04)) {
+            // USER_CTRL.FIFO_RESET: FIFO boşalır, bit kendiliğinden sıfırlanır
+            mpu_fifo_head = 0;
+            mpu_fifo_count = 0;
+            mpu_regs[r] = src[i] & (uint8_t)~0x04;
+            continue;
+        }
+        mpu_regs[r] = src[i];
+    }
+}
+
+void SimHAL_I2C_AttachDevice(uint16_t addr, uint8_t *regs, uint16_t size) {
+    i2c_aux_addr = addr;
+    i2c_aux_regs = regs;
+    i2c_aux_size = size;
+}
+
+void SimHAL_I2C_SetFaultHook(uint8_t (*hook)(uint16_t addr)) {
+    i2c_fault_hook = hook;
+}
+
+// Adreste ACK veren cihaz var mı
+static uint8_t I2C_DeviceAcks(uint16_t addr) {
+    if (addr == 0xD0) return mpu_present;
+    return i2c_aux_regs != NULL && addr == i2c_aux_addr;
+}
+
+static void I2C_DeviceAccess(uint16_t addr, uint8_t write, uint16_t reg, uint8_t *data, uint16_t size) {
+    if (addr == 0xD0) {
+        if (write) {
+            MPU6050_WriteRegs(reg, data, size);
+        } else {
+            MPU6050_ReadRegs(reg, data, size);
+        }
+        return;
+    }
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t *r = &i2c_aux_regs[(reg + i) % i2c_aux_size];
+        if (write) {
+            *r = data[i];
+        } else {
+            data[i] = *r;
+        }
+    }
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    (void)MemAddSize;
+    (void)Timeout;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    if (hi2c->Instance->busy) return HAL_BUSY;
+    if (!I2C_DeviceAcks(DevAddress)) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    I2C_DeviceAccess(DevAddress, 0, MemAddress, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    (void)MemAddSize;
+    (void)Timeout;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    if (hi2c->Instance->busy) return HAL_BUSY;
+    if (!I2C_DeviceAcks(DevAddress)) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    I2C_DeviceAccess(DevAddress, 1, MemAddress, pData, Size);
+    return HAL_OK;
+}
+
+static void I2C_Complete(void *arg) {
+    if ((uint32_t)(uintptr_t)arg != i2c_gen) return;   // Çevre birimi arada kapatıldı
+    SimI2CXfer_t x = i2c_xfer;
+    I2C_HandleTypeDef *hi2c = x.handle;
+
+    hi2c->Instance->busy = 0;
+    i2c_xfer.handle = NULL;
+    if (x.fault == SIM_I2C_FAULT_NACK || !I2C_DeviceAcks(x.addr)) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(hi2c);
+        return;
+    }
+    if (x.fault == SIM_I2C_FAULT_BERR) {
+        // Hata anına kadar aktarılan yarı cihaza ulaşmıştır (FIFO'dan çekilmiş)
+        I2C_DeviceAccess(x.addr, x.write, x.reg, x.data, x.size / 2U);
+        hi2c->ErrorCode = HAL_I2C_ERROR_BERR;
+        HAL_I2C_ErrorCallback(hi2c);
+        return;
+    }
+
+    // Veri transferin sonunda, o anki register içeriğinden alınır
+    I2C_DeviceAccess(x.addr, x.write, x.reg, x.data, x.size);
+    if (x.write) {
+        HAL_I2C_MemTxCpltCallback(hi2c);
+    } else {
+        HAL_I2C_MemRxCpltCallback(hi2c);
+    }
+}
+
+// Kesmeli ve DMA'lı transfer aynı modelle: bitiş (veya hata) zamanlanmış olay
+static HAL_StatusTypeDef I2C_StartAsync(I2C_HandleTypeDef *hi2c, uint8_t write, uint16_t DevAddress,
+                                        uint16_t MemAddress, uint8_t *pData, uint16_t Size) {
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    if (hi2c->Instance->busy) return HAL_BUSY;
+
+    hi2c->Instance->busy = 1;
+    i2c_xfer = (SimI2CXfer_t){ hi2c, write, SIM_I2C_FAULT_NONE, DevAddress, MemAddress, pData, Size };
+    if (i2c_fault_hook != NULL) i2c_xfer.fault = i2c_fault_hook(DevAddress);
+
+    // Adres + register (+ okumada tekrar adres) + veri byte'ları, her biri 9 bit
+    uint64_t bits = ((uint64_t)Size + (write ? 2U : 3U)) * 9U;
+    switch (i2c_xfer.fault) {
+    case SIM_I2C_FAULT_STUCK:
+        // Bitiş kesmesi gelmez; hat DeInit + SCL saatlemesiyle kurtarılır
+        i2c_sda_stuck = 1;
+        i2c_scl_pulses = 0;
+        SimGPIOB.IDR &= (uint16_t)~GPIO_PIN_7;
+        return HAL_OK;
+    case SIM_I2C_FAULT_NACK:
+        bits = 9U;
+        break;
+    case SIM_I2C_FAULT_BERR:
+        bits /= 2U;
+        break;
+    default:
+        break;
+    }
+    SimHAL_Schedule(now_ns + bits * SIM_NS_PER_S / SIM_I2C_HZ, I2C_Complete, (void *)(uintptr_t)i2c_gen);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    (void)MemAddSize;
+    return I2C_StartAsync(hi2c, 0, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    (void)MemAddSize;
+    return I2C_StartAsync(hi2c, 0, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    (void)MemAddSize;
+    return I2C_StartAsync(hi2c, 1, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c) {
+    // Süren transfer iptal: zamanlanmış bitiş olayı artık eşleşmez
+    i2c_gen++;
+    i2c_xfer.handle = NULL;
+    hi2c->Instance->busy = 0;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    return i2c_sda_stuck ? HAL_ERROR : HAL_OK;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c) {
+    return hi2c->ErrorCode;
+}
+
+// Takılı köle: SCL'nin yükselen kenarlarında bir bit daha verir, yarım
+// byte'ı bitirince SDA'yı bırakır
+static void I2C_SclEdge(uint16_t was, uint16_t now_odr) {
+    if (!i2c_sda_stuck || (was & GPIO_PIN_6) || !(now_odr & GPIO_PIN_6)) return;
+    if (++i2c_scl_pulses >= 5U) {
+        i2c_sda_stuck = 0;
+        SimGPIOB.IDR |= GPIO_PIN_7;
+    }
+}
+
+__attribute__((weak)) void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+}
+
+__attribute__((weak)) void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+}
+
+__attribute__((weak)) void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+}
@@ -0,0 +1,121 @@
+/*
+ * sim_hal.h
+ *
+ * Host tarafı HAL simülasyonu: sanal saat, zamanlanmış olay kuyruğu,
+ * GPIO kenar sürme, I2C arkasındaki sahte MPU6050 register haritası ve
+ * I2C hata enjeksiyonu.
+ * Firmware kaynakları hal/stm32f1xx_hal.h ile derlenir ve buraya bağlanır.
+ */
+
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+
+#define SIM_TIMCLK_HZ        72000000ULL   // APB1 timer saati (PCLK1 x2)
+#define SIM_I2C_HZ           400000ULL     // I2C fast mode
+#define SIM_MAX_EVENTS       64
+
+#define SIM_NS_PER_MS        1000000ULL
+#define SIM_NS_PER_S         1000000000ULL
+
+typedef void (*SimEventFn)(void *arg);
+
+/**
+ * @brief Sanal saati sıfırlar, olay kuyruğunu ve çevre birimlerini temizler.
+ */
+void SimHAL_Reset(void);
+
+/**
+ * @brief Şu anki sanal zaman (ns).
+ */
+uint64_t SimHAL_Now_ns(void);
+
+/**
+ * @brief t_ns anında çağrılacak bir olay kaydeder (ISR bağlamını temsil eder).
+ * @return 0: Başarılı, 1: Kuyruk dolu
+ */
+uint8_t SimHAL_Schedule(uint64_t t_ns, SimEventFn fn, void *arg);
+
+/**
+ * @brief Sanal saati t_ns'e kadar ilerletir, aradaki olayları sırayla çalıştırır.
+ */
+void SimHAL_RunUntil(uint64_t t_ns);
+
+/**
+ * @brief __WFI (SimHAL_WFI) uyandırma kancası. WFI sanal saati bir sonraki
+ * SysTick'e (1 ms sınırı) kadar ilerletir; arada çalışan bir olaydan sonra
+ * kanca 1 dönerse hemen uyanır. Olay kuyruğunda kesme olmayan model
+ * adımları da (plant) bulunduğu için her olay uyandırmaz: yalnız kancanın
+ * gördüğü iş (ör. Scheduler_PendingEvents).
+ */
+void SimHAL_SetWakeHook(uint8_t (*hook)(void));
+
+/**
+ * @brief Bir giriş pinini sürer; EXTI açıksa uygun kenarda callback'i çağırır.
+ */
+void SimHAL_GPIO_Drive(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+/**
+ * @brief Sahte MPU6050'nin 128 byte'lık register haritası (plant buraya yazar).
+ */
+uint8_t *SimHAL_MPU6050_Regs(void);
+
+/**
+ * @brief MPU6050 INT pininin bağlı olduğu giriş (NULL: bağlı değil).
+ */
+void SimHAL_MPU6050_SetIntPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/**
+ * @brief Sensörün bir örnek anı: FIFO açıksa register'lardaki örnek FIFO'ya
+ * eklenir (dolduysa en eski byte'lar üzerine yazılır), DATA_RDY açıksa INT
+ * pininde 50 us darbe üretilir. Plant register'ları yazdıktan sonra çağırır.
+ * @return 1: INT darbesi üretildi
+ */
+uint8_t SimHAL_MPU6050_Sample(void);
+
+/**
+ * @brief Sensör kopukluğunu simüle etmek için (0: yok, 1: var).
+ */
+void SimHAL_MPU6050_SetPresent(uint8_t present);
+
+// SimHAL_I2C_SetFaultHook dönüşü
+#define SIM_I2C_FAULT_NONE   0U
+#define SIM_I2C_FAULT_NACK   1U   // Adres NACK: ilk byte sonunda AF hatası
+#define SIM_I2C_FAULT_BERR   2U   // Transferin ortasında BERR (okumada ilk yarı çekilmiş olur)
+#define SIM_I2C_FAULT_STUCK  3U   // Köle SDA'yı tutar: bitiş yok, SCL'de 5 darbe bırakır
+
+/**
+ * @brief Hattaki ikinci sahte cihaz: 8 bit adres, register dizisi (adres
+ * artar, sonda başa döner). Okumalar/yazmalar doğrudan regs'e gider.
+ * Kayıtlı olmayan adreslere yapılan transfer NACK alır.
+ */
+void SimHAL_I2C_AttachDevice(uint16_t addr, uint8_t *regs, uint16_t size);
+
+/**
+ * @brief Her kesmeli/DMA'lı I2C transferi başında çağrılır, SIM_I2C_FAULT_*
+ * döndürür (NULL: hata yok). STUCK'ta SDA (PB7) düşük kalır; çevre birimi
+ * HAL_I2C_DeInit ile kapatılıp PB6 GPIO olarak saatlenene kadar
+ * HAL_I2C_Init HAL_ERROR döner (F1'de takılı BUSY bayrağı).
+ */
+void SimHAL_I2C_SetFaultHook(uint8_t (*hook)(uint16_t addr));
+
+/**
+ * @brief ADC girişleri: her dönüşümde kanal numarasıyla çağrılır, 12-bit
+ * sonucu döndürür (NULL: tüm kanallar 0).
+ */
+void SimHAL_ADC_SetSource(uint16_t (*source)(uint32_t channel));
+
+/**
+ * @brief Sahte flash'ın addr adresindeki içeriği (aralık dışıysa NULL).
+ * Silinmiş byte 0xFF; HAL_FLASH_Program sadece silinmiş yeri yazar.
+ */
+const uint8_t *SimHAL_Flash(uint32_t addr);
+
+/**
+ * @brief UART TX çıktısının yazılacağı dosya (NULL: at).
+ */
+void SimHAL_UART_SetSink(FILE *sink);
+
+#endif
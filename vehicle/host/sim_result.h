@@ -0,0 +1,60 @@
+/*
+ * sim_result.h
+ *
+ * tunnel_sim -R çıktısının biçimi: koşu başına tek satır. tunnel_mc'nin
+ * hafif koşusu (mc_run.c) aynı alanları aynı kontrol bitleriyle üretir;
+ * ikisinin ortak senaryo modeli ve kontrol sınırları da burada.
+ *
+ * Alanlar: seed, seyir hızı, ivme, fren yavaşlaması, fren gecikmesi, son
+ * konum hatası (optik, füzyon), fren noktası hatası (komut anında firmware
+ * konumu - gerçek konum), duruş tahmini hatası (gerçek - tahmin), durma
+ * sınırı payı, kenar hız hatası RMS ve maks (ilk işaret hariç: kestirim
+ * yok), füzyon konum RMS, başarısız kontrollerin bit maskesi (SIM_FAIL_*).
+ */
+
+#ifndef SIM_RESULT_H
+#define SIM_RESULT_H
+
+#define SIM_RESULT_FORMAT  "%u %.3f %.3f %.3f %.4f %.6f %.6f %.6f %.6f %.6f %.6f %.6f %.6f 0x%04X\n"
+
+// --- Senaryo modeli ---
+#define SIM_GATE_WARMUP         3         // -r: ilk işaretler düşürülmez (kapının hız tahmini yok)
+#define SIM_GLINT_MIN           0.8       // -g: parlama, reflektörden bu kadar sonra ...
+#define SIM_GLINT_MAX           2.6       // ... ile bu kadar sonra arasında (m)
+#define SIM_G                   9.80665
+#define SIM_IMU_ACCEL_NOISE     8.0       // LSB (1 sigma), -N ile ölçeklenir
+#define SIM_IMU_GYRO_NOISE      20.0      // LSB (1 sigma), -N ile ölçeklenir
+
+// --- Kontrol sınırları ---
+// Füzyon kabul ölçütleri
+#define SIM_FUSION_POS_RMS_MAX  0.05      // m
+#define SIM_FUSION_3SIGMA_MIN   0.95      // Hatanın 3 sigma içinde kaldığı örnek oranı
+#define SIM_FUSION_BIAS_TOL     0.02      // m/s^2
+// Fren denetçisi: plant denetçinin modelinden iyi değilse duruş sınırı en çok bu kadar geçilebilir
+#define SIM_BRAKE_STOP_TOL      0.05      // m
+
+// Başarısız kontrol bitleri (tunnel_sim'in SONUÇ satırlarıyla aynı sıra)
+#define SIM_FAIL_PROBES         0x0001U
+#define SIM_FAIL_SCHED          0x0002U
+#define SIM_FAIL_ANALOG         0x0004U
+#define SIM_FAIL_NTC            0x0008U
+#define SIM_FAIL_ENCODER        0x0010U
+#define SIM_FAIL_BRAKE          0x0020U
+#define SIM_FAIL_GATE           0x0040U
+#define SIM_FAIL_STRIPS         0x0080U
+#define SIM_FAIL_FUSION         0x0100U
+#define SIM_FAIL_IMU_FIFO       0x0200U
+#define SIM_FAIL_IMU_FIXED      0x0400U
+#define SIM_FAIL_IMU_FILTER     0x0800U
+#define SIM_FAIL_RECORDER       0x1000U
+#define SIM_FAIL_EVLOG          0x2000U
+#define SIM_FAIL_I2C            0x4000U
+#define SIM_FAIL_VELFIT         0x8000U
+#define SIM_FAIL_TOLERANCE      0x10000U
+#define SIM_FAIL_BITS           17U
+
+#define SIM_FAIL_NAMES { "probe", "zamanlayıcı", "analog", "NTC", "enkoder", "fren", \
+                         "kenar kapısı", "şerit", "füzyon", "IMU FIFO", "IMU Q16", "IMU filtre", \
+                         "kayıt", "olay logu", "I2C", "hız uydurma", "tolerans" }
+
+#endif
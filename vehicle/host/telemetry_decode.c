@@ -0,0 +1,88 @@
+/*
+ * telemetry_decode.c
+ *
+ * UART'tan yakalanmış ham akışı (dosya veya stdin) 0x00 ayraçlarından bölüp
+ * telemetri paketlerini CSV'ye çevirir. Metin satırları ve bozuk çerçeveler
+ * sayılır ve atlanır; sıra numarası boşlukları kayıp çerçeve olarak raporlanır.
+ *
+ * Kullanım: telemetry_decode [girdi.bin] > telemetry.csv
+ * Çıkış kodu: 0 en az bir geçerli çerçeve var ve CRC hatası yok, 1 aksi halde
+ */
+
+#include "telemetry.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define DECODE_MAX_FRAME   256U
+
+int main(int argc, char **argv) {
+    FILE *in = stdin;
+    if (argc > 1) {
+        in = fopen(argv[1], "rb");
+        if (!in) {
+            perror(argv[1]);
+            return 2;
+        }
+    }
+
+    uint8_t frame[DECODE_MAX_FRAME];
+    uint16_t len = 0;
+    uint8_t overlong = 0;
+
+    uint32_t ok = 0, bad_crc = 0, bad_version = 0, bad_framing = 0, lost = 0;
+    int32_t last_seq = -1;
+
+    printf("seq,time_ms,position_m,velocity_mps,reflector_count,status,error_flags,"
+           "accel_x_g,accel_y_g,accel_z_g,gyro_x_dps,gyro_y_dps,gyro_z_dps,temp_c\n");
+
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        if (c != 0) {
+            if (len < DECODE_MAX_FRAME) {
+                frame[len++] = (uint8_t)c;
+            } else {
+                overlong = 1;
+            }
+            continue;
+        }
+
+        // Ayraç: biriken çerçeveyi çöz
+        if (len == 0) continue;
+
+        TelemetryPacket_t pkt;
+        uint8_t status = overlong ? TELEMETRY_ERR_FRAMING : Telemetry_Decode(frame, len, &pkt);
+        len = 0;
+        overlong = 0;
+
+        if (status == TELEMETRY_ERR_CRC) {
+            bad_crc++;
+            continue;
+        } else if (status == TELEMETRY_ERR_VERSION) {
+            bad_version++;
+            continue;
+        } else if (status != TELEMETRY_OK) {
+            bad_framing++;   // Genelde aynı hatta karışan metin çıktısı
+            continue;
+        }
+
+        if (last_seq >= 0) {
+            lost += (uint16_t)(pkt.seq - (uint16_t)last_seq - 1U);
+        }
+        last_seq = pkt.seq;
+        ok++;
+
+        printf("%u,%u,%.3f,%.3f,%u,%u,%u,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f\n",
+               pkt.seq, pkt.time_ms, pkt.position_mm / 1000.0, pkt.velocity_mm_s / 1000.0,
+               pkt.reflector_count, pkt.system_status, pkt.error_flags,
+               pkt.accel_mg[0] / 1000.0, pkt.accel_mg[1] / 1000.0, pkt.accel_mg[2] / 1000.0,
+               pkt.gyro_cdps[0] / 100.0, pkt.gyro_cdps[1] / 100.0, pkt.gyro_cdps[2] / 100.0,
+               pkt.temp_cc / 100.0);
+    }
+
+    if (in != stdin) fclose(in);
+
+    fprintf(stderr, "Geçerli: %u | CRC hatası: %u | sürüm uyuşmazlığı: %u | çerçeve dışı: %u | kayıp: %u\n",
+            ok, bad_crc, bad_version, bad_framing, lost);
+    return (ok > 0 && bad_crc == 0) ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+/*
+ * tunnel_map_test.c
+ *
+ * Tünel haritasının (tunnel_map.c) parametre bloğu yolu: mühürlü kopya
+ * kabul edilmeli, bozuk kopya CRC hatasıyla reddedilip varsayılana
+ * dönülmeli (işaret sayısı değişmemeli).
+ *
+ * Kullanım: tunnel_map_test
+ * Çıkış kodu: 0 geçti, 1 başarısız
+ */
+
+#include "tunnel_map.h"
+
+#include <stdio.h>
+
+int main(void) {
+    TunnelParams_t block = *TunnelMap_Default();
+    TunnelMap_Seal(&block);
+    uint8_t sealed_status = TunnelMap_Init(&block);
+    uint16_t count = TunnelMap_Count();
+
+    block.zones[0].count++;
+    uint8_t corrupt_status = TunnelMap_Init(&block);
+
+    uint8_t ok = sealed_status == TUNNEL_MAP_OK && corrupt_status == TUNNEL_MAP_ERR_CRC &&
+                 TunnelMap_Count() == count;
+    printf("Tünel haritası: %u işaret | mühürlü blok: %s | bozuk blok: %s%s\n", (unsigned)count,
+           sealed_status == TUNNEL_MAP_OK ? "kabul" : "RED",
+           corrupt_status == TUNNEL_MAP_ERR_CRC ? "reddedildi" : "KABUL", ok ? "" : "  <-- HATALI");
+    return ok ? 0 : 1;
+}
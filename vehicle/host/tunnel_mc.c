@@ -0,0 +1,300 @@
+/*
+ * tunnel_mc.c
+ *
+ * Monte Carlo koşucusu: navigasyon ve fren kodunu binlerce rastgele
+ * senaryoyla paralel koşturur ve konum, fren noktası ve hız hatalarının
+ * dağılımını raporlar. Debounce, kapı ve fren parametreleri tek bir
+ * senaryoya göre değil bu dağılımlara göre ayarlanır.
+ *
+ * Koşular hafif koşudur (mc_run.c): çevre birimi modelleri, zamanlayıcı,
+ * telemetri ve modül self-test'leri yok, kapsül analitik. Firmware
+ * FW_STATE_PER_THREAD ile derlenir (fw_state.h): modül durumu iş parçacığı
+ * başına, her iş parçacığı koşuları sıradan çeker ve McRun_Run her koşuda
+ * modülleri Init/Reset ile yeniden kurar. -V ile ilk koşular ayrıca her
+ * biri yeni (durumu ilk değerinde) bir iş parçacığında tekrarlanır ve
+ * sonuçlar karşılaştırılır: Init'in kurmadığı bir durum varsa ayrışır.
+ *
+ * Koşu i'nin parametreleri yalnız (seed, i)'den üretilir: sonuçlar paralellik
+ * derecesinden bağımsızdır. Aynı parametrelerle tunnel_sim (-o ile yazılan
+ * CSV satırındaki değerler) tam modelle koşar; gürültü örnekleri farklı
+ * olduğundan iki program dağılım olarak karşılaştırılır, satır satır değil.
+ *
+ * Kullanım: tunnel_mc [-n koşu] [-j iş parçacığı] [-s seed] [-o csv] [-F] [-V koşu]
+ * Çıkış kodu: 0 her koşu tamamlandı, 1 -F ile kontrolü geçemeyen koşu
+ *             ya da -V ile yeni iş parçacığında farklı sonuç veren koşu var
+ */
+
+#include "mc_run.h"
+#include "sim_result.h"
+
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MC_MAX_JOBS         256U
+
+// --- Senaryo aralıkları (düzgün dağılım) ---
+#define MC_SPEED_MIN        3.0       // m/s
+#define MC_SPEED_MAX        12.0
+#define MC_ACCEL_MIN        1.0       // m/s^2
+#define MC_ACCEL_MAX        4.0
+#define MC_DECEL_MIN        3.6       // m/s^2, nominal 4 civarı
+#define MC_DECEL_MAX        4.8
+#define MC_LATENCY_MIN      0.02      // s
+#define MC_LATENCY_MAX      0.08
+#define MC_STRIP_MISS_MAX   0.10
+#define MC_REFL_MISS_MAX    0.08
+#define MC_GLINT_MAX        0.10
+#define MC_JITTER_MAX_US    20.0      // Kenar titreşimi (1 sigma)
+#define MC_NOISE_MIN        0.5       // IMU gürültü ölçeği
+#define MC_NOISE_MAX        2.0
+#define MC_BIAS_MAX         0.15      // |ivmeölçer sapması|, m/s^2
+
+typedef struct {
+    const McScenario_t *scenarios;
+    McResult_t *results;
+    uint32_t runs;
+    uint32_t next;             // Sıradaki koşu (iş parçacıkları arasında atomik)
+} McQueue_t;
+
+// splitmix64: koşu numarasından bağımsız akış
+static uint64_t Mc_Mix(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static double Mc_Uniform(uint64_t *state, double lo, double hi) {
+    return lo + (hi - lo) * (double)(Mc_Mix(state) >> 11) / 9007199254740992.0;
+}
+
+static void Mc_Scenario(unsigned base_seed, uint32_t run, McScenario_t *s) {
+    uint64_t st = ((uint64_t)base_seed << 32) ^ run;
+    s->seed = (unsigned)(Mc_Mix(&st) & 0x7FFFFFFFU);
+    s->speed = Mc_Uniform(&st, MC_SPEED_MIN, MC_SPEED_MAX);
+    s->accel = Mc_Uniform(&st, MC_ACCEL_MIN, MC_ACCEL_MAX);
+    s->decel = Mc_Uniform(&st, MC_DECEL_MIN, MC_DECEL_MAX);
+    s->latency = Mc_Uniform(&st, MC_LATENCY_MIN, MC_LATENCY_MAX);
+    s->strip_miss = Mc_Uniform(&st, 0.0, MC_STRIP_MISS_MAX);
+    s->refl_miss = Mc_Uniform(&st, 0.0, MC_REFL_MISS_MAX);
+    s->glint = Mc_Uniform(&st, 0.0, MC_GLINT_MAX);
+    s->jitter_us = Mc_Uniform(&st, 0.0, MC_JITTER_MAX_US);
+    s->noise = Mc_Uniform(&st, MC_NOISE_MIN, MC_NOISE_MAX);
+    s->bias = Mc_Uniform(&st, -MC_BIAS_MAX, MC_BIAS_MAX);
+}
+
+// İş parçacığı: koşuları sıradan çeker, sonucu koşu indeksine yazar
+static void *Mc_Worker(void *arg) {
+    McQueue_t *q = arg;
+    uint32_t run;
+    while ((run = __atomic_fetch_add(&q->next, 1U, __ATOMIC_RELAXED)) < q->runs) {
+        McRun_Run(&q->scenarios[run], &q->results[run]);
+    }
+    return NULL;
+}
+
+// Tek koşu yeni iş parçacığında (-V): modül durumu ilk değerinden başlar
+static void *Mc_Fresh(void *arg) {
+    McQueue_t *q = arg;
+    McRun_Run(&q->scenarios[0], &q->results[0]);
+    return NULL;
+}
+
+// Dolgu baytları karşılaştırılmaz; NaN alanlar bit bit aynı olmalı
+static int Mc_Same(const McResult_t *a, const McResult_t *b) {
+    return a->seed == b->seed && a->fail == b->fail &&
+           memcmp(&a->speed, &b->speed, offsetof(McResult_t, fail) - offsetof(McResult_t, speed)) == 0;
+}
+
+static int Mc_CompareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Bir metriğin dağılımı: ortalama, sapma, yüzdelikler, en büyük mutlak değer
+static void Mc_PrintDistribution(const char *name, const char *unit, const McResult_t *res, uint32_t n,
+                                 size_t offset, double *scratch) {
+    uint32_t m = 0;
+    double sum = 0.0, sum_sq = 0.0, abs_max = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        double v = *(const double *)((const char *)&res[i] + offset);
+        if (isnan(v)) continue;
+        scratch[m++] = v;
+        sum += v;
+        sum_sq += v * v;
+        if (fabs(v) > abs_max) abs_max = fabs(v);
+    }
+    if (m == 0) {
+        printf("  %s: sonuç yok\n", name);
+        return;
+    }
+    // %-*s bayt sayar: UTF-8 devam baytları kadar genişlet, sütunlar hizalı kalsın
+    int width = 22;
+    for (const char *c = name; *c; c++) {
+        if (((unsigned char)*c & 0xC0U) == 0x80U) width++;
+    }
+
+    qsort(scratch, m, sizeof(double), Mc_CompareDouble);
+    double mean = sum / m;
+    double var = sum_sq / m - mean * mean;
+    printf("  %-*s %-5s n=%-6u ort %+9.4f  σ %8.4f | p1 %+9.4f  p50 %+9.4f  p95 %+9.4f  p99 %+9.4f | maks|.| %8.4f\n",
+           width, name, unit, m, mean, var > 0.0 ? sqrt(var) : 0.0, scratch[(uint32_t)(0.01 * (m - 1))],
+           scratch[(m - 1) / 2], scratch[(uint32_t)(0.95 * (m - 1))], scratch[(uint32_t)(0.99 * (m - 1))], abs_max);
+}
+
+static uint64_t Mc_Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void Usage(const char *prog) {
+    fprintf(stderr, "Kullanım: %s [-n koşu] [-j iş parçacığı] [-s seed] [-o csv] [-F] [-V koşu]\n"
+                    "  -j  iş parçacığı (varsayılan: çekirdek sayısı)\n"
+                    "  -F  kontrolü geçemeyen koşu varsa çıkış kodu 1\n"
+                    "  -V  ilk bu kadar koşuyu yeni iş parçacıklarında tekrarla, sonuçlar aynı olmalı\n", prog);
+}
+
+int main(int argc, char **argv) {
+    uint32_t runs = 1000;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned base_seed = 1;
+    const char *csv_path = NULL;
+    uint8_t strict = 0;
+    uint32_t verify = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:j:s:o:FV:h")) != -1) {
+        switch (opt) {
+            case 'n': runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'j': jobs = strtol(optarg, NULL, 0); break;
+            case 's': base_seed = (unsigned)strtoul(optarg, NULL, 0); break;
+            case 'o': csv_path = optarg; break;
+            case 'F': strict = 1; break;
+            case 'V': verify = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default: Usage(argv[0]); return 2;
+        }
+    }
+    if (jobs < 1) jobs = 1;
+    if (jobs > (long)MC_MAX_JOBS) jobs = MC_MAX_JOBS;
+    if (runs == 0) return 2;
+    if (jobs > (long)runs) jobs = (long)runs;
+    if (verify > runs) verify = runs;
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            perror(csv_path);
+            return 2;
+        }
+        fprintf(csv, "run,seed,speed_mps,accel_mps2,decel_mps2,latency_s,strip_miss,reflector_miss,glint,"
+                     "jitter_us,imu_noise,imu_bias_mps2,pos_err_m,fused_err_m,brake_point_err_m,"
+                     "stop_pred_err_m,stop_margin_m,vel_rms_mps,vel_max_mps,fusion_rms_m,fail\n");
+    }
+
+    McScenario_t *scenarios = calloc(runs, sizeof(McScenario_t));
+    McResult_t *results = calloc(runs, sizeof(McResult_t));
+    double *scratch = calloc(runs, sizeof(double));
+    if (!scenarios || !results || !scratch) return 2;
+    for (uint32_t i = 0; i < runs; i++) {
+        Mc_Scenario(base_seed, i, &scenarios[i]);
+    }
+
+    McQueue_t queue = { .scenarios = scenarios, .results = results, .runs = runs };
+    pthread_t threads[MC_MAX_JOBS];
+    uint64_t wall_start = Mc_Now_ns();
+    for (long k = 0; k < jobs; k++) {
+        if (pthread_create(&threads[k], NULL, Mc_Worker, &queue) != 0) {
+            fprintf(stderr, "pthread_create başarısız\n");
+            return 2;
+        }
+    }
+    for (long k = 0; k < jobs; k++) {
+        pthread_join(threads[k], NULL);
+    }
+    double wall_s = (double)(Mc_Now_ns() - wall_start) / 1e9;
+
+    uint32_t fail_runs = 0, fail_count[SIM_FAIL_BITS] = {0};
+    for (uint32_t run = 0; run < runs; run++) {
+        const McScenario_t *s = &scenarios[run];
+        const McResult_t *r = &results[run];
+        if (r->fail) {
+            fail_runs++;
+            for (uint32_t b = 0; b < SIM_FAIL_BITS; b++) {
+                if (r->fail & (1U << b)) fail_count[b]++;
+            }
+        }
+        if (csv) {
+            fprintf(csv, "%u,%u,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.3f,%.4f,%.4f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,0x%04X\n",
+                    (unsigned)run, s->seed, s->speed, s->accel, s->decel, s->latency, s->strip_miss, s->refl_miss,
+                    s->glint, s->jitter_us, s->noise, s->bias, r->pos_err, r->fused_err, r->brake_point_err,
+                    r->stop_pred_err, r->stop_margin, r->vel_rms, r->vel_max, r->fusion_rms, r->fail);
+        }
+    }
+    if (csv) fclose(csv);
+
+    printf("\n=== MONTE CARLO: %u koşu, %ld iş parçacığı, seed %u ===\n", (unsigned)runs, jobs, base_seed);
+    printf("Süre: %.2f s | %.1f koşu/s (iş parçacığı başına %.1f) | kontrolü geçemeyen %u\n",
+           wall_s, runs / wall_s, runs / wall_s / jobs, (unsigned)fail_runs);
+    printf("Senaryo: hız %.0f..%.0f m/s, ivme %.0f..%.0f m/s2, fren %.1f..%.1f m/s2, gecikme %.0f..%.0f ms, "
+           "şerit kaybı <%.0f%%, reflektör kaybı <%.0f%%, parlama <%.0f%%, titreşim <%.0f us, "
+           "IMU gürültüsü x%.1f..%.1f, sapma ±%.2f m/s2\n",
+           MC_SPEED_MIN, MC_SPEED_MAX, MC_ACCEL_MIN, MC_ACCEL_MAX, MC_DECEL_MIN, MC_DECEL_MAX,
+           MC_LATENCY_MIN * 1e3, MC_LATENCY_MAX * 1e3, MC_STRIP_MISS_MAX * 100, MC_REFL_MISS_MAX * 100,
+           MC_GLINT_MAX * 100, MC_JITTER_MAX_US, MC_NOISE_MIN, MC_NOISE_MAX, MC_BIAS_MAX);
+
+    printf("\nDağılımlar:\n");
+    Mc_PrintDistribution("Son konum (optik)", "m", results, runs, offsetof(McResult_t, pos_err), scratch);
+    Mc_PrintDistribution("Son konum (füzyon)", "m", results, runs, offsetof(McResult_t, fused_err), scratch);
+    Mc_PrintDistribution("Fren noktası", "m", results, runs, offsetof(McResult_t, brake_point_err), scratch);
+    Mc_PrintDistribution("Duruş tahmini", "m", results, runs, offsetof(McResult_t, stop_pred_err), scratch);
+    Mc_PrintDistribution("Durma sınırı payı", "m", results, runs, offsetof(McResult_t, stop_margin), scratch);
+    Mc_PrintDistribution("Hız hatası RMS", "m/s", results, runs, offsetof(McResult_t, vel_rms), scratch);
+    Mc_PrintDistribution("Hız hatası maks", "m/s", results, runs, offsetof(McResult_t, vel_max), scratch);
+    Mc_PrintDistribution("Füzyon konum RMS", "m", results, runs, offsetof(McResult_t, fusion_rms), scratch);
+
+    if (fail_runs > 0) {
+        static const char *const names[SIM_FAIL_BITS] = SIM_FAIL_NAMES;
+        printf("\nBaşarısız kontroller:");
+        for (uint32_t b = 0; b < SIM_FAIL_BITS; b++) {
+            if (fail_count[b]) printf(" %s %u", names[b], (unsigned)fail_count[b]);
+        }
+        printf("\n");
+    }
+
+    // Aynı senaryo yeni iş parçacığında: önceki koşulardan kalan durum
+    // (Init'in kurmadığı bir değişken) sonucu değiştirir
+    uint32_t mismatched = 0;
+    for (uint32_t i = 0; i < verify; i++) {
+        McResult_t ref;
+        McQueue_t one = { .scenarios = &scenarios[i], .results = &ref, .runs = 1 };
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, Mc_Fresh, &one) != 0) {
+            fprintf(stderr, "pthread_create başarısız\n");
+            return 2;
+        }
+        pthread_join(thread, NULL);
+        if (!Mc_Same(&ref, &results[i])) {
+            fprintf(stderr, "koşu %u (seed %u): yeni iş parçacığında farklı sonuç\n", (unsigned)i, scenarios[i].seed);
+            mismatched++;
+        }
+    }
+    if (verify > 0) {
+        printf("\nDoğrulama: ilk %u koşu yeni iş parçacıklarında, farklı sonuç %u\n", (unsigned)verify,
+               (unsigned)mismatched);
+    }
+
+    free(scenarios);
+    free(results);
+    free(scratch);
+    return (mismatched > 0 || (strict && fail_runs > 0)) ? 1 : 0;
+}
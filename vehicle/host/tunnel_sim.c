@@ -0,0 +1,1886 @@
+/*
+ * tunnel_sim.c
+ *
+ * Deterministik tünel simülatörü. Gerçek optical_sensor.c / imu.c kodunu
+ * sim_hal üzerinde çalıştırır: kapsülün hareketi (plant) sanal saatte
+ * entegre edilir, reflektör ve bilgi şeridi geçişleri PA0 (TIM2_CH1) üzerinde
+ * kenar olarak üretilir, MPU6050 register haritası gerçek ivmeyle doldurulur,
+ * tekerlek enkoderinin sayım ve kenar yakalamaları konumdan hesaplanır,
+ * NTC kanallarının ve akü geriliminin ADC girişleri profillerden üretilir.
+ * Koşu boyunca uçuş kaydedici çalışır; -D ile kayıt menü 7/8'deki gibi
+ * UART'tan dökülür ve sahte flash'a yazılır (flight_replay ile oynatılır).
+ * IMU filtre zincirinin çıkışı double hassasiyetli bir referans zincirle
+ * karşılaştırılır (-W ile kapsül titreşimi eklenir).
+ * Sıkıştırılmış olay logu koşu sonunda çözülüp füzyona verilen son
+ * örneklerle bit bit karşılaştırılır; -E ile görüntüsü dosyaya yazılır ve
+ * menü 9'daki gibi UART'tan dökülür (evlog_decode ile çözülür).
+ * IMU okumaları paylaşılan I2C hattı yöneticisinden (i2c_bus.c) geçer; -I ile
+ * transferlere hata (NACK, hat hatası, SDA'yı tutan köle) enjekte edilir, -L
+ * ile hatta düşük öncelikli ikinci bir cihaz (barometre) eklenir.
+ * Optik hız kestiriminde (velocity_fit.c) uydurmanın ve iki noktalı
+ * dist/dt'nin kenar hız hataları yan yana raporlanır.
+ * Modüllerin sentetik girdili testleri (enkoder, hız uydurma, füzyon
+ * kapısı, harita bloğu) ayrı *_test programlarındadır; burada yalnız koşu
+ * simüle edilir.
+ * 186 m'lik bir koşu gerçek zamandan çok daha hızlı tekrar oynatılır;
+ * callback'lerin host üzerindeki süreleri profil olarak raporlanır.
+ *
+ * Kullanım: tunnel_sim [-v hız] [-a ivme] [-b fren] [-s seed] [-t tolerans] [-c csv] [-u uart] [-T Hz]
+ *                   [-m şerit kaybı] [-r reflektör kaybı] [-K kayıp konumu] [-g parlama] [-J titreşim] [-N gürültü]
+ *                   [-B sapma] [-W titreşim] [-I I2C hata oranı] [-L barometre Hz] [-R sonuç]
+ *                   [-D kayıt] [-E olay logu] [-q]
+ *
+ * -R ile koşunun özeti tek satır olarak dosyaya yazılır (sim_result.h).
+ * tunnel_mc aynı alanları ve kontrolleri binlerce rastgele senaryoda kendi
+ * hafif koşusuyla (mc_run.c) üretir; bir senaryonun ayrıntısı parametreleri
+ * bu programa verilerek incelenir.
+ */
+
+#include "sim_hal.h"
+#include "sim_result.h"
+#include "optical_sensor.h"
+#include "sensors/imu.h"
+#include "sensors/imu_filter.h"
+#include "shared_data.h"
+#include "uart_log.h"
+#include "telemetry.h"
+#include "fusion.h"
+#include "tunnel_map.h"
+#include "strip_decoder.h"
+#include "velocity_fit.h"
+#include "brake_supervisor.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "encoder.h"
+#include "sim_encoder.h"
+#include "analog.h"
+#include "ntc.h"
+#include "flight_recorder.h"
+#include "event_log.h"
+#include "i2c_bus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+// --- Tünel yerleşimi ---
+#define SIM_MARKER_WIDTH        0.02      // Reflektör/şerit bant genişliği (m)
+#define SIM_MAX_EDGES           256
+
+// --- Simülasyon adımları ---
+#define SIM_PLANT_STEP_NS       100000ULL // Kapsül dinamiği 10 kHz
+#define SIM_LAUNCH_HOLD_NS      SIM_NS_PER_S // Kalkıştan önce kapsül alanında bekleme
+#define SIM_EVENT_EDGE          1U        // Zamanlayıcı olayı: yakalama kesmesi (main.c APP_EVENT_EDGE)
+#define SIM_STATUS_PERIOD_NS    (200ULL * SIM_NS_PER_MS) // UART durum satırı 5 Hz
+#define SIM_TIME_LIMIT_NS       (120ULL * SIM_NS_PER_S)
+#define SIM_IMU_PERIOD_NS       1000000ULL// MPU6050 örnekleme (SMPLRT_DIV=7 -> 1 kHz)
+#define SIM_IMU_CLOCK_PPM       300       // Sensör osilatör hatası (MCU saatine göre)
+#define SIM_IMU_TRUTH           256       // Gerçek örnek geçmişi (FIFO modunda karşılaştırma)
+#define SIM_IMU_ACCEL_BIAS      0.05      // İvmeölçer X sapması (m/s^2), füzyon tahmin etmeli (-B)
+#define SIM_FIX_STD             0.002     // -P: kusursuz konum düzeltmelerinin belirsizliği (m)
+#define SIM_IMU_VIB_HZ          180.0     // -W: kapsül titreşimi (üç ivme ekseninde)
+#define SIM_IMU_FILTER_TOL      (8.0 / 65536.0)  // Filtre çıkışı, double referansa göre (g / dps)
+
+// Sabit nokta IMU çevriminin float referansa göre izin verilen hatası (Q16 LSB'si ~1.5e-5)
+#define SIM_Q16_TOL             (4.0 / 65536.0)
+// Enkoder: M/T penceresi (~10 ms) ivmelenirken hızı geriden izler
+#define SIM_ENCODER_VEL_RMS_MAX 0.05      // m/s
+#define SIM_ENCODER_DIST_TOL    0.001     // m, koşu sonunda
+// Hız uydurma: titreşimli kenarlarda iki noktalı hızla karşılaştırılır (velocity_fit_test ile aynı oran)
+#define SIM_VELFIT_NOISE_RATIO  0.6       // Uydurma RMS'i iki noktanınkinin en çok bu katı
+#define SIM_VELFIT_RUN_JITTER   100e-6    // s, koşuda bu titreşimden sonra uydurma iki noktayı yenmeli
+#define SIM_VELFIT_RUN_MIN      20U       // ... en az bu kadar uydurmalı kenarla
+// NTC: ADC gürültüsü ve tablo + ortalama sonrası izin verilen hata
+#define SIM_NTC_NOISE_LSB       1.5
+#define SIM_NTC_TOL             0.2       // °C
+#define SIM_NTC_OPEN_CHANNEL    3U        // Bu kanalda termistör takılı değil
+#define SIM_NTC_HOT_CHANNEL     2U        // Bu kanal aşırı sıcaklık sınırını geçip geri iner
+
+// Analog motoruna NTC'den sonra eklenen ikinci tüketici: akü gerilimi (IIR)
+#define SIM_BATTERY_CHANNEL     ADC_CHANNEL_8
+#define SIM_BATTERY_CODE        2730.0    // 12 bit, sabit gerilim
+#define SIM_BATTERY_IIR_SHIFT   3U
+#define SIM_BATTERY_TOL         1.0       // 12 bit LSB
+
+// Olay logu: füzyona verilen son örnekler tutulur, çözülen log bunların sonu olmalı
+#define SIM_EVLOG_SHADOW        8192U     // Logda kalabilecek en çok IMU örneğinden büyük
+#define SIM_EVLOG_MAX_RECORDS   4096U     // Kayıt en az 9 bit: 4096 byte'ta < 3641
+#define SIM_EVLOG_MIN_RATIO     5.0       // Ham saklamaya (32 byte/örnek) göre geçmiş
+
+// I2C hattı: -L barometresi (BMP280 benzeri, kalibrasyon + ölçüm bloğu okunur)
+#define SIM_AUX_ADDR            0xEC
+#define SIM_AUX_REG             0x88
+#define SIM_AUX_LEN             24U
+#define SIM_I2C_WAIT_MARGIN_US  300.0     // IMU bekleme sınırı: bir LOW okuması + bu pay
+
+typedef struct {
+    double cruise_speed;     // m/s
+    double accel;            // m/s^2
+    double brake_decel;      // m/s^2
+    double brake_latency;    // s (fren komutu -> fiziksel frenleme)
+    unsigned seed;
+    double tolerance;        // m, <0: kontrol yok
+    const char *csv_path;
+    const char *uart_path;   // NULL: stdout (-q ile atılır)
+    uint32_t telemetry_hz;   // >0: durum satırı yerine ikili telemetri
+    uint8_t imu_fifo;        // 1: MPU6050 FIFO + INT burst modu
+    uint8_t perfect_fixes;   // 1: füzyon optik yerine gerçek işaret konumlarıyla düzeltilir
+    double strip_miss;       // Bilgi şeridinin sensörce görülmeme olasılığı
+    double reflector_miss;   // Reflektörün görülmeme olasılığı
+    double glint;            // İki reflektör arasında parazit kenar olasılığı
+    double miss_after;       // m, >0: bu konumdan sonraki ilk reflektör görülmez
+    uint32_t imu_stall_ms;   // FIFO modunda kalkıştan 1 s sonra işleme durdurulur (taşma testi)
+    double edge_jitter;      // s, sensör kenar gecikmesinin titreşimi (1 sigma)
+    double imu_noise;        // IMU gürültüsü ölçeği (1: varsayılan)
+    double imu_bias;         // İvmeölçer X sapması (m/s^2)
+    double imu_vibration;    // g, SIM_IMU_VIB_HZ'de titreşim genliği
+    double i2c_fault;        // I2C transferi başına hata olasılığı
+    uint32_t aux_hz;         // >0: hatta barometre, bu hızda okunur
+    const char *result_path; // -R: tek satırlık koşu özeti
+    const char *record_path; // -D: uçuş kaydının flash görüntüsü (UART dökümü -u'ya)
+    const char *evlog_path;  // -E: olay logu görüntüsü (UART dökümü -u'ya)
+    uint8_t quiet;
+} SimConfig_t;
+
+typedef struct {
+    double pos;
+    uint8_t level;           // 1: yükselen (bant başı), 0: düşen
+    uint8_t spurious;        // 1: haritada olmayan parlama
+    uint16_t marker;         // Harita indeksi (parlama değilse)
+} SimEdge_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t total_ns;
+} SimProfile_t;
+
+// --- Plant durumu ---
+static SimConfig_t cfg;
+static SimEdge_t edges[SIM_MAX_EDGES];
+static uint32_t edge_total = 0;
+static uint32_t edge_next = 0;
+static uint32_t markers_passed = 0;
+static int32_t last_marker_seen = -1;    // Sensörün gördüğü son gerçek işaretin harita indeksi
+
+static double plant_x = 0.0;
+static double plant_v = 0.0;
+static double plant_a = 0.0;
+static uint64_t brake_cmd_ns = 0;        // 0: henüz fren komutu yok
+static double brake_cmd_x = 0.0;
+static uint8_t plant_stopped = 0;
+
+static I2C_HandleTypeDef hi2c1;
+static ADC_HandleTypeDef hadc1;
+static TIM_HandleTypeDef htim2;
+static UART_HandleTypeDef huart2;
+static DMA_HandleTypeDef hdma_usart2_tx;
+static FILE *csv = NULL;
+
+static SimProfile_t prof_exti;
+static SimProfile_t prof_i2c;
+static SimProfile_t prof_process;
+static uint64_t edge_post_ns = 0;         // Kenar olayının gönderildiği sanal an
+static uint64_t edge_wake_max_ns = 0;     // Gönderimden olay görevine en uzun sanal süre
+static SimProfile_t prof_log;
+static SimProfile_t prof_telemetry;
+static double vel_err_sq = 0.0;
+static double vel_err_max = 0.0;
+static uint32_t vel_err_n = 0;
+static double vel2_err_sq = 0.0;        // Aynı kenarlarda iki noktalı dist/dt
+static double vel2_err_max = 0.0;
+static double velfit_err_sq = 0.0;      // Uydurmanın kullanıldığı kenarlar: uydurma
+static double velfit_two_sq = 0.0;      // ... ve aynı kenarlarda iki nokta
+static uint32_t velfit_n = 0;
+static double imu_err_accel = 0.0;      // g
+static double imu_err_gyro = 0.0;       // dps
+static double imu_err_temp = 0.0;       // °C
+
+// FIFO modu: INT üretilen her örneğin ham byte'ları ve ISR'nin gördüğü zaman
+typedef struct {
+    uint8_t raw[MPU6050_SAMPLE_SIZE];
+    uint32_t timestamp;
+} SimImuTruth_t;
+
+static SimImuTruth_t imu_truth[SIM_IMU_TRUTH];
+static uint32_t imu_dr_index = 0;       // Üretilen INT sayısı (firmware seq ile aynı sayılır)
+static uint32_t imu_rx_samples = 0;
+static uint32_t imu_seq_gaps = 0;       // Kayıp örnek (seq atlaması)
+static uint32_t imu_ts_errors = 0;      // Zaman damgası / seq eşleşmeyen örnek
+static int64_t imu_last_seq = -1;
+static SimProfile_t prof_imu_int;
+static SimProfile_t prof_imu_batch;
+
+// Füzyon: -P için bekleyen gerçek konum düzeltmeleri ve 1 kHz hata istatistikleri
+typedef struct {
+    double pos;
+    uint32_t timestamp;
+} SimFix_t;
+
+static SimFix_t sim_fixes[16];
+static uint32_t sim_fix_count = 0;
+static SimProfile_t prof_fusion;
+static SimProfile_t prof_snapshot;
+static SimProfile_t prof_brake;
+static SimProfile_t prof_analog;
+static double fus_pos_err_sq = 0.0;
+static double fus_pos_err_max = 0.0;
+static double fus_vel_err_sq = 0.0;
+static double opt_pos_err_sq = 0.0;
+static uint32_t fus_in_3sigma = 0;
+static uint32_t fus_n = 0;
+
+// Tekerlek enkoderi: plant hareketinden sentetik sayım
+static SimEncoder_t sim_enc;
+static double enc_origin = 0.0;          // Sayım 0'ın konumu (m)
+static double enc_vel_err_sq = 0.0;
+static double enc_vel_err_max = 0.0;
+static uint32_t enc_n = 0;
+
+// NTC
+static uint32_t ntc_rng = 1;
+static uint32_t analog_callbacks = 0;     // ADC DMA kesmesi (yarım + tam)
+static int8_t battery_slot = -1;
+static double battery_err_max = 0.0;
+static double ntc_err_max = 0.0;
+static double ntc_err_sq = 0.0;
+static uint32_t ntc_n = 0;
+static uint8_t ntc_prev_overtemp = 0;
+static uint8_t ntc_overtemp_seen = 0;    // Herhangi bir anda kalkan bayraklar
+static uint8_t ntc_fault_seen = 0;
+static uint32_t ntc_sets = 0;
+static uint32_t ntc_clears = 0;
+static double ntc_set_truth = NAN;
+static double ntc_clear_truth = NAN;
+
+// ============= PROFİL =============
+static uint64_t Host_Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * SIM_NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+static void Profile_Add(SimProfile_t *p, uint64_t ns) {
+    if (p->count == 0 || ns < p->min_ns) p->min_ns = ns;
+    if (ns > p->max_ns) p->max_ns = ns;
+    p->total_ns += ns;
+    p->count++;
+}
+
+static void Profile_Print(const char *name, const SimProfile_t *p) {
+    if (p->count == 0) {
+        printf("  %-28s çağrı yok\n", name);
+        return;
+    }
+    printf("  %-28s n=%-7llu min=%5llu ns  ort=%7.1f ns  max=%6llu ns\n", name,
+           (unsigned long long)p->count, (unsigned long long)p->min_ns,
+           (double)p->total_ns / (double)p->count, (unsigned long long)p->max_ns);
+}
+
+// Kuyruk işlendikten hemen sonra firmware çıktısını gerçek değerle karşılaştır
+static double Fusion_PositionNow(const NavEstimate_t *nav) {
+    // Tahmin son IMU örneğinin anına ait; şimdiye hızla taşı
+    int32_t age = (int32_t)(OpticalSensor_GetTimestamp() - nav->timestamp);
+    return Q16_TO_FLOAT(nav->position) + Q16_TO_FLOAT(nav->velocity) * (double)age / FUSION_TICK_HZ;
+}
+
+static void Edge_Record(void) {
+    // İlk işarette hız kestirimi yok (iki nokta da 0): kestirim hatası sayılmaz
+    OpticalVelocity_t vel;
+    OpticalSensor_GetVelocity(&vel);
+    if (vel.two_point != 0) {
+        double err = Q16_TO_FLOAT(VehicleState.current_velocity) - plant_v;
+        vel_err_sq += err * err;
+        if (fabs(err) > vel_err_max) vel_err_max = fabs(err);
+        vel_err_n++;
+
+        double err2 = Q16_TO_FLOAT(vel.two_point) - plant_v;
+        vel2_err_sq += err2 * err2;
+        if (fabs(err2) > vel2_err_max) vel2_err_max = fabs(err2);
+        if (vel.fitted) {
+            velfit_err_sq += err * err;
+            velfit_two_sq += err2 * err2;
+            velfit_n++;
+        }
+    }
+
+    if (csv) {
+        fprintf(csv, "%.6f,%.4f,%.4f,%.4f,%.4f,%u,%u,%u,%.4f,%.4f,%.4f\n",
+                (double)SimHAL_Now_ns() / SIM_NS_PER_S, plant_x, (double)Q16_TO_FLOAT(VehicleState.current_position),
+                plant_v, (double)Q16_TO_FLOAT(VehicleState.current_velocity), markers_passed,
+                (unsigned)VehicleState.reflector_count, (unsigned)VehicleState.system_status,
+                Fusion_PositionNow(&VehicleState.nav), (double)Q16_TO_FLOAT(VehicleState.nav.velocity),
+                (double)Q16_TO_FLOAT(vel.two_point));
+    }
+}
+
+// Her ana döngü turunda füzyon ve yalnız-optik konumunu gerçek değerle karşılaştır
+static void Fusion_Record(void) {
+    // Kontrol döngüsü gibi tutarlı kopya üzerinden oku
+    SharedData_t state;
+    uint64_t t0 = Host_Now_ns();
+    SharedData_Snapshot(&state);
+    Profile_Add(&prof_snapshot, Host_Now_ns() - t0);
+
+    double err = Fusion_PositionNow(&state.nav) - plant_x;
+    double sigma = sqrt(state.nav.cov[0]);
+    fus_pos_err_sq += err * err;
+    if (fabs(err) > fus_pos_err_max) fus_pos_err_max = fabs(err);
+    if (fabs(err) <= 3.0 * sigma) fus_in_3sigma++;
+
+    double verr = Q16_TO_FLOAT(state.nav.velocity) - plant_v;
+    fus_vel_err_sq += verr * verr;
+
+    double oerr = Q16_TO_FLOAT(state.current_position) - plant_x;
+    opt_pos_err_sq += oerr * oerr;
+    fus_n++;
+}
+
+typedef struct {
+    uint32_t timestamp;
+    int16_t counts[MPU6050_RAW_AXES];
+} SimImuFed_t;
+
+static SimImuFed_t evlog_shadow[SIM_EVLOG_SHADOW];
+static uint32_t evlog_fed = 0;
+static EventLogRecord_t evlog_dec[SIM_EVLOG_MAX_RECORDS];
+static uint32_t evlog_dec_n = 0;
+
+// Füzyon ve uçuş kaydı imu'yu (tek örnek modunda filtreli yayın), olay logu
+// ham örneğin sayımlarını alır (main.c'deki gibi)
+// imu veya counts NULL: o yayın yeni değil, atlanır
+static void Fusion_Feed(const IMU_Data_t *imu, const int16_t *counts, uint32_t timestamp) {
+    if (imu != NULL) {
+        uint64_t t0 = Host_Now_ns();
+        Fusion_ImuSample(imu, timestamp);
+        Profile_Add(&prof_fusion, Host_Now_ns() - t0);
+        FlightRecorder_Imu(imu, timestamp);
+    }
+    if (counts == NULL) return;
+    EventLog_Imu(counts, timestamp);
+    SimImuFed_t *fed = &evlog_shadow[evlog_fed % SIM_EVLOG_SHADOW];
+    fed->timestamp = timestamp;
+    memcpy(fed->counts, counts, sizeof(fed->counts));
+    evlog_fed++;
+}
+
+static void EventLog_Collect(const EventLogRecord_t *rec, void *ctx) {
+    (void)ctx;
+    if (evlog_dec_n < SIM_EVLOG_MAX_RECORDS) evlog_dec[evlog_dec_n++] = *rec;
+}
+
+// Çözülen logun IMU kayıtları füzyona verilen son örneklerle, kenar olayları
+// uçuş kaydındaki son kenarlarla aynı olmalı. Dönüş: uyuşmayan kayıt
+static uint32_t EventLog_Verify(const uint8_t *rec_image, uint32_t *imu_out) {
+    uint32_t imu = 0, edges = 0, bad = 0;
+    for (uint32_t i = 0; i < evlog_dec_n; i++) {
+        if (evlog_dec[i].type == EVLOG_REC_IMU) imu++;
+        if (evlog_dec[i].type == EVLOG_EV_EDGE) edges++;
+        if (i > 0 && evlog_dec[i].seq != evlog_dec[i - 1].seq + 1U) bad++;
+    }
+    *imu_out = imu;
+    if (imu > evlog_fed || imu > SIM_EVLOG_SHADOW) return bad + 1U;
+
+    const FlightRecHeader_t *hdr = (const FlightRecHeader_t *)rec_image;
+    const FlightRecord_t *rec = (const FlightRecord_t *)(rec_image + sizeof(*hdr));
+    uint32_t rec_edges = 0;
+    for (uint32_t i = 0; i < hdr->count; i++) rec_edges += rec[i].type == FLIGHTREC_EDGE;
+    if (edges > rec_edges) return bad + 1U;
+
+    // Uçuş kaydında logdaki ilk kenara karşılık gelen kayıt
+    uint32_t r = 0;
+    for (uint32_t skip = rec_edges - edges; r < hdr->count; r++) {
+        if (rec[r].type == FLIGHTREC_EDGE && skip-- == 0U) break;
+    }
+
+    uint32_t k = evlog_fed - imu;
+    for (uint32_t i = 0; i < evlog_dec_n; i++) {
+        const EventLogRecord_t *d = &evlog_dec[i];
+        if (d->type == EVLOG_REC_IMU) {
+            const SimImuFed_t *fed = &evlog_shadow[k++ % SIM_EVLOG_SHADOW];
+            bad += d->time != fed->timestamp || memcmp(d->raw, fed->counts, sizeof(fed->counts)) != 0;
+        } else if (d->type == EVLOG_EV_EDGE) {
+            bad += r >= hdr->count || d->time != rec[r].time || (uint16_t)d->value != rec[r].aux;
+            do {
+                r++;
+            } while (r < hdr->count && rec[r].type != FLIGHTREC_EDGE);
+        }
+    }
+    return bad;
+}
+
+// ============= ENKODER =============
+static void Encoder_Record(void) {
+    q16_t distance, velocity;
+    Encoder_Get(&distance, &velocity);
+    double err = Q16_TO_FLOAT(velocity) - plant_v;
+    enc_vel_err_sq += err * err;
+    if (fabs(err) > enc_vel_err_max) enc_vel_err_max = fabs(err);
+    enc_n++;
+}
+
+// ============= NTC =============
+// Yaklaşık normal gürültü (4 düzgün toplamı); rand() akışını bozmaz
+static double Xorshift_Noise(uint32_t *rng, double sigma) {
+    double sum = 0.0;
+    for (int i = 0; i < 4; i++) {
+        *rng ^= *rng << 13;
+        *rng ^= *rng >> 17;
+        *rng ^= *rng << 5;
+        sum += (double)*rng / 4294967296.0;
+    }
+    return (sum - 2.0) * sigma * sqrt(3.0);
+}
+
+// Kanal sıcaklıkları: ortam, yavaş ısınan batarya, sınırı geçip soğuyan sürücü
+static double Ntc_Truth(uint8_t ch, double t) {
+    switch (ch) {
+    case 0: return 22.0;
+    case 1: return 25.0 + 0.5 * t;
+    case 2:
+        if (t < 4.0) return 50.0 + 7.5 * t;
+        if (t < 8.0) return 80.0 - 7.5 * (t - 4.0);
+        return 50.0;
+    default: return 25.0;
+    }
+}
+
+static double Ntc_Noise(double sigma) {
+    return Xorshift_Noise(&ntc_rng, sigma);
+}
+
+// β denklemi tersten: °C -> bölücü oranı -> 12 bit ADC
+static uint16_t Analog_AdcSource(uint32_t channel) {
+    static const uint32_t channels[NTC_CHANNELS] = NTC_ADC_CHANNEL_LIST;
+    if (channel == SIM_BATTERY_CHANNEL) {
+        return (uint16_t)floor(SIM_BATTERY_CODE + Ntc_Noise(SIM_NTC_NOISE_LSB));
+    }
+    uint8_t ch = 0;
+    while (ch < NTC_CHANNELS && channels[ch] != channel) ch++;
+    if (ch >= NTC_CHANNELS) return 0;
+    if (ch == SIM_NTC_OPEN_CHANNEL) return 4095;
+
+    double t_k = Ntc_Truth(ch, (double)SimHAL_Now_ns() / SIM_NS_PER_S) + 273.15;
+    double r = NTC_R25_OHM * exp(NTC_BETA_K * (1.0 / t_k - 1.0 / 298.15));
+    double code = floor(4096.0 * r / (r + NTC_R_SERIES_OHM) + Ntc_Noise(SIM_NTC_NOISE_LSB));
+    return (uint16_t)(code < 0.0 ? 0.0 : code > 4095.0 ? 4095.0 : code);
+}
+
+static void Analog_Callback(uint8_t second_half) {
+    uint64_t t0 = Host_Now_ns();
+    if (second_half) {
+        Analog_CpltCallback(&hadc1);
+    } else {
+        Analog_HalfCallback(&hadc1);
+    }
+    Profile_Add(&prof_analog, Host_Now_ns() - t0);
+    analog_callbacks++;
+}
+
+// Yayınlanan sıcaklıkları ortalama penceresinin ortasındaki gerçek değerle
+// karşılaştır (ntc_time TIM2 saatinde, sanal saatle aynı sıfırdan)
+static void Sim_ThermalTask(void) {
+    AnalogBlock_t block;
+    Analog_Read(&block);
+    if (block.updates[battery_slot] > (1U << SIM_BATTERY_IIR_SHIFT)) {
+        double err = fabs(block.value[battery_slot] / 16.0 - (SIM_BATTERY_CODE - 0.5));
+        if (err > battery_err_max) battery_err_max = err;
+    }
+
+    if (!NTC_Process()) return;
+
+    double t_mid = (double)VehicleState.ntc_time / OPTICAL_IC_TICK_HZ;
+    for (uint8_t ch = 0; ch < NTC_CHANNELS; ch++) {
+        if (ch == SIM_NTC_OPEN_CHANNEL) continue;
+        double err = fabs(Q16_TO_FLOAT(VehicleState.ntc_temp_c[ch]) - Ntc_Truth(ch, t_mid));
+        ntc_err_sq += err * err;
+        if (err > ntc_err_max) ntc_err_max = err;
+        ntc_n++;
+    }
+
+    uint8_t hot = (uint8_t)(1U << SIM_NTC_HOT_CHANNEL);
+    if ((VehicleState.ntc_overtemp & hot) && !(ntc_prev_overtemp & hot)) {
+        ntc_sets++;
+        ntc_set_truth = Ntc_Truth(SIM_NTC_HOT_CHANNEL, t_mid);
+    } else if (!(VehicleState.ntc_overtemp & hot) && (ntc_prev_overtemp & hot)) {
+        ntc_clears++;
+        ntc_clear_truth = Ntc_Truth(SIM_NTC_HOT_CHANNEL, t_mid);
+    }
+    ntc_prev_overtemp = VehicleState.ntc_overtemp;
+    ntc_overtemp_seen |= VehicleState.ntc_overtemp;
+    ntc_fault_seen |= VehicleState.ntc_fault;
+}
+
+// Aynı register byte'larını float ile çevirip firmware'in Q16 sonucuyla karşılaştır
+static int16_t IMU_ReadAxis(const uint8_t *regs, uint8_t reg) {
+    return (int16_t)(regs[reg] << 8 | regs[reg + 1]);
+}
+
+// raw: ACCEL_XOUT_H'den başlayan 14 byte (register veya FIFO düzeni aynı)
+static void IMU_CheckReference(const uint8_t *raw, const IMU_Data_t *fw) {
+    const q16_t *accel = &fw->accel_x_g;
+    const q16_t *gyro = &fw->gyro_x_dps;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        double ref_a = IMU_ReadAxis(raw, 2 * i) / (double)MPU6050_ACCEL_LSB_PER_G;
+        double ref_g = IMU_ReadAxis(raw, 8 + 2 * i) / MPU6050_GYRO_LSB_PER_DPS;
+        imu_err_accel = fmax(imu_err_accel, fabs(accel[i] / 65536.0 - ref_a));
+        imu_err_gyro = fmax(imu_err_gyro, fabs(gyro[i] / 65536.0 - ref_g));
+    }
+    double ref_t = IMU_ReadAxis(raw, 6) / MPU6050_TEMP_LSB_PER_C + MPU6050_TEMP_OFFSET_C;
+    imu_err_temp = fmax(imu_err_temp, fabs(fw->temp_c / 65536.0 - ref_t));
+}
+
+// FIFO'dan gelen örneği, INT anında kaydedilen gerçek örnekle eşleştir
+static void IMU_CheckSample(const IMU_Sample_t *s) {
+    imu_rx_samples++;
+    if (imu_last_seq >= 0 && s->seq != (uint32_t)(imu_last_seq + 1)) {
+        imu_seq_gaps += s->seq - (uint32_t)(imu_last_seq + 1);
+    }
+    imu_last_seq = s->seq;
+
+    if (imu_dr_index - s->seq > SIM_IMU_TRUTH || s->seq >= imu_dr_index) {
+        imu_ts_errors++;
+        return;
+    }
+    const SimImuTruth_t *truth = &imu_truth[s->seq % SIM_IMU_TRUTH];
+    if (truth->timestamp != s->timestamp) {
+        imu_ts_errors++;
+    }
+    // Yanlış örnek eşleşirse (hizası kaymış FIFO) fark tolerans dışına çıkar
+    IMU_CheckReference(truth->raw, &s->data);
+}
+
+// ============= IMU FİLTRESİ (referans) =============
+// Firmware zincirinin aynısı: CIC tam sayıda (int64, taşmasız), biquad'lar
+// üretilmiş tablonun katsayılarıyla double'da (çıkış yuvarlaması yok).
+// Girdi firmware'in filtreye verdiği ham çevrim (IMU_CheckReference ile doğrulanır).
+typedef struct {
+    double x1, x2, y1, y2;
+} SimBiquad_t;
+
+static SimBiquad_t ref_biquad[IMU_FILTER_AXES][IMU_FILTER_SECTIONS];
+static int64_t ref_cic_int[IMU_FILTER_AXES][IMU_FILTER_CIC_ORDER];
+static int64_t ref_cic_comb[IMU_FILTER_AXES][IMU_FILTER_CIC_ORDER];
+static uint32_t ref_phase = 0;
+static uint32_t ref_warmup = IMU_FILTER_DECIM > 1U ? IMU_FILTER_CIC_ORDER - 1U : 0U;
+static uint8_t ref_primed = 0;
+static double ref_out[IMU_FILTER_AXES];  // Q16 ölçeğinde
+static uint32_t ref_inputs = 0;
+static uint32_t ref_outputs = 0;
+static uint32_t filt_ready_mismatch = 0;  // FIFO: örneğin çıkış bayrağı referansla farklı
+static double filt_err[2];               // En büyük sapma: ivme (g), jiroskop (dps)
+// Gürültü: gerçeği 0 olan eksenler (ivme y, jiroskop z), ham ve filtreli
+static double noise_raw_sq[2], noise_filt_sq[2];
+static uint32_t noise_raw_n = 0, noise_filt_n = 0;
+
+static uint8_t ImuFilterRef_Step(const IMU_Data_t *in) {
+    const q16_t x_in[IMU_FILTER_AXES] = {
+        in->accel_x_g, in->accel_y_g, in->accel_z_g, in->gyro_x_dps, in->gyro_y_dps, in->gyro_z_dps
+    };
+    double v[IMU_FILTER_AXES];
+    ref_inputs++;
+    noise_raw_sq[0] += pow(in->accel_y_g / 65536.0, 2);
+    noise_raw_sq[1] += pow(in->gyro_z_dps / 65536.0, 2);
+    noise_raw_n++;
+
+    if (IMU_FILTER_DECIM > 1U) {
+        for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) {
+            int64_t acc = x_in[a];
+            for (uint32_t k = 0; k < IMU_FILTER_CIC_ORDER; k++) {
+                ref_cic_int[a][k] += acc;
+                acc = ref_cic_int[a][k];
+            }
+        }
+        if (++ref_phase < IMU_FILTER_DECIM) return 0;
+        ref_phase = 0;
+        double gain = pow(IMU_FILTER_DECIM, IMU_FILTER_CIC_ORDER);
+        for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) {
+            int64_t acc = ref_cic_int[a][IMU_FILTER_CIC_ORDER - 1U];
+            for (uint32_t k = 0; k < IMU_FILTER_CIC_ORDER; k++) {
+                int64_t prev = ref_cic_comb[a][k];
+                ref_cic_comb[a][k] = acc;
+                acc -= prev;
+            }
+            v[a] = floor(((double)acc + gain / 2.0) / gain);
+        }
+        if (ref_warmup > 0) {
+            ref_warmup--;
+            return 0;
+        }
+    } else {
+        for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) v[a] = x_in[a];
+    }
+
+    const double one = (double)(1L << IMU_FILTER_COEF_SHIFT);
+    for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) {
+        double x = v[a];
+        for (uint32_t k = 0; k < IMU_FILTER_SECTIONS; k++) {
+            const ImuBiquad_t *c = &imu_filter_coef[a < 3U ? 0U : 1U][k];
+            SimBiquad_t *b = &ref_biquad[a][k];
+            if (!ref_primed) *b = (SimBiquad_t){ x, x, x, x };
+            double y = (c->b0 * x + c->b1 * b->x1 + c->b2 * b->x2 + c->a1 * b->y1 + c->a2 * b->y2) / one;
+            b->x2 = b->x1;
+            b->x1 = x;
+            b->y2 = b->y1;
+            b->y1 = y;
+            x = y;
+        }
+        ref_out[a] = x;
+    }
+    ref_primed = 1;
+    ref_outputs++;
+    return 1;
+}
+
+// Firmware'in son yayınladığı filtreli örnek, referansın son çıkışıyla
+static void ImuFilterRef_Check(const IMU_Data_t *fw) {
+    const q16_t y[IMU_FILTER_AXES] = {
+        fw->accel_x_g, fw->accel_y_g, fw->accel_z_g, fw->gyro_x_dps, fw->gyro_y_dps, fw->gyro_z_dps
+    };
+    for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) {
+        double err = fabs(y[a] - ref_out[a]) / 65536.0;
+        filt_err[a < 3U ? 0 : 1] = fmax(filt_err[a < 3U ? 0 : 1], err);
+    }
+    noise_filt_sq[0] += pow(fw->accel_y_g / 65536.0, 2);
+    noise_filt_sq[1] += pow(fw->gyro_z_dps / 65536.0, 2);
+    noise_filt_n++;
+}
+
+// ============= HAL CALLBACK'LERİ (main.c'deki yönlendirmenin aynısı) =============
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim->Instance == TIM2) {
+        uint64_t t0 = Host_Now_ns();
+        OpticalSensor_IC_CaptureCallback(htim);
+        Profile_Add(&prof_exti, Host_Now_ns() - t0);
+        if (!(Scheduler_PendingEvents() & (1UL << (SIM_EVENT_EDGE - 1U)))) edge_post_ns = SimHAL_Now_ns();
+        Scheduler_Post(SIM_EVENT_EDGE);
+    }
+}
+
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    if (htim->Instance == TIM2) {
+        OpticalSensor_IC_OverflowCallback(htim);
+    }
+}
+
+void HAL_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart) {
+    UartLog_TxHalfCpltCallback(huart);
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    UartLog_TxCpltCallback(huart);
+}
+
+// Tek örnek modunda sürücü bitiş callback'inde yeni örnek yayınladıysa
+// (hat diğer cihazlar için de aynı callback'i çağırır)
+static uint32_t imu_samples_seen = 0;
+
+static void IMU_CheckSingle(void) {
+    MPU6050_FifoStats_t st;
+    MPU6050_GetFifoStats(&st);
+    if (cfg.imu_fifo || st.samples == imu_samples_seen) return;
+    imu_samples_seen = st.samples;
+    IMU_CheckReference(SimHAL_MPU6050_Regs() + REG_ACCEL_XOUT_H, &VehicleState.imu_raw);
+    if (ImuFilterRef_Step(&VehicleState.imu_raw)) ImuFilterRef_Check(&VehicleState.imu);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c->Instance == I2C1) {
+        uint64_t t0 = Host_Now_ns();
+        I2CBus_RxCpltCallback(hi2c);
+        Profile_Add(&prof_i2c, Host_Now_ns() - t0);
+        IMU_CheckSingle();
+    }
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c->Instance == I2C1) {
+        uint64_t t0 = Host_Now_ns();
+        I2CBus_TxCpltCallback(hi2c);
+        Profile_Add(&prof_i2c, Host_Now_ns() - t0);
+    }
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c->Instance == I2C1) {
+        uint64_t t0 = Host_Now_ns();
+        I2CBus_ErrorCallback(hi2c);
+        Profile_Add(&prof_i2c, Host_Now_ns() - t0);
+    }
+}
+
+// ============= I2C HATTI =============
+// -I: transfer başında hata seçimi (ayrı LCG: rand() akışı ve varsayılan
+// koşular değişmez). Hataların %60'ı NACK, %30'u hat hatası, %10'u SDA'yı
+// tutan köle.
+static uint32_t i2c_rng = 1;
+static uint32_t i2c_injected[4];        // SIM_I2C_FAULT_* başına
+
+static uint8_t I2C_FaultHook(uint16_t addr) {
+    (void)addr;
+    i2c_rng = i2c_rng * 1664525U + 1013904223U;
+    double u = (double)(i2c_rng >> 8) / 16777216.0;
+    if (u >= cfg.i2c_fault) return SIM_I2C_FAULT_NONE;
+    double k = u / cfg.i2c_fault;
+    uint8_t fault = k < 0.6 ? SIM_I2C_FAULT_NACK : (k < 0.9 ? SIM_I2C_FAULT_BERR : SIM_I2C_FAULT_STUCK);
+    i2c_injected[fault]++;
+    return fault;
+}
+
+// -L: barometre, düşük öncelik. Okunan blok cihazın o anki register'larıyla
+// aynı olmalı; her doğru okumadan sonra cihaz yeni ölçüm yazar.
+static uint8_t aux_regs[256];
+static uint8_t aux_buf[SIM_AUX_LEN];
+static uint8_t aux_dev = I2C_BUS_NO_DEVICE;
+static uint8_t aux_pending = 0;
+static uint32_t aux_tick = 0;
+static uint32_t aux_good = 0;
+static uint32_t aux_bad = 0;
+
+static void Aux_ReadDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    aux_pending = 0;
+    if (status != I2C_BUS_OK) return;
+    if (memcmp(aux_buf, &aux_regs[SIM_AUX_REG], SIM_AUX_LEN) == 0) {
+        aux_good++;
+    } else {
+        aux_bad++;
+    }
+    for (uint32_t i = 0; i < SIM_AUX_LEN; i++) {
+        aux_regs[SIM_AUX_REG + i] = (uint8_t)(aux_regs[SIM_AUX_REG + i] * 13U + 7U + i);
+    }
+}
+
+static void Aux_Tick(void) {
+    if (cfg.aux_hz == 0 || aux_pending) return;
+    uint32_t period = cfg.aux_hz >= 1000U ? 1U : 1000U / cfg.aux_hz;
+    if (aux_tick++ % period != 0U) return;
+    I2CBusXfer_t x = {
+        .device = aux_dev, .priority = I2C_BUS_PRIO_LOW, .retries = 1,
+        .reg = SIM_AUX_REG, .len = SIM_AUX_LEN, .data = aux_buf, .done = Aux_ReadDone,
+    };
+    aux_pending = I2CBus_Submit(&x) == 0;
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+    if (hadc->Instance == ADC1) Analog_Callback(0);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+    if (hadc->Instance == ADC1) Analog_Callback(1);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    if (GPIO_Pin == MPU6050_INT_PIN) {
+        uint64_t t0 = Host_Now_ns();
+        MPU6050_INT_Callback(OpticalSensor_GetTimestamp());
+        Profile_Add(&prof_imu_int, Host_Now_ns() - t0);
+    }
+}
+
+// ============= TÜNEL =============
+static void Track_AddMarker(double pos, uint8_t spurious, uint16_t marker) {
+    if (edge_total + 2 > SIM_MAX_EDGES) return;
+    edges[edge_total].pos = pos;
+    edges[edge_total].level = 1;
+    edges[edge_total].spurious = spurious;
+    edges[edge_total].marker = marker;
+    edges[edge_total + 1].pos = pos + SIM_MARKER_WIDTH;
+    edges[edge_total + 1].level = 0;
+    edges[edge_total + 1].spurious = spurious;
+    edges[edge_total + 1].marker = marker;
+    edge_total += 2;
+}
+
+static uint8_t Chance(double p) {
+    return p > 0.0 && rand() < p * ((double)RAND_MAX + 1.0);
+}
+
+// Firmware'in pist haritası: işaretler zaten konum sırasında
+static uint32_t strips_dropped = 0;
+static uint8_t reflector_dropped[TUNNEL_MAP_MAX_MARKERS];
+static uint32_t glints_passed = 0;     // Kapsülün geçtiği parlamalar
+
+// Kapı kayıp reflektörü ancak arkasından gelen işaretle çıkarır: durma
+// noktasının ötesindeki ya da son görülen işaretten sonraki kayıp sayılmaz
+static uint32_t Track_DroppedBefore(int32_t marker) {
+    uint32_t n = 0;
+    for (int32_t i = 0; i < marker; i++) {
+        n += reflector_dropped[i];
+    }
+    return n;
+}
+
+static void Track_Build(void) {
+    uint16_t count = TunnelMap_Count();
+    uint8_t dropped[TUNNEL_MAP_MAX_MARKERS];
+    uint8_t miss_placed = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        const TunnelMarker_t *m = TunnelMap_Marker(i);
+        dropped[i] = 0;
+        // -m: kirli/eksik şerit, sensör hiç kenar görmez
+        if (m->type == TUNNEL_MARKER_STRIP && Chance(cfg.strip_miss)) {
+            dropped[i] = 1;
+            strips_dropped++;
+        }
+        // -r: kayıp reflektör; kapının ısınması ve son işaret (sayım kontrolü) hariç
+        if (m->type == TUNNEL_MARKER_REFLECTOR && i >= SIM_GATE_WARMUP && i + 1U < count &&
+            Chance(cfg.reflector_miss)) {
+            dropped[i] = 1;
+            reflector_dropped[i] = 1;
+        }
+        // -K: belirli konumdaki kayıp (ör. frenleme bölgesinde) kapının
+        // yavaşlama tahminini sınar
+        if (cfg.miss_after > 0.0 && !miss_placed && m->type == TUNNEL_MARKER_REFLECTOR &&
+            Q16_TO_FLOAT(m->position) >= cfg.miss_after && i + 1U < count) {
+            miss_placed = 1;
+            dropped[i] = 1;
+            reflector_dropped[i] = 1;
+        }
+    }
+
+    edge_total = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        const TunnelMarker_t *m = TunnelMap_Marker(i);
+        const TunnelMarker_t *next = TunnelMap_Marker(i + 1U);
+        if (!dropped[i]) {
+            Track_AddMarker(Q16_TO_FLOAT(m->position), 0, i);
+        }
+        // -g: görülen iki reflektör arasında parlama (şerit gruplarından uzakta).
+        // Kayıp reflektörün yanındaki parlama onun yerine geçer, ayırt edilemez.
+        if (i + 1U >= SIM_GATE_WARMUP && m->type == TUNNEL_MARKER_REFLECTOR && !dropped[i] &&
+            next != NULL && next->type == TUNNEL_MARKER_REFLECTOR && !dropped[i + 1U] && Chance(cfg.glint)) {
+            double u = (double)rand() / RAND_MAX;
+            Track_AddMarker(Q16_TO_FLOAT(m->position) + SIM_GLINT_MIN + u * (SIM_GLINT_MAX - SIM_GLINT_MIN), 1, 0);
+        }
+    }
+    edge_next = 0;
+}
+
+// ============= PLANT =============
+static void Edge_Rise(void *arg) {
+    const SimEdge_t *edge = arg;
+    if (!edge->spurious) {
+        markers_passed++;
+        last_marker_seen = edge->marker;
+    } else {
+        glints_passed++;
+    }
+    if (cfg.perfect_fixes && !edge->spurious && sim_fix_count < sizeof(sim_fixes) / sizeof(sim_fixes[0])) {
+        sim_fixes[sim_fix_count].pos = edge->pos;
+        sim_fixes[sim_fix_count].timestamp = OpticalSensor_GetTimestamp();
+        sim_fix_count++;
+    }
+    SimHAL_GPIO_Drive(OPTICAL_SENSOR_PORT, OPTICAL_SENSOR_PIN, GPIO_PIN_SET);
+}
+
+static void Edge_Fall(void *arg) {
+    (void)arg;
+    SimHAL_GPIO_Drive(OPTICAL_SENSOR_PORT, OPTICAL_SENSOR_PIN, GPIO_PIN_RESET);
+}
+
+static double Gauss(void) {
+    // Basit Box-Muller; rand() seed ile deterministik
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static int16_t Noise(double sigma) {
+    return (int16_t)lrint(sigma * Gauss());
+}
+
+static void IMU_WriteAxis(uint8_t *regs, uint8_t reg, int32_t value) {
+    if (value > 32767) value = 32767;
+    if (value < -32768) value = -32768;
+    regs[reg] = (uint8_t)((uint16_t)value >> 8);
+    regs[reg + 1] = (uint8_t)((uint16_t)value & 0xFF);
+}
+
+static void IMU_Update(void) {
+    uint8_t *regs = SimHAL_MPU6050_Regs();
+    double accel_sigma = SIM_IMU_ACCEL_NOISE * cfg.imu_noise;
+    double gyro_sigma = SIM_IMU_GYRO_NOISE * cfg.imu_noise;
+
+    // -W: kapsül titreşimi, üç ivme ekseninde aynı fazda
+    int32_t vib = (int32_t)lrint(cfg.imu_vibration * MPU6050_ACCEL_LSB_PER_G *
+                                 sin(2.0 * M_PI * SIM_IMU_VIB_HZ * (double)SimHAL_Now_ns() / SIM_NS_PER_S));
+
+    // Ölçek imu.h'deki aralık ayarından (MPU6050_ACCEL/GYRO_FS_SEL)
+    IMU_WriteAxis(regs, REG_ACCEL_XOUT_H + 0,
+                  (int32_t)lrint((plant_a + cfg.imu_bias) / SIM_G * MPU6050_ACCEL_LSB_PER_G) + vib + Noise(accel_sigma));
+    IMU_WriteAxis(regs, REG_ACCEL_XOUT_H + 2, vib + Noise(accel_sigma));
+    IMU_WriteAxis(regs, REG_ACCEL_XOUT_H + 4, MPU6050_ACCEL_LSB_PER_G + vib + Noise(accel_sigma));
+    IMU_WriteAxis(regs, REG_ACCEL_XOUT_H + 6,
+                  (int32_t)lrint((30.0 - MPU6050_TEMP_OFFSET_C) * MPU6050_TEMP_LSB_PER_C));
+    IMU_WriteAxis(regs, REG_ACCEL_XOUT_H + 8, Noise(gyro_sigma));
+    IMU_WriteAxis(regs, REG_ACCEL_XOUT_H + 10, Noise(gyro_sigma));
+    IMU_WriteAxis(regs, REG_ACCEL_XOUT_H + 12, Noise(gyro_sigma));
+}
+
+// Sensörün kendi saatiyle örnek anı: register'lar güncellenir, FIFO/INT sürülür
+static void IMU_SampleEvent(void *arg) {
+    (void)arg;
+    uint64_t t0 = SimHAL_Now_ns();
+    uint8_t *regs = SimHAL_MPU6050_Regs();
+
+    IMU_Update();
+
+    SimImuTruth_t *truth = &imu_truth[imu_dr_index % SIM_IMU_TRUTH];
+    memcpy(truth->raw, regs + REG_ACCEL_XOUT_H, MPU6050_SAMPLE_SIZE);
+    truth->timestamp = OpticalSensor_GetTimestamp();  // ISR aynı anda aynı değeri okur
+    if (SimHAL_MPU6050_Sample()) {
+        imu_dr_index++;
+    }
+
+    if (!plant_stopped) {
+        SimHAL_Schedule(t0 + SIM_IMU_PERIOD_NS + SIM_IMU_PERIOD_NS * SIM_IMU_CLOCK_PPM / 1000000ULL,
+                        IMU_SampleEvent, NULL);
+    }
+}
+
+static void Plant_Step(void *arg) {
+    (void)arg;
+    uint64_t t0 = SimHAL_Now_ns();
+    double dt = (double)SIM_PLANT_STEP_NS / SIM_NS_PER_S;
+
+    // Enkoder sayımı şimdiki konumda (plant_x bu adımın başına ait; x1
+    // adım sonuna ait, o sayım henüz oluşmadı)
+    if (t0 >= SIM_PLANT_STEP_NS) {
+        SimEncoder_Move(&sim_enc, (plant_x - enc_origin) / SimEncoder_MetersPerCount(), t0 - SIM_PLANT_STEP_NS, t0);
+    }
+
+    // Fren komutu firmware'den gelir; aktüatör gecikmesinden sonra devreye girer
+    if (brake_cmd_ns == 0 && VehicleState.system_status == SYS_BRAKING) {
+        brake_cmd_ns = t0;
+        brake_cmd_x = plant_x;
+    }
+
+    if (brake_cmd_ns != 0 && t0 >= brake_cmd_ns + (uint64_t)(cfg.brake_latency * SIM_NS_PER_S)) {
+        plant_a = -cfg.brake_decel;
+    } else if (t0 < SIM_LAUNCH_HOLD_NS) {
+        plant_a = 0.0;
+    } else if (plant_v < cfg.cruise_speed) {
+        plant_a = cfg.accel;
+    } else {
+        plant_a = 0.0;
+    }
+
+    double v1 = plant_v + plant_a * dt;
+    if (v1 <= 0.0 && plant_a < 0.0) {
+        v1 = 0.0;
+        plant_stopped = 1;
+    }
+    if (plant_a > 0.0 && v1 > cfg.cruise_speed) v1 = cfg.cruise_speed;
+    double x1 = plant_x + 0.5 * (plant_v + v1) * dt;
+
+    // Bu adımda geçilen bantlar için kenarları tam geçiş anına zamanla
+    while (edge_next < edge_total && edges[edge_next].pos <= x1) {
+        double frac = (x1 > plant_x) ? (edges[edge_next].pos - plant_x) / (x1 - plant_x) : 0.0;
+        if (frac < 0.0) frac = 0.0;
+        uint64_t te = t0 + (uint64_t)(frac * SIM_PLANT_STEP_NS);
+        // -J: sensörün tepki süresi kenardan kenara değişir (rand akışı
+        // sadece açıkken kullanılır, varsayılan koşular aynı kalır)
+        if (cfg.edge_jitter > 0.0) {
+            double j = cfg.edge_jitter * SIM_NS_PER_S * fabs(Gauss());
+            te += (uint64_t)j;
+        }
+        SimHAL_Schedule(te, edges[edge_next].level ? Edge_Rise : Edge_Fall, &edges[edge_next]);
+        edge_next++;
+    }
+
+    plant_x = x1;
+    plant_v = v1;
+
+    if (!plant_stopped) {
+        SimHAL_Schedule(t0 + SIM_PLANT_STEP_NS, Plant_Step, NULL);
+    }
+}
+
+// Firmware'in durum satırı (OpticalSensor_RealTestStep'teki formatın aynısı)
+static void Status_Log(void) {
+    char line[96];
+    int n = snprintf(line, sizeof(line), "Konum: %6.2fm | Hız: %5.2fm/s | Reflektör: %3u | Durum: %u\r\n",
+                     (double)Q16_TO_FLOAT(VehicleState.current_position), (double)Q16_TO_FLOAT(VehicleState.current_velocity),
+                     (unsigned)VehicleState.reflector_count, (unsigned)VehicleState.system_status);
+    if (n <= 0) return;
+
+    uint64_t t0 = Host_Now_ns();
+    UartLog_Write((const uint8_t *)line, (uint16_t)n);
+    Profile_Add(&prof_log, Host_Now_ns() - t0);
+}
+
+static void Telemetry_Tick(void) {
+    uint64_t t0 = Host_Now_ns();
+    Telemetry_Send();
+    Profile_Add(&prof_telemetry, Host_Now_ns() - t0);
+}
+
+// ============= GÖREVLER =============
+// Firmware zamanlayıcısı host'ta da aynı: görev süreleri duvar saatiyle
+// (SCHEDULER_CLOCK_HZ birimine çevrilerek) ölçülür
+static uint32_t Host_SchedulerClock(void) {
+    return (uint32_t)(Host_Now_ns() / (SIM_NS_PER_S / SCHEDULER_CLOCK_HZ));
+}
+
+static IMU_Sample_t imu_batch[2 * MPU6050_FIFO_BATCH];
+static uint32_t sim_imu_seq = 0;       // Tek örnek modunda işlenen son yayın
+static uint32_t sim_imu_raw_seq = 0;
+static uint32_t sim_imu_repeats = 0;   // Yeni filtreli örnek gelmemiş tur
+static uint64_t stall_start = SIM_LAUNCH_HOLD_NS + SIM_NS_PER_S;
+static uint64_t stall_end = SIM_LAUNCH_HOLD_NS + SIM_NS_PER_S;
+
+static void Sim_ProcessEdges(void) {
+    uint64_t t0 = Host_Now_ns();
+    uint32_t processed = OpticalSensor_Process();
+    if (processed > 0) {
+        Profile_Add(&prof_process, Host_Now_ns() - t0);
+        Edge_Record();
+    }
+}
+
+// Yakalama kesmesinin olayı: kenar bir sonraki tick beklenmeden işlenir
+static uint8_t Sim_WakePending(void) {
+    return Scheduler_PendingEvents() != 0U;
+}
+
+static void Sim_EdgeTask(void) {
+    uint64_t wait = SimHAL_Now_ns() - edge_post_ns;
+    if (wait > edge_wake_max_ns) edge_wake_max_ns = wait;
+    Sim_ProcessEdges();
+}
+
+// 1 kHz. Tek örnek modunda her turda IMU okuması kuyruğa atılır,
+// FIFO modunda INT'in başlattığı burst'ler toplu çevrilir.
+static void Sim_AcquisitionTask(void) {
+    uint64_t t = SimHAL_Now_ns();
+    uint64_t t0;
+    Sim_ProcessEdges();
+
+    for (uint32_t i = 0; i < sim_fix_count; i++) {
+        Fusion_PositionFix(FUSION_SRC_EXTERNAL, Q16_FROM_FLOAT(sim_fixes[i].pos),
+                           Q16_FROM_FLOAT(SIM_FIX_STD), sim_fixes[i].timestamp);
+    }
+    sim_fix_count = 0;
+
+    // Hat zaman aşımı / kurtarma; barometre IMU'dan önce kuyruğa girer: IMU
+    // okuması en kötü durumda bir düşük öncelikli transferi bekler
+    I2CBus_Poll();
+    Aux_Tick();
+    if (!cfg.imu_fifo) {
+        // Firmware gibi: kopya alınır, sürücü sayacı ilerlemeyen yayın atlanır;
+        // örnek anı DMA bitişinde sürücünün yayınladığı (imu_time)
+        SharedData_t imu_state;
+        SharedData_Snapshot(&imu_state);
+        const IMU_Data_t *imu = NULL;
+        const int16_t *counts = NULL;
+        if (imu_state.imu_seq != sim_imu_seq) {
+            sim_imu_seq = imu_state.imu_seq;
+            imu = &imu_state.imu;
+        } else {
+            sim_imu_repeats++;
+        }
+        if (imu_state.imu_raw_seq != sim_imu_raw_seq) {
+            sim_imu_raw_seq = imu_state.imu_raw_seq;
+            counts = imu_state.imu_raw_counts;
+        }
+        Fusion_Feed(imu, NULL, imu_state.imu_time);
+        Fusion_Feed(NULL, counts, imu_state.imu_raw_time);
+        MPU6050_Start_DMA_Read();
+    } else if (t < stall_start || t >= stall_end) {
+        t0 = Host_Now_ns();
+        uint32_t n = MPU6050_FIFO_Process(imu_batch, 2 * MPU6050_FIFO_BATCH);
+        if (n > 0) Profile_Add(&prof_imu_batch, Host_Now_ns() - t0);
+        // Füzyon tek örnek modundaki gibi filtre çıkışını alır (örneğin
+        // zaman damgasıyla); her çıkış referansla karşılaştırılır
+        for (uint32_t i = 0; i < n; i++) {
+            const IMU_Sample_t *smp = &imu_batch[i];
+            IMU_CheckSample(smp);
+            uint8_t ref_ready = ImuFilterRef_Step(&smp->data);
+            if (ref_ready != smp->has_filtered) filt_ready_mismatch++;
+            if (ref_ready && smp->has_filtered) ImuFilterRef_Check(&smp->filtered);
+            Fusion_Feed(smp->has_filtered ? &smp->filtered : NULL, smp->counts, smp->timestamp);
+        }
+    }
+    Fusion_Record();
+
+    EncoderRaw_t enc_raw;
+    SimEncoder_Raw(&sim_enc, OpticalSensor_GetTimestamp(), t, &enc_raw);
+    Encoder_Sample(&enc_raw);
+    Encoder_Record();
+    if (Encoder_IsStill()) Fusion_ZeroVelocity();
+
+    t0 = Host_Now_ns();
+    BrakeSupervisor_Update(OpticalSensor_GetTimestamp());
+    Profile_Add(&prof_brake, Host_Now_ns() - t0);
+}
+
+// ============= ANA =============
+static void Usage(const char *prog) {
+    fprintf(stderr, "Kullanım: %s [-v hız m/s] [-a ivme m/s2] [-b fren m/s2] [-l fren gecikmesi s]\n"
+                    "          [-s seed] [-t konum toleransı m] [-c csv dosyası] [-u uart çıktı dosyası]\n"
+                    "          [-T telemetri Hz] [-F] [-S IMU duraklatma ms] [-P] [-m şerit kaybı]\n"
+                    "          [-r reflektör kaybı] [-K kayıp konumu m] [-g parlama] [-J kenar titreşimi us]\n"
+                    "          [-N IMU gürültü ölçeği]"
+                    "          [-B IMU sapması m/s2] [-W titreşim g] [-I I2C hata oranı] [-L barometre Hz]\n"
+                    "          [-R sonuç dosyası] [-D kayıt dosyası] [-E olay logu dosyası] [-q]\n"
+                    "  -F  MPU6050 FIFO + INT burst modu (varsayılan: ana döngüden tek örnek DMA)\n"
+                    "  -P  füzyonu optik yerine gerçek işaret konumlarıyla düzelt\n"
+                    "  -m  her bilgi şeridinin görülmeme olasılığı (0..1)\n"
+                    "  -r  her reflektörün görülmeme olasılığı (0..1)\n"
+                    "  -K  bu konumdan (m) sonraki ilk reflektörü gösterme (ör. frenleme bölgesi)\n"
+                    "  -g  iki reflektör arasında parazit kenar olasılığı (0..1)\n"
+                    "  -W  ivme eksenlerine %.0f Hz titreşim ekle (genlik, g)\n"
+                    "  -I  her I2C transferinde hata olasılığı (0..1; NACK, hat hatası, takılı SDA)\n"
+                    "  -L  I2C hattına bu hızda okunan düşük öncelikli barometre ekle\n"
+                    "  -R  koşu özetini tek satır olarak yaz (tunnel_mc için)\n"
+                    "  -D  uçuş kaydını flash'a yazıp görüntüsünü dosyaya çıkar, UART'tan da dök\n"
+                    "  -E  olay logu görüntüsünü dosyaya çıkar, UART'tan da dök\n", prog, SIM_IMU_VIB_HZ);
+}
+
+int main(int argc, char **argv) {
+    cfg.cruise_speed = 8.0;
+    cfg.accel = 2.0;
+    cfg.brake_decel = 4.0;
+    cfg.brake_latency = 0.05;
+    cfg.seed = 1;
+    cfg.tolerance = -1.0;
+    cfg.csv_path = NULL;
+    cfg.uart_path = NULL;
+    cfg.telemetry_hz = 0;
+    cfg.imu_fifo = 0;
+    cfg.perfect_fixes = 0;
+    cfg.strip_miss = 0.0;
+    cfg.reflector_miss = 0.0;
+    cfg.glint = 0.0;
+    cfg.miss_after = 0.0;
+    cfg.imu_stall_ms = 0;
+    cfg.edge_jitter = 0.0;
+    cfg.imu_noise = 1.0;
+    cfg.imu_bias = SIM_IMU_ACCEL_BIAS;
+    cfg.imu_vibration = 0.0;
+    cfg.i2c_fault = 0.0;
+    cfg.aux_hz = 0;
+    cfg.result_path = NULL;
+    cfg.record_path = NULL;
+    cfg.evlog_path = NULL;
+    cfg.quiet = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "v:a:b:l:s:t:c:u:T:FS:Pm:r:g:K:J:N:B:W:I:L:R:D:E:qh")) != -1) {
+        switch (opt) {
+            case 'v': cfg.cruise_speed = atof(optarg); break;
+            case 'a': cfg.accel = atof(optarg); break;
+            case 'b': cfg.brake_decel = atof(optarg); break;
+            case 'l': cfg.brake_latency = atof(optarg); break;
+            case 's': cfg.seed = (unsigned)strtoul(optarg, NULL, 0); break;
+            case 't': cfg.tolerance = atof(optarg); break;
+            case 'c': cfg.csv_path = optarg; break;
+            case 'u': cfg.uart_path = optarg; break;
+            case 'T': cfg.telemetry_hz = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'F': cfg.imu_fifo = 1; break;
+            case 'P': cfg.perfect_fixes = 1; break;
+            case 'm': cfg.strip_miss = atof(optarg); break;
+            case 'r': cfg.reflector_miss = atof(optarg); break;
+            case 'g': cfg.glint = atof(optarg); break;
+            case 'K': cfg.miss_after = atof(optarg); break;
+            case 'S': cfg.imu_stall_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'J': cfg.edge_jitter = atof(optarg) * 1e-6; break;
+            case 'N': cfg.imu_noise = atof(optarg); break;
+            case 'B': cfg.imu_bias = atof(optarg); break;
+            case 'W': cfg.imu_vibration = atof(optarg); break;
+            case 'I': cfg.i2c_fault = atof(optarg); break;
+            case 'L': cfg.aux_hz = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'R': cfg.result_path = optarg; break;
+            case 'D': cfg.record_path = optarg; break;
+            case 'E': cfg.evlog_path = optarg; break;
+            case 'q': cfg.quiet = 1; break;
+            default: Usage(argv[0]); return 2;
+        }
+    }
+
+    if (cfg.csv_path) {
+        csv = fopen(cfg.csv_path, "w");
+        if (!csv) {
+            perror(cfg.csv_path);
+            return 2;
+        }
+        fprintf(csv, "t_s,true_pos_m,fw_pos_m,true_vel_mps,fw_vel_mps,markers,reflector_count,status,fused_pos_m,fused_vel_mps,two_point_vel_mps\n");
+    }
+
+    srand(cfg.seed);
+    ntc_rng = cfg.seed * 2654435761U + 1U;
+    i2c_rng = cfg.seed * 2246822519U + 1U;
+    SimHAL_Reset();
+    SimHAL_ADC_SetSource(Analog_AdcSource);
+
+    FILE *uart_out = NULL;
+    if (cfg.uart_path) {
+        uart_out = fopen(cfg.uart_path, "w");
+        if (!uart_out) {
+            perror(cfg.uart_path);
+            return 2;
+        }
+        SimHAL_UART_SetSink(uart_out);
+    } else if (cfg.quiet) {
+        SimHAL_UART_SetSink(NULL);
+    }
+
+    // Firmware'in donanım kurulumu (main.c MX_TIM2_Init ile aynı):
+    // PA0 = TIM2_CH1 giriş yakalama, I2C1 üzerinde MPU6050
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    GPIO_InitStruct.Pin = OPTICAL_SENSOR_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(OPTICAL_SENSOR_PORT, &GPIO_InitStruct);
+
+    TIM_IC_InitTypeDef sConfigIC = {0};
+    htim2.Instance = TIM2;
+    htim2.Init.Prescaler = OPTICAL_IC_PRESCALER;
+    htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim2.Init.Period = 0xFFFF;
+    htim2.Init.ClockDivision = OPTICAL_IC_CLOCK_DIV;
+    HAL_TIM_IC_Init(&htim2);
+    sConfigIC.ICPolarity = TIM_ICPOLARITY_RISING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+    sConfigIC.ICFilter = OPTICAL_IC_FILTER;
+    HAL_TIM_IC_ConfigChannel(&htim2, &sConfigIC, OPTICAL_IC_CHANNEL);
+
+    huart2.Instance = USART2;
+    huart2.Init.BaudRate = 115200;
+    HAL_UART_Init(&huart2);
+    hdma_usart2_tx.Instance = DMA1_Channel7;
+    __HAL_LINKDMA(&huart2, hdmatx, hdma_usart2_tx);
+    UartLog_Init(&huart2);
+
+    // I2C1: hat yöneticisi, üzerinde MPU6050 (+ -L ile barometre). Kurulum
+    // yazmaları kuyruktan koşunun ilk milisaniyesinde çıkar
+    hi2c1.Instance = I2C1;
+    I2CBus_Init(&hi2c1, OpticalSensor_GetTimestamp);
+    if (cfg.i2c_fault > 0.0) SimHAL_I2C_SetFaultHook(I2C_FaultHook);
+    if (cfg.aux_hz > 0) {
+        SimHAL_I2C_AttachDevice(SIM_AUX_ADDR, aux_regs, sizeof(aux_regs));
+        aux_dev = I2CBus_AddDevice(SIM_AUX_ADDR, "BARO");
+    }
+    if (MPU6050_Init() != 0) {
+        fprintf(stderr, "MPU6050_Init başarısız\n");
+        return 1;
+    }
+    if (cfg.imu_fifo) {
+        // MPU6050 INT -> PB5 (EXTI, yükselen kenar)
+        GPIO_InitStruct.Pin = MPU6050_INT_PIN;
+        GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        HAL_GPIO_Init(MPU6050_INT_GPIO_PORT, &GPIO_InitStruct);
+        SimHAL_MPU6050_SetIntPin(MPU6050_INT_GPIO_PORT, MPU6050_INT_PIN);
+        if (MPU6050_FIFO_Start() != 0) {
+            fprintf(stderr, "MPU6050_FIFO_Start başarısız\n");
+            return 1;
+        }
+    }
+
+    Profiler_Init();
+    uint32_t write_gen0 = SharedData_Generation(); // Yazma probe'u buradan sayar
+    OpticalSensor_Init();
+    OpticalSensor_IC_Start(&htim2);
+    Fusion_Init(TunnelMap_Params()->start_offset, OpticalSensor_GetTimestamp());
+    EventLog_Init();
+    BrakeSupervisor_Init();
+
+    // ADC1: analog motoru NTC kanallarını ve akü gerilimini tek sırada tarar
+    // (main.c MX_ADC1_Init ile aynı; sıra Analog_Start'ta kurulur)
+    hadc1.Instance = ADC1;
+    hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+    hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+    AnalogChannelConfig_t battery = {
+        .channel = SIM_BATTERY_CHANNEL,
+        .sample_time = ADC_SAMPLETIME_55CYCLES_5,
+        .filter = ANALOG_FILTER_IIR,
+        .decimation_log2 = 0,
+        .iir_shift = SIM_BATTERY_IIR_SHIFT,
+    };
+    if (NTC_Init() != 0 || (battery_slot = Analog_Register(&battery)) < 0 ||
+        Analog_Start(&hadc1, OpticalSensor_GetTimestamp) != 0) {
+        fprintf(stderr, "Analog_Start başarısız\n");
+        return 1;
+    }
+
+    // main.c'deki tablonun host karşılığı: telemetri hızı komut satırından
+    SchedulerTask_t sim_tasks[] = {
+        { "acquisition", Sim_AcquisitionTask, 1, 0, SCHEDULER_NO_EVENT },
+        { "status", Status_Log, (uint16_t)(SIM_STATUS_PERIOD_NS / SIM_NS_PER_MS), 0, SCHEDULER_NO_EVENT },
+        { "thermal", Sim_ThermalTask, 20, 11, SCHEDULER_NO_EVENT },
+        { "edges", Sim_EdgeTask, 0, 0, SIM_EVENT_EDGE },
+    };
+    if (cfg.telemetry_hz > 0) {
+        sim_tasks[1] = (SchedulerTask_t){ "telemetry", Telemetry_Tick, 
+                                          (uint16_t)(cfg.telemetry_hz >= 1000U ? 1U : 1000U / cfg.telemetry_hz), 0,
+                                          SCHEDULER_NO_EVENT };
+    }
+    Scheduler_Init(sim_tasks, (uint8_t)(sizeof(sim_tasks) / sizeof(sim_tasks[0])), Host_SchedulerClock);
+    SimHAL_SetWakeHook(Sim_WakePending);
+    if (cfg.perfect_fixes) {
+        Fusion_SetSources(FUSION_SRC_EXTERNAL);
+    }
+
+    Track_Build();
+    double tunnel_end = Q16_TO_FLOAT(TunnelMap_Params()->end_position);
+    plant_x = Q16_TO_FLOAT(TunnelMap_Params()->start_offset);
+    enc_origin = plant_x;
+    IMU_Update();
+    SimHAL_Schedule(0, Plant_Step, NULL);
+    SimHAL_Schedule(SIM_IMU_PERIOD_NS, IMU_SampleEvent, NULL);
+
+    uint64_t wall_start = Host_Now_ns();
+    uint32_t tick_start = HAL_GetTick();
+    uint8_t overrun = 0;
+    stall_end = stall_start + (uint64_t)cfg.imu_stall_ms * SIM_NS_PER_MS;
+
+    // Ana döngü firmware'deki gibi yalnız dispatch: boşta __WFI sanal saati
+    // bir sonraki SysTick'e veya olay gönderen kesmeye kadar ilerletir
+    while (!plant_stopped && SimHAL_Now_ns() < SIM_TIME_LIMIT_NS) {
+        Scheduler_Dispatch();
+
+        if (plant_x >= tunnel_end) {
+            overrun = 1;
+            break;
+        }
+    }
+
+    uint32_t tick_end = HAL_GetTick();
+    uint64_t wall_ns = Host_Now_ns() - wall_start;
+    double sim_s = (double)SimHAL_Now_ns() / SIM_NS_PER_S;
+    double pos_err = (double)Q16_TO_FLOAT(VehicleState.current_position) - plant_x;
+
+    uint32_t imu_dr_end = imu_dr_index;  // Aşağıdaki UART boşaltması sırasında üretilenler sayılmaz
+    SimHAL_I2C_SetFaultHook(NULL);        // Enjekte edilen her hata aşağıdaki Poll'a kadar görülmeli
+
+    // Koşu bitti: kayıt donar. -D: menü 8 (flash) ve menü 7 (UART dökümü,
+    // test görevi gibi 10 ms'de bir adım)
+    FlightRecorder_Stop();
+    FlightRecStats_t rec_stats;
+    FlightRecorder_GetStats(&rec_stats);
+    uint32_t rec_size = FlightRecorder_ImageSize();
+    uint8_t rec_flash_ok = 1;
+    static uint8_t rec_image[FLIGHTREC_IMAGE_MAX];
+    FlightRecorder_Read(0, rec_image, rec_size);
+    if (cfg.record_path) {
+        rec_flash_ok = FlightRecorder_SaveFlash() == 0 &&
+                       memcmp(SimHAL_Flash(FLIGHTREC_FLASH_ADDR), rec_image, rec_size) == 0;
+        FILE *rec_out = fopen(cfg.record_path, "wb");
+        if (!rec_out) {
+            perror(cfg.record_path);
+            return 2;
+        }
+        // st-flash read gibi: ayrılmış alanın tamamı
+        fwrite(SimHAL_Flash(FLIGHTREC_FLASH_ADDR), 1, FLIGHTREC_FLASH_PAGES * FLASH_PAGE_SIZE, rec_out);
+        fclose(rec_out);
+
+        FlightRecorder_DumpStart();
+        while (FlightRecorder_DumpStep()) {
+            SimHAL_RunUntil(SimHAL_Now_ns() + 10ULL * SIM_NS_PER_MS);
+        }
+    }
+
+    // Olay logu: her blok ayrı çözülür, zamanla arama her bloğu bulmalı
+    EventLog_Stop();
+    EventLogStats_t ev_stats;
+    EventLog_GetStats(&ev_stats);
+    static uint8_t ev_image[EVLOG_BLOCKS * EVLOG_BLOCK_SIZE];
+    uint32_t ev_blocks = EventLog_BlockCount();
+    EventLog_Read(0, ev_image, ev_blocks * EVLOG_BLOCK_SIZE);
+    uint32_t ev_format_errors = 0, ev_seek_errors = 0;
+    for (uint32_t i = 0; i < ev_blocks; i++) {
+        const uint8_t *block = ev_image + i * EVLOG_BLOCK_SIZE;
+        ev_format_errors += EventLog_DecodeBlock(block, EventLog_Collect, NULL) != EVLOG_OK;
+        ev_seek_errors += EventLog_Seek(ev_image, ev_blocks, ((const EventLogBlock_t *)block)->time) != i;
+    }
+    uint32_t ev_imu = 0;
+    uint32_t ev_mismatch = EventLog_Verify(rec_image, &ev_imu);
+    if (cfg.evlog_path) {
+        FILE *ev_out = fopen(cfg.evlog_path, "wb");
+        if (!ev_out) {
+            perror(cfg.evlog_path);
+            return 2;
+        }
+        fwrite(ev_image, 1, ev_blocks * EVLOG_BLOCK_SIZE, ev_out);
+        fclose(ev_out);
+
+        EventLog_DumpStart();
+        while (EventLog_DumpStep()) {
+            SimHAL_RunUntil(SimHAL_Now_ns() + 10ULL * SIM_NS_PER_MS);
+        }
+    }
+
+    // UART halkasında kalanları hatta çıkar; son Poll koşu sonunda takılan
+    // transferin zaman aşımını da görür
+    SimHAL_RunUntil(SimHAL_Now_ns() + 200ULL * SIM_NS_PER_MS);
+    I2CBus_Poll();
+    if (csv) fclose(csv);
+    if (uart_out) fclose(uart_out);
+
+    printf("\n=== TÜNEL SİMÜLASYONU ===\n");
+    printf("Seyir hızı: %.2f m/s | ivme: %.2f m/s2 | fren: %.2f m/s2 | seed: %u\n",
+           cfg.cruise_speed, cfg.accel, cfg.brake_decel, cfg.seed);
+    printf("Sanal süre: %.3f s | duvar saati: %.3f s | hızlanma: %.0fx\n",
+           sim_s, (double)wall_ns / SIM_NS_PER_S, sim_s / ((double)wall_ns / SIM_NS_PER_S));
+    printf("Tünel haritası: %u işaret, %.1f m\n", (unsigned)TunnelMap_Count(), tunnel_end);
+    printf("Geçilen işaret: %u | firmware reflektör sayısı: %u\n",
+           markers_passed, (unsigned)VehicleState.reflector_count);
+    printf("Gerçek konum: %.3f m | firmware konumu: %.3f m | hata: %+.3f m\n",
+           plant_x, (double)Q16_TO_FLOAT(VehicleState.current_position), pos_err);
+    OpticalVelocity_t vel_info;
+    OpticalSensor_GetVelocity(&vel_info);
+    if (vel_err_n > 0) {
+        printf("Hız hatası (kenarlarda): RMS %.3f m/s | maks %.3f m/s | iki nokta RMS %.3f m/s, maks %.3f m/s | "
+               "artıkla reddedilen uydurma %u | ivme değişimi %u | yeniden kurulum %u/%u\n",
+               sqrt(vel_err_sq / vel_err_n), vel_err_max, sqrt(vel2_err_sq / vel_err_n), vel2_err_max,
+               (unsigned)vel_info.rejected, (unsigned)vel_info.restarts, (unsigned)vel_info.rebuilds,
+               (unsigned)vel_info.updates);
+        printf("  uydurmanın kullanıldığı %u kenarda: RMS %.4f m/s | aynı kenarlarda iki nokta %.4f m/s\n",
+               (unsigned)velfit_n, velfit_n > 0 ? sqrt(velfit_err_sq / velfit_n) : 0.0,
+               velfit_n > 0 ? sqrt(velfit_two_sq / velfit_n) : 0.0);
+    }
+    if (brake_cmd_ns != 0) {
+        printf("Fren komutu: t=%.3f s, x=%.3f m | duruş: %.3f m (tünel sonuna %.3f m)\n",
+               (double)brake_cmd_ns / SIM_NS_PER_S, brake_cmd_x, plant_x, tunnel_end - plant_x);
+    } else {
+        printf("Fren komutu verilmedi!\n");
+    }
+    if (overrun) printf("UYARI: Kapsül tünel sonunu geçti (%.3f m)\n", plant_x);
+
+    BrakeLog_t brake;
+    BrakeSupervisor_GetLog(&brake);
+    double stop_limit = Q16_TO_FLOAT(TunnelMap_StopLimit());
+    printf("Fren denetçisi: durum %u | komut x=%.3f m v=%.3f m/s (%s) | tahmini duruş %.3f m (gerçek %+.3f) | "
+           "pay %.3f m | karar gecikmesi %.2f ms | ölçülen yavaşlama %.2f m/s2 | frenlerken duruş %.3f m (gerçek %+.3f) | "
+           "değerlendirme %u (en uzun aralık %.2f ms)\n",
+           (unsigned)brake.state, (double)Q16_TO_FLOAT(brake.command_position),
+           (double)Q16_TO_FLOAT(brake.command_velocity), brake.source == BRAKE_SRC_FUSION ? "füzyon" : "optik",
+           (double)Q16_TO_FLOAT(brake.predicted_stop), plant_x - Q16_TO_FLOAT(brake.predicted_stop),
+           (double)Q16_TO_FLOAT(brake.command_margin), brake.decision_latency * 1000.0 / BRAKE_TICK_HZ,
+           (double)Q16_TO_FLOAT(brake.measured_decel), (double)Q16_TO_FLOAT(brake.braking_stop),
+           plant_x - Q16_TO_FLOAT(brake.braking_stop), (unsigned)brake.evaluations,
+           brake.max_period * 1000.0 / BRAKE_TICK_HZ);
+    // Plant en az denetçinin varsaydığı kadar iyi frenliyorsa duruş sınırı aşılmamalı
+    uint8_t plant_nominal = cfg.brake_decel >= Q16_TO_FLOAT(BRAKE_DECEL_NOMINAL) &&
+                            cfg.brake_latency * BRAKE_TICK_HZ <= BRAKE_ACTUATOR_LATENCY;
+    uint8_t brake_ok = brake_cmd_ns != 0 && !overrun &&
+                       (!plant_nominal || plant_x <= stop_limit + SIM_BRAKE_STOP_TOL);
+    printf("IMU hata bayrağı: %u | SharedData nesli: %u\n", (unsigned)VehicleState.imu_error_flag,
+           (unsigned)SharedData_Generation());
+    uint8_t imu_fixed_ok = imu_err_accel <= SIM_Q16_TOL && imu_err_gyro <= SIM_Q16_TOL &&
+                           imu_err_temp <= SIM_Q16_TOL;
+    printf("IMU Q16 / float farkı: ivme %.2e g | gyro %.2e dps | sıcaklık %.2e °C%s\n",
+           imu_err_accel, imu_err_gyro, imu_err_temp, imu_fixed_ok ? "" : "  <-- TOLERANS AŞILDI");
+
+    ImuFilterStats_t filt_stats;
+    ProfilerProbe_t filt_probe;
+    ImuFilter_GetStats(&filt_stats);
+    Profiler_GetProbe(PROF_IMU_FILTER, &filt_probe);
+    double filt_mean = filt_probe.count > 0 ? (double)filt_probe.total / filt_probe.count : 0.0;
+    double noise_raw[2], noise_filt[2];
+    for (uint8_t g = 0; g < 2; g++) {
+        noise_raw[g] = noise_raw_n > 0 ? sqrt(noise_raw_sq[g] / noise_raw_n) : 0.0;
+        noise_filt[g] = noise_filt_n > 0 ? sqrt(noise_filt_sq[g] / noise_filt_n) : 0.0;
+    }
+    printf("IMU filtresi: ivme %d Hz, jiroskop %d Hz, %u biquad, CIC R=%u -> %u Hz | giriş %u, çıkış %u | "
+           "referanstan sapma ivme %.2e g, gyro %.2e dps | RMS (gerçeği 0) ivme y %.2f -> %.2f mg, "
+           "gyro z %.3f -> %.3f dps | host saati ort %.0f, maks %lu döngü, bütçe %u (aşan %u)\n",
+           IMU_FILTER_ACCEL_HZ, IMU_FILTER_GYRO_HZ, IMU_FILTER_SECTIONS, IMU_FILTER_DECIM, IMU_FILTER_OUT_HZ,
+           (unsigned)filt_stats.inputs, (unsigned)filt_stats.outputs, filt_err[0], filt_err[1],
+           noise_raw[0] * 1e3, noise_filt[0] * 1e3, noise_raw[1], noise_filt[1], filt_mean,
+           (unsigned long)filt_probe.max, IMU_FILTER_CYCLE_BUDGET, (unsigned)filt_probe.over_budget);
+    // Sabit nokta zincir referansla aynı anlarda aynı sonucu vermeli. Host
+    // saatinde tek tek ölçümler OS kesmelerine açık: ortalama bütçe içinde,
+    // aşan çalışma %1'den az olmalı (hedefte menü 6 aynı sayacı gösterir)
+    uint8_t imu_filter_ok = filt_stats.outputs > 0 && filt_stats.inputs == ref_inputs &&
+                            filt_stats.outputs == ref_outputs && filt_ready_mismatch == 0 &&
+                            filt_err[0] <= SIM_IMU_FILTER_TOL &&
+                            filt_err[1] <= SIM_IMU_FILTER_TOL && filt_mean <= IMU_FILTER_CYCLE_BUDGET &&
+                            filt_probe.over_budget * 100U <= filt_probe.count;
+
+    // Yazma bölgesi: kesmelerin kapalı kaldığı süre. Aynı %1 payı (OS kesmeleri)
+    ProfilerProbe_t write_probe;
+    Profiler_GetProbe(PROF_SHARED_WRITE, &write_probe);
+    double write_mean = write_probe.count > 0 ? (double)write_probe.total / write_probe.count : 0.0;
+    uint8_t shared_write_ok = write_probe.count == SharedData_Generation() - write_gen0 &&
+                              write_mean <= PROFILER_SHARED_WRITE_BUDGET &&
+                              write_probe.over_budget * 100U <= write_probe.count;
+    printf("SharedData yazma bölgesi (kesme kapalı): %u bölge | host saati ort %.1f, maks %lu döngü, "
+           "bütçe %u (aşan %u)%s\n",
+           (unsigned)write_probe.count, write_mean, (unsigned long)write_probe.max,
+           PROFILER_SHARED_WRITE_BUDGET, (unsigned)write_probe.over_budget,
+           shared_write_ok ? "" : "  <-- BÜTÇE AŞILDI");
+
+    printf("\nHost profili:\n");
+    Profile_Print("OpticalSensor_IC_CaptureCb", &prof_exti);
+    Profile_Print("I2CBus_*Callback", &prof_i2c);
+    Profile_Print("MPU6050_INT_Callback", &prof_imu_int);
+    Profile_Print("MPU6050_FIFO_Process", &prof_imu_batch);
+    Profile_Print("Fusion_ImuSample", &prof_fusion);
+    Profile_Print("SharedData_Snapshot", &prof_snapshot);
+    Profile_Print("OpticalSensor_Process", &prof_process);
+    Profile_Print("BrakeSupervisor_Update", &prof_brake);
+    Profile_Print("Analog_DMA_Callback", &prof_analog);
+    Profile_Print("UartLog_Write", &prof_log);
+    Profile_Print("Telemetry_Send", &prof_telemetry);
+
+    // Firmware'in kendi probeları (main.c menü 6 ile aynı döküm). Dışarıdan
+    // ölçülen çağrı sayılarıyla aynı olmalı: her Begin'in End'i var
+    Profiler_Dump();
+    ProfilerProbe_t probe;
+    FusionStats_t probe_fus;
+    Fusion_GetStats(&probe_fus);
+    uint8_t probes_ok = 1;
+    Profiler_GetProbe(PROF_OPTICAL_CAPTURE, &probe);
+    probes_ok &= probe.count == prof_exti.count;
+    Profiler_GetProbe(PROF_I2C_BUS, &probe);
+    probes_ok &= probe.count == prof_i2c.count;
+    Profiler_GetProbe(PROF_IMU_INT, &probe);
+    probes_ok &= probe.count == prof_imu_int.count;
+    Profiler_GetProbe(PROF_FUSION_IMU, &probe);
+    probes_ok &= probe.count + probe_fus.stale_samples == prof_fusion.count;
+    Profiler_GetProbe(PROF_BRAKE, &probe);
+    probes_ok &= probe.count == prof_brake.count;
+    Profiler_GetProbe(PROF_ANALOG_DMA, &probe);
+    probes_ok &= probe.count == prof_analog.count;
+    ProfilerProbe_t evlog_probe;
+    Profiler_GetProbe(PROF_EVLOG, &evlog_probe);
+    probes_ok &= evlog_probe.count == prof_fusion.count;
+    probes_ok &= filt_probe.count == filt_stats.inputs;
+    probes_ok &= shared_write_ok;
+
+    UartLogStats_t log_stats;
+    UartLog_GetStats(&log_stats);
+    printf("UART log: %u byte, %u DMA transferi, atılan %u mesaj, en yüksek doluluk %u/%u\n",
+           (unsigned)log_stats.written_bytes, (unsigned)log_stats.dma_transfers,
+           (unsigned)log_stats.dropped_msgs, (unsigned)log_stats.high_water, UART_LOG_BUF_SIZE);
+
+    MPU6050_FifoStats_t imu_stats;
+    MPU6050_GetFifoStats(&imu_stats);
+    uint8_t imu_fifo_ok = 1;
+    if (cfg.imu_fifo) {
+        printf("IMU FIFO: INT %u | çevrilen %u | burst %u | taşma %u | kayıp %u (seq boşluğu %u) | "
+               "başlatılamayan okuma %u | ts düzeltme %u | en çok bekleyen %u\n",
+               (unsigned)imu_dr_end, (unsigned)imu_stats.samples, (unsigned)imu_stats.bursts,
+               (unsigned)imu_stats.fifo_overflows, (unsigned)imu_stats.lost_samples,
+               (unsigned)imu_seq_gaps, (unsigned)imu_stats.dropped_reads,
+               (unsigned)imu_stats.ts_resyncs, (unsigned)imu_stats.max_backlog);
+        // Her kayıp firmware tarafından sayılmış olmalı, zaman damgaları INT anıyla aynı olmalı
+        imu_fifo_ok = imu_ts_errors == 0 && imu_seq_gaps == imu_stats.lost_samples &&
+                      imu_rx_samples + imu_stats.lost_samples + 2 * MPU6050_FIFO_BATCH + MPU6050_FIFO_MAX_SAMPLES >= imu_dr_end;
+        if (imu_ts_errors > 0) printf("  <-- %u örnekte zaman damgası/seq uyuşmuyor\n", (unsigned)imu_ts_errors);
+    } else {
+        printf("IMU tek örnek: çevrilen %u | eklenmeyen okuma (önceki bekliyor) %u | hatalı okuma %u\n",
+               (unsigned)imu_stats.samples, (unsigned)imu_stats.dropped_reads, (unsigned)imu_stats.read_errors);
+    }
+
+    // I2C hattı: kabul edilen her transfer ya bitmiş ya bekliyor olmalı.
+    // Hatasız koşuda hata/ret yok ve IMU en çok bir düşük öncelikli okuma
+    // kadar bekler; -I ile her enjekte hata tam bir kez sayılmalı, IMU
+    // okumalarının çoğu yine tamamlanmalı (IMU okuması tekrarsız: hata oranının
+    // iki katından fazlası kaybolmamalı).
+    I2CBusStats_t bus;
+    I2CBus_GetStats(&bus);
+    double i2c_wait_max_us = (SIM_AUX_LEN + 3U) * 9.0 * 1e6 / SIM_I2C_HZ + SIM_I2C_WAIT_MARGIN_US;
+    uint32_t injected = i2c_injected[SIM_I2C_FAULT_NACK] + i2c_injected[SIM_I2C_FAULT_BERR] +
+                        i2c_injected[SIM_I2C_FAULT_STUCK];
+    printf("I2C hattı: transfer %u | NACK %u | hat hatası %u | zaman aşımı %u | kurtarma %u | kapanma %u (%u ms) | "
+           "en derin kuyruk %u | enjekte NACK/hat/takılma %u/%u/%u\n",
+           (unsigned)bus.transfers, (unsigned)bus.nacks, (unsigned)bus.bus_errors, (unsigned)bus.timeouts,
+           (unsigned)bus.recoveries, (unsigned)bus.offline, (unsigned)bus.offline_ms, (unsigned)bus.max_depth,
+           (unsigned)i2c_injected[SIM_I2C_FAULT_NACK], (unsigned)i2c_injected[SIM_I2C_FAULT_BERR],
+           (unsigned)i2c_injected[SIM_I2C_FAULT_STUCK]);
+    uint8_t i2c_ok = MPU6050_GetState() == MPU6050_STATE_READY && aux_bad == 0 && (cfg.aux_hz == 0 || aux_good > 0);
+    for (uint8_t d = 0; d < I2CBus_DeviceCount(); d++) {
+        I2CBusDeviceStats_t dev;
+        I2CBus_GetDeviceStats(d, &dev);
+        double wait_us = (double)dev.max_wait * 1e6 / OPTICAL_IC_TICK_HZ;
+        int64_t pending = (int64_t)dev.queued - dev.completed - dev.errors;
+        printf("  %-8s 0x%02X: kuyruğa %u | tamam %u | ret %u | hata %u | tekrar %u | bekleyen %lld | "
+               "en uzun bekleme %.0f us\n",
+               dev.name, (unsigned)dev.addr, (unsigned)dev.queued, (unsigned)dev.completed, (unsigned)dev.dropped,
+               (unsigned)dev.errors, (unsigned)dev.retries, (long long)pending, wait_us);
+        i2c_ok &= pending >= 0 && pending <= I2C_BUS_PRIORITIES * I2C_BUS_QUEUE_DEPTH + 1;
+        if (injected == 0) {
+            i2c_ok &= dev.errors == 0 && dev.dropped == 0;
+            if (dev.addr == MPU6050_ADDR) i2c_ok &= wait_us <= i2c_wait_max_us;
+        } else if (dev.addr == MPU6050_ADDR) {
+            i2c_ok &= dev.completed >= dev.queued * (1.0 - 2.0 * cfg.i2c_fault);
+        }
+    }
+    if (cfg.aux_hz > 0) {
+        printf("  barometre %u Hz: doğru okuma %u, YANLIŞ %u\n", (unsigned)cfg.aux_hz, (unsigned)aux_good,
+               (unsigned)aux_bad);
+    }
+    i2c_ok &= bus.nacks == i2c_injected[SIM_I2C_FAULT_NACK] && bus.bus_errors == i2c_injected[SIM_I2C_FAULT_BERR] &&
+              bus.timeouts == i2c_injected[SIM_I2C_FAULT_STUCK] && (injected > 0 || bus.recoveries == 0);
+
+    FusionStats_t fus_stats;
+    Fusion_GetStats(&fus_stats);
+    double fus_pos_rms = sqrt(fus_pos_err_sq / fus_n);
+    double fus_3sigma = (double)fus_in_3sigma / fus_n;
+    double bias_est = Q16_TO_FLOAT(VehicleState.nav.accel_bias);
+    printf("Füzyon (%s düzeltme): konum RMS %.3f m (maks %.3f) | hız RMS %.3f m/s | "
+           "3σ içinde %%%.1f | yalnız optik konum RMS %.3f m\n",
+           cfg.perfect_fixes ? "gerçek" : "optik", fus_pos_rms, fus_pos_err_max,
+           sqrt(fus_vel_err_sq / fus_n), 100.0 * fus_3sigma, sqrt(opt_pos_err_sq / fus_n));
+    printf("  sapma tahmini %.4f m/s2 (gerçek %.4f) | σ konum %.4f m | düzeltme %u (geç %u, zorla %u, "
+           "yok sayılan %u) | kapıda atılan %u (kapısız %u, en büyük r²/S %.2f) | sıfır hız %u | eski IMU örneği %u (yeni örneksiz tur %u) | boşluk %u\n",
+           bias_est, cfg.imu_bias, sqrt(VehicleState.nav.cov[0]), (unsigned)fus_stats.fixes,
+           (unsigned)fus_stats.late_fixes, (unsigned)fus_stats.forced_fixes, (unsigned)fus_stats.ignored_fixes,
+           (unsigned)fus_stats.rejected_fixes, (unsigned)fus_stats.forced_gate, (double)fus_stats.max_nis,
+           (unsigned)fus_stats.zero_velocity,
+           (unsigned)fus_stats.stale_samples, (unsigned)sim_imu_repeats, (unsigned)fus_stats.gaps);
+    // Optik kapı sayımı koruyorsa inovasyon kapısı hiç zorlanmamalı
+    uint8_t fusion_ok = fus_pos_rms <= SIM_FUSION_POS_RMS_MAX && fus_3sigma >= SIM_FUSION_3SIGMA_MIN &&
+                        fabs(bias_est - cfg.imu_bias) <= SIM_FUSION_BIAS_TOL && fus_stats.forced_gate == 0;
+
+    StripDecoderStats_t strip_stats;
+    OpticalMarkerStats_t marker_stats;
+    StripDecoder_GetStats(&strip_stats);
+    OpticalSensor_GetMarkerStats(&marker_stats);
+    const TunnelMarker_t *last_marker = TunnelMap_Marker((uint16_t)last_marker_seen);
+    printf("Şerit çözücü: grup %u, çözülen %u, reddedilen %u | atlanan şerit %u, çıkarılan %u | "
+           "son güven %u | hizalama %u (tahminle çelişen %u) | bekletilen kenar %u | atlanan şerit sayımı %u\n",
+           (unsigned)strip_stats.bursts, (unsigned)strip_stats.decoded, (unsigned)strip_stats.rejected,
+           (unsigned)strips_dropped, (unsigned)strip_stats.missing, (unsigned)marker_stats.last_confidence,
+           (unsigned)marker_stats.strip_resyncs, (unsigned)marker_stats.strip_rejected, (unsigned)marker_stats.held_edges,
+           (unsigned)marker_stats.skipped_strips);
+    // Sayım her durumda görülen son işarette bitmeli; şerit kaybı yoksa her grup çözülmeli
+    // (ağır kayıpta 1-2 kenar kalan grup güvenle eşleşmeyebilir, bu beklenen)
+    uint8_t strips_ok = (cfg.strip_miss > 0.0 || strip_stats.decoded == TunnelMap_Params()->zone_count) &&
+                        last_marker != NULL && VehicleState.current_position == last_marker->position &&
+                        VehicleState.reflector_count == last_marker->reflector_seq;
+
+    uint32_t reflectors_dropped = Track_DroppedBefore(last_marker_seen);
+    uint32_t q_overflow, q_high, q_faults;
+    OpticalSensor_GetQueueStats(&q_overflow, &q_high, &q_faults);
+    printf("Kenar kapısı: kabul %u | red %u (parlama %u) | çıkarılan reflektör %u (düşürülen %u) | "
+           "yeniden yakalama %u\n",
+           (unsigned)marker_stats.gate_accepted, (unsigned)marker_stats.gate_rejected, (unsigned)glints_passed,
+           (unsigned)marker_stats.gate_inferred, (unsigned)reflectors_dropped,
+           (unsigned)marker_stats.gate_reacquired);
+    // Her parlama reddedilmeli, her kayıp reflektör aralıktan çıkarılmalı; temiz
+    // pistte kapı hiçbir kenara dokunmamalı. Kenar kuyruğuna yalnız yakalama
+    // kesmesi yazar (edge_queue.h)
+    uint8_t gate_ok = marker_stats.gate_rejected == glints_passed &&
+                      marker_stats.gate_inferred == reflectors_dropped &&
+                      marker_stats.gate_reacquired == 0 && q_faults == 0;
+
+    EncoderStats_t enc_stats;
+    q16_t enc_distance, enc_velocity;
+    Encoder_GetStats(&enc_stats);
+    Encoder_Get(&enc_distance, &enc_velocity);
+    double enc_dist_err = Q16_TO_FLOAT(enc_distance) - (plant_x - enc_origin);
+    double enc_vel_rms = enc_n > 0 ? sqrt(enc_vel_err_sq / enc_n) : 0.0;
+    printf("Enkoder: mesafe %.4f m (hata %+.5f) | hız RMS %.4f m/s (maks %.4f) | M/T %u | sınırlanan %u | "
+           "en büyük adım %u sayım\n",
+           (double)Q16_TO_FLOAT(enc_distance), enc_dist_err, enc_vel_rms, enc_vel_err_max,
+           (unsigned)enc_stats.mt_updates, (unsigned)enc_stats.bounded, (unsigned)enc_stats.max_step);
+    uint8_t encoder_ok = enc_vel_rms <= SIM_ENCODER_VEL_RMS_MAX &&
+                         fabs(enc_dist_err) <= SIM_ENCODER_DIST_TOL;
+
+    AnalogStats_t analog_stats;
+    AnalogBlock_t analog_block;
+    Analog_GetStats(&analog_stats);
+    Analog_Read(&analog_block);
+    printf("Analog: %u kanal | kesme %u, yarım tampon %u (%.2f ms) | akü IIR %u sonuç, hata maks %.2f LSB\n",
+           (unsigned)analog_stats.channels, (unsigned)analog_callbacks, (unsigned)analog_stats.halves,
+           analog_stats.half_ticks * 1e3 / OPTICAL_IC_TICK_HZ, (unsigned)analog_block.updates[battery_slot],
+           battery_err_max);
+    // Kanal eklemek kesme eklemez: DMA kesmesi başına tam bir yarım tampon
+    uint8_t analog_ok = analog_stats.halves > 0 && analog_stats.halves == analog_callbacks &&
+                        analog_block.updates[battery_slot] == analog_stats.halves &&
+                        battery_err_max <= SIM_BATTERY_TOL;
+
+    NtcStats_t ntc_stats;
+    NTC_GetStats(&ntc_stats);
+    printf("NTC: hata maks %.3f °C (RMS %.3f) | set %u, işlenen %u, kaçırılan %u | "
+           "aşırı sıcaklık kalkış %u (gerçek %.2f °C), iniş %u (gerçek %.2f °C) | arıza 0x%02X\n",
+           ntc_err_max, ntc_n > 0 ? sqrt(ntc_err_sq / ntc_n) : 0.0,
+           (unsigned)analog_block.updates[0], (unsigned)ntc_stats.processed, (unsigned)ntc_stats.missed,
+           (unsigned)ntc_sets, ntc_set_truth, (unsigned)ntc_clears, ntc_clear_truth, (unsigned)ntc_fault_seen);
+    // Sıcak kanal sınırı bir kez geçip histerezis altına iner; takılı olmayan
+    // kanal arıza, diğerleri hiç bayrak kaldırmaz
+    uint8_t ntc_ok = ntc_n > 0 && ntc_err_max <= SIM_NTC_TOL && ntc_stats.missed == 0 &&
+                     ntc_sets == 1 && ntc_clears == 1 &&
+                     ntc_set_truth >= Q16_TO_FLOAT(NTC_OVERTEMP_C) - SIM_NTC_TOL &&
+                     ntc_clear_truth <= Q16_TO_FLOAT(NTC_OVERTEMP_CLEAR_C) + SIM_NTC_TOL &&
+                     ntc_overtemp_seen == (1U << SIM_NTC_HOT_CHANNEL) &&
+                     ntc_fault_seen == (1U << SIM_NTC_OPEN_CHANNEL) &&
+                     VehicleState.ntc_fault == (1U << SIM_NTC_OPEN_CHANNEL);
+
+    printf("Kenar kuyruğu: taşma %u | en yüksek doluluk %u | üretici çakışması %u\n", (unsigned)q_overflow,
+           (unsigned)q_high, (unsigned)q_faults);
+
+    SchedulerStats_t sched;
+    SchedulerTaskStats_t acq, aux, edge_task;
+    Scheduler_GetStats(&sched);
+    Scheduler_GetTaskStats(0, &acq);
+    Scheduler_GetTaskStats(1, &aux);
+    Scheduler_GetTaskStats(3, &edge_task);
+    uint32_t elapsed_ticks = tick_end - tick_start;
+    printf("Zamanlayıcı: tick %u (görülmeyen %u) | acquisition %u çalışma, WCET %.1f us, atlanan %u | "
+           "%s %u çalışma, WCET %.1f us, atlanan %u\n",
+           (unsigned)sched.ticks, (unsigned)sched.missed_ticks, (unsigned)acq.runs,
+           acq.wcet * 1e6 / SCHEDULER_CLOCK_HZ, (unsigned)acq.overruns,
+           cfg.telemetry_hz > 0 ? "telemetry" : "status", (unsigned)aux.runs,
+           aux.wcet * 1e6 / SCHEDULER_CLOCK_HZ, (unsigned)aux.overruns);
+    printf("Uyku: %u uyanış | kenar olayı %u (görev %u) | olaydan göreve en uzun %.1f us sanal, "
+           "%.1f us host | boşta (host saati) %%%.1f\n",
+           (unsigned)sched.wakeups, (unsigned)sched.events, (unsigned)edge_task.runs, edge_wake_max_ns / 1e3,
+           edge_task.max_latency * 1e6 / SCHEDULER_CLOCK_HZ,
+           sched.elapsed ? 100.0 * (double)sched.idle / (double)sched.elapsed : 0.0);
+    // WFI her SysTick'te uyanıyor: hiçbir tick ve salınım kaçmamalı. Kenar
+    // olayı tick beklemeden, kesmenin çalıştığı sanal anda işlenmeli.
+    uint8_t sched_ok = sched.ticks == elapsed_ticks && acq.runs == elapsed_ticks && sched.missed_ticks == 0 &&
+                       acq.overruns == 0 && aux.overruns == 0 && sched.wakeups >= sched.ticks &&
+                       edge_task.runs > 0 && edge_task.runs == sched.events && edge_wake_max_ns == 0;
+
+    printf("Uçuş kaydı: %u kayıt (IMU örneği %u) | ezilen %u | görüntü %u/%u byte%s\n",
+           (unsigned)rec_stats.records, (unsigned)rec_stats.imu_samples, (unsigned)rec_stats.dropped,
+           (unsigned)rec_size, (unsigned)FLIGHTREC_IMAGE_MAX,
+           cfg.record_path ? (rec_flash_ok ? " | flash eşleşiyor" : " | FLASH FARKLI") : "");
+    // Koşunun tamamı sığmalı: başı ezilen kayıt oynatılamaz
+    uint8_t recorder_ok = rec_stats.dropped == 0 && rec_flash_ok;
+
+    // Geçmiş: kapanmış bloklardaki IMU örneklerinin ham saklamada kaplayacağı
+    // yer / blokların boyu (açık blok koşunun bittiği ana göre yarım kalır)
+    uint32_t ev_imu_closed = 0;
+    uint32_t ev_open_seq = ev_blocks > 0 ? ((const EventLogBlock_t *)(ev_image + (ev_blocks - 1U) * EVLOG_BLOCK_SIZE))->seq : 0;
+    for (uint32_t i = 0; i < evlog_dec_n; i++) {
+        ev_imu_closed += evlog_dec[i].type == EVLOG_REC_IMU && evlog_dec[i].seq < ev_open_seq;
+    }
+    double ev_ratio = ev_blocks > 1 ? (double)ev_imu_closed * EVLOG_RAW_SAMPLE_BYTES / ((ev_blocks - 1U) * EVLOG_BLOCK_SIZE) : 0.0;
+    double ev_span = ev_imu > 0 ? (double)(evlog_shadow[(evlog_fed - 1U) % SIM_EVLOG_SHADOW].timestamp -
+                                           evlog_shadow[(evlog_fed - ev_imu) % SIM_EVLOG_SHADOW].timestamp) /
+                                  OPTICAL_IC_TICK_HZ : 0.0;
+    printf("Olay logu: IMU %u, olay %u | blok %u açıldı, %u atıldı | tamponda %u IMU örneği (%.3f s), "
+           "%.2f byte/örnek -> ham saklamanın %.1fx'i | kaçış %u | kodlayıcı (host saati) ort %lu, maks %lu döngü | "
+           "çözüm: %s\n",
+           (unsigned)ev_stats.imu_samples, (unsigned)ev_stats.events, (unsigned)ev_stats.blocks,
+           (unsigned)ev_stats.dropped_blocks, (unsigned)ev_imu, ev_span,
+           ev_imu_closed > 0 ? (double)EVLOG_RAW_SAMPLE_BYTES / ev_ratio : 0.0, ev_ratio,
+           (unsigned)ev_stats.escapes,
+           evlog_probe.count > 0 ? (unsigned long)(evlog_probe.total / evlog_probe.count) : 0UL,
+           (unsigned long)evlog_probe.max,
+           (ev_format_errors == 0 && ev_seek_errors == 0 && ev_mismatch == 0) ? "aynı" : "FARKLI");
+    if (ev_format_errors + ev_seek_errors + ev_mismatch > 0) {
+        printf("  <-- bozuk blok %u, arama hatası %u, uyuşmayan kayıt %u\n", (unsigned)ev_format_errors,
+               (unsigned)ev_seek_errors, (unsigned)ev_mismatch);
+    }
+    // Halka dolmuş olmalı (koşu tampondan uzun) ve hedef oran tutmalı (-W
+    // titreşiminde de: öngörücü onu izler). -I'nın kaybettirdiği örnekler seq
+    // boşluğu olarak kaçış kodlarına girdiği için o koşularda yalnız
+    // kayıpsızlık aranır
+    uint8_t evlog_ok = ev_format_errors == 0 && ev_seek_errors == 0 && ev_mismatch == 0 &&
+                       ev_stats.dropped_blocks > 0 && (cfg.i2c_fault > 0.0 || ev_ratio >= SIM_EVLOG_MIN_RATIO);
+
+    // Kenar titreşimi belirginse uydurma, kullanıldığı kenarlarda iki noktayı
+    // velocity_fit_test'teki oranla yenmeli (titreşimsiz koşuda ikisi de ~0)
+    uint8_t velfit_ok = cfg.edge_jitter < SIM_VELFIT_RUN_JITTER || velfit_n < SIM_VELFIT_RUN_MIN ||
+                        velfit_err_sq <= SIM_VELFIT_NOISE_RATIO * SIM_VELFIT_NOISE_RATIO * velfit_two_sq;
+    uint8_t tolerance_ok = cfg.tolerance < 0.0 || (!overrun && fabs(pos_err) <= cfg.tolerance);
+    if (cfg.result_path) {
+        uint32_t fail = (probes_ok ? 0 : SIM_FAIL_PROBES) |
+                        (sched_ok ? 0 : SIM_FAIL_SCHED) | (analog_ok ? 0 : SIM_FAIL_ANALOG) |
+                        (ntc_ok ? 0 : SIM_FAIL_NTC) | (encoder_ok ? 0 : SIM_FAIL_ENCODER) |
+                        (brake_ok ? 0 : SIM_FAIL_BRAKE) | (gate_ok ? 0 : SIM_FAIL_GATE) |
+                        (strips_ok ? 0 : SIM_FAIL_STRIPS) | (fusion_ok ? 0 : SIM_FAIL_FUSION) |
+                        (imu_fifo_ok ? 0 : SIM_FAIL_IMU_FIFO) | (imu_fixed_ok ? 0 : SIM_FAIL_IMU_FIXED) |
+                        (imu_filter_ok ? 0 : SIM_FAIL_IMU_FILTER) | (recorder_ok ? 0 : SIM_FAIL_RECORDER) | (evlog_ok ? 0 : SIM_FAIL_EVLOG) |
+                        (i2c_ok ? 0 : SIM_FAIL_I2C) | (velfit_ok ? 0 : SIM_FAIL_VELFIT) |
+                        (tolerance_ok ? 0 : SIM_FAIL_TOLERANCE);
+        // Fren noktası hatası: komut anında firmware'in konumu - gerçek konum
+        double brake_point_err = brake_cmd_ns != 0 ? Q16_TO_FLOAT(brake.command_position) - brake_cmd_x : NAN;
+        FILE *res = fopen(cfg.result_path, "w");
+        if (!res) {
+            perror(cfg.result_path);
+            return 2;
+        }
+        fprintf(res, SIM_RESULT_FORMAT, cfg.seed, cfg.cruise_speed, cfg.accel, cfg.brake_decel,
+                cfg.brake_latency, pos_err, Fusion_PositionNow(&VehicleState.nav) - plant_x, brake_point_err, plant_x - Q16_TO_FLOAT(brake.predicted_stop),
+                stop_limit - plant_x, vel_err_n > 0 ? sqrt(vel_err_sq / vel_err_n) : 0.0, vel_err_max,
+                fus_pos_rms, (unsigned)fail);
+        fclose(res);
+    }
+
+    if (!probes_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (profil probeları sayımı)\n");
+        return 1;
+    }
+    if (!sched_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (zamanlayıcı)\n");
+        return 1;
+    }
+    if (!analog_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (analog toplama motoru)\n");
+        return 1;
+    }
+    if (!ntc_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (NTC sıcaklık izleme)\n");
+        return 1;
+    }
+    if (!encoder_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (enkoder)\n");
+        return 1;
+    }
+    if (!brake_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (fren denetçisi, duruş sınırı %.3f m)\n", stop_limit);
+        return 1;
+    }
+    if (!gate_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (kenar kapısı)\n");
+        return 1;
+    }
+    if (!strips_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (şerit çözücü / işaret sayımı)\n");
+        return 1;
+    }
+    if (!fusion_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (füzyon doğruluğu)\n");
+        return 1;
+    }
+    if (!imu_fifo_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (IMU FIFO)\n");
+        return 1;
+    }
+    if (!imu_fixed_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (IMU sabit nokta çevrimi)\n");
+        return 1;
+    }
+    if (!imu_filter_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (IMU filtresi)\n");
+        return 1;
+    }
+    if (!recorder_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (uçuş kaydedici)\n");
+        return 1;
+    }
+    if (!evlog_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (olay logu)\n");
+        return 1;
+    }
+    if (!i2c_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (I2C hattı)\n");
+        return 1;
+    }
+    if (!velfit_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (hız uydurma titreşimli kenarlarda)\n");
+        return 1;
+    }
+    if (!tolerance_ok) {
+        printf("\nSONUÇ: BAŞARISIZ (tolerans %.3f m)\n", cfg.tolerance);
+        return 1;
+    }
+    return 0;
+}
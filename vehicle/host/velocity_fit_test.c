@@ -0,0 +1,242 @@
+/*
+ * velocity_fit_test.c
+ *
+ * Optik hız uydurmasının (velocity_fit.c) host testi: sentetik reflektör
+ * dizileri (SIM_VELFIT_PITCH aralıklı, IC sayacı koşu ortasında döner)
+ * uydurmaya ve iki noktalı dist/dt'ye aynı kenarlarla verilir. Kenar
+ * titreşiminde uydurma sabit hızda iki noktadan az gürültülü, sabit ivmede
+ * hem az gürültülü hem gecikmesiz olmalı; titreşimsiz sabit hızda iki nokta
+ * kadar kesin olmalı (zaman birimine yuvarlama düzeltilir). Çok yavaş hızda
+ * pencere sayaç dönüşünü aşmalı, tek işarete verilen yanlış konum (sayım
+ * kayması) pencereyi yeniden başlatıp kabul edilen uydurmaya girmemeli.
+ *
+ * Tam sayı çözüm ayrıca rastgele pencerelerde (hız, ivme, işaret aralığı,
+ * titreşim, nokta sayısı) aynı toplam çerçevesinin long double en küçük
+ * kareler çözümüyle karşılaştırılır.
+ *
+ * Kullanım: velocity_fit_test
+ * Çıkış kodu: 0 geçti, 1 başarısız
+ */
+
+#include "velocity_fit.h"
+#include "optical_sensor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define SIM_VELFIT_PITCH        4.0       // m
+#define SIM_VELFIT_JITTER       100e-6    // s, kenar zamanı gürültüsü (1 sigma)
+#define SIM_VELFIT_NOISE_RATIO  0.6       // Sabit hızda uydurma RMS'i iki noktanınkinin en çok bu katı
+#define SIM_VELFIT_LAG_TOL      0.002     // m/s, sabit ivmede uydurmanın ortalama hatası
+#define SIM_VELFIT_ACCEL_TOL    0.1       // m/s2, sabit ivmede (zaman çerçevesi 2^14 birim çözünürlük)
+#define SIM_VELFIT_SLIP_TOL     0.05      // m/s, sayım kaymasında kabul edilen uydurmanın en büyük hatası
+#define SIM_VELFIT_TEST_BASE    0xF0000000U // IC sayacı ~34 s sonra döner
+#define SIM_VELFIT_CLEAN_TOL    0.0005    // m/s, titreşimsiz sabit hızda uydurmanın RMS'i
+#define SIM_VELFIT_REF_RUNS     2000U     // Referansla karşılaştırılan rastgele dizi
+#define SIM_VELFIT_REF_V_LSB    1.0       // Q16 LSB, hızın referanstan farkı
+#define SIM_VELFIT_REF_A_LSB    1.0       // Q16 LSB, ivme (+ bağıl SIM_VELFIT_REF_A_REL)
+#define SIM_VELFIT_REF_A_REL    1e-6      // ivmede merkezlenmiş momentlerin yuvarlaması
+#define SIM_VELFIT_REF_R_LSB    1.0       // Q16 LSB, artık RMS'i
+
+static uint32_t velfit_rng = 12345U;
+
+// Yaklaşık normal gürültü (4 düzgün toplamı)
+static double Xorshift_Noise(uint32_t *rng, double sigma) {
+    double sum = 0.0;
+    for (int i = 0; i < 4; i++) {
+        *rng ^= *rng << 13;
+        *rng ^= *rng >> 17;
+        *rng ^= *rng << 5;
+        sum += (double)*rng / 4294967296.0;
+    }
+    return (sum - 2.0) * sigma * sqrt(3.0);
+}
+
+typedef struct {
+    double fit_sq, fit_sum, fit_max;   // En yeni kenardaki hız hatası (uydurma)
+    double two_sq, two_sum;            // Aynı kenarda iki noktalı dist/dt
+    double accel_max;                  // Uydurma ivmesinin en büyük hatası
+    double residual_max;               // Temiz pencerelerde en büyük artık
+    uint32_t n;                        // Dolu pencereyle çözülen kenar
+    uint32_t flagged;                  // Artık VELFIT_MAX_RESIDUAL'ı aştı
+    uint32_t restarts;                 // İvme değişimi sayılıp pencere yeniden başladı
+} VelFitTest_t;
+
+// x = v0*t + a*t^2/2 hareketinde SIM_VELFIT_PITCH aralıklı işaretler. bad_edge
+// indeksli işarete bir aralık ileri konum verilir (sayım kayması).
+static void VelFit_TestRun(VelFit_t *f, double v0, double a, double jitter, uint32_t edges, int32_t bad_edge,
+                           VelFitTest_t *r) {
+    uint32_t prev_ts = 0;
+    VelFit_Init(f);
+    *r = (VelFitTest_t){0};
+
+    for (uint32_t k = 0; k < edges; k++) {
+        double x = k * SIM_VELFIT_PITCH;
+        double t = (a == 0.0) ? x / v0 : (sqrt(v0 * v0 + 2.0 * a * x) - v0) / a;
+        double v = v0 + a * t;
+        uint32_t ts = SIM_VELFIT_TEST_BASE +
+                      (uint32_t)llround((t + Xorshift_Noise(&velfit_rng, jitter)) * OPTICAL_IC_TICK_HZ);
+        double pos = x + ((int32_t)k == bad_edge ? SIM_VELFIT_PITCH : 0.0);
+        VelFit_Add(f, ts, (q16_t)llround(pos * 65536.0));
+
+        double two = SIM_VELFIT_PITCH * OPTICAL_IC_TICK_HZ / (double)(uint32_t)(ts - prev_ts);
+        prev_ts = ts;
+        VelFitResult_t fit;
+        if (k < VELFIT_WINDOW || !VelFit_Solve(f, &fit)) continue;
+
+        if (fit.residual > VELFIT_MAX_RESIDUAL) {
+            r->flagged++;
+            continue;
+        }
+        double err = Q16_TO_FLOAT(fit.velocity) - v;
+        r->fit_sq += err * err;
+        r->fit_sum += err;
+        if (fabs(err) > r->fit_max) r->fit_max = fabs(err);
+        r->two_sq += (two - v) * (two - v);
+        r->two_sum += two - v;
+        if (fabs(Q16_TO_FLOAT(fit.accel) - a) > r->accel_max) r->accel_max = fabs(Q16_TO_FLOAT(fit.accel) - a);
+        if (Q16_TO_FLOAT(fit.residual) > r->residual_max) r->residual_max = Q16_TO_FLOAT(fit.residual);
+        r->n++;
+    }
+    r->restarts = f->restarts;
+}
+
+// Firmware'in çözdüğü problemin kendisi: penceredeki (u, xc - x0) çiftlerine
+// long double ikinci derece uydurma, Q16 birimlerle. Dönüş: 0 çözüm yok
+static int VelFit_Reference(const VelFit_t *f, long double *v, long double *a, long double *res) {
+    long double u[VELFIT_WINDOW], d[VELFIT_WINDOW], um = 0.0L, dm = 0.0L;
+    uint32_t n = f->n;
+    for (uint32_t i = 0; i < n; i++) {
+        uint8_t j = (uint8_t)((f->head + VELFIT_WINDOW - n + i) % VELFIT_WINDOW);
+        int64_t dt = (int32_t)(f->t[j] - f->t0);
+        u[i] = (long double)(f->shift ? (dt + (1LL << (f->shift - 1U))) >> f->shift : dt);
+        d[i] = (long double)((int64_t)f->xc[j] - f->x0);
+        um += u[i] / n;
+        dm += d[i] / n;
+    }
+    // Merkezlenmiş normal denklemler: [c2 c3; c3 c4 - c2^2/n] [b1; b2] = [cd1; cd2]
+    long double c2 = 0, c3 = 0, c4 = 0, cd1 = 0, cd2 = 0, dd = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        long double tau = u[i] - um, y = d[i] - dm;
+        c2 += tau * tau;
+        c3 += tau * tau * tau;
+        c4 += tau * tau * tau * tau;
+        cd1 += tau * y;
+        cd2 += tau * tau * y;           // sum y = 0: (tau^2 - c2/n)*y ile aynı
+        dd += y * y;
+    }
+    long double e4 = c4 - c2 * c2 / n, det = c2 * e4 - c3 * c3;
+    if (c2 <= 0.0L || det <= 0.0L) return 0;
+    long double b2 = (c2 * cd2 - c3 * cd1) / det;
+    long double b1 = (cd1 - c3 * b2) / c2;
+    long double per_s = (long double)OPTICAL_IC_TICK_HZ / (long double)(1UL << f->shift);
+    long double sse = dd - b1 * cd1 - b2 * cd2;
+    *v = (b1 + 2.0L * b2 * (u[n - 1U] - um)) * per_s;
+    *a = 2.0L * b2 * per_s * per_s;
+    *res = (n > 3U && sse > 0.0L) ? sqrtl(sse / (n - 3U)) : 0.0L;
+    return 1;
+}
+
+typedef struct {
+    uint32_t n;
+    double v_max, a_max, r_max;        // En büyük fark (Q16 LSB, bağıl pay düşülmüş)
+} VelFitRef_t;
+
+// Rastgele hareket: hız 0.3..60 m/s, ivme ±6 m/s2 (hız 0.2 m/s'nin altına
+// inmez), işaret aralığı 0.05..4 m, titreşim 0..200 us, sayaç dönüşü rastgele
+static void VelFit_RefRun(uint32_t seed, VelFitRef_t *r) {
+    uint32_t rng = seed * 2654435761U + 1U;
+    VelFit_t f;
+    VelFit_Init(&f);
+    srand(seed);
+    double v0 = 0.3 + 59.7 * rand() / RAND_MAX;
+    double a = -6.0 + 12.0 * rand() / RAND_MAX;
+    double pitch = (rand() & 1) ? 4.0 : 0.05 + 0.5 * rand() / RAND_MAX;
+    double jitter = 200e-6 * rand() / RAND_MAX;
+    uint32_t base = (uint32_t)rand() * 2654435761U;
+    double x = 0.0, t = 0.0, v = v0;
+
+    for (uint32_t k = 0; k < 40U && v > 0.2; k++) {
+        uint32_t ts = base + (uint32_t)llround((t + Xorshift_Noise(&rng, jitter)) * OPTICAL_IC_TICK_HZ);
+        VelFit_Add(&f, ts, (q16_t)llround(x * 65536.0));
+        VelFitResult_t fit;
+        long double rv, ra, rr;
+        if (VelFit_Solve(&f, &fit) && VelFit_Reference(&f, &rv, &ra, &rr)) {
+            double ev = fabs(fit.velocity - (double)rv);
+            double ea = fabs(fit.accel - (double)ra) - SIM_VELFIT_REF_A_REL * fabs((double)ra);
+            double er = fabs(fit.residual - (double)rr);
+            if (ev > r->v_max) r->v_max = ev;
+            if (ea > r->a_max) r->a_max = ea;
+            if (er > r->r_max) r->r_max = er;
+            r->n++;
+        }
+        // Sonraki işaret: x + pitch'e varış
+        double disc = v * v + 2.0 * a * pitch;
+        if (disc <= 0.04) break;
+        double dt = (a == 0.0) ? pitch / v : (sqrt(disc) - v) / a;
+        t += dt;
+        v += a * dt;
+        x += pitch;
+    }
+}
+
+int main(void) {
+    VelFit_t f;
+    VelFitTest_t noise, clean, lag, lag_jit, slow, slip;
+
+    // 1. Gürültü: 20 m/s sabit, kenar zamanında 100 us titreşim
+    VelFit_TestRun(&f, 20.0, 0.0, SIM_VELFIT_JITTER, 400, -1, &noise);
+    uint32_t updates = f.updates, rebuilds = f.rebuilds;
+    double noise_fit = sqrt(noise.fit_sq / noise.n), noise_two = sqrt(noise.two_sq / noise.n);
+
+    // 2. Titreşimsiz 8 m/s: iki nokta kesin; uydurma da (zaman birimine
+    //    yuvarlamanın kalanı düzeltilir)
+    VelFit_TestRun(&f, 8.0, 0.0, 0.0, 100, -1, &clean);
+    double clean_fit = sqrt(clean.fit_sq / clean.n), clean_two = sqrt(clean.two_sq / clean.n);
+
+    // 3. Gecikme: 2 m/s'den 3 m/s^2 ile ~50 m/s'ye. İki nokta aralığın
+    //    ortasındaki hızı verir (a*dt/2 geride), uydurma en yeni kenarınkini.
+    //    Titreşimsiz ve 100 us titreşimle
+    VelFit_TestRun(&f, 2.0, 3.0, 0.0, 100, -1, &lag);
+    VelFit_TestRun(&f, 2.0, 3.0, SIM_VELFIT_JITTER, 100, -1, &lag_jit);
+    double lag_fit = sqrt(lag_jit.fit_sq / lag_jit.n), lag_two = sqrt(lag_jit.two_sq / lag_jit.n);
+
+    // 4. Yavaş: 0.5 m/s, işaret başına 8 s; pencere 56 s, IC sayacı arada döner
+    VelFit_TestRun(&f, 0.5, 0.0, 0.0, 30, -1, &slow);
+
+    // 5. Sayım kayması: tek işarete yanlış konum. Öngörüden sapan nokta
+    //    pencereyi yeniden başlatır (girişte ve çıkışta); yanlış noktalı
+    //    uydurma kabul edilmemeli
+    VelFit_TestRun(&f, 10.0, 0.0, SIM_VELFIT_JITTER, 60, 30, &slip);
+
+    // 6. Tam sayı çözüm, aynı çerçevenin long double çözümüne karşı
+    VelFitRef_t ref = {0};
+    for (uint32_t i = 1; i <= SIM_VELFIT_REF_RUNS; i++) VelFit_RefRun(i, &ref);
+
+    uint8_t noise_ok = noise.n > 0 && noise_fit <= SIM_VELFIT_NOISE_RATIO * noise_two && noise.restarts == 0 &&
+                       rebuilds * (VELFIT_WINDOW - 1U) <= updates + VELFIT_WINDOW;
+    uint8_t clean_ok = clean.n > 0 && clean_fit <= SIM_VELFIT_CLEAN_TOL && clean.restarts == 0;
+    uint8_t lag_ok = lag.n > 0 && fabs(lag.fit_sum / lag.n) <= SIM_VELFIT_LAG_TOL &&
+                     lag.accel_max <= SIM_VELFIT_ACCEL_TOL && lag.restarts == 0 &&
+                     lag_jit.n > 0 && fabs(lag_jit.fit_sum / lag_jit.n) <= SIM_VELFIT_LAG_TOL &&
+                     fabs(lag_jit.two_sum / lag_jit.n) > 10.0 * SIM_VELFIT_LAG_TOL &&
+                     lag_fit <= SIM_VELFIT_NOISE_RATIO * lag_two;
+    uint8_t edge_ok = slow.n > 0 && slow.fit_max <= 1e-3 && slip.restarts == 2U &&
+                      slip.fit_max <= SIM_VELFIT_SLIP_TOL && slip.residual_max < Q16_TO_FLOAT(VELFIT_MAX_RESIDUAL);
+    uint8_t ref_ok = ref.n > 0 && ref.v_max <= SIM_VELFIT_REF_V_LSB && ref.a_max <= SIM_VELFIT_REF_A_LSB &&
+                     ref.r_max <= SIM_VELFIT_REF_R_LSB;
+
+    printf("Hız uydurma: titreşimde RMS %.4f m/s (iki nokta %.4f)%s | titreşimsiz %.5f m/s (iki nokta %.5f)%s\n",
+           noise_fit, noise_two, noise_ok ? "" : "  <-- HATALI", clean_fit, clean_two, clean_ok ? "" : "  <-- HATALI");
+    printf("  sabit ivmede ort. hata %+.4f m/s (iki nokta %+.4f), ivme hatası %.4f m/s2 | titreşimle ort. %+.4f "
+           "(iki nokta %+.4f), RMS %.4f (iki nokta %.4f)%s\n",
+           lag.fit_sum / lag.n, lag.two_sum / lag.n, lag.accel_max, lag_jit.fit_sum / lag_jit.n,
+           lag_jit.two_sum / lag_jit.n, lag_fit, lag_two, lag_ok ? "" : "  <-- HATALI");
+    printf("  yavaş %.5f m/s | kayma: yeniden başlama %u, en büyük hata %.4f m/s | yeniden kurulum %u/%u%s\n",
+           slow.fit_max, (unsigned)slip.restarts, slip.fit_max, (unsigned)rebuilds, (unsigned)updates,
+           edge_ok ? "" : "  <-- HATALI");
+    printf("  double referans: %u çözüm, en büyük fark hız %.2f, ivme %.2f, artık %.2f LSB%s\n", (unsigned)ref.n,
+           ref.v_max, ref.a_max, ref.r_max, ref_ok ? "" : "  <-- HATALI");
+    return (noise_ok && clean_ok && lag_ok && edge_ok && ref_ok) ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/*
+ * analog.h
+ *
+ * Ortak ADC/DMA toplama motoru. Analog sensörler (NTC, ileride fren basıncı,
+ * akü gerilimi) ADC'yi kendileri sürmez: açılışta kanallarını, örnekleme
+ * sürelerini ve filtrelerini Analog_Register ile bildirir. Analog_Start tek
+ * bir tarama sırası kurar, ADC1 sürekli modda bu sırayı çevirir, DMA
+ * sonuçları dairesel tampona yazar.
+ *
+ * Kesme sayısı kanal sayısından bağımsızdır: tampon başına yarım ve tam
+ * transfer olmak üzere iki kesme. Her kesmede o yarının örnekleri kanal
+ * başına toplanır, ardından her kanalın filtresi bir adım ilerler:
+ *   - ANALOG_FILTER_AVERAGE: 2^decimation_log2 yarım boyunca toplam, sonra
+ *     tek değer (kutu ortalama + seyreltme).
+ *   - ANALOG_FILTER_IIR: her yarımın ortalaması birinci derece alçak
+ *     geçirenden geçer, 2^decimation_log2 yarımda bir yayınlanır.
+ * Değerler 16 bit aşırı örneklenmiş koddur (12 bit + 4 bit kesir).
+ *
+ * Sonuçlar çift tamponlu bir blokta yayınlanır: kesme arka bloğu yazıp
+ * indeksi çevirir, okuyucu ön bloğu kesme kapatmadan kopyalar. Her kanal
+ * değerinin yanında ait olduğu an (ortalama penceresinin ortası) ve
+ * kanalın ürettiği sonuç sayısı bulunur; tüketici yeni değeri ve kaçırdığı
+ * sonuçları bu sayaçtan anlar.
+ */
+
+#ifndef ANALOG_H
+#define ANALOG_H
+
+#include "stm32f1xx_hal.h"
+
+#define ANALOG_MAX_CHANNELS      8U
+#define ANALOG_SEQ_PER_HALF      32U       // Yarım tampondaki tarama sayısı
+#define ANALOG_SEQ_SHIFT         5U        // log2(ANALOG_SEQ_PER_HALF)
+#define ANALOG_MAX_DECIMATION    10U       // 2^10 yarım x 32 x 4095 < 2^32
+#define ANALOG_DMA_MAX           (2U * ANALOG_SEQ_PER_HALF * ANALOG_MAX_CHANNELS)
+
+#if ANALOG_SEQ_PER_HALF != (1U << ANALOG_SEQ_SHIFT)
+#error "ANALOG_SEQ_SHIFT, ANALOG_SEQ_PER_HALF ile uyumlu değil"
+#endif
+
+// Kanal filtresi
+#define ANALOG_FILTER_AVERAGE    0U
+#define ANALOG_FILTER_IIR        1U
+
+typedef struct {
+    uint32_t channel;          // ADC_CHANNEL_x
+    uint32_t sample_time;      // ADC_SAMPLETIME_x (kaynak empedansına göre)
+    uint8_t filter;            // ANALOG_FILTER_*
+    uint8_t decimation_log2;   // Sonuç her 2^n yarım tamponda bir (n <= ANALOG_MAX_DECIMATION)
+    uint8_t iir_shift;         // IIR: y += (x - y) / 2^k, yarım tampon başına
+} AnalogChannelConfig_t;
+
+// Yayınlanan sonuç bloğu; indeksler Analog_Register'ın döndürdüğü yuva
+typedef struct {
+    uint32_t seq;                            // Her yarım tamponda +1
+    uint32_t timestamp;                      // Yarım tamponun bittiği an (Analog_Start saati)
+    uint16_t value[ANALOG_MAX_CHANNELS];     // 16 bit kod (0..65520)
+    uint32_t time[ANALOG_MAX_CHANNELS];      // Değerin ait olduğu an: pencere ortası
+    uint32_t updates[ANALOG_MAX_CHANNELS];   // Kanalın ürettiği sonuç sayısı
+} AnalogBlock_t;
+
+typedef struct {
+    uint8_t channels;          // Kayıtlı kanal
+    uint32_t halves;           // İşlenen yarım tampon (= DMA kesmesi)
+    uint32_t half_ticks;       // Son yarım tamponun süresi
+    uint32_t read_retries;     // Kopya sırasında iki yayın geçti, okuma tekrarlandı
+} AnalogStats_t;
+
+/**
+ * @brief Bir kanalı tarama sırasına ekler. Analog_Start'tan önce çağrılır.
+ * @return Kanalın bloktaki yuvası, -1: yer yok / ayar geçersiz / motor çalışıyor
+ */
+int8_t Analog_Register(const AnalogChannelConfig_t *config);
+
+/**
+ * @brief Tarama sırasını kurar, kalibre eder ve dairesel DMA'yı başlatır.
+ * @param hadc MX_ADC1_Init'te dairesel, yarım kelime DMA bağlanmış ADC1;
+ *             tarama/sürekli mod ve sıra uzunluğu burada ayarlanır
+ * @param clock Zaman damgası saati (OpticalSensor_GetTimestamp), NULL: HAL_GetTick
+ * @return 0: Başarılı, 1: kanal yok ya da HAL hatası
+ */
+uint8_t Analog_Start(ADC_HandleTypeDef *hadc, uint32_t (*clock)(void));
+
+/**
+ * @brief HAL_ADC_ConvHalfCpltCallback / HAL_ADC_ConvCpltCallback içinden.
+ */
+void Analog_HalfCallback(ADC_HandleTypeDef *hadc);
+void Analog_CpltCallback(ADC_HandleTypeDef *hadc);
+
+/**
+ * @brief Son yayınlanan bloğu kopyalar (kesme kapatmaz).
+ * @return Bloğun seq değeri
+ */
+uint32_t Analog_Read(AnalogBlock_t *out);
+
+void Analog_GetStats(AnalogStats_t *stats);
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * brake_supervisor.h
+ *
+ * Fren denetçisi: sabit hızda (BRAKE_SUPERVISOR_HZ) çağrılır, güncel konum
+ * ve hızdan tahmini duruş noktasını hesaplar:
+ *   duruş = x + aktüatör gecikmesi boyunca alınan yol (o anki ivmeyle)
+ *             + v_L^2 / (2 * a_fren)
+ * a_fren: fren ölçülmeden BRAKE_DECEL_PLAN (garanti edilen yavaşlamanın
+ * altında: aşınmış/ıslak frende de tünelde durmak için). Fren tuttuktan
+ * BRAKE_DECEL_SETTLE_TICKS sonra başlayıp BRAKE_DECEL_MEASURE_TICKS boyunca
+ * ölçülen ortalama yavaşlama ile BRAKE_DECEL_NOMINAL'ın küçüğü. Optik kapı
+ * da frenlerken kat edilen yolu bu yavaşlamayla tahmin eder.
+ * Bir sonraki değerlendirmede duruş noktası tünel sınırını
+ * (end_position - stop_margin) geçecekse fren şimdi komut edilir: sabit bir
+ * konum eşiği yerine hıza göre en geç güvenli an.
+ *
+ * Konum/hız füzyon tahmininden (taze ise), yoksa son optik güncellemeden
+ * ileri taşınarak alınır. Her koşu için karar anı, tahminin yaşı, komut
+ * anındaki pay, ölçülen yavaşlama ve gerçek duruş noktası kaydedilir
+ * (BrakeLog_t, UART'a iki satır): agresifliği veriden ayarlamak için.
+ */
+
+#ifndef BRAKE_SUPERVISOR_H
+#define BRAKE_SUPERVISOR_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+// Zaman damgaları TIM2 giriş yakalama saatiyle aynı (OPTICAL_IC_TICK_HZ)
+#define BRAKE_TICK_HZ             8000000U
+#define BRAKE_SUPERVISOR_HZ       1000U
+#define BRAKE_PERIOD_TICKS        (BRAKE_TICK_HZ / BRAKE_SUPERVISOR_HZ)
+
+// --- Araç parametreleri ---
+#define BRAKE_DECEL_NOMINAL       Q16_FROM_FLOAT(4.0f)   // m/s^2, frenin garanti ettiği yavaşlama
+#ifndef BRAKE_DECEL_PLAN
+#define BRAKE_DECEL_PLAN          Q16_FROM_FLOAT(3.5f)   // m/s^2, karar anında varsayılan (nominalin ~%12 altı)
+#endif
+#define BRAKE_ACTUATOR_LATENCY    (BRAKE_TICK_HZ / 20U)  // Komut -> fiziksel frenleme (50 ms)
+#define BRAKE_DECEL_SETTLE_TICKS  (BRAKE_TICK_HZ / 20U)  // Fren tuttuktan sonra ölçüm başlangıcı (kestirim gecikmesi)
+#define BRAKE_DECEL_MEASURE_TICKS (BRAKE_TICK_HZ / 10U)  // Ölçülen yavaşlama bu kadar ölçümden sonra geçerli
+#define BRAKE_DECEL_STEP          Q16_FROM_FLOAT(0.05f)  // Kullanılan yavaşlama bundan küçük değişimde güncellenmez
+
+// Füzyon tahmini bundan eskiyse (IMU kopmuş) optik konuma dönülür
+#define BRAKE_MAX_ESTIMATE_AGE    (BRAKE_TICK_HZ / 20U)
+#define BRAKE_STOP_VELOCITY       Q16_FROM_FLOAT(0.05f)  // Bunun altında durmuş sayılır
+
+// Denetçi durumu
+#define BRAKE_STATE_ARMED         0U
+#define BRAKE_STATE_COMMANDED     1U
+#define BRAKE_STATE_STOPPED       2U
+
+// Tahmin kaynağı
+#define BRAKE_SRC_FUSION          0U
+#define BRAKE_SRC_OPTICAL         1U
+
+typedef struct {
+    uint8_t state;              // BRAKE_STATE_*
+    uint8_t source;             // Komut anındaki tahmin kaynağı (BRAKE_SRC_*)
+    uint32_t evaluations;
+    uint32_t max_period;        // İki değerlendirme arasındaki en uzun süre (tick)
+    uint32_t command_time;      // Komut anı (tick)
+    q16_t command_position;     // m
+    q16_t command_velocity;     // m/s
+    q16_t predicted_stop;       // Komut anında tahmin edilen duruş noktası (m)
+    q16_t command_margin;       // Sınır - tahmini duruş (m); >= 0: zamanında
+    uint32_t decision_latency;  // Komutta kullanılan tahminin yaşı (tick)
+    q16_t measured_decel;       // Fren devreye girdikten sonra ölçülen (m/s^2)
+    q16_t braking_stop;         // Yavaşlama ölçülünce a_fren ile ilk duruş tahmini (m)
+    q16_t stop_position;        // Durulan konum (m)
+    q16_t stop_margin;          // Tünel sonu - durulan konum (m)
+} BrakeLog_t;
+
+void BrakeSupervisor_Init(void);
+
+/**
+ * @brief Bir değerlendirme. BRAKE_SUPERVISOR_HZ hızında çağrılmalı; fren
+ * kararında VehicleState.system_status = SYS_BRAKING yazılır.
+ * @param now Şimdiki an (OpticalSensor_GetTimestamp)
+ */
+void BrakeSupervisor_Update(uint32_t now);
+
+/**
+ * @brief Duruş noktası tahmini (denetçinin kullandığı formül).
+ * @param accel Şimdiki ivme (m/s^2), gecikme süresince sabit varsayılır
+ * @param decel Fren tuttuktan sonraki yavaşlama (m/s^2, > 0)
+ */
+q16_t BrakeSupervisor_PredictStop(q16_t position, q16_t velocity, q16_t accel, q16_t decel);
+
+
+void BrakeSupervisor_GetLog(BrakeLog_t *log);
+
+#endif
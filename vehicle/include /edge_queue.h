@@ -0,0 +1,104 @@
+/*
+ * edge_queue.h
+ *
+ * ISR -> ana döngü arası kilitsiz kenar olayı kuyruğu.
+ * Tek üretici (TIM2 yakalama kesmesi) / tek tüketici (OpticalSensor_Process).
+ * head sadece üretici, tail sadece tüketici tarafından yazılır; kesme
+ * kapatmaya gerek yoktur. Push/Pop ISR içinde çağrıldığı için inline.
+ *
+ * İkinci bir üretici (ör. ana döngüden yazılımla kenar) yakalama kesmesiyle
+ * aynı slotu yazabilir; yazılımla üretilen kenarlar kuyruğu kullanmaz
+ * (OpticalSensor_SoftwareEdge). Push iç içe girerse (bir üretici diğerini
+ * kesmişse) içteki olay yazılmaz, producer_faults sayılır: sıfır kalmalı.
+ */
+
+#ifndef EDGE_QUEUE_H
+#define EDGE_QUEUE_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+#define EDGE_QUEUE_SIZE   32U   // 2'nin kuvveti olmalı
+#define EDGE_QUEUE_MASK   (EDGE_QUEUE_SIZE - 1U)
+
+#if (EDGE_QUEUE_SIZE & EDGE_QUEUE_MASK) != 0
+#error "EDGE_QUEUE_SIZE 2'nin kuvveti olmalı"
+#endif
+
+typedef struct {
+    uint32_t timestamp;   // Genişletilmiş IC sayacı (OPTICAL_IC_TICK_HZ)
+} EdgeEvent_t;
+
+typedef struct {
+    EdgeEvent_t buf[EDGE_QUEUE_SIZE];
+    volatile uint32_t head;            // Yazma indeksi (serbest sayım)
+    volatile uint32_t tail;            // Okuma indeksi (serbest sayım)
+    volatile uint32_t overflow_count;  // Kuyruk doluyken kaybolan olaylar
+    volatile uint32_t high_water;      // Görülen en yüksek doluluk
+    volatile uint32_t producer_faults; // İç içe Push (tek üretici ihlali)
+    volatile uint8_t pushing;          // Push sürüyor
+} EdgeQueue_t;
+
+static inline void EdgeQueue_Init(EdgeQueue_t *q) {
+    q->head = 0;
+    q->tail = 0;
+    q->overflow_count = 0;
+    q->high_water = 0;
+    q->producer_faults = 0;
+    q->pushing = 0;
+}
+
+/**
+ * @brief Üretici (ISR) tarafı. Kuyruk doluysa olay düşürülür ve sayılır.
+ * Başka bir Push'un ortasında çağrıldıysa olay düşürülür, producer_faults
+ * sayılır (kesilen Push'un slotu ve head'i bozulmaz).
+ * @return 0: Başarılı, 1: Kuyruk dolu ya da ikinci üretici
+ */
+static inline uint8_t EdgeQueue_Push(EdgeQueue_t *q, uint32_t timestamp) {
+    if (q->pushing) {
+        q->producer_faults++;
+        return 1;
+    }
+    q->pushing = 1U;
+
+    uint32_t head = q->head;
+    uint32_t used = head - q->tail;
+
+    if (used >= EDGE_QUEUE_SIZE) {
+        q->overflow_count++;
+        q->pushing = 0U;
+        return 1;
+    }
+
+    q->buf[head & EDGE_QUEUE_MASK].timestamp = timestamp;
+    __DMB();                 // Veri, indeksten önce görünür olmalı
+    q->head = head + 1U;
+
+    if (used + 1U > q->high_water) {
+        q->high_water = used + 1U;
+    }
+    q->pushing = 0U;
+    return 0;
+}
+
+/**
+ * @brief Tüketici (ana döngü) tarafı.
+ * @return 1: Olay alındı, 0: Kuyruk boş
+ */
+static inline uint8_t EdgeQueue_Pop(EdgeQueue_t *q, EdgeEvent_t *out) {
+    uint32_t tail = q->tail;
+
+    if (tail == q->head) return 0;
+
+    __DMB();                 // head okunduktan sonra veri okunmalı
+    *out = q->buf[tail & EDGE_QUEUE_MASK];
+    __DMB();                 // Veri okunmadan slot serbest bırakılmamalı
+    q->tail = tail + 1U;
+    return 1;
+}
+
+static inline uint32_t EdgeQueue_Count(const EdgeQueue_t *q) {
+    return q->head - q->tail;
+}
+
+#endif
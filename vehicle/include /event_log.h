@@ -0,0 +1,165 @@
+/*
+ * event_log.h
+ *
+ * Sıkıştırılmış olay logu: 1 kHz IMU örneklerini ve sensör olaylarını (optik
+ * kenarlar) RAM'deki sabit bir tamponda mümkün olan en uzun geçmişle tutar.
+ * Ham saklamada örnek başına 32 byte gider (4 byte zaman + IMU_Data_t); 4 KB
+ * tampon 128 örnek = 0.13 s eder. Burada örnek ~5-6 byte'a iner (kapsül
+ * titreşiminde de).
+ *
+ * Kodlama:
+ *   - IMU kanalları Q16 yerine sensörün ham sayımlarıyla saklanır: sürücü
+ *     sayımları örnekle birlikte yayınlar (VehicleState.imu_raw_counts,
+ *     IMU_Sample_t.counts), log onları olduğu gibi alır. Q16'da bir LSB
+ *     jiroskopta ~500 birimdir.
+ *   - Her değer bir öngörücüye göre fark olarak yazılır. Zaman: önceki
+ *     örnek artı periyot; örnek anı DMA bitişinde alındığından hat beklemesi
+ *     tek bir örneği geciktirebilir, bu gecikme sonraki öngörüden düşülür
+ *     ve fark ya zamanında olmaya ya son gecikmeye göre (kısa olan) yazılır.
+ *     Kanal öngörüsü yavaş bir üstel ortalama (EVLOG_EMA_SHIFT)
+ *     artı son iki sapmanın uyarlanan ağırlıklı toplamıdır (iki katsayılı
+ *     NLMS): beyaz gürültüde katsayılar ~0 kalır ve öngörü ortalamadır,
+ *     titreşim gibi dar bantlı bir bileşende ikinci dereceden özyinelemeye
+ *     (x[n] ~ 2cos(w) x[n-1] - x[n-2]) yakınsar. Geçmişe ham örnek yerine
+ *     öngörüyle hatanın ortası yazılır (EVLOG_SMOOTH_SHIFT): gürültü geçmiş
+ *     üzerinden öngörüye daha az taşınır. Hepsi tam sayı; çözücü aynı
+ *     adımları birebir tekrarlar.
+ *   - Fark zig-zag ile işaretsize çevrilir ve Rice koduyla yazılır: q = zz >> k
+ *     tekli (q adet 1 + 0), ardından k alt bit. k her bağlam için son
+ *     değerlerin ortalamasından uyarlanır. q EVLOG_RICE_ESCAPE'e ulaşırsa
+ *     (fren darbesi gibi) değer 7 bitlik varint olarak yazılır.
+ *   - Kayıt başına etiket: 0 = IMU, 1 + 2 bit = olay tipi.
+ *
+ * Bloklar: tampon EVLOG_BLOCK_SIZE'lık bloklardan oluşan bir halkadır. Her
+ * blok bir başlık ve anahtar kareyle (öngörücü durumu byte varint, Rice k
+ * değerleri birer nibble) başlar; bu yüzden her blok tek başına
+ * çözülür (EventLog_Seek ile zamana göre rastgele erişim). Anahtar kare
+ * durumu yuvarlar (ortalama tam sayıma, katsayı 8 bite, geçmiş
+ * EVLOG_KF_HIST_SHIFT'e); kodlayıcı da yuvarlanmış durumdan devam eder.
+ * Kanal başına beş değer taşıdığı için blok 1 KB: anahtar kare bloğun ~%5'i.
+ * Halka dolunca en eski blok atılır. Açık blok her kayıttan sonra
+ * çözülebilir durumdadır.
+ *
+ * Görüntü (döküm ve host'a aktarım): bloklar eskiden yeniye, her biri
+ * EVLOG_BLOCK_SIZE byte. Çözücü (EventLog_DecodeBlock) firmware kodudur,
+ * host'taki evlog_decode ve tunnel_sim aynı kodu kullanır.
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdint.h>
+#include "shared_data.h"
+#include "sensors/imu.h"
+
+#define EVLOG_BLOCK_SIZE         1024U  // Rastgele erişim adımı (~0.18 s IMU)
+#define EVLOG_BLOCKS             4U     // 4096 byte RAM
+#define EVLOG_RAW_SAMPLE_BYTES   (4U + sizeof(IMU_Data_t))  // Karşılaştırma: ham saklama
+
+#define EVLOG_PRED_SHIFT         4      // Kanal ortalaması Q4 tutulur
+#define EVLOG_TIME_TRACK         16     // Bu kadar tıklık zaman farkı periyoda eklenir (saat kayması)
+#define EVLOG_TIME_ADAPT_MAX     64U    // IMU zamanı k uyarlamasına en çok bu kadar girer
+#define EVLOG_EMA_SHIFT          4      // Üstel ortalama katsayısı 1/16 (titreşimi izlemez)
+#define EVLOG_COEF_SHIFT         14     // NLMS katsayıları Q14 (|c| < 2)
+#define EVLOG_NLMS_SHIFT         5      // Adım ~2^-5 (geçmişin enerjisine göre normalize)
+#define EVLOG_SMOOTH_SHIFT       1      // Geçmişe öngörü + hata / 2
+#define EVLOG_KF_HIST_SHIFT      3      // Anahtar karede geçmişin çözünürlüğü (8 sayım)
+#define EVLOG_RICE_SHIFT         4      // k uyarlaması ~16 değerlik pencere
+#define EVLOG_RICE_ESCAPE        20U    // Bu kadar 1'den sonra varint gelir
+
+// UART dökümü: "EL <ofset> <hex> <crc>" satırı başına byte
+#define EVLOG_DUMP_CHUNK         32U
+
+// Olay tipleri (2 bit)
+#define EVLOG_EV_EDGE            0U     // value = kenardan sonraki reflector_count
+#define EVLOG_EV_TYPES           4U
+#define EVLOG_REC_IMU            EVLOG_EV_TYPES  // Çözülen kaydın tipi: IMU örneği
+
+// EventLog_DecodeBlock dönüşü
+#define EVLOG_OK                 0U
+#define EVLOG_ERR_FORMAT         1U     // Başlık/anahtar kare tutarsız veya akış blok dışına taşıyor
+
+typedef struct {
+    uint32_t seq;          // Bloğun ilk kaydının sıra numarası (Init'ten beri)
+    uint32_t time;         // Anahtar karedeki son IMU zamanı (EventLog_Seek için)
+    uint16_t records;
+    uint16_t bits;         // Anahtar kareden sonraki bit akışının uzunluğu
+} EventLogBlock_t;
+
+typedef struct {
+    uint32_t seq;
+    uint8_t type;          // EVLOG_EV_* veya EVLOG_REC_IMU
+    uint32_t time;         // 8 MHz TIM2 tick
+    int16_t raw[MPU6050_RAW_AXES];  // IMU: ham sayımlar (MPU6050_FromRaw ile Q16)
+    int32_t value;         // Olay: tipine göre değer
+} EventLogRecord_t;
+
+typedef void (*EventLogSink_t)(const EventLogRecord_t *rec, void *ctx);
+
+typedef struct {
+    uint32_t records;          // Yazılan toplam kayıt
+    uint32_t imu_samples;
+    uint32_t events;
+    uint32_t blocks;           // Açılan blok
+    uint32_t dropped_blocks;   // Halka dolunca atılan (en eski) blok
+    uint32_t dropped_records;
+    uint32_t escapes;          // Varint'e kaçan değer
+} EventLogStats_t;
+
+/**
+ * @brief Tamponu boşaltır ve kaydı başlatır.
+ */
+void EventLog_Init(void);
+
+/**
+ * @brief Kaydı durdurur (döküm donmuş tamponu okur). Init yeniden başlatır.
+ */
+void EventLog_Stop(void);
+
+/**
+ * @brief IMU örneği (ana döngüden, füzyona verilen her örnek).
+ * @param raw Sensör sayımları, MPU6050_RAW_AXES adet (register sırası)
+ */
+void EventLog_Imu(const int16_t *raw, uint32_t timestamp);
+
+/**
+ * @brief Sensör olayı; zamanı son IMU örneğine göre, değeri aynı tipin bir
+ * önceki değerine göre fark olarak yazılır.
+ */
+void EventLog_Event(uint8_t type, uint32_t time, int32_t value);
+
+/**
+ * @brief Görüntüdeki blok sayısı (eskiden yeniye).
+ */
+uint32_t EventLog_BlockCount(void);
+
+/**
+ * @brief Görüntünün [offset, offset + len) aralığını kopyalar.
+ * @return Kopyalanan byte
+ */
+uint32_t EventLog_Read(uint32_t offset, uint8_t *out, uint32_t len);
+
+/**
+ * @brief Tek bloğu çözer, her kayıt için sink çağrılır. Firmware'de
+ * kullanılmaz; host araçları için burada (telemetri çözücüsü gibi).
+ * @return EVLOG_OK veya EVLOG_ERR_FORMAT
+ */
+uint8_t EventLog_DecodeBlock(const uint8_t *block, EventLogSink_t sink, void *ctx);
+
+/**
+ * @brief Görüntüde time anını içeren bloğu bulur (ikili arama).
+ * @return Blok indeksi; time ilk bloktan önceyse 0
+ */
+uint32_t EventLog_Seek(const uint8_t *image, uint32_t blocks, uint32_t time);
+
+/**
+ * @brief UART dökümü: kaydı durdurur, Test_Run ile adımlanır
+ * (FlightRecorder_DumpStep ile aynı satır biçimi, "EL" önekiyle).
+ * @return 1: Sürüyor, 0: Bitti
+ */
+void EventLog_DumpStart(void);
+uint8_t EventLog_DumpStep(void);
+
+void EventLog_GetStats(EventLogStats_t *stats);
+
+#endif
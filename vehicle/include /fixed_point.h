@@ -0,0 +1,79 @@
+/*
+ * fixed_point.h
+ *
+ * STM32F103'te FPU yok; float işlemleri yazılımla (yavaş) yapılır.
+ * Konum, hız ve IMU değerleri Q16.16 işaretli sabit noktada tutulur:
+ * değer = ham / 65536. Aralık ±32768, çözünürlük ~15e-6.
+ * Float'a çevirme (Q16_TO_FLOAT) sadece debug çıktısı içindir.
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+typedef int32_t q16_t;
+
+#define Q16_SHIFT            16
+#define Q16_ONE              ((q16_t)1 << Q16_SHIFT)
+
+// Derleme zamanı sabitleri için (argüman sabit ifade olmalı)
+#define Q16_FROM_INT(x)      ((q16_t)((x) * Q16_ONE))
+#define Q16_FROM_FLOAT(x)    ((q16_t)((x) * 65536.0 + (((x) >= 0) ? 0.5 : -0.5)))
+
+// Sadece debug/printf için
+#define Q16_TO_FLOAT(x)      ((float)(x) * (1.0f / 65536.0f))
+
+// Q16 çarpım: 32x32 -> 64 (Cortex-M3'te tek SMULL), sonra kaydırma
+static inline q16_t q16_mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b) >> Q16_SHIFT);
+}
+
+// Tamsayı x Q16 karşılıklı (reciprocal) sabit: bölme yerine çarpma
+static inline q16_t q16_mul_int(int32_t raw, int32_t recip_q16) {
+    return (q16_t)(((int64_t)raw * recip_q16) >> Q16_SHIFT);
+}
+
+// 64 x 64 çarpım 128 bit ara sonuçla (Cortex-M3'te dört UMULL), 2^s'ye
+// yuvarlanarak bölünür: a*b/2^s (s <= 126). Sonuç int64'e sığmalı
+static inline int64_t q64_mul_shift(int64_t a, int64_t b, uint32_t s) {
+    uint64_t ua = (a < 0) ? 0U - (uint64_t)a : (uint64_t)a;
+    uint64_t ub = (b < 0) ? 0U - (uint64_t)b : (uint64_t)b;
+    uint64_t p00 = (ua & 0xFFFFFFFFU) * (ub & 0xFFFFFFFFU);
+    uint64_t p01 = (ua & 0xFFFFFFFFU) * (ub >> 32);
+    uint64_t p10 = (ua >> 32) * (ub & 0xFFFFFFFFU);
+    uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFFU) + (p10 & 0xFFFFFFFFU);
+    uint64_t lo = (mid << 32) | (p00 & 0xFFFFFFFFU);
+    uint64_t hi = (ua >> 32) * (ub >> 32) + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    if (s > 0U) {
+        if (s <= 64U) {
+            uint64_t half = 1ULL << (s - 1U);
+            lo += half;
+            hi += (lo < half);
+        } else {
+            hi += 1ULL << (s - 65U);
+        }
+        lo = (s < 64U) ? (lo >> s) | (hi << (64U - s)) : hi >> (s - 64U);
+    }
+    return ((a < 0) != (b < 0)) ? -(int64_t)lo : (int64_t)lo;
+}
+
+// Çalışma anında karşılıklı değer: 1/x ~ m / 2^s, m 32 bit'e normalize
+// (bağıl hata < 2^-31). Tek bölme; sonra y/x = q64_mul_shift(y, m, s)
+typedef struct {
+    uint32_t m;
+    uint32_t s;
+} q64_recip_t;
+
+static inline q64_recip_t q64_recip(uint64_t x) {
+    uint32_t b = 64U - (uint32_t)__builtin_clzll(x);   // x > 0: 2^(b-1) <= x < 2^b
+    uint64_t xs = (b > 32U) ? x >> (b - 32U) : x << (32U - b);
+    return (q64_recip_t){ (uint32_t)(0x7FFFFFFFFFFFFFFFULL / xs), 31U + b };
+}
+
+// Q16 değeri tamsayı ölçeğe çevirir (ör. m -> mm için scale=1000)
+static inline int32_t q16_to_scaled(q16_t x, int32_t scale) {
+    return (int32_t)(((int64_t)x * scale) >> Q16_SHIFT);
+}
+
+#endif
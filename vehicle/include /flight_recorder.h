@@ -0,0 +1,176 @@
+/*
+ * flight_recorder.h
+ *
+ * Uçuş kaydedici: koşu boyunca optik navigasyonun girdilerini RAM'deki bir
+ * halkaya yazar, koşudan sonra UART'tan döker veya flash'a kaydeder. Host'taki
+ * flight_replay kaydı aynı optical_sensor.c / strip_decoder.c kodundan
+ * geçirir ve her kayıttaki konumu, sayacı ve durumu bit bit karşılaştırır.
+ *
+ * Kapsam: bit bit oynatılan yalnız optik navigasyondur (kenar kapısı, şerit
+ * çözücü, konum / hız / sayaç / durum). Füzyon ve fren denetçisi yeniden
+ * çalıştırılmaz: ikisi de 1 kHz girdi ister (her IMU örneği, her
+ * değerlendirmenin anı ve füzyon tahmini), bir koşunun bu hızdaki girdisi
+ * 20 KB RAM'e sığmaz. Denetçinin navigasyona etkisi (durum geçişi, kapının
+ * fren modeli) kayıttan aynen uygulanır; füzyonun son ~0.7 s'lik ham IMU
+ * girdisi olay logundadır (event_log.h).
+ *
+ * Kaydedilenler (hepsi ana döngü bağlamında, yazma bölgesi dışında;
+ * VehicleState alanları SharedData_Snapshot kopyasından; kayıt başına 12 byte):
+ *   - FLIGHTREC_EDGE: işlenen her kenarın yakalama anı ve sonrasındaki durum
+ *   - FLIGHTREC_STRIP: StripDecoder_Poll'un kenar beklemeden kapattığı
+ *     patlama (Poll'a verilen an; oynatmada bu an bilinmeden aynı sonuç çıkmaz)
+ *   - FLIGHTREC_STATE: system_status geçişleri. Navigasyon dışından gelenler
+ *     (fren denetçisi) oynatmada aynen uygulanır, kapı kararını etkiler
+ *   - FLIGHTREC_BRAKE: fren denetçisinin kenar kapısına verdiği tutma anı ve
+ *     yavaşlama (komutta ve yavaşlama ölçülünce); oynatmada aynen verilir
+ *   - FLIGHTREC_IMU: her FLIGHTREC_IMU_DIV örnekte bir IMU örneği (sadece
+ *     inceleme için; füzyon tam hızda örnek ister, oynatılmaz)
+ *
+ * Halka dolunca en eski kayıt ezilir (dropped). Başı eksik kayıt
+ * incelenebilir ama bit bit oynatılamaz: optik durum koşu başından kurulur.
+ * Kayıt OpticalSensor_Init ile sıfırlanıp başlar, FlightRecorder_Stop ile
+ * donar; döküm ve flash'a yazma donmuş kaydı okur.
+ *
+ * Görüntü biçimi (döküm ve flash aynı, little-endian): FlightRecHeader_t,
+ * ardından count adet FlightRecord_t (eskiden yeniye). Başlıktaki crc,
+ * crc alanına kadarki başlık byte'larıyla kayıtları kapsar.
+ */
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+#include "tunnel_map.h"
+#include "shared_data.h"
+
+#define FLIGHTREC_MAGIC          0x43455246U   // "FREC"
+#define FLIGHTREC_VERSION        2U
+#define FLIGHTREC_RECORDS        320U          // 3840 byte RAM
+#define FLIGHTREC_IMU_DIV        500U          // 1 kHz IMU -> 2 Hz kayıt (~90 s koşu sığar)
+
+// Flash: tünel parametre sayfasının önündeki 4 sayfa (linker betiği bu
+// alanı koda vermemeli)
+#define FLIGHTREC_FLASH_PAGES    4U
+#define FLIGHTREC_FLASH_ADDR     (TUNNEL_PARAMS_FLASH_ADDR - FLIGHTREC_FLASH_PAGES * 0x400U)
+
+// UART dökümü: "FR <ofset> <hex> <crc>" satırı başına byte
+#define FLIGHTREC_DUMP_CHUNK     32U
+
+// Kayıt tipleri
+#define FLIGHTREC_EDGE           1U
+#define FLIGHTREC_STRIP          2U
+#define FLIGHTREC_STATE          3U
+#define FLIGHTREC_IMU            4U
+#define FLIGHTREC_BRAKE          5U
+#define FLIGHTREC_TYPES          6U
+
+// FLIGHTREC_STATE kaynağı
+#define FLIGHTREC_SRC_OPTICAL    0U   // Navigasyon kendisi (oynatmada yeniden oluşur)
+#define FLIGHTREC_SRC_BRAKE      1U   // Fren denetçisi (oynatmada uygulanır)
+
+/*
+ * Alanların anlamı tipe göre:
+ *   EDGE/STRIP: time = kenar / Poll anı, arg = system_status,
+ *               aux = reflector_count, value = current_position
+ *   STATE:      time = geçiş anı, arg = yeni durum, aux = eski durum | kaynak << 8,
+ *               value = current_velocity
+ *   BRAKE:      time = frenin tuttuğu an, value = yavaşlama (m/s^2, Q16)
+ *   IMU:        time = örnek anı, aux = gyro_z (dps, Q8.8), value = accel_x (g, Q16)
+ * Zamanlar 8 MHz TIM2 tick.
+ */
+typedef struct {
+    uint32_t time;
+    uint8_t type;
+    uint8_t arg;
+    uint16_t aux;
+    int32_t value;
+} FlightRecord_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;       // sizeof(FlightRecord_t)
+    uint16_t count;             // Görüntüdeki kayıt
+    uint16_t imu_div;
+    uint32_t dropped;           // Halka dolup ezilen (en eski) kayıt
+    uint32_t start_time;        // OpticalSensor_Init anı (TIM2)
+    q16_t final_position;       // Durdurulduğu andaki navigasyon çıktısı
+    q16_t final_velocity;
+    uint32_t final_reflectors;
+    TunnelParams_t map;         // Kaydın alındığı pist (oynatma aynı haritayı kurar)
+    uint16_t crc;
+    uint16_t reserved;
+} FlightRecHeader_t;
+
+#define FLIGHTREC_IMAGE_MAX      (sizeof(FlightRecHeader_t) + FLIGHTREC_RECORDS * sizeof(FlightRecord_t))
+
+typedef struct {
+    uint32_t records;           // Yazılan toplam kayıt
+    uint32_t dropped;
+    uint32_t imu_samples;       // Görülen IMU örneği (kaydedilen: / FLIGHTREC_IMU_DIV)
+    uint8_t running;
+} FlightRecStats_t;
+
+/**
+ * @brief Halkayı sıfırlar ve kaydı başlatır (OpticalSensor_Init çağırır).
+ * Harita o anki TunnelMap_Params'tan kopyalanır.
+ */
+void FlightRecorder_Start(uint32_t now);
+
+/**
+ * @brief Kaydı dondurur; son navigasyon durumu ve CRC başlığa yazılır.
+ * Zaten donmuşsa bir şey yapmaz.
+ */
+void FlightRecorder_Stop(void);
+
+/**
+ * @brief EDGE / STRIP kaydı: o anki VehicleState kopyasından doldurulur.
+ */
+void FlightRecorder_Nav(uint8_t type, uint32_t time);
+
+/**
+ * @brief system_status geçişi; geçişi yazan bölge kapandıktan sonra çağrılır
+ * (kopya alınır: yazma bölgesinin içinden çağrılamaz).
+ */
+void FlightRecorder_State(uint32_t time, uint8_t from, uint8_t to, uint8_t source);
+
+/**
+ * @brief Kenar kapısının fren modeli (OpticalSensor_SetBraking'den).
+ */
+void FlightRecorder_Brake(uint32_t onset, q16_t decel);
+
+/**
+ * @brief Füzyona verilen her IMU örneği; FLIGHTREC_IMU_DIV'de bir kaydedilir.
+ */
+void FlightRecorder_Imu(const IMU_Data_t *imu, uint32_t timestamp);
+
+/**
+ * @brief Donmuş kaydın görüntü uzunluğu (başlık + kayıtlar, byte).
+ */
+uint32_t FlightRecorder_ImageSize(void);
+
+/**
+ * @brief Görüntünün [offset, offset + len) aralığını kopyalar.
+ * @return Kopyalanan byte (görüntü sonunda kısalır)
+ */
+uint32_t FlightRecorder_Read(uint32_t offset, uint8_t *out, uint32_t len);
+
+/**
+ * @brief UART dökümü: kaydı dondurur, Test_Run ile adımlanır. Her adım UART
+ * halkasına sığdığı kadar satır yazar (halka dolduğu için satır atılmaz).
+ * @return 1: Sürüyor, 0: Bitti
+ */
+void FlightRecorder_DumpStart(void);
+uint8_t FlightRecorder_DumpStep(void);
+
+/**
+ * @brief Kaydı dondurup FLIGHTREC_FLASH_ADDR'e yazar (sayfa silme CPU'yu
+ * ~20 ms/sayfa durdurur: sadece koşu bittikten sonra).
+ * @return 0: Başarılı, 1: Silme/yazma hatası
+ */
+uint8_t FlightRecorder_SaveFlash(void);
+
+void FlightRecorder_GetStats(FlightRecStats_t *stats);
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * fusion.h
+ *
+ * IMU + optik sensör füzyonu: 3 durumlu Kalman filtresi.
+ *   x = [konum (m), hız (m/s), ivme sapması (m/s^2)]
+ * Her IMU örneğinde accel_x_g ile tahmin adımı, her reflektör/şerit
+ * geçişinde konum düzeltmesi yapılır. Sonuç VehicleState.nav'a yazılır.
+ * Düzeltmeler inovasyon kapısından geçer: tahminden ölçüm belirsizliğine
+ * göre çok uzak düzeltme (ör. sayımı kaymış işaret) atılır.
+ *
+ * Konum ve hız Q32.32 tamsayıda birikir (1 kHz'de float yuvarlaması
+ * 25 s'lik koşuda cm'ler mertebesinde kayma yapardı). Kovaryans float:
+ * değerleri 1e-9..1e2 arasında, tek bir Q formatına sığmaz. Örnek başına
+ * ~35 yazılım float işlemi (F1'de ~2k döngü, 1 kHz'de ~%3 CPU).
+ */
+
+#ifndef FUSION_H
+#define FUSION_H
+
+#include <stdint.h>
+#include "shared_data.h"
+
+// Zaman damgaları TIM2 giriş yakalama saatiyle aynı (OPTICAL_IC_TICK_HZ)
+#define FUSION_TICK_HZ           8000000U
+
+#define FUSION_G                 9.80665f
+
+// --- Model parametreleri ---
+#define FUSION_ACCEL_PSD         1.0e-4f   // İvme gürültüsü (m/s^2)^2/Hz (titreşim payıyla)
+#define FUSION_BIAS_PSD          1.0e-6f   // Sapma rastgele yürüyüşü (m/s^2)^2/s
+#define FUSION_INIT_POS_STD      0.5f      // m
+#define FUSION_INIT_VEL_STD      0.1f      // m/s (durarak başlar)
+#define FUSION_INIT_BIAS_STD     0.2f      // m/s^2
+#define FUSION_REFLECTOR_STD     Q16_FROM_FLOAT(0.01f)  // Reflektör kenarı konum belirsizliği
+#define FUSION_INFERRED_STD      Q16_FROM_FLOAT(0.25f)  // Arası çıkarılan (görülmeyen işaret atlanmış) kenar
+#define FUSION_REACQUIRED_STD    Q16_FROM_FLOAT(1.0f)   // Optik kapının penceresi dışında zorla kabul ettiği kenar
+
+// Tekerlek dururken (Encoder_IsStill) sıfır hız ölçümünün belirsizliği:
+// kalkıştan önce ivme sapması buradan öğrenilir
+#define FUSION_ZUPT_STD          0.005f    // m/s
+
+// İnovasyon kapısı: r^2 / S bunu aşan düzeltme atılır (1 serbestlik, ~%99.9).
+// Art arda FUSION_GATE_MAX_REJECTS atılırsa tahmin bozulmuş sayılır,
+// sıradaki düzeltme kapısız uygulanır (filtre kendini kilitlemesin)
+#define FUSION_GATE_CHI2         11.0f
+#define FUSION_GATE_MAX_REJECTS  3U
+
+// Bir IMU örneği gelmeden önce bu kadar uzun boşluk olursa (sensör kopması)
+// ivme bilinmiyor sayılır, aralık sabit hız varsayımıyla ilerletilir;
+// bilinmeyen ivme (en fazla ~hızlanma/fren) kovaryansa eklenir
+#define FUSION_MAX_DT_S          0.05f
+#define FUSION_GAP_ACCEL_STD     5.0f      // m/s^2
+
+// Zamanı IMU'nun ilerisinde kalan düzeltmeler IMU yetişene kadar bekletilir
+#define FUSION_FIX_QUEUE         4U
+
+// Düzeltme kaynakları (Fusion_SetSources)
+#define FUSION_SRC_OPTICAL       0x01U
+#define FUSION_SRC_EXTERNAL      0x02U
+
+typedef struct {
+    uint32_t predicts;       // IMU tahmin adımı
+    uint32_t stale_samples;  // Tahmin zamanından eski IMU örneği (atlandı)
+    uint32_t gaps;           // FUSION_MAX_DT_S'den uzun IMU boşluğu
+    uint32_t fixes;          // Uygulanan konum düzeltmesi
+    uint32_t late_fixes;     // Zamanı geçmiş, gecikme telafisiyle uygulanan
+    uint32_t forced_fixes;   // Kuyruk doldu, IMU beklenmeden uygulanan
+    uint32_t ignored_fixes;  // Kaynağı kapalı düzeltme
+    uint32_t rejected_fixes; // İnovasyon kapısında atılan
+    uint32_t forced_gate;    // Art arda redden sonra kapısız uygulanan
+    float max_nis;           // Uygulanan düzeltmelerde en büyük r^2 / S
+    uint32_t zero_velocity;  // Sıfır hız düzeltmesi
+} FusionStats_t;
+
+/**
+ * @brief Filtreyi bilinen başlangıç konumunda, durur halde başlatır.
+ * @param timestamp Başlangıç anı (FUSION_TICK_HZ)
+ */
+void Fusion_Init(q16_t position, uint32_t timestamp);
+
+/**
+ * @brief IMU örneğiyle tahmin adımı. Zamanı gelen bekleyen düzeltmeler
+ * araya girer. Ana döngüden çağrılır, VehicleState.nav'ı günceller.
+ */
+void Fusion_ImuSample(const IMU_Data_t *imu, uint32_t timestamp);
+
+/**
+ * @brief Mutlak konum ölçümü (reflektör, bilgi şeridi).
+ * @param source FUSION_SRC_*
+ * @param std Ölçüm standart sapması (m)
+ * @param timestamp Kenar yakalama anı
+ */
+void Fusion_PositionFix(uint8_t source, q16_t position, q16_t std, uint32_t timestamp);
+
+/**
+ * @brief Sıfır hız düzeltmesi (tekerlek duruyor), son IMU örneğinin anında.
+ * Durağan IMU'da hız yalnız sapmayla büyür: sapma gözlenir hale gelir.
+ */
+void Fusion_ZeroVelocity(void);
+
+/**
+ * @brief Hangi kaynakların düzeltmelerinin kullanılacağı (arızalı sensörü dışlamak için).
+ */
+void Fusion_SetSources(uint8_t mask);
+
+void Fusion_GetStats(FusionStats_t *stats);
+
+#endif
@@ -0,0 +1,24 @@
+/*
+ * fw_state.h
+ *
+ * Modül durumunun depolama sınıfı. Hedefte her modülün durumu dosya
+ * kapsamında tek örnektir (FW_STATE = static). Host'taki Monte Carlo
+ * koşucusu (host/tunnel_mc) firmware'i FW_STATE_PER_THREAD ile derler:
+ * durum iş parçacığı başına ayrı örnek olur, koşular iş parçacıklarında
+ * paralel ve her iş parçacığında modüllerin Init/Reset çağrılarıyla art
+ * arda yürür. Init/Reset bu yüzden modülün tüm durumunu kurmalıdır.
+ */
+
+#ifndef FW_STATE_H
+#define FW_STATE_H
+
+#ifdef FW_STATE_PER_THREAD
+#define FW_THREAD_LOCAL   _Thread_local
+#else
+#define FW_THREAD_LOCAL
+#endif
+
+// Dosya kapsamındaki modül durumu
+#define FW_STATE          static FW_THREAD_LOCAL
+
+#endif
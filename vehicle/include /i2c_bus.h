@@ -0,0 +1,170 @@
+/*
+ * i2c_bus.h
+ *
+ * Paylaşılan I2C1 hattının yöneticisi. Sürücüler HAL'i doğrudan çağırmaz:
+ * her okuma/yazma bir tanımlayıcı olarak kuyruğa girer, hat boşalınca
+ * sıradaki başlatılır ve bitince sahibinin callback'i çağrılır. Sürücü
+ * beklemez; bloklayan HAL_I2C_Mem_Read/Write (100 ms zaman aşımı) kullanılmaz.
+ *
+ * Öncelik: I2C_BUS_PRIORITIES sınıf, her biri I2C_BUS_QUEUE_DEPTH'lik bir
+ * FIFO. Hat boşaldığında en yüksek öncelikli sınıfın en eski işlemi başlar;
+ * süren işlem kesilmez, yani yüksek öncelikli bir işlemin beklemesi en çok
+ * bir düşük öncelikli işlemin süresi kadardır. Aynı sınıftaki işlemlerin
+ * sırası korunur (kurulum yazmaları art arda kuyruğa atılabilir).
+ *
+ * Tamamlanma: HAL_I2C_MemRxCpltCallback / MemTxCpltCallback /
+ * ErrorCallback -> I2CBus_*Callback -> sahibin callback'i (kesme bağlamında,
+ * her kabul edilen işlem için tam bir kez) -> sıradaki işlem. Okumalar
+ * 2 byte ve üstünde DMA ile, tek byte'lık okumalar (F1 I2C DMA'sı en az
+ * 2 byte ister) ve yazmalar kesmeyle yapılır. Yazma verisi kuyruğa
+ * kopyalanır; okuma hedefi işlem bitene kadar geçerli kalmalı.
+ *
+ * Hatalar ve kurtarma (harcanan süre sınırlı):
+ *   - NACK (AF): HAL STOP üretmiştir, hat sağlam. İşlem kendi tekrar hakkı
+ *     (retries, en çok I2C_BUS_MAX_RETRIES) kadar hemen yeniden denenir.
+ *   - Hat hatası (BERR/ARLO) veya zaman aşımı (işlem süresinin iki katı +
+ *     pay, I2CBus_Poll denetler): köle SDA'yı tutuyor olabilir. Bir sonraki
+ *     Poll'da çevre birimi kapatılır, SCL en çok I2C_BUS_RECOVERY_CLOCKS kez
+ *     GPIO ile saatlenir (SDA bırakılınca durur), STOP üretilir, SWRST ve
+ *     yeniden kurulum yapılır (en kötü ~0.1 ms, görev bağlamında).
+ *   - Art arda I2C_BUS_FAIL_LIMIT başarısız deneme: hat kapatılır. Kuyruk
+ *     I2C_BUS_ERR_OFFLINE ile boşaltılır, yeni istekler reddedilir. Bekleme
+ *     süresi I2C_BUS_BACKOFF_MS'den başlayıp her kapanışta iki katına çıkar
+ *     (en çok I2C_BUS_BACKOFF_MAX_MS); süre dolunca kurtarma yapılıp hat
+ *     açılır. İlk başarılı işlem bekleme süresini sıfırlar. Ölü bir hat
+ *     böylece CPU'yu ve yüksek öncelikli sürücüleri meşgul etmez.
+ *
+ * Cihaz başına sayaçlar: kuyruğa alınan, tamamlanan, reddedilen (kuyruk
+ * dolu / hat kapalı), hatayla biten, tekrar ve kuyrukta en uzun bekleme.
+ * Her kabul edilen işlem ya tamamlanır ya hatayla biter:
+ * queued = completed + errors + bekleyen.
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "stm32f1xx_hal.h"
+
+#define I2C_BUS_MAX_DEVICES      4U
+#define I2C_BUS_PRIORITIES       3U
+#define I2C_BUS_QUEUE_DEPTH      8U     // Sınıf başına (2'nin kuvveti)
+#define I2C_BUS_WRITE_MAX        8U     // Kuyruğa kopyalanan yazma verisi
+#define I2C_BUS_MAX_RETRIES      3U
+
+#define I2C_BUS_HZ               400000U  // Fast mode (CubeMX I2C1 ayarı)
+#define I2C_BUS_TIMEOUT_PAD_MS   2U       // Zaman aşımı: 2 x işlem süresi + bu pay
+#define I2C_BUS_FAIL_LIMIT       4U       // Art arda başarısız deneme -> hat kapanır
+#define I2C_BUS_BACKOFF_MS       10U
+#define I2C_BUS_BACKOFF_MAX_MS   320U
+#define I2C_BUS_RECOVERY_CLOCKS  9U       // Bir byte + ACK: köle en geç bunda SDA'yı bırakır
+#define I2C_BUS_RECOVERY_SPIN    90U      // Yarım SCL periyodu (~5 us, 72 MHz'de döngü)
+
+// I2C1 pinleri (remap yok): kurtarmada GPIO olarak sürülür
+#define I2C_BUS_GPIO_PORT        GPIOB
+#define I2C_BUS_SCL_PIN          GPIO_PIN_6
+#define I2C_BUS_SDA_PIN          GPIO_PIN_7
+
+#if (I2C_BUS_QUEUE_DEPTH & (I2C_BUS_QUEUE_DEPTH - 1U)) != 0U
+#error "I2C_BUS_QUEUE_DEPTH 2'nin kuvveti olmalı"
+#endif
+
+// Öncelik sınıfları (küçük = önce)
+#define I2C_BUS_PRIO_HIGH        0U     // Zamana bağlı örnekleme (IMU okumaları)
+#define I2C_BUS_PRIO_NORMAL      1U     // Kurulum / kontrol yazmaları
+#define I2C_BUS_PRIO_LOW         2U     // Arka plan (yavaş sensörler, EEPROM)
+
+// Callback durumu
+#define I2C_BUS_OK               0U
+#define I2C_BUS_ERR_NACK         1U     // Cihaz yanıt vermedi (tekrarlar tükendi)
+#define I2C_BUS_ERR_BUS          2U     // Hat hatası / başlatılamadı
+#define I2C_BUS_ERR_TIMEOUT      3U
+#define I2C_BUS_ERR_OFFLINE      4U     // Hat kapandı, işlem çalıştırılmadan atıldı
+
+#define I2C_BUS_NO_DEVICE        0xFFU
+
+typedef void (*I2CBusDone_t)(uint8_t status, void *ctx);
+
+typedef struct {
+    uint8_t device;          // I2CBus_AddDevice dönüşü
+    uint8_t priority;        // I2C_BUS_PRIO_*
+    uint8_t write;           // 0: okuma, 1: yazma
+    uint8_t retries;         // Hata sonrası tekrar (<= I2C_BUS_MAX_RETRIES)
+    uint8_t reg;             // İlk register
+    uint16_t len;
+    uint8_t *data;           // Okuma hedefi / yazılacak veri (yazmada kopyalanır)
+    I2CBusDone_t done;       // NULL olabilir; kesme bağlamında çağrılır
+    void *ctx;
+} I2CBusXfer_t;
+
+typedef struct {
+    uint16_t addr;
+    const char *name;
+    uint32_t queued;
+    uint32_t completed;
+    uint32_t dropped;        // Reddedildi: kuyruk dolu veya hat kapalı
+    uint32_t errors;         // Hatayla bitti (tekrarlar tükendi, zaman aşımı, hat kapandı)
+    uint32_t retries;
+    uint32_t max_wait;       // Kuyruktan hatta geçişe kadar en uzun bekleme (saat tick)
+} I2CBusDeviceStats_t;
+
+typedef struct {
+    uint32_t transfers;      // Hatta başlatılan deneme (tekrarlar dahil)
+    uint32_t nacks;
+    uint32_t bus_errors;     // BERR/ARLO veya HAL başlatamadı
+    uint32_t timeouts;
+    uint32_t recoveries;     // SCL saatleme + yeniden kurulum
+    uint32_t offline;        // Hat kapanma sayısı
+    uint32_t offline_ms;     // Kapalı geçen toplam süre
+    uint32_t max_depth;      // Kuyrukta aynı anda bekleyen en çok işlem
+} I2CBusStats_t;
+
+/**
+ * @brief Kuyruğu boşaltır ve hattı bağlar. MX_I2C1_Init'ten sonra, sürücü
+ * Init'lerinden önce çağrılır.
+ * @param clock Bekleme ölçümü için saat (OpticalSensor_GetTimestamp), NULL: HAL_GetTick
+ */
+void I2CBus_Init(I2C_HandleTypeDef *hi2c, uint32_t (*clock)(void));
+
+/**
+ * @brief Hattın saati (I2CBus_Init'e verilen). Bitiş callback'inden
+ * çağrılınca transferin tamamlandığı an.
+ */
+uint32_t I2CBus_Now(void);
+
+/**
+ * @brief Hattaki bir cihazı kaydeder (sayaçlar cihaz başına tutulur).
+ * @param addr 8 bit adres (HAL biçimi, ör. 0xD0)
+ * @return Cihaz kimliği, I2C_BUS_NO_DEVICE: yer yok
+ */
+uint8_t I2CBus_AddDevice(uint16_t addr, const char *name);
+
+/**
+ * @brief Adresi kayıtlı cihazın kimliği (I2C_BUS_NO_DEVICE: yok).
+ */
+uint8_t I2CBus_FindDevice(uint16_t addr);
+
+/**
+ * @brief İşlemi kuyruğa atar; hat boşsa hemen başlatır. Kesme ve görev
+ * bağlamından (sahibin callback'i içinden de) çağrılabilir.
+ * @return 0: Kabul edildi (done tam bir kez çağrılacak), 1: Reddedildi
+ */
+uint8_t I2CBus_Submit(const I2CBusXfer_t *xfer);
+
+/**
+ * @brief 1 kHz görevinden: zaman aşımı, bekleyen kurtarma ve kapalı hattın
+ * yeniden açılması.
+ */
+void I2CBus_Poll(void);
+
+/**
+ * @brief HAL_I2C_MemRxCpltCallback / MemTxCpltCallback / ErrorCallback içinden.
+ */
+void I2CBus_RxCpltCallback(I2C_HandleTypeDef *hi2c);
+void I2CBus_TxCpltCallback(I2C_HandleTypeDef *hi2c);
+void I2CBus_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+uint8_t I2CBus_DeviceCount(void);
+void I2CBus_GetDeviceStats(uint8_t device, I2CBusDeviceStats_t *stats);
+void I2CBus_GetStats(I2CBusStats_t *stats);
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * profiler.h
+ *
+ * Sıcak yol ölçümü: kod bölgelerinin başına/sonuna konan probelar
+ * Cortex-M3 DWT döngü sayacını (CYCCNT, SystemCoreClock hızında) okur. Her
+ * probe için en kısa/en uzun/ortalama süre ve log2 kovalı histogram
+ * tutulur: kova k, [2^k, 2^(k+1)) döngü süren çalışmaları sayar.
+ *
+ * Probelar iç içe açılabilir (ana döngüdeki bir probe ISR'deki bir probe
+ * tarafından kesilebilir). Açık probeların yığını tutulur; içteki probe
+ * bitince süresi dıştakinin "kesilme" süresine eklenir. Böylece bir
+ * kesmenin diğer kod yollarına eklediği gecikme de görülür.
+ *
+ * Bütçe: Profiler_SetBudget ile bir probeye döngü sınırı verilebilir. Sınır
+ * probe'un kendi süresine (iç probelar / kesmeler hariç) uygulanır; aşan
+ * çalışmalar sayılır ve dökümde işaretlenir.
+ *
+ * Yığın kullanımı: hedefte Profiler_Init boş yığın alanını desenle
+ * doldurur, döküm sırasında desenin bozulduğu en derin nokta aranır. Host'ta
+ * probelar sırasında görülen en derin yığın adresi kullanılır.
+ *
+ * PROFILER_ENABLE tanımlı değilse tüm probelar ve API hiçbir kod üretmez.
+ * Host derlemesinde (PROFILER_HOST_CLOCK) CYCCNT yerine monotonik saat
+ * PROFILER_CLOCK_HZ döngüsüne çevrilir.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#define PROFILER_CLOCK_HZ        72000000U  // SYSCLK (HSE 8 MHz x PLL 9)
+#define PROFILER_HIST_BUCKETS    16U        // Son kova 2^15 döngü (~455 us) ve üstü
+#define PROFILER_MAX_DEPTH       8U         // Aynı anda açık probe
+#define PROFILER_STACK_PAINT     0xC5C5C5C5U
+
+// Probe kimlikleri
+#define PROF_OPTICAL_CAPTURE     0U   // OpticalSensor_IC_CaptureCallback (TIM2 ISR)
+#define PROF_OPTICAL_SOFT        1U   // OpticalSensor_SoftwareEdge (yazılımla kenar)
+#define PROF_OPTICAL_CALC        2U   // OpticalSensor_CalculatePositionVelocity
+#define PROF_IMU_DMA             3U   // MPU6050 örnek dönüşümü (I2C bitiş ISR'sinden)
+#define PROF_IMU_INT             4U   // MPU6050_INT_Callback (EXTI ISR)
+#define PROF_FUSION_IMU          5U   // Fusion_ImuSample
+#define PROF_BRAKE               6U   // BrakeSupervisor_Update
+#define PROF_ANALOG_DMA          7U   // Analog motoru yarım/tam transfer (ADC DMA ISR)
+#define PROF_EVLOG               8U   // EventLog_Imu (örnek başına kodlama)
+#define PROF_IMU_FILTER          9U   // ImuFilter_Process (6 eksen, örnek başına)
+#define PROF_I2C_BUS             10U  // I2CBus bitiş/hata callback'i (sahibin callback'i dahil)
+#define PROF_SHARED_WRITE        11U  // SharedData yazma bölgesi (kesmeler kapalı)
+#define PROFILER_PROBES          12U
+
+// Kesmelerin kapalı kaldığı en uzun süre yakalama/DMA kesmelerinin en kötü
+// gecikmesidir: yazma bölgesinde yalnız hazır değerler saklanır (~2.8 us).
+// Bölgeyi açan kodun probe'unda iç probe (kesilme) olarak görünür
+#ifndef PROFILER_SHARED_WRITE_BUDGET
+#define PROFILER_SHARED_WRITE_BUDGET  200U
+#endif
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;              // Döngü
+    uint32_t max;
+    uint64_t total;            // Ortalama = total / count
+    uint32_t preempted;        // İç içe probe tarafından kesilen çalışma
+    uint32_t max_preempt;      // Tek çalışmada kesmelerin eklediği en uzun süre
+    uint32_t over_budget;      // Kendi süresi bütçeyi aşan çalışma (bütçe varsa)
+    uint32_t hist[PROFILER_HIST_BUCKETS];
+} ProfilerProbe_t;
+
+#ifdef PROFILER_ENABLE
+
+#define PROFILE_BEGIN(id)        Profiler_Begin(id)
+#define PROFILE_END(id)          Profiler_End(id)
+
+/**
+ * @brief Döngü sayacını açar, sayaçları sıfırlar, boş yığını desenle doldurur.
+ */
+void Profiler_Init(void);
+void Profiler_Reset(void);
+void Profiler_Begin(uint8_t id);
+void Profiler_End(uint8_t id);
+
+/**
+ * @brief Probe'a döngü bütçesi verir (0: yok). Profiler_Reset bütçeleri korur.
+ */
+void Profiler_SetBudget(uint8_t id, uint32_t cycles);
+
+/**
+ * @brief Tüm probeları ve yığın kullanımını printf (hata ayıklama UART'ı) ile yazar.
+ */
+void Profiler_Dump(void);
+
+/**
+ * @return 0: id geçersiz
+ */
+uint8_t Profiler_GetProbe(uint8_t id, ProfilerProbe_t *probe);
+
+/**
+ * @return Görülen en yüksek yığın kullanımı (byte)
+ */
+uint32_t Profiler_StackHighWater(void);
+
+#else
+
+#define PROFILE_BEGIN(id)        ((void)0)
+#define PROFILE_END(id)          ((void)0)
+#define Profiler_Init()          ((void)0)
+#define Profiler_Reset()         ((void)0)
+#define Profiler_SetBudget(id, cycles) ((void)0)
+#define Profiler_Dump()          ((void)0)
+
+#endif
+
+#endif
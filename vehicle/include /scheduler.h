@@ -0,0 +1,115 @@
+/*
+ * scheduler.h
+ *
+ * Zaman tetiklemeli, işbirlikçi (cooperative) yürütücü. Görevler derleme
+ * zamanında bir tabloda tanımlanır: her birinin sabit periyodu ve faz
+ * kayması (offset) vardır. Zaman tabanı SysTick'in 1 ms tick'i
+ * (HAL_GetTick); ana döngü sadece Scheduler_Dispatch'i çağırır.
+ *
+ * Bir tick'te zamanı gelen görevler tablo sırasıyla sonuna kadar çalışır
+ * (kesme yok). Periyodu 0 olan görevler iki türlüdür:
+ *   - Olay görevi (event != 0): bir kesme Scheduler_Post ile olayını
+ *     gönderince, bir sonraki tick beklenmeden ilk uyanışta çalışır. Aynı
+ *     olay işlenmeden birden çok gönderilirse görev bir kez çalışır.
+ *   - Arka plan görevi (event == 0; konsol): her uyanışta bir kez çalışır,
+ *     bir adımda kısa sürüp dönmelidir.
+ *
+ * Yapılacak iş kalmayınca (yeni tick yok, bekleyen olay yok) çekirdek WFI
+ * ile bir sonraki kesmeye kadar uyur. Periyodik görevlerin en yakın
+ * salınımı en geç bir sonraki SysTick'tir (1 kHz görevi her tick'te
+ * çalışır), bu yüzden SysTick yeniden programlanmaz; uyanma kaynağı ya
+ * SysTick ya da olay gönderen kesmedir. Uykuda geçen süre ve kesmenin olayı
+ * göndermesinden görevin başlamasına kadar geçen süre ölçülür.
+ *
+ * Her görev için en kötü çalışma süresi (WCET) ve kaçırılan salınımlar
+ * (overrun) tutulur. Bir tick'in işi bir sonraki tick'e taşarsa bu çerçeve
+ * taşması olarak sayılır; gecikmeyle kaçırılan salınımlar sonradan
+ * toplu çalıştırılmaz, atlanır ve sayılır.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+#define SCHEDULER_MAX_TASKS      8U
+#define SCHEDULER_MAX_EVENTS     8U         // Olay numaraları 1..SCHEDULER_MAX_EVENTS
+#define SCHEDULER_NO_EVENT       0U
+
+// 0: Boşta uyumadan döner (WFI'da bağlantısı kopan hata ayıklayıcılar için)
+#ifndef SCHEDULER_SLEEP
+#define SCHEDULER_SLEEP          1
+#endif
+#define SCHEDULER_TICK_HZ        1000U      // HAL_GetTick çözünürlüğü
+#define SCHEDULER_CLOCK_HZ       8000000U   // Süre ölçüm saati (TIM2, OPTICAL_IC_TICK_HZ)
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+    uint16_t period_ms;    // 0: olay görevi (event != 0) veya arka plan (her uyanışta)
+    uint16_t offset_ms;    // İlk salınım; aynı periyottaki görevleri ayrı tick'lere dağıtır
+    uint8_t event;         // period_ms == 0 iken tetikleyen olay, SCHEDULER_NO_EVENT: arka plan
+} SchedulerTask_t;
+
+typedef struct {
+    uint32_t runs;
+    uint32_t overruns;     // Önceki iş taştığı için atlanan salınım
+    uint32_t wcet;         // En uzun çalışma süresi (SCHEDULER_CLOCK_HZ tick)
+    uint32_t last;         // Son çalışma süresi
+    uint32_t max_lateness; // Salınım anından başlamaya kadar en uzun gecikme (ms)
+    uint32_t max_latency;  // Olay görevi: Scheduler_Post'tan başlamaya en uzun süre (SCHEDULER_CLOCK_HZ tick)
+    uint64_t latency_sum;  // Ortalama için toplam
+} SchedulerTaskStats_t;
+
+typedef struct {
+    uint32_t ticks;            // İşlenen tick
+    uint32_t missed_ticks;     // Dispatch geç çağrıldığı için hiç görülmeyen tick
+    uint32_t frame_overruns;   // Tick'in işi bir sonraki tick'e taştı
+    uint32_t max_frame;        // Bir tick'teki toplam iş (SCHEDULER_CLOCK_HZ tick)
+    uint32_t background_runs;
+    uint32_t events;           // İşlenen olay (birleşenler bir sayılır)
+    uint32_t wakeups;          // WFI'dan uyanış
+    uint64_t idle;             // Uykuda geçen süre (SCHEDULER_CLOCK_HZ tick)
+    uint64_t elapsed;          // Init'ten son Dispatch'e kadar geçen süre; boşta oranı = idle / elapsed
+} SchedulerStats_t;
+
+/**
+ * @brief Görev tablosunu kurar; tüm salınımlar şimdiki tick + offset'e ayarlanır.
+ * @param tasks Tablo (çağıranın ömrü boyunca geçerli kalmalı)
+ * @param clock Süre ölçüm saati, SCHEDULER_CLOCK_HZ hızında sayan (ör. OpticalSensor_GetTimestamp)
+ */
+void Scheduler_Init(const SchedulerTask_t *tasks, uint8_t count, uint32_t (*clock)(void));
+
+/**
+ * @brief Ana döngüden sürekli çağrılır. Yapılacak iş yoksa önce WFI ile
+ * uyur; sonra bekleyen olayların görevlerini, yeni tick geldiyse zamanı
+ * gelen periyodik görevleri ve arka plan görevlerini birer kez çalıştırır.
+ */
+void Scheduler_Dispatch(void);
+
+/**
+ * @brief Olayı gönderir; görevi bir sonraki Dispatch'te çalışır. Kesme
+ * bağlamından çağrılır (çekirdeği uyandıran kesmenin kendisi).
+ * @param event 1..SCHEDULER_MAX_EVENTS
+ */
+void Scheduler_Post(uint8_t event);
+
+/**
+ * @brief Gönderilmiş ama henüz işlenmemiş olaylar (bit n-1: olay n).
+ */
+uint32_t Scheduler_PendingEvents(void);
+
+void Scheduler_GetStats(SchedulerStats_t *stats);
+
+/**
+ * @brief Görev istatistiği.
+ * @return 0: index tablo dışında
+ */
+uint8_t Scheduler_GetTaskStats(uint8_t index, SchedulerTaskStats_t *stats);
+
+/**
+ * @brief Görev tablosunu ve istatistikleri printf ile yazar.
+ */
+void Scheduler_Print(void);
+
+#endif
@@ -1 +1,108 @@
+/*
+ * encoder.h
+ *
+ * Tekerlek enkoderi (A/B kareleme). TIM1 enkoder modunda (PA8 = A,
+ * PA9 = B, x4) darbeleri donanımda sayar; 16-bit sayaç taşma kesmesinde
+ * yazılımla 64-bit'e genişletilir. Darbe başına CPU maliyeti yok.
+ *
+ * Hız M/T yöntemiyle: A kanalı ayrıca TIM2_CH2'ye (PA1) bağlıdır. Son
+ * yükselen A kenarının zamanı TIM2 CCR2'de, o andaki sayım TIM1 CCR1'de
+ * donanımca tutulur (kesme yok). Periyodik örnekte bu iki değer okunur;
+ * hız, en az ENCODER_MT_WINDOW süren bir pencerenin iki ucundaki kenarlar
+ * arasından = sayım farkı / kenar zamanı farkı. Pencere kenarlara
+ * hizalandığı için yüksek hızda sayım (M), düşük hızda süre (T) ölçümü
+ * kadar doğrudur. Kenar gelmedikçe hız, bir sonraki kenarın en erken
+ * geleceği ana göre sınırlanır; ENCODER_STOP_TICKS sonra sıfırdır.
+ *
+ * Donanım okuması (Encoder_Update) ile hesap (Encoder_Sample) ayrıdır:
+ * host testleri Encoder_Sample'a sentetik sayım dizileri verir.
+ */
 
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include "stm32f1xx_hal.h"
+#include "fixed_point.h"
+
+// --- Tekerlek ve enkoder (derleme zamanı) ---
+#ifndef ENCODER_CPR
+#define ENCODER_CPR              4096U     // Tur başına sayım (1024 çizgi x4)
+#endif
+#ifndef ENCODER_WHEEL_CIRC
+#define ENCODER_WHEEL_CIRC       Q16_FROM_FLOAT(0.2513f)  // m, 80 mm tekerlek
+#endif
+#define ENCODER_COUNTS_PER_EDGE  4U        // x4: her A yükselen kenarı 4 sayım
+
+// --- Zamanlama ---
+#define ENCODER_TICK_HZ          8000000U  // Kenar zamanı TIM2 ile (OPTICAL_IC_TICK_HZ)
+#define ENCODER_SAMPLE_HZ        1000U     // Encoder_Update hızı; TIM2 16 bit 8.2 ms'de döner, daha seyrek olamaz
+#define ENCODER_MT_WINDOW        (ENCODER_TICK_HZ / 100U)  // En kısa hız penceresi (10 ms)
+#define ENCODER_STOP_TICKS       (ENCODER_TICK_HZ / 4U)    // Bu kadar kenar yoksa durmuş
+#define ENCODER_PUBLISH_DIV      10U       // Her 10 örnekte bir SharedData (100 Hz)
+#define ENCODER_STILL_TICKS      (ENCODER_TICK_HZ / 50U)   // Sayım bu kadar kıpırdamazsa tekerlek duruyor
+#define ENCODER_STILL_COUNTS     2         // Dururken titreşimle oynayabilecek sayım
+
+// Donanım
+#define ENCODER_EDGE_CHANNEL     TIM_CHANNEL_2   // TIM2_CH2 = PA1, A kanalı
+#define ENCODER_COUNT_CHANNEL    TIM_CHANNEL_1   // TIM1 CCR1: A kenarındaki sayım
+
+// Bir örnekte donanımdan okunanlar
+typedef struct {
+    int32_t wraps;         // Sayaç taşmaları (ileri +1, geri -1)
+    uint16_t count;        // TIM1 CNT
+    uint16_t edge_count;   // TIM1 CCR1: son A yükselen kenarındaki sayım
+    uint16_t edge_time;    // TIM2 CCR2: aynı kenarın zamanı (alt 16 bit)
+    uint32_t now;          // Örnek anı (OpticalSensor_GetTimestamp)
+} EncoderRaw_t;
+
+typedef struct {
+    uint32_t samples;
+    uint32_t mt_updates;   // M/T penceresi kapanıp hız hesaplanan
+    uint32_t bounded;      // Kenar gecikti, hız süreyle sınırlandı
+    uint32_t stops;        // ENCODER_STOP_TICKS boyunca kenar yok
+    uint32_t max_step;     // İki örnek arasındaki en büyük sayım farkı
+} EncoderStats_t;
+
+/**
+ * @brief Enkoder ve kenar yakalama kanalını başlatır.
+ * @param enc_htim TIM1, MX_TIM1_Init'te enkoder moduna (TI12) ayarlanmış
+ * @param ic_htim TIM2 (optik sensörle ortak 8 MHz sayaç)
+ */
+void Encoder_Init(TIM_HandleTypeDef *enc_htim, TIM_HandleTypeDef *ic_htim);
+
+/**
+ * @brief Hesap durumunu sıfırlar (donanıma dokunmaz).
+ */
+void Encoder_Reset(void);
+
+/**
+ * @brief HAL_TIM_PeriodElapsedCallback içinden (TIM1): taşma/alttan taşma sayar.
+ */
+void Encoder_OverflowCallback(TIM_HandleTypeDef *htim);
+
+/**
+ * @brief ENCODER_SAMPLE_HZ'de çağrılır: sayaç ve kenar yakalamayı okuyup Encoder_Sample'a verir.
+ */
+void Encoder_Update(uint32_t now);
+
+/**
+ * @brief Bir örneği işler; her ENCODER_PUBLISH_DIV örnekte mesafe ve hızı
+ * VehicleState'e yazar.
+ */
+void Encoder_Sample(const EncoderRaw_t *raw);
+
+/**
+ * @brief Sayım son ENCODER_STILL_TICKS boyunca ±ENCODER_STILL_COUNTS içinde
+ * kaldıysa 1 (tekerlek duruyor; füzyonun sıfır hız düzeltmesi için).
+ * Hızdan farkı: ENCODER_STOP_TICKS beklemez, kalkışta ilk sayımlarda düşer.
+ */
+uint8_t Encoder_IsStill(void);
+
+/**
+ * @brief Son örnekteki mesafe (m, başlangıçtan) ve hız (m/s).
+ */
+void Encoder_Get(q16_t *distance, q16_t *velocity);
+
+void Encoder_GetStats(EncoderStats_t *stats);
+
+#endif
@@ -13,27 +13,155 @@
 #define REG_SMPLRT_DIV       0x19
 #define REG_GYRO_CONFIG      0x1B
 #define REG_ACCEL_CONFIG     0x1C
+#define REG_FIFO_EN          0x23
+#define REG_INT_PIN_CFG      0x37
+#define REG_INT_ENABLE       0x38
+#define REG_INT_STATUS       0x3A
 #define REG_ACCEL_XOUT_H     0x3B
+#define REG_USER_CTRL        0x6A
 #define REG_PWR_MGMT_1       0x6B
+#define REG_FIFO_COUNTH      0x72
+#define REG_FIFO_R_W         0x74
 #define REG_WHO_AM_I         0x75
 
+// Register bitleri (FIFO modu)
+#define MPU6050_FIFO_EN_ALL      0xF8  // TEMP, XG, YG, ZG, ACCEL -> FIFO
+#define MPU6050_USER_FIFO_EN     0x40
+#define MPU6050_USER_FIFO_RESET  0x04
+#define MPU6050_INT_DATA_RDY_EN  0x01
+
+// --- Ölçüm aralıkları (derleme zamanı) ---
+// AFS_SEL: 0: ±2g, 1: ±4g, 2: ±8g (Hyperloop için seçilen), 3: ±16g
+#ifndef MPU6050_ACCEL_FS_SEL
+#define MPU6050_ACCEL_FS_SEL     2
+#endif
+// FS_SEL: 0: ±250dps, 1: ±500dps, 2: ±1000dps, 3: ±2000dps
+#ifndef MPU6050_GYRO_FS_SEL
+#define MPU6050_GYRO_FS_SEL      0
+#endif
+
+// Datasheet hassasiyetleri: ivme 16384/8192/4096/2048 LSB/g
+#define MPU6050_ACCEL_LSB_PER_G  (16384 >> MPU6050_ACCEL_FS_SEL)
+
+#if MPU6050_GYRO_FS_SEL == 0
+#define MPU6050_GYRO_LSB_PER_DPS 131.0
+#elif MPU6050_GYRO_FS_SEL == 1
+#define MPU6050_GYRO_LSB_PER_DPS 65.5
+#elif MPU6050_GYRO_FS_SEL == 2
+#define MPU6050_GYRO_LSB_PER_DPS 32.8
+#elif MPU6050_GYRO_FS_SEL == 3
+#define MPU6050_GYRO_LSB_PER_DPS 16.4
+#else
+#error "MPU6050_GYRO_FS_SEL 0..3 olmalı"
+#endif
+
+// Sıcaklık: T = ham / 340 + 36.53 °C
+#define MPU6050_TEMP_LSB_PER_C   340.0
+#define MPU6050_TEMP_OFFSET_C    36.53
+
+// --- FIFO modu ---
+// Örnek düzeni FIFO'da da register sırasıyla aynı: ivme(6) sıcaklık(2) jiroskop(6)
+#define MPU6050_SAMPLE_SIZE      14U
+#define MPU6050_RAW_AXES         7U    // Sayım sırası (MPU6050_FromRaw): ax ay az temp gx gy gz
+#define MPU6050_FIFO_SIZE        1024U
+#define MPU6050_FIFO_MAX_SAMPLES (MPU6050_FIFO_SIZE / MPU6050_SAMPLE_SIZE)
+
+// MPU6050'de FIFO eşik (watermark) kesmesi yok: INT pini her örnekte
+// (DATA_RDY, 1 kHz) darbe verir, bu kadar örnek birikince burst okunur
+#ifndef MPU6050_FIFO_BATCH
+#define MPU6050_FIFO_BATCH       4U
+#endif
+
+// Örnek zaman damgası geçmişi (2'nin kuvveti, FIFO kapasitesinden büyük)
+#define MPU6050_TS_HISTORY       128U
+
+// INT pini (EXTI). HAL_GPIO_EXTI_Callback bu pinde MPU6050_INT_Callback'i çağırmalı.
+#define MPU6050_INT_GPIO_PORT    GPIOB
+#define MPU6050_INT_PIN          GPIO_PIN_5
+
+// MPU6050_GetState
+#define MPU6050_STATE_OFF        0U
+#define MPU6050_STATE_INIT       1U    // WHO_AM_I / kurulum yazmaları kuyrukta
+#define MPU6050_STATE_READY      2U
+#define MPU6050_STATE_ERROR      3U    // Sensör yok, ID uyuşmadı veya kurulum yazılamadı
+
+typedef struct {
+    uint32_t timestamp;   // INT kesmesinde alınan zaman (çağıranın saati, ör. 8 MHz TIM2)
+    uint32_t seq;         // DATA_RDY sayacı; boşluk = kayıp örnek
+    IMU_Data_t data;      // Ham (filtresiz) çevrim
+    int16_t counts[MPU6050_RAW_AXES];  // Aynı örneğin sensör sayımları (olay logu)
+    IMU_Data_t filtered;  // Bu örnekte filtre zincirinin verdiği çıkış (imu_filter.h)
+    uint8_t has_filtered; // 0: seyreltmede, filtered yazılmadı
+} IMU_Sample_t;
+
+typedef struct {
+    uint32_t samples;         // Çevrilen örnek (tek örnek modunda okuma başına bir)
+    uint32_t bursts;          // Tamamlanan FIFO burst okuması
+    uint32_t fifo_overflows;  // FIFO taştı / hizası bozuldu -> sıfırlandı
+    uint32_t lost_samples;    // Taşmada kaybolan örnek (tahmini)
+    uint32_t dropped_reads;   // Okuma kuyruğa alınmadı (tek örnek modunda: önceki okuma hâlâ bekliyor)
+    uint32_t read_errors;     // Kuyruğa alınan okuma hatayla bitti (I2CBus tekrarlarından sonra)
+    uint32_t ts_resyncs;      // Örnek <-> INT eşlemesi düzeltildi (kaçırılmış INT)
+    uint32_t max_backlog;     // FIFO'da okunmayı bekleyen en fazla örnek
+} MPU6050_FifoStats_t;
+
+/**
+ * @brief Sensörü başlatır (MPU6050_ACCEL/GYRO_FS_SEL aralıkları). Beklemez:
+ * WHO_AM_I okuması ve kurulum yazmaları I2CBus kuyruğuna girer, sonuç
+ * callback zincirinde MPU6050_GetState ve VehicleState.imu_error_flag'e
+ * yazılır. I2CBus_Init'ten sonra çağrılır.
+ * @return 0: Kuyruğa alındı, 1: Hata (hat kapalı / cihaz tablosu dolu)
+ */
+uint8_t MPU6050_Init(void);
+
 /**
- * @brief Sensörü başlatır (±8g ve DMA için hazırlık).
- * @return 0: Başarılı, 1: Hata
+ * @brief Başlatma durumu (MPU6050_STATE_*).
  */
-uint8_t MPU6050_Init(I2C_HandleTypeDef *hi2c);
+uint8_t MPU6050_GetState(void);
 
 /**
- * @brief DMA ile okumayı tetikler (Main loop içinde periyodik çağrılmalı).
- * Non-blocking çalışır (İşlemciyi durdurmaz).
+ * @brief Tek örnek okumasını yüksek öncelikle kuyruğa atar (Main loop içinde
+ * periyodik çağrılmalı). Önceki okuma hâlâ kuyruktaysa yenisi eklenmez: o
+ * okuma hatta çıktığında en taze örneği getirir. Okuma bitince (I2CBus
+ * callback'i, kesme bağlamı) veri çevrilir, filtre zincirinden (imu_filter.h)
+ * geçirilir ve SharedData'ya yazılır (imu_raw her örnekte, imu filtre çıkışında).
  */
 void MPU6050_Start_DMA_Read(void);
 
 /**
- * @brief DMA okuması bittiğinde HAL kütüphanesi tarafından çağrılır.
- * Veriyi işler ve SharedData'ya yazar.
- * (Bu fonksiyonu main.c'deki HAL_I2C_MemRxCpltCallback içinden çağıracaksın)
+ * @brief FIFO modunu açar: FIFO'ya tüm eksenler + sıcaklık, INT pini DATA_RDY.
+ * Kurulum sürüyorsa bitince açılır. FIFO sıfırlama yazmaları kuyruğa girer;
+ * bu moddan sonra MPU6050_Start_DMA_Read çağrılmaz, okumaları INT kesmesi başlatır.
+ * @return 0: Başarılı / istendi, 1: Hata (sensör hazır değil)
+ */
+uint8_t MPU6050_FIFO_Start(void);
+
+/**
+ * @brief INT (DATA_RDY) kesmesi. Sadece zaman damgasını kaydeder, eşik dolunca
+ * FIFO burst okumasını başlatır. EXTI ve I2C kesmeleri aynı öncelikte olmalı.
+ * @param timestamp Kesme anı (tüm örnekler bu saatle damgalanır)
+ */
+void MPU6050_INT_Callback(uint32_t timestamp);
+
+/**
+ * @brief Tamamlanmış burst tamponlarını ana döngüde toplu olarak çevirir.
+ * Her örnek filtre zincirinden geçer; son ham örnek VehicleState.imu_raw'a
+ * (sayımları imu_raw_counts'a), son filtre çıkışı VehicleState.imu'ya yazılır. out'a her örnek
+ * zaman damgasıyla gider: ham çevrim ve sayımlar (kayıpsız log), filtre o
+ * örnekte çıkış verdiyse filtreli değer (füzyon; tek örnek moduyla aynı
+ * sinyal). Taşma sonrası FIFO sıfırlaması da buradan kuyruğa atılır.
+ * @param out Örneklerin yazılacağı dizi (NULL olabilir)
+ * @param max out kapasitesi; bir tampon ancak tamamı sığıyorsa işlenir
+ * @return Çevrilen örnek sayısı
+ */
+uint32_t MPU6050_FIFO_Process(IMU_Sample_t *out, uint32_t max);
+
+void MPU6050_GetFifoStats(MPU6050_FifoStats_t *stats);
+
+/**
+ * @brief Ham sensör sayımlarını (register sırası) Q16.16 birimlere çevirir;
+ * sürücünün kendi çevrimiyle aynı.
  */
-void MPU6050_DMA_Callback(void);
+void MPU6050_FromRaw(const int16_t *raw, IMU_Data_t *out);
 
 #endif
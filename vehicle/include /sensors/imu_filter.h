@@ -0,0 +1,100 @@
+/*
+ * imu_filter.h
+ *
+ * IMU filtre zinciri: sürücünün çevirdiği her örnek (1 kHz) yayından önce
+ * buradan geçer. VehicleState.imu filtreli değeri, VehicleState.imu_raw son
+ * ham örneği tutar.
+ *
+ *   ham (Q16) -> [CIC seyreltici, IMU_FILTER_DECIM > 1 ise]
+ *             -> [alçak geçiren biquad x IMU_FILTER_SECTIONS] -> yayın
+ *
+ * CIC: IMU_FILTER_CIC_ORDER kademe, R = IMU_FILTER_DECIM. İntegratörler her
+ * örnekte, tarak (comb) katları yalnız çıkışta çalışır; kazanç R^N kaydırmayla
+ * geri alınır (R 2'nin kuvveti). Taşma modüler aritmetikte zararsızdır,
+ * çıkış aralığı 32 bite sığdığı sürece sonuç doğrudur.
+ *
+ * Biquad: Butterworth (2 * IMU_FILTER_SECTIONS derece), çift doğrusal
+ * dönüşüm, çıkış hızında tasarlanır. Direct Form I, katsayılar Q2.30,
+ * 64 bit birikim (Cortex-M3'te SMULL/SMLAL) ve birinci derece hata geri
+ * beslemesi: kesilen alt bitler bir sonraki örneğe eklenir, düşük kesim
+ * frekansında da ölü bant / sınır salınımı olmaz. DC kazancı tam 1
+ * (üreteç orta katsayıyı buna göre yuvarlar): sabit sapma olduğu gibi geçer.
+ *
+ * Katsayılar imu_filter_coef.c'de, derleme sırasında host'ta
+ * imu_filter_gen ile üretilir (ntc_table.c gibi); ayarlar değişince
+ * make -C vehicle/host tabloyu yeniden üretir.
+ *
+ * Altı eksen tek döngüde işlenir; sıcaklık filtrelenmez (son değer geçer).
+ * İlk örnekler zinciri doldurur: CIC belleği dolana kadar çıkış yok, biquad
+ * ilk çıkışla kararlı duruma getirilir (açılışta 0'dan geçiş salınımı yok).
+ */
+
+#ifndef IMU_FILTER_H
+#define IMU_FILTER_H
+
+#include <stdint.h>
+#include "shared_data.h"
+
+// --- Ayarlar (imu_filter_coef.c bu değerlerle üretilir) ---
+#define IMU_FILTER_RATE_HZ       1000U  // Giriş: MPU6050 SMPLRT_DIV=7
+#ifndef IMU_FILTER_DECIM
+#define IMU_FILTER_DECIM         1U     // CIC seyreltme (1: kapalı; 2, 4, 8)
+#endif
+#define IMU_FILTER_CIC_ORDER     2U
+#ifndef IMU_FILTER_SECTIONS
+#define IMU_FILTER_SECTIONS      1U     // Eksen başına biquad (1 veya 2)
+#endif
+#ifndef IMU_FILTER_ACCEL_HZ
+#define IMU_FILTER_ACCEL_HZ      50     // -3 dB, Hz (tamsayı)
+#endif
+#ifndef IMU_FILTER_GYRO_HZ
+#define IMU_FILTER_GYRO_HZ       100
+#endif
+#define IMU_FILTER_OUT_HZ        (IMU_FILTER_RATE_HZ / IMU_FILTER_DECIM)
+
+// ImuFilter_Process için döngü bütçesi (72 MHz, kesmeler hariç)
+#ifndef IMU_FILTER_CYCLE_BUDGET
+#define IMU_FILTER_CYCLE_BUDGET  (150U + 350U * IMU_FILTER_SECTIONS)
+#endif
+
+#define IMU_FILTER_AXES          6U     // ivme x y z, jiroskop x y z
+#define IMU_FILTER_GROUPS        2U     // Katsayı grubu: 0 ivme, 1 jiroskop
+#define IMU_FILTER_COEF_SHIFT    30
+
+#if IMU_FILTER_DECIM != 1U && IMU_FILTER_DECIM != 2U && IMU_FILTER_DECIM != 4U && IMU_FILTER_DECIM != 8U
+#error "IMU_FILTER_DECIM 1, 2, 4 veya 8 olmalı"
+#endif
+#if IMU_FILTER_SECTIONS < 1U || IMU_FILTER_SECTIONS > 2U
+#error "IMU_FILTER_SECTIONS 1 veya 2 olmalı"
+#endif
+
+// y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2 (Q2.30; a'lar işareti çevrilmiş)
+typedef struct {
+    int32_t b0, b1, b2;
+    int32_t a1, a2;
+} ImuBiquad_t;
+
+typedef struct {
+    uint32_t inputs;          // İşlenen ham örnek
+    uint32_t outputs;         // Yayınlanan filtreli örnek
+} ImuFilterStats_t;
+
+// imu_filter_coef.c (üretilmiş)
+extern const ImuBiquad_t imu_filter_coef[IMU_FILTER_GROUPS][IMU_FILTER_SECTIONS];
+
+/**
+ * @brief Filtre durumunu sıfırlar (bir sonraki örnekle yeniden doldurulur).
+ * MPU6050_Init çağırır.
+ */
+void ImuFilter_Init(void);
+
+/**
+ * @brief Bir ham örneği zincire verir.
+ * @param out Yeni filtreli örnek (yalnız dönüş 1 ise yazılır)
+ * @return 1: out yazıldı (IMU_FILTER_OUT_HZ), 0: seyreltmede / dolum sürüyor
+ */
+uint8_t ImuFilter_Process(const IMU_Data_t *in, IMU_Data_t *out);
+
+void ImuFilter_GetStats(ImuFilterStats_t *stats);
+
+#endif
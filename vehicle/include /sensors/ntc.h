@@ -1 +1,88 @@
+/*
+ * ntc.h
+ *
+ * NTC termistör sıcaklık izleme. Her kanal bir gerilim bölücü: VDDA -
+ * NTC_R_SERIES_OHM - ADC girişi - NTC - GND. Kanallar ortak toplama
+ * motoruna (analog.h) kutu ortalamalı olarak kaydedilir; motor
+ * NTC_SAMPLES_PER_RESULT örneği 16 bit "aşırı örneklenmiş" koda indirger
+ * (12 bit + 4 bit kesir, gürültü ortalanır). NTC_Process görev bağlamında
+ * motorun sonuç bloğundan yeni seti alır.
+ *
+ * Kod -> °C: logaritma yok (FPU'suz MCU). ntc_table.c derleme sırasında
+ * host'ta ntc_table_gen ile β denkleminden üretilir; kod aralığı eşit
+ * parçalara bölünmüştür, parça numarası kodun üst bitleridir. Bir kanalın
+ * çevrimi bir kaydırma, iki tablo okuması ve bir çarpmadır: arama yok,
+ * süre kanal sayısından ve sıcaklıktan bağımsız.
+ */
 
+#ifndef NTC_H
+#define NTC_H
+
+#include "stm32f1xx_hal.h"
+#include "fixed_point.h"
+#include "analog.h"
+
+// --- Termistör ve bölücü (ntc_table.c bu değerlerle üretilir) ---
+#ifndef NTC_R25_OHM
+#define NTC_R25_OHM              10000     // 25 °C'deki direnç
+#endif
+#ifndef NTC_BETA_K
+#define NTC_BETA_K               3950      // β (25/85 °C)
+#endif
+#ifndef NTC_R_SERIES_OHM
+#define NTC_R_SERIES_OHM         10000     // VDDA tarafındaki sabit direnç
+#endif
+#define NTC_TABLE_BITS           8         // 2^8 parça, 257 nokta (1 KB flash)
+#define NTC_TABLE_SIZE           ((1U << NTC_TABLE_BITS) + 1U)
+#define NTC_TABLE_SHIFT          (16U - NTC_TABLE_BITS)
+#define NTC_TEMP_MIN_C           (-55)     // Tablo bu aralığa kırpılır
+#define NTC_TEMP_MAX_C           200
+
+// --- Kanallar: PA4..PA7 (ADC12_IN4..7) ---
+#define NTC_CHANNELS             4U
+#define NTC_ADC_CHANNEL_LIST     { ADC_CHANNEL_4, ADC_CHANNEL_5, ADC_CHANNEL_6, ADC_CHANNEL_7 }
+#define NTC_SAMPLE_TIME          ADC_SAMPLETIME_239CYCLES_5  // 10k kaynak empedansı için uzun örnekleme
+
+// --- Aşırı örnekleme ---
+// 12 MHz ADC saatinde 252 saat/dönüşüm: yalnız NTC kanallarıyla 32 tarama
+// ~2.7 ms'de bir yarım tampon, 16 yarımda (~43 ms, ~23 Hz) bir sonuç.
+// Motora başka kanal eklenince yarım tampon ve sonuç aralığı uzar.
+#define NTC_DECIMATION_LOG2      4U        // 2^4 yarım tampon
+#define NTC_SAMPLES_PER_RESULT   (ANALOG_SEQ_PER_HALF << NTC_DECIMATION_LOG2)
+
+// --- Sınırlar ---
+#define NTC_OVERTEMP_C           Q16_FROM_INT(70)  // Bayrak kalkar
+#define NTC_OVERTEMP_CLEAR_C     Q16_FROM_INT(65)  // Bu değerin altında iner (histerezis)
+#define NTC_CODE_SHORT           655U      // 16 bit kod; altı: NTC kısa devre (~180 °C üstü)
+#define NTC_CODE_OPEN            64880U    // üstü: NTC takılı değil / kopuk (~-50 °C altı)
+
+typedef struct {
+    uint32_t processed;       // NTC_Process'in yayınladığı set
+    uint32_t missed;          // İşlenmeden üzerine yazılan set
+    uint32_t overtemp_events; // Bayrağın kalktığı an sayısı (tüm kanallar)
+} NtcStats_t;
+
+// ntc_table.c (üretilmiş): parça sınırlarındaki sıcaklıklar, °C
+extern const q16_t ntc_table[NTC_TABLE_SIZE];
+
+/**
+ * @brief Kanalları toplama motoruna kaydeder. Analog_Start'tan önce çağrılır.
+ * @return 0: Başarılı, 1: motorda yer yok
+ */
+uint8_t NTC_Init(void);
+
+/**
+ * @brief Yeni ortalama set varsa °C'ye çevirir, bayrakları günceller ve
+ * VehicleState'e yazar. Görev bağlamında çağrılır.
+ * @return 1: yeni set yayınlandı
+ */
+uint8_t NTC_Process(void);
+
+/**
+ * @brief 16 bit aşırı örneklenmiş kod -> °C (tablo + doğrusal ara değer).
+ */
+q16_t NTC_CodeToTemp(uint16_t code);
+
+void NTC_GetStats(NtcStats_t *stats);
+
+#endif
@@ -4,30 +4,161 @@
 #include "stm32f1xx_hal.h"
 #include "shared_data.h"
 
-// Tünel sabitleri (metre cinsinden)
-#define TUNNEL_START_OFFSET      5.0f      // İlk 5m kapsül alanı
-#define FIRST_REFLECTOR_DIST     11.0f     // İlk reflektörün başlangıca uzaklığı (5m+6m)
-#define REFLECTOR_SPACING        4.0f      // Normal reflektör aralığı (metre)
-#define INFO_STRIP_SPACING       0.05f     // Özel işaret bölgelerinde aralık (5 cm)
-
-// Özel bölge başlangıçları (tünel başlangıcından itibaren metre)
-#define LAST_100M_MARK_START     97.0f     // Son 100m işaretinin başlangıcı
-#define LAST_48M_MARK_START      149.0f    // Son 48m işaretinin başlangıcı
+// Tünel geometrisi (işaret konumları, bölgeler, fren noktası) tunnel_map.h'de
 
 // Sensor pin tanımı (OMRON E3FA için)
 #define OPTICAL_SENSOR_PIN       GPIO_PIN_0
 #define OPTICAL_SENSOR_PORT      GPIOA
 
+// Giriş yakalama: PA0 = TIM2_CH1. Kenar zamanı donanımda yakalanır,
+// kesme gecikmesinden bağımsızdır.
+#define OPTICAL_IC_TICK_HZ       8000000U  // 72MHz / 9 -> 125 ns çözünürlük
+#define OPTICAL_IC_PRESCALER     (72000000U / OPTICAL_IC_TICK_HZ - 1U)
+#define OPTICAL_IC_CHANNEL       TIM_CHANNEL_1
+#define OPTICAL_IC_ACTIVE_CH     HAL_TIM_ACTIVE_CHANNEL_1
+// Donanım giriş filtresi (yazılım debounce yerine):
+// CKD=DIV4 -> fDTS = 18MHz, ICF=0xF -> fSAMPLING = fDTS/32, N=8 => ~14 µs.
+// Bundan kısa parazit darbeleri yakalama üretmez.
+#define OPTICAL_IC_CLOCK_DIV     TIM_CLOCKDIVISION_DIV4
+#define OPTICAL_IC_FILTER        0x0FU
+
+// Kenar kapısı: sıradaki işaretin kenarı, son aralıkların hız ve ivmesinden
+// tahmin edilen yolla karşılaştırılır (sabit süreli debounce yerine hıza
+// göre ölçeklenen pencere). Pencere dışındaki kenar parazit sayılıp atılır,
+// birkaç işaret ilerideki adaya uyan kenarda aradakiler kayıp sayılır.
+#define OPTICAL_GATE_WINDOW         Q16_FROM_FLOAT(0.3f)   // Beklenen mesafenin ±%30'u
+#define OPTICAL_GATE_MAX_REJECTS    3U    // Art arda bu kadar red: kenar en yakın adaya kabul edilir
+#define OPTICAL_GATE_MAX_ACCEL      Q16_FROM_FLOAT(20.0f)  // m/s^2, tahmin bununla sınırlanır
+#define OPTICAL_GATE_ACCEL_HORIZON  (OPTICAL_IC_TICK_HZ / 2U)  // İvme en fazla 0.5 s ileri taşınır
+
 // Sistem durumları
 #define SYS_IDLE     0
 #define SYS_READY    1
 #define SYS_RUNNING  2
 #define SYS_BRAKING  3
 
+typedef struct {
+    uint32_t strip_fixes;     // Uygulanan şerit grubu düzeltmesi
+    uint32_t strip_resyncs;   // Düzeltmenin işaret indeksini değiştirdiği
+    uint32_t strip_rejected;  // Kapı tahminiyle çelişip uygulanmayan düzeltme
+    uint32_t held_edges;      // Şerit patlamasında, harita reflektör beklerken gelen kenar
+    uint32_t skipped_strips;  // Grup yarıda bitti, görülmeyen sayılıp atlanan şerit
+    uint32_t unmapped_edges;  // Haritadaki son işaretten sonra gelen kenar
+    uint32_t gate_accepted;   // İşaret olarak sayılan kenar
+    uint32_t gate_rejected;   // Tahmin penceresi dışında kalıp atılan kenar
+    uint32_t gate_inferred;   // Kenarı görülmeyip aralıktan çıkarılan reflektör
+    uint32_t gate_reacquired; // Art arda redden sonra pencere dışında kabul
+    uint8_t last_confidence;  // Son çözülen grubun güveni (0..100)
+} OpticalMarkerStats_t;
+
+typedef struct {
+    q16_t two_point;          // Son iki işaretten dist/dt (m/s)
+    q16_t accel;              // Son uydurmanın ivmesi (m/s^2)
+    q16_t residual;           // Son uydurmanın artık RMS'i (m)
+    uint8_t points;           // Son uydurmadaki işaret
+    uint8_t fitted;           // 1: current_velocity uydurmadan, 0: iki noktadan
+    uint32_t rejected;        // Artık VELFIT_MAX_RESIDUAL'ı aştı, iki nokta kullanıldı
+    uint32_t updates;         // Uydurmaya eklenen işaret
+    uint32_t rebuilds;        // Çerçeve yeniden kurulumu (velocity_fit.h)
+    uint32_t restarts;        // İvme değişti, pencere yeniden başladı
+} OpticalVelocity_t;
+
+// Bir işaretin VehicleState'e yayınlanacak sonucu
+typedef struct {
+    q16_t position;           // m
+    q16_t velocity;           // m/s
+    uint32_t reflector_count;
+    uint8_t has_velocity;     // 0: hız yok (ilk işaret), önceki değer kalır
+} OpticalUpdate_t;
+
 void OpticalSensor_Init(void);
-void OpticalSensor_EXTI_Callback(uint16_t GPIO_Pin);
-void OpticalSensor_CalculatePositionVelocity(void);
+
+/**
+ * @brief Yazılımla üretilen kenar (otomatik simülasyon, self-test): o anki
+ * sayaçla hemen işlenir, kenar kuyruğunu kullanmaz (tek üreticisi TIM2
+ * yakalama kesmesi, edge_queue.h). Ana döngüden çağrılır; önce kuyrukta
+ * bekleyen yakalamalar işlenir.
+ */
+void OpticalSensor_SoftwareEdge(void);
+
+/**
+ * @brief Giriş yakalama timer'ını (update + CC kesmeleri) başlatır.
+ * Timer MX_TIM2_Init içinde IC moduna ayarlanmış olmalı.
+ */
+void OpticalSensor_IC_Start(TIM_HandleTypeDef *htim);
+
+/**
+ * @brief HAL_TIM_IC_CaptureCallback içinden çağrılır; yakalanan kenarı işler.
+ */
+void OpticalSensor_IC_CaptureCallback(TIM_HandleTypeDef *htim);
+
+/**
+ * @brief HAL_TIM_PeriodElapsedCallback içinden çağrılır; 16-bit sayacı 32-bit'e genişletir.
+ */
+void OpticalSensor_IC_OverflowCallback(TIM_HandleTypeDef *htim);
+
+/**
+ * @brief Genişletilmiş sayacın o anki değeri (OPTICAL_IC_TICK_HZ tick).
+ * Timer başlatılmadıysa HAL_GetTick'ten türetilir.
+ */
+uint32_t OpticalSensor_GetTimestamp(void);
+
+/**
+ * @brief Sıradaki harita işaretine göre konum/hızı hesaplar, işaret sayımını
+ * ilerletir. Hız iki noktalı dist/dt; kenar işleyici geçerli uydurmayı
+ * (velocity_fit.h) bunun üzerine yazar. VehicleState'e yazmaz: sonuç tek bir
+ * kısa SharedData bölgesinde yayınlanır. İşaret tablodayken çağrılmalı.
+ */
+void OpticalSensor_CalculatePositionVelocity(OpticalUpdate_t *out);
+
+/**
+ * @brief Kenar kuyruğunu boşaltır; her olay için konum/hız/durum günceller,
+ * biten şerit grubunu çözer. Ana döngüden çağrılır (ISR'ler sadece kuyruğa yazar).
+ * @return İşlenen olay sayısı
+ */
+uint32_t OpticalSensor_Process(void);
+
+/**
+ * @brief Kayıttan oynatma (flight_replay): kuyruğu ve saati atlayıp
+ * OpticalSensor_Process'in kenar ve şerit zaman aşımı yollarını çalıştırır.
+ * ReplayStrip'in verdiği an kayıttaki FLIGHTREC_STRIP anıdır.
+ * @return ReplayStrip: 1 açık grup kapandı (kayıtla tutarlı), 0 kapanmadı
+ */
+void OpticalSensor_ReplayEdge(uint32_t timestamp);
+uint8_t OpticalSensor_ReplayStrip(uint32_t now);
+
+/**
+ * @brief Fren denetçisinden: frenin tuttuğu an (IC tick) ve yavaşlama
+ * (m/s^2). Kenar kapısı bu andan sonraki yolu bu yavaşlamayla tahmin eder.
+ * Kayda alınır (FLIGHTREC_BRAKE), oynatmada aynen verilir.
+ */
+void OpticalSensor_SetBraking(uint32_t onset, q16_t decel);
+
+/**
+ * @brief Hız kestirimi durumu: iki noktalı hız, uydurmanın ivmesi ve artığı.
+ */
+void OpticalSensor_GetVelocity(OpticalVelocity_t *out);
+
+/**
+ * @brief Kenar kuyruğu istatistikleri (taşma sayısı, en yüksek doluluk,
+ * tek üretici ihlali: sıfır kalmalı).
+ */
+void OpticalSensor_GetQueueStats(uint32_t *overflow_count, uint32_t *high_water, uint32_t *producer_faults);
+
+/**
+ * @brief İşaret sayımı ve şerit çözücü sayaçları.
+ */
+void OpticalSensor_GetMarkerStats(OpticalMarkerStats_t *stats);
+
 void OpticalSensor_SimulateTest(uint32_t interval_ms, uint8_t mode);
 void OpticalSensor_DebugOutput(void);
 
+/**
+ * @brief Tam otomatik test: sensör kesmelerini tünel haritasına göre simüle eder.
+ * Start bir kez, Step zamanlayıcının test görevinden (100 Hz) çağrılır.
+ * @return Step: 1 test sürüyor, 0 bitti (özet yazıldı)
+ */
+void OpticalSensor_RealTestStart(void);
+uint8_t OpticalSensor_RealTestStep(void);
+
 #endif
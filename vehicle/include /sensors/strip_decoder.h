@@ -0,0 +1,88 @@
+/*
+ * strip_decoder.h
+ *
+ * Bilgi şeridi çözücü. Birbirine yakın kenarlar (aralarındaki mesafe
+ * STRIP_BURST_GAP'ten kısa) bir patlama oluşturur. Patlama bitince kenar
+ * sayısı ve aralıkları tünel haritasındaki şerit gruplarıyla karşılaştırılır.
+ * Eşleşen grubun son şeridi mutlak konum düzeltmesi, şerit aralığı ise
+ * ortalama hız verir.
+ *
+ * Kayıp şerit ile birleşmiş (çözülemeyen) şerit aynı izi bırakır: medyanın
+ * katı kadar uzun bir aralık. Bu aralıklardan eksik şerit sayısı çıkarılır
+ * ve güven değeri buna göre düşürülür. Grubun başındaki veya sonundaki
+ * kayıp aralıktan görülmez, sadece sayı farkı olarak güveni düşürür.
+ */
+
+#ifndef STRIP_DECODER_H
+#define STRIP_DECODER_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+#define STRIP_BURST_GAP          Q16_FROM_FLOAT(0.5f)  // Bu mesafeden kısa aralık: aynı patlama
+#define STRIP_MAX_EDGES          32U
+#define STRIP_IDLE_TICKS         8000000U              // Çok düşük hızda bile patlama en geç 1 s'de kapanır
+#define STRIP_MIN_CONFIDENCE     50U                   // Bunun altındaki eşleşme düzeltme olarak kullanılmaz
+
+// Güven cezaları (100 üzerinden)
+#define STRIP_PENALTY_MISSING    10U   // Aralıktan çıkarılan her kayıp/birleşik şerit
+#define STRIP_PENALTY_COUNT      20U   // Beklenen şerit sayısından her fark
+#define STRIP_PENALTY_IRREGULAR  20U   // Aralıklar katlarına %25'ten fazla uymuyor
+
+typedef struct {
+    uint8_t zone;          // Eşleşen TUNNEL_ZONE_* (NONE: eşleşme yok)
+    uint8_t slot;          // TunnelParams_t.zones indeksi
+    uint8_t edges;         // Görülen kenar
+    uint8_t missing;       // Aralıklardan çıkarılan kayıp/birleşik şerit
+    uint8_t confidence;    // 0..100
+    q16_t position;        // Son görülen şeridin mutlak konumu (m)
+    q16_t velocity;        // Patlama boyunca ortalama hız (m/s)
+    uint32_t timestamp;    // Son görülen şeridin kenar anı
+    uint16_t next_marker;  // Gruptan sonraki ilk işaretin harita indeksi
+} StripFix_t;
+
+typedef struct {
+    uint32_t bursts;       // Kapanan patlama (>= 2 kenar)
+    uint32_t decoded;      // Güveni yeterli eşleşme
+    uint32_t rejected;     // Eşleşmeyen veya güveni düşük
+    uint32_t missing;      // Toplam çıkarılan kayıp/birleşik şerit
+    uint32_t overflow;     // STRIP_MAX_EDGES'i aşan patlama
+} StripDecoderStats_t;
+
+void StripDecoder_Init(void);
+
+/**
+ * @brief Kenarı patlamaya ekler. Kenar uzun aralıkla geldiyse önceki patlama
+ * kapanır ve çözülür; kenar yeni bir patlamanın olası ilk şerididir.
+ * @param velocity Güncel hız tahmini. Sadece yeni patlamanın ilk kenarında
+ * alınır; grup içindeki (belki yanlış sayılmış) şerit hızları eşiği değiştirmez
+ * @return 1: önceki patlama çözüldü, fix dolduruldu
+ */
+uint8_t StripDecoder_Edge(uint32_t timestamp, q16_t velocity, StripFix_t *fix);
+
+/**
+ * @brief Son kenar bir önceki kenarla aynı patlamadaysa 1.
+ */
+uint8_t StripDecoder_InBurst(void);
+
+/**
+ * @brief Poll'un kapatabileceği (en az bir kenarlı) açık bir grup varsa 1.
+ */
+uint8_t StripDecoder_Pending(void);
+
+/**
+ * @brief Son kenar yeni bir patlamanın tek kenarıysa onu geri alır
+ * (kenar kapısının reddettiği parazit şerit grubuna karışmasın).
+ */
+void StripDecoder_Discard(void);
+
+/**
+ * @brief Zaman aşımı: son kenardan beri STRIP_BURST_GAP kadar yol alındıysa
+ * patlamayı kapatıp çözer. Ana döngüden çağrılır.
+ * @return 1: patlama çözüldü, fix dolduruldu
+ */
+uint8_t StripDecoder_Poll(uint32_t now, StripFix_t *fix);
+
+void StripDecoder_GetStats(StripDecoderStats_t *stats);
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * velocity_fit.h
+ *
+ * Kayan pencereli en küçük kareler hız kestirimi. Son VELFIT_WINDOW işaretin
+ * (reflektör ve şerit) kenar zamanı / harita konumu çiftlerine ikinci derece
+ * polinom x(t) = b0 + b1*t + b2*t^2 uydurulur; hız eğrinin en yeni noktadaki
+ * türevi, ivme 2*b2'dir. İki noktalı dist/dt'den farkı: tek bir geç kenar
+ * pencere boyunca yayılır, sabit ivmede gecikme yoktur.
+ *
+ * Toplamlar (sum t^k, sum t^k*x, sum x^2) eklenen noktada artırılır, çıkan
+ * noktada azaltılır: güncelleme O(1). Zaman bir çerçeveye göredir (başlangıç
+ * + 2^shift tick birim, en yakın birime yuvarlı). Yeni nokta çerçeveden
+ * taşınca başlangıç ona kaydırılır: toplamlar binom açılımıyla kesin
+ * güncellenir, sabit hızda yeniden kurulum olmaz. Birim yalnız pencere süresi
+ * çerçeveyi aşınca (yavaşlama) veya çerçevenin 1/16'sından kısalınca
+ * (hızlanma) yeniden seçilip toplamlar pencereden hesaplanır (O(pencere)).
+ *
+ * Toplamlar int64 tam sayı: |u| < 2^VELFIT_TIME_BITS, |d| < 2^VELFIT_DISP_BITS
+ * (Q16) ve pencere <= 8 noktada en büyüğü sum u^4 < 2^63; ekle/çıkar/kaydır
+ * kayıpsız, kalıntı birikmez. Zaman birimi pencere süresinin en az 2^-14'ü
+ * (8 m/s'de 4 m aralıkla ~0.25 ms); birime yuvarlamanın kalanı noktanın
+ * konumundan son hız kestirimiyle düşülür (x - v*kalan), sabit hızda
+ * uydurma iki nokta kadar kesindir.
+ *
+ * Çözüm de tam sayı (F103'te FPU yok): toplamlar pencerenin tam sayı
+ * ortalamasına kesin taşınır, merkezlenmiş momentler int64'te kalır; 2x2
+ * sistem dik tabanda (1, tau, tau^2 - r*tau - c) iki karşılıklı değer ve
+ * 128 bit ara çarpımla (fixed_point.h q64_*) çözülür; artıklar pencerenin
+ * noktalarında 2^-32 çözünürlükle, RMS'i tam sayı karekökle. Kenar başına bir kez; çağıran bunu SharedData yazma
+ * bölgesinin dışında yapar.
+ *
+ * Yeni nokta bir önceki uydurmanın öngörüsünden VELFIT_BREAK'ten fazla
+ * saparsa ivme değişmiştir (fren tuttu, hızlanma bitti): ikinci derece eğri
+ * iki rejimi birlikte uyduramaz, pencere son noktadan yeniden başlar.
+ */
+
+#ifndef VELOCITY_FIT_H
+#define VELOCITY_FIT_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+#ifndef VELFIT_WINDOW
+#define VELFIT_WINDOW        8U     // Uydurulan son işaret sayısı
+#endif
+#define VELFIT_TIME_BITS     15U    // Çerçeve içi |zaman| < 2^15 birim (u^4 toplamı int64'e sığar)
+#define VELFIT_DISP_BITS     24U    // Çerçeve içi konum farkı < 256 m (Q16)
+#define VELFIT_MIN_POINTS    4U     // Artık denetlenebilsin: 3 noktalı eğri her noktadan geçer
+
+// Yeni nokta öngörüden bu kadar saparsa pencere yeniden başlar (m)
+#ifndef VELFIT_BREAK
+#define VELFIT_BREAK         Q16_FROM_FLOAT(0.03f)
+#endif
+
+// Artıkların RMS'i bunu aşarsa uydurma güvenilmez (ör. işaret sayımı kaymış)
+#ifndef VELFIT_MAX_RESIDUAL
+#define VELFIT_MAX_RESIDUAL  Q16_FROM_FLOAT(0.1f)
+#endif
+
+#if VELFIT_WINDOW < VELFIT_MIN_POINTS || VELFIT_WINDOW > 8U
+#error "VELFIT_WINDOW 4..8 olmalı (artık denetimi; int64 u^4 toplamı)"
+#endif
+
+// Çerçevedeki toplamlar: sum u^k (k = 1..4), sum u^k*d (k = 0..2)
+typedef struct {
+    int64_t u, uu, u3, u4;
+    int64_t d, ud, uud;
+} VelFitSums_t;
+
+typedef struct {
+    uint32_t t[VELFIT_WINDOW];   // Kenar zamanı (OPTICAL_IC_TICK_HZ)
+    q16_t x[VELFIT_WINDOW];      // İşaret konumu (m)
+    q16_t xc[VELFIT_WINDOW];     // Zaman birimine yuvarlanan ana düzeltilmiş konum (toplamlara giren)
+    uint8_t head;                // Sıradaki yazma yeri
+    uint8_t n;                   // Penceredeki nokta
+
+    // Toplam çerçevesi: u = (t - t0) / 2^shift, d = xc - x0 (Q16)
+    uint32_t t0;
+    q16_t x0;
+    uint8_t shift;
+    VelFitSums_t s;
+
+    // Son kabul edilen çözüm: sıradaki noktanın öngörüsü için
+    q16_t pred_velocity;
+    q16_t pred_accel;
+    uint8_t pred_valid;
+
+    uint32_t updates;            // Eklenen nokta
+    uint32_t rebuilds;           // Çerçeve yeniden kurulumu (O(n) toplam)
+    uint32_t restarts;           // Öngörüden sapan nokta: pencere yeniden başladı
+} VelFit_t;
+
+typedef struct {
+    q16_t velocity;    // m/s, en yeni noktada
+    q16_t accel;       // m/s^2
+    q16_t residual;    // m, artıkların RMS'i (n - 3 serbestlik)
+    uint8_t points;    // Uydurulan nokta
+} VelFitResult_t;
+
+void VelFit_Init(VelFit_t *f);
+
+/**
+ * @brief Pencereyi boşaltır (ör. işaret sayımı düzeltildi); sayaçlar kalır.
+ */
+void VelFit_Reset(VelFit_t *f);
+
+/**
+ * @brief Noktayı pencereye ekler; pencere doluysa en eskisi çıkar, nokta
+ * son çözümün öngörüsünden VELFIT_BREAK'ten fazla saparsa pencere son
+ * noktadan yeniden başlar. Zamanlar artan sırada gelmeli (32-bit sarma
+ * farkla karşılanır).
+ */
+void VelFit_Add(VelFit_t *f, uint32_t timestamp, q16_t position);
+
+/**
+ * @brief Penceredeki noktalara ikinci derece uydurma. Artık
+ * VELFIT_MAX_RESIDUAL içindeyse çözüm sıradaki noktanın öngörüsü olur.
+ * @return 1: Çözüldü, 0: Nokta az (< VELFIT_MIN_POINTS) veya zamanlar ayrık değil
+ */
+uint8_t VelFit_Solve(VelFit_t *f, VelFitResult_t *out);
+
+#endif
@@ -1,35 +1,111 @@
 // shared_data.h
+//
+// VehicleState iki bağlamdan yazılır: ana döngü (optik, füzyon, FIFO IMU) ve
+// I2C DMA tamamlama kesmesi (tek örnek IMU). Tutarlılık seqlock ile sağlanır:
+//   - Yazarlar SharedData_WriteBegin/End arasında alanları günceller. Bölge
+//     kısa tutulur; kesme sadece yazar tarafında kısa süre kapatılır (iki
+//     yazar bağlamı birbirini bölmesin diye). Hesap bölgeden önce yapılır,
+//     bölgede yalnız hazır değerler saklanır; kapalı kalma süresi
+//     PROF_SHARED_WRITE probe'u ile ölçülür (profiler.h, bütçeli).
+//   - Birden fazla alanı birlikte kullanan okuyucular SharedData_Snapshot ile
+//     kopya alır; kesme kapatmaz, yazarı hiç bekletmez, yazma araya girerse
+//     kopyayı tekrarlar.
 
 #ifndef SHARED_DATA_H
 #define SHARED_DATA_H
 
 #include <stdint.h>
+#include "fixed_point.h"
+#include "fw_state.h"
+#include "sensors/ntc.h"
 
-// IMU verilerini düzenli tutmak için alt bir struct
+// IMU verilerini düzenli tutmak için alt bir struct (Q16.16)
 typedef struct {
-    float accel_x_g;    // X ekseni ivmesi (g cinsinden)
-    float accel_y_g;    // Y ekseni ivmesi (g cinsinden)
-    float accel_z_g;    // Z ekseni ivmesi (g cinsinden)
-    float gyro_x_dps;   // X ekseni jiroskop (derece/saniye)
-    float gyro_y_dps;   // Y ekseni jiroskop
-    float gyro_z_dps;   // Z ekseni jiroskop
-    float temp_c;       // Sıcaklık
+    q16_t accel_x_g;    // X ekseni ivmesi (g cinsinden)
+    q16_t accel_y_g;    // Y ekseni ivmesi (g cinsinden)
+    q16_t accel_z_g;    // Z ekseni ivmesi (g cinsinden)
+    q16_t gyro_x_dps;   // X ekseni jiroskop (derece/saniye)
+    q16_t gyro_y_dps;   // Y ekseni jiroskop
+    q16_t gyro_z_dps;   // Z ekseni jiroskop
+    q16_t temp_c;       // Sıcaklık
 } IMU_Data_t;
 
+// IMU + optik füzyon tahmini (fusion.c, IMU hızında güncellenir)
 typedef struct {
-    float current_velocity;
-    float current_position;
+    q16_t position;      // m
+    q16_t velocity;      // m/s
+    q16_t accel_bias;    // m/s^2, ivmeölçer X ekseni sapması
+    float cov[6];        // Kovaryans (üst üçgen): pp, pv, pb, vv, vb, bb
+    uint32_t timestamp;  // Tahminin ait olduğu an (8 MHz TIM2 tick)
+    uint32_t fix_count;  // Uygulanan konum düzeltmesi
+} NavEstimate_t;
+
+typedef struct {
+    q16_t current_velocity;  // m/s (Q16.16)
+    q16_t current_position;  // m   (Q16.16)
     uint32_t reflector_count;
-    uint32_t last_update_time;
+    uint32_t optical_time_ms;  // Son optik güncelleme (HAL_GetTick)
+    uint32_t imu_time_ms;      // Son filtreli IMU yayını (HAL_GetTick)
     uint8_t system_status; // 0: Idle, 1: Ready, 2: Braking
     
     // YENİ EKLENEN: IMU Verileri
-    IMU_Data_t imu; 
+    IMU_Data_t imu;      // Filtreli (imu_filter.h), IMU_FILTER_OUT_HZ'de
+    IMU_Data_t imu_raw;  // Son ham örnek (sürücü çevrimi)
+    int16_t imu_raw_counts[7];  // Aynı örneğin sensör sayımları, register sırası
+                                // (MPU6050_RAW_AXES; olay logu bunları kaydeder)
+    uint32_t imu_seq;      // Filtreli yayın sayacı (sürücü artırır): okuyucu yeni
+    uint32_t imu_raw_seq;  // örneği ayırır, aynı örneği iki kez işlemez
+    // Örnek anları, I2C hat saatinde (I2CBus_Now, 8 MHz TIM2): tek örnek
+    // modunda DMA okumasının bittiği, FIFO modunda örneğin INT anı
+    uint32_t imu_time;     // imu'nun (filtre çıkışının) örneği
+    uint32_t imu_raw_time; // imu_raw'ın örneği
+
+    // Reflektörler arasında da sürekli konum/hız (IMU + optik füzyon)
+    NavEstimate_t nav;
+
+    // Tekerlek enkoderi (encoder.c, 100 Hz)
+    q16_t encoder_distance;  // m, başlangıçtan
+    q16_t encoder_velocity;  // m/s, M/T yöntemi
+    uint32_t encoder_time;   // Son yayın (8 MHz TIM2 tick)
+
+    // NTC termistörleri (ntc.c, ~23 Hz)
+    q16_t ntc_temp_c[NTC_CHANNELS];  // °C; arızalı kanalda son geçerli değer
+    uint8_t ntc_overtemp;            // Kanal başına bit: NTC_OVERTEMP_C aşıldı
+    uint8_t ntc_fault;               // Kanal başına bit: açık/kısa devre
+    uint32_t ntc_time;               // Ortalama penceresinin ortası (TIM2, 8 MHz)
     
     // Hata takibi için (Sensör koptu mu?)
     uint8_t imu_error_flag; // 0: OK, 1: Hata
 } SharedData_t;
 
-extern SharedData_t VehicleState; 
+extern FW_THREAD_LOCAL SharedData_t VehicleState;
+
+/**
+ * @brief Yazma bölgesini açar. Bölge içinde başka bir bölge açılmamalı.
+ * @return SharedData_WriteEnd'e verilecek kesme durumu
+ */
+uint32_t SharedData_WriteBegin(void);
+
+/**
+ * @brief Yazma bölgesini kapatır, nesil sayacını bir artırır.
+ */
+void SharedData_WriteEnd(uint32_t key);
+
+/**
+ * @brief VehicleState'in tutarlı bir kopyasını alır (kesme kapatmaz).
+ * @return Kopyanın nesli: her tamamlanan yazma bölgesiyle bir artar
+ */
+uint32_t SharedData_Snapshot(SharedData_t *out);
+
+/**
+ * @brief Son tamamlanan yazmanın nesli (yeni veri var mı kontrolü için).
+ */
+uint32_t SharedData_Generation(void);
+
+/**
+ * @brief VehicleState'i açılıştaki haline (sıfır) döndürür; nesil sayacı
+ * sürer. Host'ta art arda koşuların arasında çağrılır (fw_state.h).
+ */
+void SharedData_Reset(void);
 
 #endif
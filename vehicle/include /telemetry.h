@@ -0,0 +1,88 @@
+/*
+ * telemetry.h
+ *
+ * İkili telemetri çerçevesi. SharedData_t sabit düzenli, little-endian bir
+ * pakete tamsayı olarak yazılır, sonuna CRC-16/CCITT eklenir ve COBS ile
+ * kodlanıp 0x00 ayracıyla bitirilir. Çerçeve içinde 0x00 bulunmadığı için
+ * alıcı akışın ortasından da senkron olabilir.
+ *
+ * Paket düzeni (TELEMETRY_VERSION 1, 35 byte):
+ *   0  u8   version
+ *   1  u16  seq
+ *   3  u32  time_ms
+ *   7  i32  position_mm
+ *  11  i32  velocity_mm_s
+ *  15  u16  reflector_count
+ *  17  u8   system_status
+ *  18  u8   error_flags      (bit0: IMU hatası)
+ *  19  i16  accel_mg[3]
+ *  25  i16  gyro_cdps[3]     (0.01 derece/s)
+ *  31  i16  temp_cc          (0.01 °C)
+ *  33  u16  crc              (0..32 üzerinden)
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include "shared_data.h"
+
+#define TELEMETRY_VERSION        1U
+#define TELEMETRY_PACKET_SIZE    35U
+// COBS en fazla 254 byte'ta bir ek byte + ayraç
+#define TELEMETRY_FRAME_MAX      (TELEMETRY_PACKET_SIZE + 2U)
+
+#define TELEMETRY_ERR_IMU        0x01U
+
+// Telemetry_Unpack dönüş değerleri
+#define TELEMETRY_OK             0
+#define TELEMETRY_ERR_FRAMING    1
+#define TELEMETRY_ERR_CRC        2
+#define TELEMETRY_ERR_VERSION    3
+
+typedef struct {
+    uint8_t  version;
+    uint16_t seq;
+    uint32_t time_ms;
+    int32_t  position_mm;
+    int32_t  velocity_mm_s;
+    uint16_t reflector_count;
+    uint8_t  system_status;
+    uint8_t  error_flags;
+    int16_t  accel_mg[3];
+    int16_t  gyro_cdps[3];
+    int16_t  temp_cc;
+} TelemetryPacket_t;
+
+/**
+ * @brief Durumdan bir paket doldurur (ölçek dönüşümleri burada).
+ */
+void Telemetry_FromState(const SharedData_t *state, uint16_t seq, uint32_t time_ms, TelemetryPacket_t *pkt);
+
+/**
+ * @brief Paketi serileştirir, CRC ekler, COBS ile kodlar, 0x00 ile bitirir.
+ * @param frame En az TELEMETRY_FRAME_MAX byte
+ * @return Çerçeve uzunluğu (ayraç dahil)
+ */
+uint16_t Telemetry_Encode(const TelemetryPacket_t *pkt, uint8_t *frame);
+
+/**
+ * @brief Ayraçsız bir COBS çerçevesini çözer ve doğrular.
+ * @return TELEMETRY_OK veya TELEMETRY_ERR_*
+ */
+uint8_t Telemetry_Decode(const uint8_t *frame, uint16_t len, TelemetryPacket_t *pkt);
+
+/**
+ * @brief VehicleState'in anlık görüntüsünü çerçeveleyip UART log halkasına yazar.
+ * Halka doluysa çerçeve atılır (sıra numarası yine de artar, alıcı boşluğu görür).
+ */
+void Telemetry_Send(void);
+
+uint16_t Telemetry_Crc16(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Parça parça CRC: ilk çağrıda crc = 0xFFFF, sonrakilerde önceki sonuç.
+ */
+uint16_t Telemetry_Crc16Update(uint16_t crc, const uint8_t *data, uint16_t len);
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * tunnel_map.h
+ *
+ * Tünel tanımı: işaretlerin (reflektör, bilgi şeridi) sıralı tablosu.
+ * Pist geometrisi kodda değil, bir parametre bloğunda durur:
+ *   - Blok flash'ın son sayfasına ayrı yazılabilir (TUNNEL_PARAMS_FLASH_ADDR);
+ *     başka bir pist için kod yeniden derlenmez, sadece blok değişir.
+ *   - Blok geçersizse (magic/sürüm/CRC/geometri) derlenmiş varsayılan kullanılır.
+ * TunnelMap_Init bloğu bir kez RAM'deki işaret tablosuna açar; kenar başına
+ * beklenen konum ve bölge indeksle O(1) okunur, karşılaştırma zinciri yoktur.
+ */
+
+#ifndef TUNNEL_MAP_H
+#define TUNNEL_MAP_H
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+#define TUNNEL_MAP_MAGIC         0x50414D54U   // "TMAP"
+#define TUNNEL_MAP_VERSION       2U    // 2: braking_distance yerine stop_margin
+#define TUNNEL_MAP_MAX_ZONES     4U
+#define TUNNEL_MAP_MAX_MARKERS   96U
+
+// 64 KB STM32F103C8'in son 1 KB flash sayfası
+#define TUNNEL_PARAMS_FLASH_ADDR 0x0800FC00U
+
+// İşaret tipleri
+#define TUNNEL_MARKER_REFLECTOR  0U
+#define TUNNEL_MARKER_STRIP      1U
+
+// Bölge kimlikleri (0: normal bölge)
+#define TUNNEL_ZONE_NONE         0U
+#define TUNNEL_ZONE_LAST_100M    1U
+#define TUNNEL_ZONE_LAST_48M     2U
+
+// TunnelMap_Init dönüş değerleri
+#define TUNNEL_MAP_OK            0
+#define TUNNEL_MAP_ERR_MISSING   1   // Blok yok (NULL)
+#define TUNNEL_MAP_ERR_HEADER    2   // magic, sürüm veya uzunluk uyuşmuyor
+#define TUNNEL_MAP_ERR_CRC       3
+#define TUNNEL_MAP_ERR_GEOMETRY  4   // Sırasız/çakışan işaret, tablo taşması
+
+// Aynı aralıkla dizilmiş şerit grubu
+typedef struct {
+    q16_t start;       // İlk şeridin konumu (m)
+    q16_t pitch;       // Şerit aralığı (m)
+    uint16_t count;    // Şerit sayısı
+    uint8_t id;        // TUNNEL_ZONE_*
+    uint8_t reserved;
+} TunnelZoneParams_t;
+
+// Flash'ta saklanan blok; tüm uzunluklar metre, Q16.16
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;            // sizeof(TunnelParams_t)
+    q16_t start_offset;         // Kapsülün başlangıç konumu
+    q16_t end_position;         // Tünel sonu
+    q16_t stop_margin;          // Kapsül sona en az bu kadar kala durmalı (fren denetçisi)
+    q16_t reflector_first;      // İlk reflektör
+    q16_t reflector_pitch;      // Reflektör aralığı (sona kadar tekrar eder)
+    uint16_t zone_count;
+    uint16_t reserved;
+    TunnelZoneParams_t zones[TUNNEL_MAP_MAX_ZONES];  // Konuma göre sıralı
+    uint16_t crc;               // CRC-16/CCITT, crc alanına kadar olan byte'lar
+    uint16_t pad;
+} TunnelParams_t;
+
+typedef struct {
+    q16_t position;      // m
+    uint8_t type;        // TUNNEL_MARKER_*
+    uint8_t zone;        // TUNNEL_ZONE_*
+    uint16_t zone_index; // Bölge içindeki sıra (normal bölgede 0)
+    uint16_t reflector_seq; // Bu işarete kadar (dahil) geçilen reflektör sayısı
+    uint16_t reserved;
+} TunnelMarker_t;
+
+/**
+ * @brief Parametre bloğunu doğrulayıp işaret tablosunu kurar.
+ * @param params Flash'taki blok (NULL: varsayılan)
+ * @return TUNNEL_MAP_OK veya TUNNEL_MAP_ERR_*; hata durumunda tablo
+ * derlenmiş varsayılanla kurulur, harita her durumda kullanılabilir
+ */
+uint8_t TunnelMap_Init(const TunnelParams_t *params);
+
+/**
+ * @brief Bloğun başlığını ve CRC'sini doldurur (blok yazan araçlar için).
+ */
+void TunnelMap_Seal(TunnelParams_t *params);
+
+/**
+ * @brief Derlenmiş varsayılan pist (186 m test tüneli).
+ */
+const TunnelParams_t *TunnelMap_Default(void);
+
+/**
+ * @brief Etkin parametreler.
+ */
+const TunnelParams_t *TunnelMap_Params(void);
+
+/**
+ * @brief index. işaret (tünel başından sıralı); tablo dışıysa NULL.
+ */
+const TunnelMarker_t *TunnelMap_Marker(uint16_t index);
+
+uint16_t TunnelMap_Count(void);
+
+/**
+ * @brief Params()->zones[slot] bölgesinin ilk şeridinin işaret indeksi.
+ */
+uint16_t TunnelMap_ZoneFirstMarker(uint8_t slot);
+
+/**
+ * @brief Duruş noktasının geçmemesi gereken konum (end_position - stop_margin).
+ */
+q16_t TunnelMap_StopLimit(void);
+
+#endif
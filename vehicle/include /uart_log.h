@@ -0,0 +1,52 @@
+/*
+ * uart_log.h
+ *
+ * Bloklamayan debug çıktısı: printf/_write verisi bir TX halkasına kopyalanır,
+ * USART2 TX DMA halkayı arka planda boşaltır. Half-transfer callback'i
+ * gönderilmiş ilk yarıyı erkenden serbest bırakır, böylece halkanın bir
+ * bölümü DMA tarafından okunurken diğerine yazılabilir (çift tampon).
+ * Halka doluysa mesaj bütün olarak atılır ve sayılır; çağıran asla beklemez.
+ */
+
+#ifndef UART_LOG_H
+#define UART_LOG_H
+
+#include "stm32f1xx_hal.h"
+#include <stdint.h>
+
+#define UART_LOG_BUF_SIZE   1024U   // 2'nin kuvveti olmalı
+
+typedef struct {
+    uint32_t written_bytes;    // Halkaya kabul edilen byte
+    uint32_t dropped_msgs;     // Yer olmadığı için atılan mesaj
+    uint32_t dropped_bytes;
+    uint32_t high_water;       // Halkanın en yüksek doluluğu (byte)
+    uint32_t dma_transfers;    // Başlatılan DMA transferi sayısı
+} UartLogStats_t;
+
+/**
+ * @brief Halkayı sıfırlar; huart'ın hdmatx'i bağlanmış olmalı.
+ */
+void UartLog_Init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief Veriyi halkaya kopyalar ve DMA boştaysa gönderimi başlatır.
+ * ISR ve ana döngüden çağrılabilir (kısa bir kritik bölge kullanır).
+ * @return 0: Kabul edildi, 1: Halka dolu, mesaj atıldı
+ */
+uint8_t UartLog_Write(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief HAL_UART_TxHalfCpltCallback / HAL_UART_TxCpltCallback içinden çağrılır.
+ */
+void UartLog_TxHalfCpltCallback(UART_HandleTypeDef *huart);
+void UartLog_TxCpltCallback(UART_HandleTypeDef *huart);
+
+/**
+ * @brief Halkada bekleyen (henüz gönderilmemiş) byte sayısı.
+ */
+uint32_t UartLog_Pending(void);
+
+void UartLog_GetStats(UartLogStats_t *stats);
+
+#endif
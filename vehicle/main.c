@@ -13,24 +13,123 @@
 #include "stm32f1xx_hal.h"
 #include "optical_sensor.h"
 #include "shared_data.h"
+#include "uart_log.h"
+#include "telemetry.h"
+#include "tunnel_map.h"
+#include "brake_supervisor.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "encoder.h"
+#include "analog.h"
+#include "ntc.h"
+#include "flight_recorder.h"
+#include "event_log.h"
+#include "imu_filter.h"
+#ifdef USE_IMU
+#include "i2c_bus.h"
+#include "imu.h"
+#include "fusion.h"
+#endif
 #include <stdio.h>
 #include <string.h>
 
 /* Private variables ---------------------------------------------------------*/
 UART_HandleTypeDef huart2; // Debug UART
-TIM_HandleTypeDef htim2;   // Timer for simulation
+DMA_HandleTypeDef hdma_usart2_tx; // USART2 TX -> DMA1 Kanal 7
+ADC_HandleTypeDef hadc1;   // Analog motoru: tek tarama sırası (NTC PA4..PA7)
+DMA_HandleTypeDef hdma_adc1;      // ADC1 -> DMA1 Kanal 1 (dairesel)
+TIM_HandleTypeDef htim1;   // Tekerlek enkoderi (PA8/PA9, enkoder modu)
+TIM_HandleTypeDef htim2;   // Optik sensör giriş yakalama (PA0 = TIM2_CH1)
+TIM_HandleTypeDef htim3;   // Timer for simulation
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_USART2_UART_Init(void);
+static void MX_ADC1_Init(void);
+static void MX_TIM1_Init(void);
 static void MX_TIM2_Init(void);
+static void MX_TIM3_Init(void);
 void Test_Menu(void);
-void Test_ManualTrigger(void);
-void Test_AutoSimulation(void);
+void Test_ManualTriggerStart(void);
+uint8_t Test_ManualTriggerStep(void);
+void Test_AutoSimulationStart(void);
+uint8_t Test_AutoSimulationStep(void);
+static void App_AcquisitionTask(void);
+static void App_EdgeTask(void);
+static void Test_AutoSimulationTrigger(void);
+static void App_TestTask(void);
+static void App_ThermalTask(void);
+#ifdef TELEMETRY_MODE
+static void App_TelemetryTask(void);
+#endif
 
 /* Global variables ----------------------------------------------------------*/
-volatile uint8_t sensor_triggered = 0;
+#ifdef USE_IMU
+extern I2C_HandleTypeDef hi2c1;  // I2C1 + DMA kurulumu CubeMX tarafında (i2c.c)
+#ifdef IMU_FIFO_MODE
+static IMU_Sample_t imu_batch[2U * MPU6050_FIFO_BATCH];  // FIFO_Process çıkışı (iki burst)
+#else
+static uint32_t imu_seq_seen = 0;      // İşlenen son filtreli / ham yayın
+static uint32_t imu_raw_seq_seen = 0;
+#endif
+#endif
+
+/* MPU6050 INT (EXTI9_5) önceliği: i2c.c'deki I2C1 olay/hata ve DMA
+ * kesmeleriyle aynı olmalı (imu.h: INT kesmesi burst'ü kuyruğa atarken I2C
+ * callback'i araya girmemeli) */
+#ifndef APP_IMU_IRQ_PRIORITY
+#define APP_IMU_IRQ_PRIORITY 2U
+#endif
+
+/* TIM2 (optik yakalama + taşma, enkoder kenar zamanı) en yüksek öncelikte:
+ * CCR1 sonraki kenardan önce okunmalı ve taşma 8.2 ms içinde sayılmalı;
+ * I2C/DMA/UART kesmeleri onu geciktirmemeli. TIM3 yalnız olay gönderir */
+#ifndef APP_EDGE_IRQ_PRIORITY
+#define APP_EDGE_IRQ_PRIORITY 0U
+#endif
+#ifndef APP_SIM_IRQ_PRIORITY
+#define APP_SIM_IRQ_PRIORITY 7U
+#endif
+
+/* Zamanlayıcı olayları: kesme Scheduler_Post ile gönderir, görevi bir
+ * sonraki tick beklenmeden uyanışta çalışır */
+#define APP_EVENT_EDGE       1U  // TIM2 yakalama: kenar kuyruğa girdi
+#define APP_EVENT_SIM_TICK   2U  // TIM3: otomatik simülasyon tetiği
+
+/* Görev tablosu --------------------------------------------------------------
+ * 1 kHz: kenar kuyruğu, IMU okuma / FIFO burst çevrimi ve fren denetçisi
+ *        (BRAKE_SUPERVISOR_HZ)
+ * 100 Hz: seçili test modunun bir adımı
+ * 50 Hz: NTC sıcaklıkları (ADC ~23 Hz'de yeni ortalama üretir)
+ * 50 Hz: ikili telemetri
+ * Olay: kenar kuyruğu (yakalama kesmesinden), simülasyon tetiği (TIM3)
+ * Arka plan: test menüsü (konsol), her uyanışta bir adım
+ * Aynı tick'e düşmesinler diye 10/20 ms'lik görevler kaydırılmış. */
+static const SchedulerTask_t app_tasks[] = {
+  { "acquisition", App_AcquisitionTask,       1,  0,  SCHEDULER_NO_EVENT },
+  { "test",        App_TestTask,              10, 3,  SCHEDULER_NO_EVENT },
+  { "thermal",     App_ThermalTask,           20, 11, SCHEDULER_NO_EVENT },
+#ifdef TELEMETRY_MODE
+  { "telemetry",   App_TelemetryTask,         20, 7,  SCHEDULER_NO_EVENT },
+#endif
+  { "edges",       App_EdgeTask,              0,  0,  APP_EVENT_EDGE },
+  { "sim_trigger", Test_AutoSimulationTrigger, 0, 0,  APP_EVENT_SIM_TICK },
+  { "console",     Test_Menu,                 0,  0,  SCHEDULER_NO_EVENT },
+};
+
+/* Test menüsü durumu: menü ve testler CPU'yu bekletmez, adım adım ilerler */
+#define MENU_SHOW    0U  // Menü yazılacak
+#define MENU_CHOICE  1U  // Seçim bekleniyor (1 s sonra varsayılan)
+#define MENU_TEST    2U  // Test görevi adımlıyor
+#define MENU_RETURN  3U  // Test bitti, 3 s sonra menü
+#define MENU_IDLE    4U  // Konsol boşta
+
+static uint8_t menu_state = MENU_SHOW;
+static uint8_t menu_after_test = MENU_RETURN;
+static uint32_t menu_time = 0;
+static uint8_t (*test_step)(void) = NULL;  // Çalışan testin adımı; 0 dönünce biter
 
 /**
   * @brief  The application entry point.
@@ -41,11 +140,16 @@ int main(void)
   /* MCU Configuration--------------------------------------------------------*/
   HAL_Init();
   SystemClock_Config();
+  Profiler_Init();        // PROFILER_ENABLE yoksa kod üretmez
   
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();          // UART TX ve ADC DMA kesmeleri (USART2_UART_Init'ten önce)
   MX_USART2_UART_Init();  // Debug UART
-  MX_TIM2_Init();         // Timer for simulation
+  MX_ADC1_Init();         // NTC taraması (DMA1 Kanal 1)
+  MX_TIM1_Init();         // Tekerlek enkoderi
+  MX_TIM2_Init();         // Optik sensör giriş yakalama
+  MX_TIM3_Init();         // Timer for simulation
   
   // LED GPIO'yu başlat (PC13)
   __HAL_RCC_GPIOC_CLK_ENABLE();
@@ -56,7 +160,9 @@ int main(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
   HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
   
-  /* Test butonu için GPIO (manuel tetikleme için) */
+  /* Test butonu için GPIO (manuel tetikleme için)
+   * PA0 aynı zamanda TIM2_CH1 girişi; F1'de timer girişi için pin
+   * giriş modunda kalır, remap gerekmez. */
   GPIO_InitStruct.Pin = GPIO_PIN_0;
   GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
   GPIO_InitStruct.Pull = GPIO_PULLUP;
@@ -68,51 +174,185 @@ int main(void)
   printf("STM32F1 - Optical Sensor Test\r\n");
   printf("========================================\r\n\r\n");
   
+  /* Pist haritası: flash'taki parametre bloğu, geçersizse derlenmiş varsayılan */
+  uint8_t map_status = TunnelMap_Init((const TunnelParams_t *)TUNNEL_PARAMS_FLASH_ADDR);
+  printf("Tunnel map: %u markers (%s)\r\n", TunnelMap_Count(),
+         (map_status == TUNNEL_MAP_OK) ? "flash" : "default");
+
   /* Optik sensörü başlat */
   OpticalSensor_Init();
+  OpticalSensor_IC_Start(&htim2);
+  Encoder_Init(&htim1, &htim2);   // Kenar zamanı TIM2_CH2 (PA1), aynı 8 MHz sayaç
   printf("Optical sensor initialized.\r\n");
-  printf("First reflector at: %.1f m\r\n", FIRST_REFLECTOR_DIST);
-  printf("Reflector spacing: %.1f m\r\n", REFLECTOR_SPACING);
+  printf("First reflector at: %.1f m\r\n", Q16_TO_FLOAT(TunnelMap_Params()->reflector_first));
+  printf("Reflector spacing: %.1f m\r\n", Q16_TO_FLOAT(TunnelMap_Params()->reflector_pitch));
+  printf("Stop limit: %.1f m\r\n", Q16_TO_FLOAT(TunnelMap_StopLimit()));
   printf("\r\n");
   
-  /* Test menüsünü göster */
-  Test_Menu();
+#ifdef USE_IMU
+  /* I2C1 hat yöneticisi; MPU6050 kurulumu kuyruğa girer (sonuç
+     VehicleState.imu_error_flag). Varsayılan tek örnek modu: her 1 ms'de bir
+     okuma. IMU_FIFO_MODE: FIFO + INT (PB5) burst'leri, kurulum bitince açılır */
+  I2CBus_Init(&hi2c1, OpticalSensor_GetTimestamp);
+  if (MPU6050_Init() != 0)
+  {
+    printf("MPU6050 kurulamadi!\r\n");
+  }
+#ifdef IMU_FIFO_MODE
+  else if (MPU6050_FIFO_Start() != 0)
+  {
+    printf("MPU6050 FIFO modu acilamadi!\r\n");
+  }
+#endif
+  Fusion_Init(TunnelMap_Params()->start_offset, OpticalSensor_GetTimestamp());
+#endif
+  EventLog_Init();        // Son ~0.7 s IMU + kenar olayları (sıkıştırılmış)
+  
+  BrakeSupervisor_Init();
+  
+  /* Analog sensörler kanallarını kaydeder, motor tek tarama sırasını başlatır.
+     NTC ilk ortalaması ~43 ms sonra */
+  if (NTC_Init() != 0 || Analog_Start(&hadc1, OpticalSensor_GetTimestamp) != 0)
+  {
+    printf("Analog ADC baslatilamadi!\r\n");
+  }
   
-  /* Sonsuz döngü - Test modu */
+  /* Zamanlayıcı: görev süreleri TIM2 saatiyle (8 MHz) ölçülür */
+  Scheduler_Init(app_tasks, (uint8_t)(sizeof(app_tasks) / sizeof(app_tasks[0])),
+                 OpticalSensor_GetTimestamp);
+  
+  /* Sonsuz döngü - Test modu (menü arka plan görevi olarak çalışır).
+     Yapılacak iş yokken zamanlayıcı WFI ile bir sonraki kesmeye kadar uyur */
   while (1)
   {
-    // Ana döngüde sadece küçük bir bekleme
-    HAL_Delay(10);
+    Scheduler_Dispatch();
   }
 }
 
 /**
-  * @brief Test menüsü
+  * @brief Olay görevi: yakalama kesmesinin kuyruğa attığı kenarlar tick
+  * beklenmeden işlenir
   */
-void Test_Menu(void)
+static void App_EdgeTask(void)
 {
-  uint8_t choice = 0;
-  char buffer[10];
+  OpticalSensor_Process();
+}
+
+/**
+  * @brief 1 kHz görevi: kenarlar, IMU ve fren kararı
+  */
+static void App_AcquisitionTask(void)
+{
+  // Olay görevinden sonra gelen kenarlar (aynı uyanışta) fren kararından önce
+  OpticalSensor_Process();
   
-  printf("\r\n=== TEST MENUSU ===\r\n");
-  printf("1. Tam Otomatik Test (OpticalSensor_RealTest)\r\n");
-  printf("2. Manuel Tetikleme Testi\r\n");
-  printf("3. Otomatik Simulasyon (Timer ile)\r\n");
-  printf("4. Debug Ciktisi\r\n");
-  printf("5. Sensor Durumunu Goster\r\n");
-  printf("Seciminiz (1-5): ");
+#ifdef USE_IMU
+#ifdef IMU_FIFO_MODE
+  // FIFO modu: INT kesmesinin başlattığı burst'ler toplu çevrilir. Füzyon ve
+  // uçuş kaydı tek örnek modundaki gibi filtre çıkışını, olay logu her ham
+  // örneği alır; hepsi örneğin INT anının zaman damgasıyla
+  uint32_t imu_n = MPU6050_FIFO_Process(imu_batch, 2U * MPU6050_FIFO_BATCH);
+  for (uint32_t i = 0; i < imu_n; i++) {
+    if (imu_batch[i].has_filtered) {
+      Fusion_ImuSample(&imu_batch[i].filtered, imu_batch[i].timestamp);
+      FlightRecorder_Imu(&imu_batch[i].filtered, imu_batch[i].timestamp);
+    }
+    EventLog_Imu(imu_batch[i].counts, imu_batch[i].timestamp);
+  }
+  I2CBus_Poll();          // Zaman aşımı / hat kurtarma
+#else
+  // Önceki DMA okumasının filtreli sonucu füzyona (ve seyreltilmiş olarak
+  // uçuş kaydına), ham örnek olay loguna; bir sonraki okuma başlatılır.
+  // DMA kesmesi alanları her an yazabilir: kopya alınır, yalnızca sürücünün
+  // sayacı ilerlemişse işlenir (okuma gecikti / hata: eski örnek yeniden
+  // entegre edilmez). Örnek anı DMA bitiş kesmesinde alınmıştır: görevin
+  // gecikmesi füzyonun zamanına girmez
+  SharedData_t imu_state;
+  SharedData_Snapshot(&imu_state);
+  if (imu_state.imu_seq != imu_seq_seen) {
+    imu_seq_seen = imu_state.imu_seq;
+    Fusion_ImuSample(&imu_state.imu, imu_state.imu_time);
+    FlightRecorder_Imu(&imu_state.imu, imu_state.imu_time);
+  }
+  if (imu_state.imu_raw_seq != imu_raw_seq_seen) {
+    imu_raw_seq_seen = imu_state.imu_raw_seq;
+    EventLog_Imu(imu_state.imu_raw_counts, imu_state.imu_raw_time);
+  }
+  I2CBus_Poll();          // Zaman aşımı / hat kurtarma
+  MPU6050_Start_DMA_Read();
+#endif
+#endif
   
-  // Basit bir bekleme ve varsayılan seçim
-  HAL_Delay(1000);
-  choice = 1; // Varsayılan olarak tam otomatik test
+  // Enkoder: sayaç ve son kenar yakalaması, 100 Hz'de SharedData'ya
+  Encoder_Update(OpticalSensor_GetTimestamp());
+#ifdef USE_IMU
+  // Tekerlek dönmüyorsa hız sıfır: kalkıştan önce ivme sapması öğrenilir
+  if (Encoder_IsStill()) Fusion_ZeroVelocity();
+#endif
   
+  BrakeSupervisor_Update(OpticalSensor_GetTimestamp());
+}
+
+/**
+  * @brief 100 Hz görevi: seçili test modunun bir adımı
+  */
+static void App_TestTask(void)
+{
+  if (test_step == NULL) return;
+  
+  if (!test_step())
+  {
+    test_step = NULL;
+    menu_time = HAL_GetTick();
+    menu_state = menu_after_test;
+  }
+}
+
+/**
+  * @brief 50 Hz görevi: yeni NTC ortalaması varsa °C'ye çevirip yayınlar
+  */
+static void App_ThermalTask(void)
+{
+  NTC_Process();
+}
+
+#ifdef TELEMETRY_MODE
+/**
+  * @brief 50 Hz görevi: ikili telemetri; host'ta telemetry_decode ile CSV'ye çevrilir
+  */
+static void App_TelemetryTask(void)
+{
+  Telemetry_Send();
+}
+#endif
+
+/**
+  * @brief Testi test görevine bağlar
+  * @param after Test bitince menünün geçeceği durum
+  */
+static void Test_Run(uint8_t (*step)(void), uint8_t after)
+{
+  test_step = step;
+  menu_after_test = after;
+  menu_state = MENU_TEST;
+}
+
+/**
+  * @brief Seçilen testi başlatır
+  */
+static void Test_Select(uint8_t choice)
+{
   printf("%d\r\n", choice);
   
+  // Tek seferlik çıktılardan sonra menü tekrar gösterilir
+  menu_state = MENU_SHOW;
+  
   switch(choice)
   {
     case 1:
       printf("\r\n=== TAM OTOMATIK TEST BASLATILIYOR ===\r\n");
-      OpticalSensor_RealTest();
+      OpticalSensor_RealTestStart();
+      Test_Run(OpticalSensor_RealTestStep, MENU_IDLE);
       break;
       
     case 2:
@@ -120,179 +360,309 @@ void Test_Menu(void)
       printf("PA0 pinini baglayarak veya butona basarak test edin.\r\n");
       printf("Her tetiklemede bir reflektor sayilacak.\r\n");
       printf("Cikmak icin reset atin.\r\n\r\n");
-      Test_ManualTrigger();
+      Test_ManualTriggerStart();
+      Test_Run(Test_ManualTriggerStep, MENU_RETURN);
       break;
       
     case 3:
       printf("\r\n=== OTOMATIK SIMULASYON ===\r\n");
       printf("Timer ile otomatik sensor sinyalleri uretilecek.\r\n");
-      Test_AutoSimulation();
+      Test_AutoSimulationStart();
+      Test_Run(Test_AutoSimulationStep, MENU_RETURN);
       break;
       
     case 4:
       printf("\r\n=== DEBUG CIKTISI ===\r\n");
       OpticalSensor_DebugOutput();
-      Test_Menu(); // Menüye geri dön
+      Scheduler_Print();
       break;
       
     case 5:
+    {
+      SharedData_t state;
+      uint32_t generation = SharedData_Snapshot(&state);
       printf("\r\n=== SENSOR DURUMU ===\r\n");
-      printf("Reflector Count: %lu\r\n", VehicleState.reflector_count);
-      printf("Position: %.2f m\r\n", VehicleState.current_position);
-      printf("Velocity: %.2f m/s\r\n", VehicleState.current_velocity);
-      printf("System Status: %d\r\n", VehicleState.system_status);
-      Test_Menu(); // Menüye geri dön
+      printf("Reflector Count: %lu\r\n", state.reflector_count);
+      printf("Position: %.2f m\r\n", Q16_TO_FLOAT(state.current_position));
+      printf("Velocity: %.2f m/s\r\n", Q16_TO_FLOAT(state.current_velocity));
+      printf("System Status: %d\r\n", state.system_status);
+      printf("Optik: %lu ms | IMU: %lu ms | Nesil: %lu\r\n",
+             state.optical_time_ms, state.imu_time_ms, generation);
+      printf("IMU ivme x: ham %.4f g | filtreli %.4f g (%u Hz, %lu Hz cikis)\r\n",
+             Q16_TO_FLOAT(state.imu_raw.accel_x_g), Q16_TO_FLOAT(state.imu.accel_x_g),
+             IMU_FILTER_ACCEL_HZ, IMU_FILTER_OUT_HZ);
+      
+      BrakeLog_t brake;
+      BrakeSupervisor_GetLog(&brake);
+      printf("Fren: durum %u | komut x=%.2f m v=%.2f m/s | tahmini durus %.2f m (pay %.2f m) | "
+             "durus %.2f m (sona %.2f m)\r\n", brake.state,
+             Q16_TO_FLOAT(brake.command_position), Q16_TO_FLOAT(brake.command_velocity),
+             Q16_TO_FLOAT(brake.predicted_stop), Q16_TO_FLOAT(brake.command_margin),
+             Q16_TO_FLOAT(brake.stop_position), Q16_TO_FLOAT(brake.stop_margin));
+      printf("Enkoder: %.3f m | %.3f m/s\r\n",
+             Q16_TO_FLOAT(state.encoder_distance), Q16_TO_FLOAT(state.encoder_velocity));
+      printf("NTC:");
+      for (uint8_t ch = 0; ch < NTC_CHANNELS; ch++)
+      {
+        printf(" %.1fC%s", Q16_TO_FLOAT(state.ntc_temp_c[ch]),
+               (state.ntc_fault & (1U << ch)) ? "(ariza)" : (state.ntc_overtemp & (1U << ch)) ? "(SICAK)" : "");
+      }
+      printf(" | %lu ms\r\n", state.ntc_time / (OPTICAL_IC_TICK_HZ / 1000U));
+#ifdef USE_IMU
+      I2CBusStats_t bus;
+      I2CBus_GetStats(&bus);
+      printf("I2C: transfer %lu | NACK %lu | hat hatasi %lu | zaman asimi %lu | kurtarma %lu | kapanma %lu\r\n",
+             bus.transfers, bus.nacks, bus.bus_errors, bus.timeouts, bus.recoveries, bus.offline);
+      for (uint8_t d = 0; d < I2CBus_DeviceCount(); d++)
+      {
+        I2CBusDeviceStats_t dev;
+        I2CBus_GetDeviceStats(d, &dev);
+        printf("  %s: tamam %lu/%lu | ret %lu | hata %lu | en uzun bekleme %lu us\r\n", dev.name,
+               dev.completed, dev.queued, dev.dropped, dev.errors, dev.max_wait / (OPTICAL_IC_TICK_HZ / 1000000U));
+      }
+#endif
+    }
+      break;
+      
+    case 6:
+      printf("\r\n=== PROFIL ===\r\n");
+      Profiler_Dump();
+      Profiler_Reset();
+      break;
+      
+    case 7:
+    {
+      // Kayıt donar; "FR" satırları host'ta flight_replay ile çözülür
+      FlightRecStats_t rec;
+      FlightRecorder_Stop();
+      FlightRecorder_GetStats(&rec);
+      printf("\r\n=== UCUS KAYDI ===\r\n");
+      printf("Kayit: %lu (ezilen %lu) | %lu byte\r\n", rec.records, rec.dropped, FlightRecorder_ImageSize());
+      FlightRecorder_DumpStart();
+      Test_Run(FlightRecorder_DumpStep, MENU_RETURN);
+    }
+      break;
+      
+    case 8:
+      printf("\r\n=== UCUS KAYDI -> FLASH ===\r\n");
+      if (FlightRecorder_SaveFlash() == 0)
+      {
+        printf("%lu byte 0x%08lX adresine yazildi\r\n", FlightRecorder_ImageSize(),
+               (unsigned long)FLIGHTREC_FLASH_ADDR);
+      }
+      else
+      {
+        printf("Flash yazma hatasi!\r\n");
+      }
+      break;
+      
+    case 9:
+    {
+      // Log durur; "EL" satırları host'ta evlog_decode ile çözülür
+      EventLogStats_t ev;
+      EventLog_Stop();
+      EventLog_GetStats(&ev);
+      printf("\r\n=== OLAY LOGU ===\r\n");
+      printf("IMU %lu, olay %lu | blok %lu (atilan %lu) | %lu byte\r\n", ev.imu_samples, ev.events,
+             EventLog_BlockCount(), ev.dropped_blocks, EventLog_BlockCount() * EVLOG_BLOCK_SIZE);
+      EventLog_DumpStart();
+      Test_Run(EventLog_DumpStep, MENU_RETURN);
+    }
       break;
       
     default:
       printf("Gecersiz secim!\r\n");
-      Test_Menu();
       break;
   }
 }
 
+/**
+  * @brief Test menüsü (arka plan görevi). Her çağrıda bir durum adımı;
+  *        testler test görevinde koşarken menü sadece bekler.
+  */
+void Test_Menu(void)
+{
+  switch (menu_state)
+  {
+    case MENU_SHOW:
+      printf("\r\n=== TEST MENUSU ===\r\n");
+      printf("1. Tam Otomatik Test (OpticalSensor_RealTest)\r\n");
+      printf("2. Manuel Tetikleme Testi\r\n");
+      printf("3. Otomatik Simulasyon (Timer ile)\r\n");
+      printf("4. Debug Ciktisi\r\n");
+      printf("5. Sensor Durumunu Goster\r\n");
+      printf("6. Profil Dokumu (PROFILER_ENABLE)\r\n");
+      printf("7. Ucus Kaydi Dokumu (UART, flight_replay)\r\n");
+      printf("8. Ucus Kaydini Flash'a Yaz\r\n");
+      printf("9. Olay Logu Dokumu (UART, evlog_decode)\r\n");
+      printf("Seciminiz (1-9): ");
+      menu_time = HAL_GetTick();
+      menu_state = MENU_CHOICE;
+      break;
+      
+    case MENU_CHOICE:
+      // Basit bir bekleme ve varsayılan seçim
+      if (HAL_GetTick() - menu_time >= 1000)
+      {
+        Test_Select(1); // Varsayılan olarak tam otomatik test
+      }
+      break;
+      
+    case MENU_RETURN:
+      if (HAL_GetTick() - menu_time >= 3000)
+      {
+        menu_state = MENU_SHOW;
+      }
+      break;
+      
+    default:
+      break;
+  }
+}
+
+/* Manuel tetikleme testi durumu */
+static uint8_t manual_trigger_count = 0;
+
 /**
   * @brief Manuel tetikleme testi
   */
-void Test_ManualTrigger(void)
+void Test_ManualTriggerStart(void)
 {
-  uint32_t last_trigger_time = 0;
-  uint8_t last_button_state = 1;
-  uint8_t trigger_count = 0;
+  manual_trigger_count = 0;
   
   printf("Manuel test basladi. Her tetiklemede LED yanip donecek.\r\n");
   printf("Tetikleme sayisi: 0\r");
+}
+
+uint8_t Test_ManualTriggerStep(void)
+{
+  // Buton PA0 = TIM2_CH1: bırakınca (yükselen kenar) yakalama kesmesi kenarı
+  // kuyruğa yazar, debounce giriş filtresinde (OPTICAL_IC_FILTER). Yazılımla
+  // kenar eklenmez: aynı basış iki kez sayılırdı
+  uint32_t edges = OpticalSensor_Process();
   
-  while(1)
+  for (uint32_t i = 0; i < edges; i++)
   {
-    uint8_t button_state = HAL_GPIO_ReadPin(GPIOA, GPIO_PIN_0);
-    
-    // Butona basıldığında (active low)
-    if (button_state == 0 && last_button_state == 1)
-    {
-      // Debounce
-      if (HAL_GetTick() - last_trigger_time > 50)
-      {
-        // Sensor sinyalini simüle et
-        OpticalSensor_EXTI_Callback(OPTICAL_SENSOR_PIN);
-        
-        trigger_count++;
-        printf("Tetikleme sayisi: %d | Konum: %.2fm | Hiz: %.2fm/s\r", 
-               trigger_count, 
-               VehicleState.current_position,
-               VehicleState.current_velocity);
-        
-        last_trigger_time = HAL_GetTick();
-      }
-    }
-    
-    last_button_state = button_state;
+    manual_trigger_count++;
+    printf("Tetikleme sayisi: %d | Konum: %.2fm | Hiz: %.2fm/s\r", 
+           manual_trigger_count, 
+           Q16_TO_FLOAT(VehicleState.current_position),
+           Q16_TO_FLOAT(VehicleState.current_velocity));
     
     // Her 10 tetiklemede bir özet göster
-    if (trigger_count > 0 && trigger_count % 10 == 0)
+    if (manual_trigger_count % 10 == 0)
     {
       printf("\r\n--- OZET ---\r\n");
-      printf("Toplam tetikleme: %d\r\n", trigger_count);
-      printf("Son konum: %.2f m\r\n", VehicleState.current_position);
-      printf("Son hiz: %.2f m/s\r\n", VehicleState.current_velocity);
+      printf("Toplam tetikleme: %d\r\n", manual_trigger_count);
+      printf("Son konum: %.2f m\r\n", Q16_TO_FLOAT(VehicleState.current_position));
+      printf("Son hiz: %.2f m/s\r\n", Q16_TO_FLOAT(VehicleState.current_velocity));
       printf("---\r\n");
     }
-    
-    // 100 tetikleme sonunda testi bitir
-    if (trigger_count >= 100)
-    {
-      printf("\r\n\r\nTest tamamlandi! 100 tetikleme yapildi.\r\n");
-      printf("Son durum:\r\n");
-      OpticalSensor_DebugOutput();
-      break;
-    }
-    
-    HAL_Delay(10);
   }
   
-  // Test bittikten sonra menüye dön
-  printf("\r\nTest bitti. 3 saniye sonra menu goruntulenecek...\r\n");
-  HAL_Delay(3000);
-  Test_Menu();
+  // 100 tetikleme sonunda testi bitir
+  if (manual_trigger_count >= 100)
+  {
+    printf("\r\n\r\nTest tamamlandi! 100 tetikleme yapildi.\r\n");
+    printf("Son durum:\r\n");
+    OpticalSensor_DebugOutput();
+    
+    // Test bittikten sonra menüye dön
+    printf("\r\nTest bitti. 3 saniye sonra menu goruntulenecek...\r\n");
+    return 0;
+  }
+  return 1;
 }
 
+/* Otomatik simülasyon durumu */
+static uint32_t simulation_time = 0;
+static uint32_t simulation_last_print = 0;
+static volatile uint8_t simulation_running = 0;
+
 /**
   * @brief Timer ile otomatik simulasyon
   */
-void Test_AutoSimulation(void)
+void Test_AutoSimulationStart(void)
 {
   printf("Otomatik simulasyon basliyor...\r\n");
   printf("Simulasyon hizi: 8 m/s\r\n");
-  printf("Reflektorler arasi sure: %.0f ms\r\n", REFLECTOR_SPACING / 8.0f * 1000.0f);
+  printf("Reflektorler arasi sure: %.0f ms\r\n", Q16_TO_FLOAT(TunnelMap_Params()->reflector_pitch) / 8.0f * 1000.0f);
   
   // Timer'ı başlat (her 500ms'de bir kesme)
-  htim2.Instance = TIM2;
-  htim2.Init.Prescaler = 7200 - 1;    // 72MHz / 7200 = 10kHz
-  htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim2.Init.Period = 5000 - 1;       // 10kHz / 5000 = 2Hz (500ms)
-  htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-  HAL_TIM_Base_Init(&htim2);
-  HAL_TIM_Base_Start_IT(&htim2);
+  htim3.Instance = TIM3;
+  htim3.Init.Prescaler = 7200 - 1;    // 72MHz / 7200 = 10kHz
+  htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim3.Init.Period = 5000 - 1;       // 10kHz / 5000 = 2Hz (500ms)
+  htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  HAL_TIM_Base_Init(&htim3);
   
-  uint32_t simulation_time = 0;
-  uint32_t last_print_time = 0;
+  simulation_time = 0;
+  simulation_last_print = 0;
+  simulation_running = 1;
+  HAL_TIM_Base_Start_IT(&htim3);
   
   printf("\r\nSimulasyon basladi...\r\n");
   printf("Zaman | Reflektor | Konum | Hiz\r\n");
   printf("--------------------------------\r\n");
+}
+
+/**
+  * @brief Olay görevi (TIM3 kesmesi): bir sensör tetiği işlenir
+  */
+static void Test_AutoSimulationTrigger(void)
+{
+  if (!simulation_running) return;
+  
+  // Sensor sinyalini simüle et (kenar kuyruğu atlanır, hemen işlenir)
+  OpticalSensor_SoftwareEdge();
   
-  while(1)
+  simulation_time += 500; // 500ms aralıklarla
+  
+  // Her 5 saniyede bir çıktı ver
+  if (simulation_time - simulation_last_print >= 5000)
   {
-    // Timer kesmesi geldi mi?
-    if (sensor_triggered)
-    {
-      sensor_triggered = 0;
-      
-      // Sensor sinyalini simüle et
-      OpticalSensor_EXTI_Callback(OPTICAL_SENSOR_PIN);
-      
-      simulation_time += 500; // 500ms aralıklarla
-      
-      // Her 5 saniyede bir çıktı ver
-      if (simulation_time - last_print_time >= 5000)
-      {
-        printf("%5.1fs | %9lu | %6.1fm | %5.2fm/s\r\n", 
-               simulation_time / 1000.0f,
-               VehicleState.reflector_count,
-               VehicleState.current_position,
-               VehicleState.current_velocity);
-        last_print_time = simulation_time;
-      }
-      
-      // Tünel sonuna ulaşıldı mı?
-      if (VehicleState.current_position >= 186.0f)
-      {
-        printf("\r\n=== TUNEL SONUNA ULASILDI ===\r\n");
-        printf("Toplam simulasyon suresi: %.1f saniye\r\n", simulation_time / 1000.0f);
-        printf("Toplam reflektor: %lu\r\n", VehicleState.reflector_count);
-        printf("Ortalama hiz: %.2f m/s\r\n", 
-               186.0f / (simulation_time / 1000.0f));
-        break;
-      }
-    }
-    
-    // 30 saniye sonra otomatik dur
-    if (simulation_time >= 30000)
-    {
-      printf("\r\nSimulasyon 30 saniye sonra durduruldu.\r\n");
-      break;
-    }
-    
-    HAL_Delay(10);
+    printf("%5.1fs | %9lu | %6.1fm | %5.2fm/s\r\n", 
+           simulation_time / 1000.0f,
+           VehicleState.reflector_count,
+           Q16_TO_FLOAT(VehicleState.current_position),
+           Q16_TO_FLOAT(VehicleState.current_velocity));
+    simulation_last_print = simulation_time;
   }
   
-  // Timer'ı durdur
-  HAL_TIM_Base_Stop_IT(&htim2);
+  // Tünel sonuna ulaşıldı mı? (haritadaki son işaret)
+  if (VehicleState.current_position >= TunnelMap_Marker(TunnelMap_Count() - 1U)->position)
+  {
+    printf("\r\n=== TUNEL SONUNA ULASILDI ===\r\n");
+    printf("Toplam simulasyon suresi: %.1f saniye\r\n", simulation_time / 1000.0f);
+    printf("Toplam reflektor: %lu\r\n", VehicleState.reflector_count);
+    printf("Ortalama hiz: %.2f m/s\r\n", 
+           Q16_TO_FLOAT(VehicleState.current_position) / (simulation_time / 1000.0f));
+    simulation_running = 0;
+  }
+  // 30 saniye sonra otomatik dur
+  else if (simulation_time >= 30000)
+  {
+    printf("\r\nSimulasyon 30 saniye sonra durduruldu.\r\n");
+    simulation_running = 0;
+  }
   
-  // Test bittikten sonra menüye dön
-  printf("\r\nSimulasyon bitti. 3 saniye sonra menu goruntulenecek...\r\n");
-  HAL_Delay(3000);
-  Test_Menu();
+  if (!simulation_running)
+  {
+    // Timer'ı durdur
+    HAL_TIM_Base_Stop_IT(&htim3);
+    
+    // Test bittikten sonra menüye dön
+    printf("\r\nSimulasyon bitti. 3 saniye sonra menu goruntulenecek...\r\n");
+  }
+}
+
+/**
+  * @brief Test görevi adımı: tetikler olay görevinde işlenir, burada sadece
+  * bitiş beklenir
+  */
+uint8_t Test_AutoSimulationStep(void)
+{
+  return simulation_running;
 }
 
 /**
@@ -302,7 +672,46 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
   if (htim->Instance == TIM2)
   {
-    sensor_triggered = 1;
+    OpticalSensor_IC_OverflowCallback(htim);
+  }
+  else if (htim->Instance == TIM1)
+  {
+    Encoder_OverflowCallback(htim);
+  }
+  else if (htim->Instance == TIM3)
+  {
+    Scheduler_Post(APP_EVENT_SIM_TICK);
+  }
+}
+
+/**
+  * @brief ADC DMA yarım/tam transfer callback'leri
+  */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    Analog_HalfCallback(hadc);
+  }
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+  if (hadc->Instance == ADC1)
+  {
+    Analog_CpltCallback(hadc);
+  }
+}
+
+/**
+  * @brief Giriş yakalama kesme callback
+  */
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+  if (htim->Instance == TIM2)
+  {
+    OpticalSensor_IC_CaptureCallback(htim);
+    Scheduler_Post(APP_EVENT_EDGE);
   }
 }
 
@@ -330,30 +739,150 @@ void SystemClock_Config(void)
   RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
   RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
   HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2);
+
+  // ADC saati en çok 14 MHz: PCLK2 72 MHz / 6 = 12 MHz
+  RCC_PeriphCLKInitTypeDef PeriphClkInit = {0};
+  PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+  PeriphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV6;
+  HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit);
+}
+
+/**
+  * @brief ADC1 Initialization Function (analog motoru: sürekli tarama + dairesel DMA)
+  */
+static void MX_ADC1_Init(void)
+{
+  __HAL_RCC_ADC1_CLK_ENABLE();
+
+  hadc1.Instance = ADC1;
+  hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;
+  hadc1.Init.ContinuousConvMode = ENABLE;
+  hadc1.Init.DiscontinuousConvMode = DISABLE;
+  hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+  hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+  hadc1.Init.NbrOfConversion = 1;   // Sıra ve uzunluk Analog_Start'ta, kayıtlı kanallardan
+  HAL_ADC_Init(&hadc1);
+
+  hdma_adc1.Instance = DMA1_Channel1;
+  hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+  hdma_adc1.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_adc1.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+  hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+  hdma_adc1.Init.Mode = DMA_CIRCULAR;
+  hdma_adc1.Init.Priority = DMA_PRIORITY_MEDIUM;
+  HAL_DMA_Init(&hdma_adc1);
+  __HAL_LINKDMA(&hadc1, DMA_Handle, hdma_adc1);
+}
+
+/**
+  * @brief TIM1 Initialization Function (enkoder modu, TI1 ve TI2 kenarlarında x4 sayım)
+  * NOT: TIM1_UP_IRQHandler -> HAL_TIM_IRQHandler(&htim1) stm32f1xx_it.c'de.
+  */
+static void MX_TIM1_Init(void)
+{
+  TIM_Encoder_InitTypeDef sConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+
+  __HAL_RCC_TIM1_CLK_ENABLE();
+
+  htim1.Instance = TIM1;
+  htim1.Init.Prescaler = 0;
+  htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim1.Init.Period = 0xFFFF;                    // Taşma Encoder_OverflowCallback'te genişletilir
+  htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+  sConfig.EncoderMode = TIM_ENCODERMODE_TI12;
+  sConfig.IC1Polarity = TIM_ICPOLARITY_RISING;
+  sConfig.IC1Selection = TIM_ICSELECTION_DIRECTTI;
+  sConfig.IC1Prescaler = TIM_ICPSC_DIV1;
+  sConfig.IC1Filter = 4;                         // Kontak sıçramasına karşı kısa filtre
+  sConfig.IC2Polarity = TIM_ICPOLARITY_RISING;
+  sConfig.IC2Selection = TIM_ICSELECTION_DIRECTTI;
+  sConfig.IC2Prescaler = TIM_ICPSC_DIV1;
+  sConfig.IC2Filter = 4;
+  HAL_TIM_Encoder_Init(&htim1, &sConfig);
+
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  HAL_TIMEx_MasterConfigSynchronization(&htim1, &sMasterConfig);
+
+  // Taşma kesmesi: TIM1 update ayrı vektörde
+  HAL_NVIC_SetPriority(TIM1_UP_IRQn, 1, 0);
+  HAL_NVIC_EnableIRQ(TIM1_UP_IRQn);
 }
 
 /**
-  * @brief TIM2 Initialization Function
+  * @brief TIM2 Initialization Function (CH1 giriş yakalama, optik sensör)
+  * NOT: TIM2_IRQHandler -> HAL_TIM_IRQHandler(&htim2) stm32f1xx_it.c'de;
+  *      yakalama ve taşma aynı vektörde.
   */
 static void MX_TIM2_Init(void)
 {
   TIM_ClockConfigTypeDef sClockSourceConfig = {0};
   TIM_MasterConfigTypeDef sMasterConfig = {0};
+  TIM_IC_InitTypeDef sConfigIC = {0};
+
+  __HAL_RCC_TIM2_CLK_ENABLE();
 
   htim2.Instance = TIM2;
-  htim2.Init.Prescaler = 7200 - 1;
+  htim2.Init.Prescaler = OPTICAL_IC_PRESCALER;   // 8 MHz sayaç
   htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim2.Init.Period = 5000 - 1;
-  htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim2.Init.Period = 0xFFFF;                    // Serbest sayım, taşma yazılımda genişletilir
+  htim2.Init.ClockDivision = OPTICAL_IC_CLOCK_DIV;
   htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
   HAL_TIM_Base_Init(&htim2);
 
   sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
   HAL_TIM_ConfigClockSource(&htim2, &sClockSourceConfig);
 
+  HAL_TIM_IC_Init(&htim2);
+
   sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
   sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
   HAL_TIMEx_MasterConfigSynchronization(&htim2, &sMasterConfig);
+
+  sConfigIC.ICPolarity = TIM_ICPOLARITY_RISING;
+  sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+  sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+  sConfigIC.ICFilter = OPTICAL_IC_FILTER;
+  HAL_TIM_IC_ConfigChannel(&htim2, &sConfigIC, OPTICAL_IC_CHANNEL);
+
+  // Yakalama (CC1/CC2) ve taşma kesmesi: I2C, DMA ve UART'ın önünde
+  HAL_NVIC_SetPriority(TIM2_IRQn, APP_EDGE_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+/**
+  * @brief TIM3 Initialization Function (simülasyon tetikleyicisi)
+  * NOT: TIM3_IRQHandler -> HAL_TIM_IRQHandler(&htim3) stm32f1xx_it.c'de.
+  */
+static void MX_TIM3_Init(void)
+{
+  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+
+  __HAL_RCC_TIM3_CLK_ENABLE();
+
+  htim3.Instance = TIM3;
+  htim3.Init.Prescaler = 7200 - 1;
+  htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim3.Init.Period = 5000 - 1;
+  htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  HAL_TIM_Base_Init(&htim3);
+
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  HAL_TIM_ConfigClockSource(&htim3, &sClockSourceConfig);
+
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig);
+
+  // Update kesmesi yalnız Scheduler_Post yapar: en düşük öncelik
+  HAL_NVIC_SetPriority(TIM3_IRQn, APP_SIM_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(TIM3_IRQn);
 }
 
 /**
@@ -370,10 +899,43 @@ static void MX_USART2_UART_Init(void)
   huart2.Init.HwFlowCtl = UART_HWCONTROL_NONE;
   huart2.Init.OverSampling = UART_OVERSAMPLING_16;
   HAL_UART_Init(&huart2);
+
+  // TX DMA: printf çıktısını uart_log halkasından arka planda gönderir
+  hdma_usart2_tx.Instance = DMA1_Channel7;
+  hdma_usart2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_usart2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_usart2_tx.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma_usart2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+  hdma_usart2_tx.Init.Priority = DMA_PRIORITY_LOW;
+  HAL_DMA_Init(&hdma_usart2_tx);
+  __HAL_LINKDMA(&huart2, hdmatx, hdma_usart2_tx);
+
+  UartLog_Init(&huart2);
+}
+
+/**
+  * @brief DMA Initialization Function
+  * NOT: DMA1_Channel7_IRQHandler -> HAL_DMA_IRQHandler(&hdma_usart2_tx) ve
+  *      USART2_IRQHandler -> HAL_UART_IRQHandler(&huart2) stm32f1xx_it.c'de.
+  */
+static void MX_DMA_Init(void)
+{
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 6, 0);   // Analog motoru: ~370 Hz, acil değil
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+  HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+  HAL_NVIC_SetPriority(USART2_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(USART2_IRQn);
 }
 
 /**
   * @brief GPIO Initialization Function
+  * NOT: IMU_FIFO_MODE'da EXTI9_5_IRQHandler ->
+  *      HAL_GPIO_EXTI_IRQHandler(MPU6050_INT_PIN) stm32f1xx_it.c'de.
   */
 static void MX_GPIO_Init(void)
 {
@@ -385,17 +947,97 @@ static void MX_GPIO_Init(void)
 
   /* Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
+
+#if defined(USE_IMU) && defined(IMU_FIFO_MODE)
+  /* MPU6050 INT (DATA_RDY, aktif yüksek darbe) -> PB5, yükselen kenar.
+     INT_ENABLE MPU6050_FIFO_Start'a kadar kapalı: erken kesme gelmez */
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  GPIO_InitStruct.Pin = MPU6050_INT_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(MPU6050_INT_GPIO_PORT, &GPIO_InitStruct);
+
+  HAL_NVIC_SetPriority(EXTI9_5_IRQn, APP_IMU_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+#else
+  (void)GPIO_InitStruct;
+#endif
 }
 
 /**
   * @brief  Retargets the C library printf function to the USART.
+  *         Veri DMA halkasına kopyalanır; halka doluysa mesaj atılır,
+  *         CPU UART'ı beklemez.
   */
+int _write(int file, char *ptr, int len)
+{
+  (void)file;
+  UartLog_Write((const uint8_t *)ptr, (uint16_t)len);
+  return len;
+}
+
 int __io_putchar(int ch)
 {
-  HAL_UART_Transmit(&huart2, (uint8_t *)&ch, 1, HAL_MAX_DELAY);
+  uint8_t c = (uint8_t)ch;
+  UartLog_Write(&c, 1);
   return ch;
 }
 
+#ifdef USE_IMU
+/**
+  * @brief I2C1 işlem callback'leri -> i2c_bus (sahibin callback'i, sıradaki işlem)
+  */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c == &hi2c1)
+  {
+    I2CBus_RxCpltCallback(hi2c);
+  }
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c == &hi2c1)
+  {
+    I2CBus_TxCpltCallback(hi2c);
+  }
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c == &hi2c1)
+  {
+    I2CBus_ErrorCallback(hi2c);
+  }
+}
+
+#ifdef IMU_FIFO_MODE
+/**
+  * @brief EXTI callback: MPU6050 INT -> zaman damgası, eşikte FIFO burst'ü
+  */
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == MPU6050_INT_PIN)
+  {
+    MPU6050_INT_Callback(OpticalSensor_GetTimestamp());
+  }
+}
+#endif
+#endif
+
+/**
+  * @brief UART TX DMA callback'leri -> uart_log
+  */
+void HAL_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart)
+{
+  UartLog_TxHalfCpltCallback(huart);
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  UartLog_TxCpltCallback(huart);
+}
+
 /**
   * @brief  This function is executed in case of error occurrence.
   */
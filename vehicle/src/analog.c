@@ -0,0 +1,174 @@
+// analog.c
+#include "analog.h"
+#include "fw_state.h"
+#include "profiler.h"
+
+FW_STATE AnalogChannelConfig_t configs[ANALOG_MAX_CHANNELS];
+FW_STATE uint8_t channel_count = 0;
+
+FW_STATE ADC_HandleTypeDef *analog_hadc = NULL;
+FW_STATE uint32_t (*analog_clock)(void) = NULL;
+
+// DMA tamponu: [tarama][kanal], iki yarı. Uzunluk kayıtlı kanal sayısına göre
+FW_STATE uint16_t dma_buf[ANALOG_DMA_MAX];
+FW_STATE uint32_t dma_length = 0;
+
+// Kesme bağlamı: kanal başına filtre durumu
+FW_STATE uint32_t acc[ANALOG_MAX_CHANNELS];          // AVERAGE: pencere toplamı
+FW_STATE uint32_t iir[ANALOG_MAX_CHANNELS];          // IIR: kod << 8
+FW_STATE uint16_t halves[ANALOG_MAX_CHANNELS];       // Penceredeki yarım tampon
+FW_STATE uint32_t window_start[ANALOG_MAX_CHANNELS];
+FW_STATE uint8_t iir_primed = 0;                     // Kanal başına bit: IIR ilk değerini aldı
+FW_STATE uint32_t last_half_end = 0;
+
+// Çift tampon: kesme [front ^ 1]'i yazar, sonra front'u çevirir
+FW_STATE AnalogBlock_t blocks[2];
+FW_STATE volatile uint8_t front = 0;
+
+FW_STATE AnalogStats_t stats;
+
+int8_t Analog_Register(const AnalogChannelConfig_t *config) {
+    if (analog_hadc != NULL || channel_count >= ANALOG_MAX_CHANNELS) return -1;
+    if (config->filter > ANALOG_FILTER_IIR || config->decimation_log2 > ANALOG_MAX_DECIMATION) return -1;
+    if (config->filter == ANALOG_FILTER_IIR && config->iir_shift > 15U) return -1;
+
+    configs[channel_count] = *config;
+    return (int8_t)channel_count++;
+}
+
+static uint32_t Analog_Now(void) {
+    return analog_clock ? analog_clock() : HAL_GetTick();
+}
+
+uint8_t Analog_Start(ADC_HandleTypeDef *hadc, uint32_t (*clock)(void)) {
+    if (channel_count == 0 || analog_hadc != NULL) return 1;
+
+    analog_clock = clock;
+    dma_length = 2U * ANALOG_SEQ_PER_HALF * channel_count;
+    blocks[0] = (AnalogBlock_t){0};
+    blocks[1] = (AnalogBlock_t){0};
+    front = 0;
+    stats = (AnalogStats_t){0};
+    stats.channels = channel_count;
+
+    hadc->Init.ScanConvMode = ADC_SCAN_ENABLE;
+    hadc->Init.ContinuousConvMode = ENABLE;
+    hadc->Init.NbrOfConversion = channel_count;
+    if (HAL_ADC_Init(hadc) != HAL_OK) return 1;
+
+    ADC_ChannelConfTypeDef sConfig = {0};
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        sConfig.Channel = configs[ch].channel;
+        sConfig.Rank = ADC_REGULAR_RANK_1 + ch;
+        sConfig.SamplingTime = configs[ch].sample_time;
+        if (HAL_ADC_ConfigChannel(hadc, &sConfig) != HAL_OK) return 1;
+    }
+    if (HAL_ADCEx_Calibration_Start(hadc) != HAL_OK) return 1;
+
+    last_half_end = Analog_Now();
+    iir_primed = 0;
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        acc[ch] = 0;
+        iir[ch] = 0;
+        halves[ch] = 0;
+        window_start[ch] = last_half_end;
+    }
+
+    analog_hadc = hadc;
+    if (HAL_ADC_Start_DMA(hadc, (uint32_t *)dma_buf, dma_length) != HAL_OK) {
+        analog_hadc = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+// Yarım tampon: DMA şu an diğer yarıyı dolduruyor
+static void Analog_ProcessHalf(const uint16_t *half) {
+    PROFILE_BEGIN(PROF_ANALOG_DMA);
+    uint32_t now = Analog_Now();
+    uint32_t half_ticks = now - last_half_end;
+    last_half_end = now;
+
+    uint32_t sum[ANALOG_MAX_CHANNELS] = {0};
+    for (uint32_t s = 0; s < ANALOG_SEQ_PER_HALF; s++) {
+        for (uint8_t ch = 0; ch < channel_count; ch++) {
+            sum[ch] += *half++;
+        }
+    }
+
+    // Ön bloğun kopyası üzerine sadece sonucu çıkan kanallar yazılır
+    uint8_t f = front;
+    AnalogBlock_t *b = &blocks[f ^ 1U];
+    *b = blocks[f];
+
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+        const AnalogChannelConfig_t *c = &configs[ch];
+        uint32_t value;
+
+        if (c->filter == ANALOG_FILTER_IIR) {
+            // Yarım ortalaması, 16 bit kod << 8
+            uint32_t x = sum[ch] << (12U - ANALOG_SEQ_SHIFT);
+            if (!(iir_primed & (1U << ch))) {
+                iir[ch] = x;   // İlk yarım: sıfırdan oturmayı beklemesin
+                iir_primed |= (uint8_t)(1U << ch);
+            } else {
+                iir[ch] = (uint32_t)((int32_t)iir[ch] + (((int32_t)x - (int32_t)iir[ch]) >> c->iir_shift));
+            }
+            if (++halves[ch] < (1U << c->decimation_log2)) continue;
+            value = (iir[ch] + 0x80U) >> 8;
+            // Grup gecikmesi ~(2^k - 1) yarım: değer, son yarımın ortasından o kadar eski
+            b->time[ch] = now - half_ticks / 2U - ((1U << c->iir_shift) - 1U) * half_ticks;
+        } else {
+            acc[ch] += sum[ch];
+            if (++halves[ch] < (1U << c->decimation_log2)) continue;
+            uint32_t shift = ANALOG_SEQ_SHIFT + c->decimation_log2 - 4U;
+            value = (acc[ch] + (1U << (shift - 1U))) >> shift;
+            acc[ch] = 0;
+            b->time[ch] = window_start[ch] + (now - window_start[ch]) / 2U;
+        }
+
+        halves[ch] = 0;
+        window_start[ch] = now;
+        b->value[ch] = (uint16_t)value;
+        b->updates[ch]++;
+    }
+
+    b->seq = blocks[f].seq + 1U;
+    b->timestamp = now;
+    __DMB();   // Blok, indeksten önce görünür olmalı
+    front = f ^ 1U;
+
+    stats.halves++;
+    stats.half_ticks = half_ticks;
+    PROFILE_END(PROF_ANALOG_DMA);
+}
+
+void Analog_HalfCallback(ADC_HandleTypeDef *hadc) {
+    if (hadc != analog_hadc) return;
+    Analog_ProcessHalf(&dma_buf[0]);
+}
+
+void Analog_CpltCallback(ADC_HandleTypeDef *hadc) {
+    if (hadc != analog_hadc) return;
+    Analog_ProcessHalf(&dma_buf[dma_length / 2U]);
+}
+
+uint32_t Analog_Read(AnalogBlock_t *out) {
+    uint32_t seq;
+    for (;;) {
+        uint8_t f = front;
+        seq = blocks[f].seq;
+        __DMB();
+        *out = blocks[f];
+        __DMB();
+        // Kopya sırasında tek yayın diğer bloğa yazar; bu blok ancak ikinci
+        // yayında değişir, o zaman seq de değişmiş olur
+        if (blocks[f].seq == seq && out->seq == seq) break;
+        stats.read_retries++;
+    }
+    return seq;
+}
+
+void Analog_GetStats(AnalogStats_t *out) {
+    *out = stats;
+}
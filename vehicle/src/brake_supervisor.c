@@ -0,0 +1,206 @@
+// brake_supervisor.c
+#include "brake_supervisor.h"
+#include "fw_state.h"
+#include "flight_recorder.h"
+#include "optical_sensor.h"
+#include "profiler.h"
+#include "shared_data.h"
+#include "tunnel_map.h"
+#include "uart_log.h"
+#include <stdio.h>
+
+// Fren tutma anı kenar kapısında kenar zaman damgalarıyla karşılaştırılır
+#if BRAKE_TICK_HZ != OPTICAL_IC_TICK_HZ
+#error "BRAKE_TICK_HZ ve OPTICAL_IC_TICK_HZ aynı saat olmalı"
+#endif
+
+#define BRAKE_G   Q16_FROM_FLOAT(9.80665f)
+
+FW_STATE BrakeLog_t brake_log;
+FW_STATE uint32_t last_eval = 0;
+FW_STATE uint8_t have_eval = 0;
+
+// Fren tuttuğu andaki hız; ölçülen yavaşlama buradan ortalanır
+FW_STATE q16_t onset_velocity = 0;
+FW_STATE uint32_t onset_time = 0;
+FW_STATE uint8_t onset_seen = 0;
+FW_STATE q16_t brake_decel = BRAKE_DECEL_PLAN;  // v^2/2a'daki a: plan, ölçülünce min(nominal, ölçülen)
+
+static q16_t Brake_TicksToSeconds(uint32_t ticks) {
+    return (q16_t)(((uint64_t)ticks << Q16_SHIFT) / BRAKE_TICK_HZ);
+}
+
+// Konum ve hızı now anına taşır. Füzyon tahmini tazeyse o (reflektörler
+// arasında da sürekli), değilse son optik güncelleme.
+static uint8_t Brake_Estimate(const SharedData_t *s, uint32_t now, q16_t *pos, q16_t *vel,
+                              q16_t *accel, uint32_t *age) {
+    uint8_t source;
+    int32_t nav_age = (int32_t)(now - s->nav.timestamp);
+
+    if (s->nav.fix_count > 0 && nav_age < (int32_t)BRAKE_MAX_ESTIMATE_AGE) {
+        *age = (nav_age > 0) ? (uint32_t)nav_age : 0U;
+        *pos = s->nav.position;
+        *vel = s->nav.velocity;
+        *accel = q16_mul(s->imu.accel_x_g, BRAKE_G) - s->nav.accel_bias;
+        source = BRAKE_SRC_FUSION;
+    } else {
+        *age = (HAL_GetTick() - s->optical_time_ms) * (BRAKE_TICK_HZ / 1000U);
+        *pos = s->current_position;
+        *vel = s->current_velocity;
+        *accel = 0;
+        source = BRAKE_SRC_OPTICAL;
+    }
+    *pos += q16_mul(*vel, Brake_TicksToSeconds(*age));
+    return source;
+}
+
+// Satır telemetri çerçeveleri arasına düşebilir: arkasındaki 0x00 ayracı
+// onu bir sonraki çerçeveden ayırır (çözücü çerçeve dışı sayıp atlar)
+static void Brake_LogLine(const char *line, int n) {
+    static const uint8_t delimiter = 0x00;
+    if (n > 0) {
+        UartLog_Write((const uint8_t *)line, (uint16_t)n);
+        UartLog_Write(&delimiter, 1);
+    }
+}
+
+void BrakeSupervisor_Init(void) {
+    brake_log = (BrakeLog_t){0};
+    brake_log.state = BRAKE_STATE_ARMED;
+    last_eval = 0;
+    have_eval = 0;
+    onset_velocity = 0;
+    onset_time = 0;
+    onset_seen = 0;
+    brake_decel = BRAKE_DECEL_PLAN;
+}
+
+// latency: fren tutana kadar kalan süre (tick)
+static q16_t Brake_Stop(q16_t position, q16_t velocity, q16_t accel, q16_t decel, uint32_t latency_ticks) {
+    if (velocity <= 0) return position;
+    if (decel <= 0) decel = BRAKE_DECEL_PLAN;
+
+    // 1. Aktüatör gecikmesi: fren henüz tutmuyor, kapsül o anki ivmeyle gider
+    q16_t latency = Brake_TicksToSeconds(latency_ticks);
+    int64_t v_l = velocity + q16_mul(accel, latency);
+    if (v_l < 0) v_l = 0;
+    int64_t travel = (((int64_t)velocity + v_l) * latency) >> (Q16_SHIFT + 1);
+
+    // 2. Frenleme: v_L^2 / (2 a), Q32 / Q16 -> Q16
+    int64_t braking = (v_l * v_l) / (2 * (int64_t)decel);
+
+    int64_t stop = position + travel + braking;
+    return (stop > INT32_MAX) ? INT32_MAX : (q16_t)stop;
+}
+
+q16_t BrakeSupervisor_PredictStop(q16_t position, q16_t velocity, q16_t accel, q16_t decel) {
+    return Brake_Stop(position, velocity, accel, decel, BRAKE_ACTUATOR_LATENCY);
+}
+
+
+static void Brake_Evaluate(uint32_t now) {
+    if (have_eval && now - last_eval > brake_log.max_period) {
+        brake_log.max_period = now - last_eval;
+    }
+    last_eval = now;
+    have_eval = 1;
+    brake_log.evaluations++;
+
+    SharedData_t state;
+    SharedData_Snapshot(&state);
+
+    q16_t pos, vel, accel;
+    uint32_t age;
+    uint8_t source = Brake_Estimate(&state, now, &pos, &vel, &accel, &age);
+
+    char line[128];
+    const TunnelParams_t *map = TunnelMap_Params();
+
+    if (brake_log.state == BRAKE_STATE_ARMED) {
+        // Bir sonraki değerlendirmeye kadar kapsül v*T daha ilerler: o zaman
+        // geç kalınacaksa karar şimdi
+        q16_t stop = BrakeSupervisor_PredictStop(pos, vel, accel, brake_decel);
+        q16_t next = stop + q16_mul(vel, Brake_TicksToSeconds(BRAKE_PERIOD_TICKS));
+        q16_t limit = TunnelMap_StopLimit();
+        if (next < limit) return;
+
+        // Durumu yalnız ana döngü yazar: kopyadaki eski durum hâlâ geçerli
+        uint32_t key = SharedData_WriteBegin();
+        VehicleState.system_status = SYS_BRAKING;
+        SharedData_WriteEnd(key);
+        FlightRecorder_State(now, state.system_status, SYS_BRAKING, FLIGHTREC_SRC_BRAKE);
+
+        brake_log.state = BRAKE_STATE_COMMANDED;
+        brake_log.source = source;
+        brake_log.command_time = now;
+        brake_log.command_position = pos;
+        brake_log.command_velocity = vel;
+        brake_log.predicted_stop = stop;
+        brake_log.command_margin = limit - stop;
+        brake_log.decision_latency = age;
+        OpticalSensor_SetBraking(now + BRAKE_ACTUATOR_LATENCY, brake_decel);
+
+        int n = snprintf(line, sizeof(line),
+                         "[BRAKE] komut x=%ld mm v=%ld mm/s durus=%ld mm pay=%ld mm yas=%lu us kaynak=%u\r\n",
+                         (long)q16_to_scaled(pos, 1000), (long)q16_to_scaled(vel, 1000),
+                         (long)q16_to_scaled(stop, 1000), (long)q16_to_scaled(limit - stop, 1000),
+                         (unsigned long)(age / (BRAKE_TICK_HZ / 1000000U)), source);
+        Brake_LogLine(line, n);
+        return;
+    }
+
+    if (brake_log.state != BRAKE_STATE_COMMANDED) return;
+
+    // Fren tuttuktan sonra ortalama yavaşlama; hız kestirimi basamağa
+    // oturduktan sonra başlar. Yeterince uzun ölçüldüyse ve nominalden
+    // küçükse (fren zayıf) duruş tahmini onu kullanır
+    int32_t since_onset = (int32_t)(now - (brake_log.command_time + BRAKE_ACTUATOR_LATENCY));
+    if (since_onset >= (int32_t)BRAKE_DECEL_SETTLE_TICKS) {
+        if (!onset_seen) {
+            onset_velocity = vel;
+            onset_time = now;
+            onset_seen = 1;
+        } else {
+            q16_t dt = Brake_TicksToSeconds(now - onset_time);
+            if (dt > 0) {
+                int64_t dv = (int64_t)(onset_velocity - vel) << Q16_SHIFT;
+                brake_log.measured_decel = (q16_t)(dv / dt);
+            }
+            if (now - onset_time >= BRAKE_DECEL_MEASURE_TICKS && brake_log.measured_decel > 0) {
+                uint8_t first = (brake_log.braking_stop == 0);
+                q16_t decel = (brake_log.measured_decel < BRAKE_DECEL_NOMINAL) ? brake_log.measured_decel
+                                                                                : BRAKE_DECEL_NOMINAL;
+                // Kapıya (ve uçuş kaydına) sadece anlamlı değişim gider
+                if ((first && decel != brake_decel) || decel > brake_decel + BRAKE_DECEL_STEP ||
+                    decel < brake_decel - BRAKE_DECEL_STEP) {
+                    brake_decel = decel;
+                    OpticalSensor_SetBraking(brake_log.command_time + BRAKE_ACTUATOR_LATENCY, decel);
+                }
+                // Ölçülen yavaşlamayla ilk tahmin: zayıf frende komut anındaki
+                // nominal tahminden ne kadar saptığını gösterir
+                if (first) brake_log.braking_stop = Brake_Stop(pos, vel, 0, brake_decel, 0);
+            }
+        }
+    }
+
+    if (vel <= BRAKE_STOP_VELOCITY) {
+        brake_log.state = BRAKE_STATE_STOPPED;
+        brake_log.stop_position = pos;
+        brake_log.stop_margin = map->end_position - pos;
+
+        int n = snprintf(line, sizeof(line), "[BRAKE] durus x=%ld mm sona=%ld mm yavaslama=%ld mm/s2\r\n",
+                         (long)q16_to_scaled(pos, 1000), (long)q16_to_scaled(brake_log.stop_margin, 1000),
+                         (long)q16_to_scaled(brake_log.measured_decel, 1000));
+        Brake_LogLine(line, n);
+    }
+}
+
+void BrakeSupervisor_Update(uint32_t now) {
+    PROFILE_BEGIN(PROF_BRAKE);
+    Brake_Evaluate(now);
+    PROFILE_END(PROF_BRAKE);
+}
+
+void BrakeSupervisor_GetLog(BrakeLog_t *log) {
+    *log = brake_log;
+}
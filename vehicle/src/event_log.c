@@ -0,0 +1,582 @@
+// event_log.c
+#include "event_log.h"
+#include "fw_state.h"
+#include "telemetry.h"
+#include "uart_log.h"
+#include "profiler.h"
+#include <stddef.h>
+#include <stdio.h>
+
+_Static_assert(sizeof(EventLogBlock_t) == 12U, "Blok başlığı düzeni");
+_Static_assert(EVLOG_BLOCK_SIZE * 8U <= UINT16_MAX, "Blok bit sayısı 16 bite sığmalı");
+
+// Rice bağlamları: IMU zamanı, 7 kanal, olay zamanı, olay değeri
+#define CTX_IMU_TIME     0U
+#define CTX_CHANNEL      1U
+#define CTX_EV_TIME      (CTX_CHANNEL + MPU6050_RAW_AXES)
+#define CTX_EV_VALUE     (CTX_EV_TIME + 1U)
+#define CTX_COUNT        (CTX_EV_VALUE + 1U)
+
+#define RICE_CLAMP       (1U << 24)                 // Uyarlama toplamı taşmasın
+#define RICE_K_MAX       15U                        // Anahtar karede 4 bit
+
+#define CHAN_TAPS        2U                         // NLMS: son iki sapma
+#define KF_COEF_SHIFT    (EVLOG_COEF_SHIFT - 6)     // Anahtar karede katsayı Q6, int8
+
+// Kanal öngörücüsü: ortalama + katsayılar * geçmiş
+typedef struct {
+    int32_t mean;                    // Üstel ortalama, Q EVLOG_PRED_SHIFT
+    int32_t hist[CHAN_TAPS];         // Yumuşatılmış sapma (ortalamaya göre), en yenisi 0
+    int32_t coef[CHAN_TAPS];         // Q EVLOG_COEF_SHIFT
+} EvLogChan_t;
+
+// Öngörücü durumu = anahtar kare (imu_time blok başlığında)
+typedef struct {
+    uint32_t imu_time;
+    int32_t imu_period;
+    int32_t imu_late;                // Son örneğin öngörülen anından gecikmesi (tek gecikmiş örnek)
+    int32_t imu_delay;               // Son görülen gecikme (hat beklemesi tekrarlanır)
+    EvLogChan_t chan[MPU6050_RAW_AXES];
+    int32_t ev_value[EVLOG_EV_TYPES];
+} EvLogPred_t;
+
+// Varint'ler: periyot, gecikme, son gecikme, olay değerleri, kanal başına
+// ortalama + geçmiş; ardından kanal başına katsayı byte'ları ve k nibble'ları
+#define KEYFRAME_VALUES  (3U + EVLOG_EV_TYPES + (1U + CHAN_TAPS) * MPU6050_RAW_AXES)
+#define KEYFRAME_K_BYTES ((CTX_COUNT + 1U) / 2U)
+#define KEYFRAME_MAX     (KEYFRAME_VALUES * 5U + CHAN_TAPS * MPU6050_RAW_AXES + KEYFRAME_K_BYTES)
+// En uzun kayıt: etiket + 8 kaçış (1 + 8 * (20 + 40) bit)
+#define RECORD_MAX_BYTES ((1U + (1U + MPU6050_RAW_AXES) * (EVLOG_RICE_ESCAPE + 40U) + 7U) / 8U)
+
+_Static_assert(sizeof(EventLogBlock_t) + KEYFRAME_MAX + RECORD_MAX_BYTES <= EVLOG_BLOCK_SIZE,
+               "En uzun kayıt boş bloğa sığmalı");
+
+// Bloklar 4 byte hizalı (başlık doğrudan okunur)
+FW_STATE uint32_t log_mem[EVLOG_BLOCKS][EVLOG_BLOCK_SIZE / 4U];
+FW_STATE uint32_t block_first = 0;     // En eski blok
+FW_STATE uint32_t block_count = 0;
+FW_STATE uint8_t running = 0;
+
+FW_STATE EvLogPred_t pred;
+FW_STATE uint32_t rice_a[CTX_COUNT];
+FW_STATE EventLogStats_t stats;
+
+// Açık bloğa yazıcı: acc'de nacc (< 8) bit bekler, out bir sonraki byte
+FW_STATE struct {
+    EventLogBlock_t *hdr;
+    uint8_t *out;
+    uint32_t acc;
+    uint32_t nacc;
+    uint32_t limit;                  // Bit akışı kapasitesi
+} wr;
+
+FW_STATE uint32_t dump_offset = 0;
+FW_STATE uint8_t dump_done = 1;
+
+static inline uint8_t *EvLog_Block(uint32_t i) {
+    return (uint8_t *)log_mem[(block_first + i) % EVLOG_BLOCKS];
+}
+
+static inline uint32_t EvLog_ZigZag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t EvLog_UnZigZag(uint32_t u) {
+    return (int32_t)(u >> 1) ^ -(int32_t)(u & 1U);
+}
+
+static inline int32_t EvLog_Mean(const EvLogChan_t *c) {
+    return (c->mean + (1 << (EVLOG_PRED_SHIFT - 1))) >> EVLOG_PRED_SHIFT;
+}
+
+static inline int32_t EvLog_Clamp(int64_t v, int32_t lo, int32_t hi) {
+    return (v < lo) ? lo : (v > hi) ? hi : (int32_t)v;
+}
+
+// Öngörü sayım aralığında tutulur: fark 17 bite, geçmiş 18 bite sığar
+static int32_t EvLog_ChanPredict(const EvLogChan_t *c) {
+    int64_t acc = 0;
+    for (uint32_t j = 0; j < CHAN_TAPS; j++) acc += (int64_t)c->coef[j] * c->hist[j];
+    acc = (acc + (1LL << (EVLOG_COEF_SHIFT - 1))) >> EVLOG_COEF_SHIFT;
+    return EvLog_Clamp(EvLog_Mean(c) + acc, INT16_MIN, INT16_MAX);
+}
+
+// IMU zamanı: bir sonraki örnek, son örneğin gecikmesi geri alınıp bir
+// periyot sonra beklenir. Hat beklemesiyle gecikmiş tek örnek (DMA bitiş
+// anı) böylece tek bir fark bırakır, sonraki örnek yine tam öngörülür
+static inline uint32_t EvLog_TimePredict(const EvLogPred_t *s) {
+    return s->imu_time - (uint32_t)s->imu_late + (uint32_t)s->imu_period;
+}
+
+// Zaman farkının iki adayı: zamanında (0) ve son gecikme kadar geç. Çift
+// kod 0'a, tek kod son gecikmeye göre farktır; kodlayıcı kısa olanı seçer
+static inline uint32_t EvLog_TimeCode(const EvLogPred_t *s, int32_t err) {
+    uint32_t on_time = EvLog_ZigZag(err);
+    uint32_t delayed = EvLog_ZigZag((int32_t)((uint32_t)err - (uint32_t)s->imu_delay));
+    return (on_time <= delayed) ? on_time * 2U : delayed * 2U + 1U;
+}
+
+static inline int32_t EvLog_TimeErr(const EvLogPred_t *s, uint32_t code) {
+    int32_t d = EvLog_UnZigZag(code >> 1);
+    return (code & 1U) ? (int32_t)((uint32_t)d + (uint32_t)s->imu_delay) : d;
+}
+
+// Küçük fark periyoda eklenir (saat kayması). Büyük fark önce gecikme
+// sayılır; hemen ardından yine büyükse (örnek kaçtı, faz kaydı) periyot
+// son aralığa kurulur. Kodlayıcı ve çözücü aynı sırayla çağırır
+static void EvLog_TimeUpdate(EvLogPred_t *s, uint32_t timestamp) {
+    int32_t err = (int32_t)(timestamp - EvLog_TimePredict(s));
+    if (err >= -EVLOG_TIME_TRACK && err <= EVLOG_TIME_TRACK) {
+        s->imu_period += err;
+        s->imu_late = 0;
+    } else if (s->imu_late == 0) {
+        s->imu_late = err;
+        s->imu_delay = err;
+    } else {
+        s->imu_period = (int32_t)(timestamp - s->imu_time);
+        s->imu_late = 0;
+    }
+    s->imu_time = timestamp;
+}
+
+// NLMS: adım geçmişin enerjisini aşan ilk 2'nin kuvvetine bölünür (bölme
+// yok). Kodlayıcı ve çözücü aynı sırayla çağırır
+static void EvLog_ChanUpdate(EvLogChan_t *c, int32_t raw, int32_t predicted) {
+    int32_t err = raw - predicted;
+    int64_t energy = 0;
+    for (uint32_t j = 0; j < CHAN_TAPS; j++) energy += (int64_t)c->hist[j] * c->hist[j];
+    uint32_t norm = (energy > 0) ? 64U - (uint32_t)__builtin_clzll((uint64_t)energy) : 0U;
+    for (uint32_t j = 0; j < CHAN_TAPS; j++) {
+        int64_t step = ((int64_t)err * c->hist[j] * (1 << (EVLOG_COEF_SHIFT - EVLOG_NLMS_SHIFT))) >> norm;
+        c->coef[j] = EvLog_Clamp(c->coef[j] + step, INT16_MIN, INT16_MAX);
+    }
+
+    c->mean += (raw * (1 << EVLOG_PRED_SHIFT) - c->mean) >> EVLOG_EMA_SHIFT;
+    for (uint32_t j = CHAN_TAPS - 1U; j > 0U; j--) c->hist[j] = c->hist[j - 1U];
+    c->hist[0] = predicted + (err >> EVLOG_SMOOTH_SHIFT) - EvLog_Mean(c);
+}
+
+static inline uint32_t EvLog_RiceK(uint32_t a) {
+    uint32_t mean = a >> EVLOG_RICE_SHIFT;
+    return (mean > 1U) ? 31U - (uint32_t)__builtin_clz(mean) : 0U;
+}
+
+static inline void EvLog_RiceAdapt(uint32_t *a, uint32_t zz, uint32_t clamp) {
+    *a += ((zz < clamp) ? zz : clamp) - (*a >> EVLOG_RICE_SHIFT);
+}
+
+// IMU zamanında büyük fark seyrek (gecikmiş tek örnek) ve kaçışla yazılır:
+// k'yı büyütüp her örneğin zamanını uzatmasın
+static inline uint32_t EvLog_RiceClamp(uint32_t ctx) {
+    return (ctx == CTX_IMU_TIME) ? EVLOG_TIME_ADAPT_MAX : RICE_CLAMP;
+}
+
+// Anahtar karedeki k'dan uyarlama toplamı: ortalama 1.5 * 2^k
+static inline uint32_t EvLog_RiceFromK(uint32_t k) {
+    return (3U << k) << (EVLOG_RICE_SHIFT - 1);
+}
+
+static inline uint32_t EvLog_VarintLen(uint32_t v) {
+    uint32_t bits = 32U - (uint32_t)__builtin_clz(v | 1U);
+    return (bits + 6U) / 7U;
+}
+
+static uint32_t EvLog_CodeLen(uint32_t zz, uint32_t k) {
+    uint32_t q = zz >> k;
+    if (q < EVLOG_RICE_ESCAPE) return q + 1U + k;
+    return EVLOG_RICE_ESCAPE + 8U * EvLog_VarintLen(zz);
+}
+
+static uint8_t *EvLog_PutVarint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80U) {
+        *p++ = (uint8_t)(v | 0x80U);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// n <= 24 (acc'de en fazla 7 bit bekler)
+static void EvLog_PutBits(uint32_t value, uint32_t n) {
+    wr.acc |= value << wr.nacc;
+    wr.nacc += n;
+    while (wr.nacc >= 8U) {
+        *wr.out++ = (uint8_t)wr.acc;
+        wr.acc >>= 8;
+        wr.nacc -= 8U;
+    }
+}
+
+static void EvLog_PutRice(uint32_t zz, uint32_t k) {
+    uint32_t q = zz >> k;
+    if (q >= EVLOG_RICE_ESCAPE) {
+        EvLog_PutBits((1U << EVLOG_RICE_ESCAPE) - 1U, EVLOG_RICE_ESCAPE);
+        while (zz >= 0x80U) {
+            EvLog_PutBits((zz & 0x7FU) | 0x80U, 8U);
+            zz >>= 7;
+        }
+        EvLog_PutBits(zz, 8U);
+        stats.escapes++;
+        return;
+    }
+    EvLog_PutBits((1U << q) - 1U, q + 1U);
+    if (k > 16U) {
+        EvLog_PutBits(zz & 0xFFFFU, 16U);
+        EvLog_PutBits((zz >> 16) & ((1U << (k - 16U)) - 1U), k - 16U);
+    } else if (k > 0U) {
+        EvLog_PutBits(zz & ((1U << k) - 1U), k);
+    }
+}
+
+// Öngörücü durumu (varint, katsayılar byte) ve bağlam başına k (4 bit):
+// blok önceki bloktan bağımsız çözülür ama uyarlamayı baştan öğrenmez.
+// Kanal durumu yazılırken yuvarlanır, kodlayıcı yuvarlanmış durumla sürer
+static uint8_t *EvLog_PutKeyframe(uint8_t *p, EvLogPred_t *s, uint32_t *a) {
+    p = EvLog_PutVarint(p, EvLog_ZigZag(s->imu_period));
+    p = EvLog_PutVarint(p, EvLog_ZigZag(s->imu_late));
+    p = EvLog_PutVarint(p, EvLog_ZigZag(s->imu_delay));
+    for (uint32_t i = 0; i < EVLOG_EV_TYPES; i++) p = EvLog_PutVarint(p, EvLog_ZigZag(s->ev_value[i]));
+    for (uint32_t i = 0; i < MPU6050_RAW_AXES; i++) {
+        EvLogChan_t *c = &s->chan[i];
+        int32_t mean = EvLog_Mean(c);
+        c->mean = mean * (1 << EVLOG_PRED_SHIFT);
+        p = EvLog_PutVarint(p, EvLog_ZigZag(mean));
+        for (uint32_t j = 0; j < CHAN_TAPS; j++) {
+            int32_t h = (c->hist[j] + (1 << (EVLOG_KF_HIST_SHIFT - 1))) >> EVLOG_KF_HIST_SHIFT;
+            c->hist[j] = h * (1 << EVLOG_KF_HIST_SHIFT);
+            p = EvLog_PutVarint(p, EvLog_ZigZag(h));
+        }
+        for (uint32_t j = 0; j < CHAN_TAPS; j++) {
+            int32_t q = EvLog_Clamp((c->coef[j] + (1 << (KF_COEF_SHIFT - 1))) >> KF_COEF_SHIFT, INT8_MIN, INT8_MAX);
+            c->coef[j] = q * (1 << KF_COEF_SHIFT);
+            *p++ = (uint8_t)q;
+        }
+    }
+    for (uint32_t i = 0; i < CTX_COUNT; i += 2U) {
+        uint32_t k0 = EvLog_RiceK(a[i]);
+        uint32_t k1 = (i + 1U < CTX_COUNT) ? EvLog_RiceK(a[i + 1U]) : 0U;
+        if (k0 > RICE_K_MAX) k0 = RICE_K_MAX;
+        if (k1 > RICE_K_MAX) k1 = RICE_K_MAX;
+        a[i] = EvLog_RiceFromK(k0);
+        if (i + 1U < CTX_COUNT) a[i + 1U] = EvLog_RiceFromK(k1);
+        *p++ = (uint8_t)(k0 | (k1 << 4));
+    }
+    return p;
+}
+
+static void EvLog_NewBlock(void) {
+    if (block_count == EVLOG_BLOCKS) {
+        stats.dropped_blocks++;
+        stats.dropped_records += ((const EventLogBlock_t *)EvLog_Block(0))->records;
+        block_first = (block_first + 1U) % EVLOG_BLOCKS;
+    } else {
+        block_count++;
+    }
+    stats.blocks++;
+
+    uint8_t *block = EvLog_Block(block_count - 1U);
+    wr.hdr = (EventLogBlock_t *)block;
+    wr.hdr->seq = stats.records;
+    wr.hdr->time = pred.imu_time;
+    wr.hdr->records = 0;
+    wr.hdr->bits = 0;
+    wr.out = EvLog_PutKeyframe(block + sizeof(EventLogBlock_t), &pred, rice_a);
+    wr.acc = 0;
+    wr.nacc = 0;
+    wr.limit = (uint32_t)(block + EVLOG_BLOCK_SIZE - wr.out) * 8U;
+}
+
+static uint32_t EvLog_RecordLen(uint32_t tag_bits, const uint32_t *zz, uint32_t ctx, uint32_t n) {
+    uint32_t len = tag_bits;
+    for (uint32_t i = 0; i < n; i++) len += EvLog_CodeLen(zz[i], EvLog_RiceK(rice_a[ctx + i]));
+    return len;
+}
+
+// Kayıt açık bloğa sığmıyorsa yeni blok açar. Dönüş 1: açıldı; bağlamlar
+// anahtar karenin k'sına, kanal öngörücüleri anahtar karedeki değerlere
+// yuvarlandığı için IMU farkları yeniden hesaplanır
+static uint8_t EvLog_Room(uint32_t tag_bits, const uint32_t *zz, uint32_t ctx, uint32_t n) {
+    if (block_count != 0U && wr.hdr->bits + EvLog_RecordLen(tag_bits, zz, ctx, n) <= wr.limit) return 0;
+    EvLog_NewBlock();
+    return 1;
+}
+
+// Etiket + n değer (ctx'ten başlayan ardışık bağlamlar); yer EvLog_Room ile açılmış olmalı
+static void EvLog_Append(uint32_t tag, uint32_t tag_bits, const uint32_t *zz, uint32_t ctx, uint32_t n) {
+    uint32_t len = EvLog_RecordLen(tag_bits, zz, ctx, n);
+
+    EvLog_PutBits(tag, tag_bits);
+    for (uint32_t i = 0; i < n; i++) {
+        EvLog_PutRice(zz[i], EvLog_RiceK(rice_a[ctx + i]));
+        EvLog_RiceAdapt(&rice_a[ctx + i], zz[i], EvLog_RiceClamp(ctx + i));
+    }
+    // Yarım byte da yazılır: açık blok her an çözülebilir
+    if (wr.nacc > 0U) *wr.out = (uint8_t)wr.acc;
+
+    wr.hdr->records++;
+    wr.hdr->bits = (uint16_t)(wr.hdr->bits + len);
+    stats.records++;
+}
+
+// zz[0]: zamanın, zz[1..]: kanalların öngörüden farkı
+static void EvLog_ImuResiduals(const int16_t *raw, uint32_t timestamp, int32_t *predicted, uint32_t *zz) {
+    zz[0] = EvLog_TimeCode(&pred, (int32_t)(timestamp - EvLog_TimePredict(&pred)));
+    for (uint32_t i = 0; i < MPU6050_RAW_AXES; i++) {
+        predicted[i] = EvLog_ChanPredict(&pred.chan[i]);
+        zz[1U + i] = EvLog_ZigZag(raw[i] - predicted[i]);
+    }
+}
+
+void EventLog_Init(void) {
+    block_first = 0;
+    block_count = 0;
+    pred = (EvLogPred_t){0};
+    stats = (EventLogStats_t){0};
+    for (uint32_t i = 0; i < CTX_COUNT; i++) rice_a[i] = EvLog_RiceFromK(2U);
+    dump_done = 1;
+    running = 1;
+}
+
+void EventLog_Stop(void) {
+    running = 0;
+}
+
+void EventLog_Imu(const int16_t *raw, uint32_t timestamp) {
+    if (!running) return;
+    PROFILE_BEGIN(PROF_EVLOG);
+
+    uint32_t zz[1U + MPU6050_RAW_AXES];
+    int32_t predicted[MPU6050_RAW_AXES];
+    EvLog_ImuResiduals(raw, timestamp, predicted, zz);
+    if (EvLog_Room(1U, zz, CTX_IMU_TIME, 1U + MPU6050_RAW_AXES)) {
+        EvLog_ImuResiduals(raw, timestamp, predicted, zz);
+    }
+    EvLog_Append(0U, 1U, zz, CTX_IMU_TIME, 1U + MPU6050_RAW_AXES);
+
+    EvLog_TimeUpdate(&pred, timestamp);
+    for (uint32_t i = 0; i < MPU6050_RAW_AXES; i++) {
+        EvLog_ChanUpdate(&pred.chan[i], raw[i], predicted[i]);
+    }
+    stats.imu_samples++;
+    PROFILE_END(PROF_EVLOG);
+}
+
+void EventLog_Event(uint8_t type, uint32_t time, int32_t value) {
+    if (!running || type >= EVLOG_EV_TYPES) return;
+
+    uint32_t zz[2];
+    zz[0] = EvLog_ZigZag((int32_t)(time - pred.imu_time));
+    zz[1] = EvLog_ZigZag(value - pred.ev_value[type]);
+    (void)EvLog_Room(3U, zz, CTX_EV_TIME, 2U);
+    EvLog_Append(1U | ((uint32_t)type << 1), 3U, zz, CTX_EV_TIME, 2U);
+
+    pred.ev_value[type] = value;
+    stats.events++;
+}
+
+uint32_t EventLog_BlockCount(void) {
+    return block_count;
+}
+
+uint32_t EventLog_Read(uint32_t offset, uint8_t *out, uint32_t len) {
+    uint32_t size = block_count * EVLOG_BLOCK_SIZE;
+    if (offset >= size) return 0;
+    if (len > size - offset) len = size - offset;
+
+    for (uint32_t n = 0; n < len; n++, offset++) {
+        out[n] = EvLog_Block(offset / EVLOG_BLOCK_SIZE)[offset % EVLOG_BLOCK_SIZE];
+    }
+    return len;
+}
+
+// ============= ÇÖZÜCÜ =============
+typedef struct {
+    const uint8_t *data;
+    uint32_t pos;        // Bit
+    uint32_t end;
+    uint8_t overrun;     // Akışın sonundan öte okundu
+} EvLogReader_t;
+
+static uint32_t EvLog_GetBits(EvLogReader_t *r, uint32_t n) {
+    uint32_t v = 0;
+    if (r->pos + n > r->end) {
+        r->overrun = 1;
+        return 0;
+    }
+    for (uint32_t i = 0; i < n; i++, r->pos++) {
+        v |= (uint32_t)((r->data[r->pos >> 3] >> (r->pos & 7U)) & 1U) << i;
+    }
+    return v;
+}
+
+static uint8_t EvLog_GetRice(EvLogReader_t *r, uint32_t k, uint32_t *zz) {
+    uint32_t q = 0;
+    while (q < EVLOG_RICE_ESCAPE && !r->overrun && EvLog_GetBits(r, 1U) == 1U) q++;
+    if (q == EVLOG_RICE_ESCAPE) {
+        uint32_t v = 0;
+        for (uint32_t shift = 0; shift < 35U; shift += 7U) {
+            uint32_t byte = EvLog_GetBits(r, 8U);
+            v |= (byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0U) {
+                *zz = v;
+                return !r->overrun;
+            }
+        }
+        return 0;
+    }
+    uint32_t low = (k > 16U) ? (EvLog_GetBits(r, 16U) | (EvLog_GetBits(r, k - 16U) << 16)) : EvLog_GetBits(r, k);
+    *zz = (q << k) | low;
+    return !r->overrun;
+}
+
+static const uint8_t *EvLog_GetVarint(const uint8_t *p, const uint8_t *end, uint32_t *v) {
+    *v = 0;
+    for (uint32_t shift = 0; shift < 35U && p < end; shift += 7U) {
+        uint8_t byte = *p++;
+        *v |= (uint32_t)(byte & 0x7FU) << shift;
+        if ((byte & 0x80U) == 0U) return p;
+    }
+    return NULL;
+}
+
+uint8_t EventLog_DecodeBlock(const uint8_t *block, EventLogSink_t sink, void *ctx) {
+    const EventLogBlock_t *hdr = (const EventLogBlock_t *)block;
+    const uint8_t *end = block + EVLOG_BLOCK_SIZE;
+    const uint8_t *p = block + sizeof(*hdr);
+    EvLogPred_t s;
+    uint32_t v;
+
+    s.imu_time = hdr->time;
+    p = EvLog_GetVarint(p, end, &v);
+    if (p == NULL) return EVLOG_ERR_FORMAT;
+    s.imu_period = EvLog_UnZigZag(v);
+    p = EvLog_GetVarint(p, end, &v);
+    if (p == NULL) return EVLOG_ERR_FORMAT;
+    s.imu_late = EvLog_UnZigZag(v);
+    p = EvLog_GetVarint(p, end, &v);
+    if (p == NULL) return EVLOG_ERR_FORMAT;
+    s.imu_delay = EvLog_UnZigZag(v);
+    for (uint32_t i = 0; i < EVLOG_EV_TYPES; i++) {
+        p = EvLog_GetVarint(p, end, &v);
+        if (p == NULL) return EVLOG_ERR_FORMAT;
+        s.ev_value[i] = EvLog_UnZigZag(v);
+    }
+    for (uint32_t i = 0; i < MPU6050_RAW_AXES; i++) {
+        EvLogChan_t *c = &s.chan[i];
+        p = EvLog_GetVarint(p, end, &v);
+        if (p == NULL) return EVLOG_ERR_FORMAT;
+        c->mean = EvLog_UnZigZag(v) * (1 << EVLOG_PRED_SHIFT);
+        for (uint32_t j = 0; j < CHAN_TAPS; j++) {
+            p = EvLog_GetVarint(p, end, &v);
+            if (p == NULL) return EVLOG_ERR_FORMAT;
+            c->hist[j] = EvLog_UnZigZag(v) * (1 << EVLOG_KF_HIST_SHIFT);
+        }
+        if (end - p < (ptrdiff_t)CHAN_TAPS) return EVLOG_ERR_FORMAT;
+        for (uint32_t j = 0; j < CHAN_TAPS; j++) c->coef[j] = (int8_t)*p++ * (1 << KF_COEF_SHIFT);
+    }
+    uint32_t a[CTX_COUNT];
+    if (end - p < (ptrdiff_t)KEYFRAME_K_BYTES) return EVLOG_ERR_FORMAT;
+    for (uint32_t i = 0; i < CTX_COUNT; i++) {
+        a[i] = EvLog_RiceFromK((p[i / 2U] >> ((i & 1U) * 4U)) & 0x0FU);
+    }
+    p += KEYFRAME_K_BYTES;
+    if ((uint32_t)hdr->bits > (uint32_t)(end - p) * 8U) return EVLOG_ERR_FORMAT;
+
+    EvLogReader_t r = { p, 0, hdr->bits, 0 };
+
+    for (uint32_t n = 0; n < hdr->records; n++) {
+        EventLogRecord_t rec = { .seq = hdr->seq + n };
+        uint32_t zz[1U + MPU6050_RAW_AXES];
+        uint32_t ctx0, count;
+
+        if (EvLog_GetBits(&r, 1U) == 0U) {
+            rec.type = EVLOG_REC_IMU;
+            ctx0 = CTX_IMU_TIME;
+            count = 1U + MPU6050_RAW_AXES;
+        } else {
+            rec.type = (uint8_t)EvLog_GetBits(&r, 2U);
+            ctx0 = CTX_EV_TIME;
+            count = 2U;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            if (!EvLog_GetRice(&r, EvLog_RiceK(a[ctx0 + i]), &zz[i])) return EVLOG_ERR_FORMAT;
+            EvLog_RiceAdapt(&a[ctx0 + i], zz[i], EvLog_RiceClamp(ctx0 + i));
+        }
+
+        if (rec.type == EVLOG_REC_IMU) {
+            rec.time = EvLog_TimePredict(&s) + (uint32_t)EvLog_TimeErr(&s, zz[0]);
+            EvLog_TimeUpdate(&s, rec.time);
+            for (uint32_t i = 0; i < MPU6050_RAW_AXES; i++) {
+                int32_t predicted = EvLog_ChanPredict(&s.chan[i]);
+                int32_t raw = predicted + EvLog_UnZigZag(zz[1U + i]);
+                if (raw < INT16_MIN || raw > INT16_MAX) return EVLOG_ERR_FORMAT;
+                rec.raw[i] = (int16_t)raw;
+                EvLog_ChanUpdate(&s.chan[i], raw, predicted);
+            }
+        } else {
+            rec.time = s.imu_time + (uint32_t)EvLog_UnZigZag(zz[0]);
+            rec.value = s.ev_value[rec.type] + EvLog_UnZigZag(zz[1]);
+            s.ev_value[rec.type] = rec.value;
+        }
+        sink(&rec, ctx);
+    }
+    return (r.pos == r.end) ? EVLOG_OK : EVLOG_ERR_FORMAT;
+}
+
+uint32_t EventLog_Seek(const uint8_t *image, uint32_t blocks, uint32_t time) {
+    if (blocks == 0U) return 0;
+    // Zamanlar ilk bloğa göre (TIM2 sayacı taşabilir)
+    uint32_t t0 = ((const EventLogBlock_t *)image)->time;
+    int32_t target = (int32_t)(time - t0);
+    uint32_t lo = 0, hi = blocks - 1U;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi + 1U) / 2U;
+        const EventLogBlock_t *h = (const EventLogBlock_t *)(image + mid * EVLOG_BLOCK_SIZE);
+        if ((int32_t)(h->time - t0) <= target) {
+            lo = mid;
+        } else {
+            hi = mid - 1U;
+        }
+    }
+    return lo;
+}
+
+// ============= UART DÖKÜMÜ =============
+void EventLog_DumpStart(void) {
+    EventLog_Stop();
+    dump_offset = UINT32_MAX;
+    dump_done = 0;
+}
+
+uint8_t EventLog_DumpStep(void) {
+    char line[24U + 2U * EVLOG_DUMP_CHUNK];
+    uint32_t size = block_count * EVLOG_BLOCK_SIZE;
+
+    while (!dump_done && UART_LOG_BUF_SIZE - UartLog_Pending() >= sizeof(line)) {
+        int n;
+        if (dump_offset == UINT32_MAX) {
+            n = snprintf(line, sizeof(line), "EL BEGIN %lu\r\n", (unsigned long)size);
+            dump_offset = 0;
+        } else if (dump_offset >= size) {
+            n = snprintf(line, sizeof(line), "EL END\r\n");
+            dump_done = 1;
+        } else {
+            uint8_t chunk[EVLOG_DUMP_CHUNK];
+            uint32_t len = EventLog_Read(dump_offset, chunk, sizeof(chunk));
+            n = snprintf(line, sizeof(line), "EL %04lX ", (unsigned long)dump_offset);
+            for (uint32_t i = 0; i < len; i++) {
+                n += snprintf(&line[n], sizeof(line) - (size_t)n, "%02X", chunk[i]);
+            }
+            n += snprintf(&line[n], sizeof(line) - (size_t)n, " %04X\r\n",
+                          Telemetry_Crc16(chunk, (uint16_t)len));
+            dump_offset += len;
+        }
+        line[n++] = '\0';
+        UartLog_Write((const uint8_t *)line, (uint16_t)n);
+    }
+    return !dump_done;
+}
+
+void EventLog_GetStats(EventLogStats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,205 @@
+// flight_recorder.c
+#include "flight_recorder.h"
+#include "fw_state.h"
+#include "telemetry.h"
+#include "uart_log.h"
+#include "stm32f1xx_hal.h"
+#include <stddef.h>
+#include <stdio.h>
+
+_Static_assert(FLIGHTREC_IMAGE_MAX <= FLIGHTREC_FLASH_PAGES * 0x400U, "Kayıt görüntüsü flash alanına sığmıyor");
+
+FW_STATE FlightRecord_t ring[FLIGHTREC_RECORDS];
+FW_STATE uint32_t ring_head = 0;        // Sıradaki yazılacak yer
+FW_STATE uint32_t ring_count = 0;
+FW_STATE uint32_t imu_phase = 0;
+FW_STATE uint8_t running = 0;
+FW_STATE FlightRecHeader_t header;      // Stop'ta tamamlanır
+FW_STATE FlightRecStats_t stats;
+
+// UART dökümü: sıradaki ofset (UINT32_MAX: BEGIN satırı yazılmadı)
+FW_STATE uint32_t dump_offset = 0;
+FW_STATE uint8_t dump_done = 1;
+
+static void FlightRecorder_Push(uint32_t time, uint8_t type, uint8_t arg, uint16_t aux, int32_t value) {
+    if (!running) return;
+
+    FlightRecord_t *r = &ring[ring_head];
+    r->time = time;
+    r->type = type;
+    r->arg = arg;
+    r->aux = aux;
+    r->value = value;
+    ring_head = (ring_head + 1U) % FLIGHTREC_RECORDS;
+    if (ring_count < FLIGHTREC_RECORDS) {
+        ring_count++;
+    } else {
+        stats.dropped++;
+    }
+    stats.records++;
+}
+
+// Görüntüde i. kayıt (0: en eski)
+static const FlightRecord_t *FlightRecorder_At(uint32_t i) {
+    return &ring[(ring_head + FLIGHTREC_RECORDS - ring_count + i) % FLIGHTREC_RECORDS];
+}
+
+void FlightRecorder_Start(uint32_t now) {
+    ring_head = 0;
+    ring_count = 0;
+    imu_phase = 0;
+    stats = (FlightRecStats_t){0};
+    dump_done = 1;
+
+    header = (FlightRecHeader_t){0};
+    header.magic = FLIGHTREC_MAGIC;
+    header.version = FLIGHTREC_VERSION;
+    header.record_size = sizeof(FlightRecord_t);
+    header.imu_div = FLIGHTREC_IMU_DIV;
+    header.start_time = now;
+    header.map = *TunnelMap_Params();
+
+    running = 1;
+    stats.running = 1;
+}
+
+void FlightRecorder_Stop(void) {
+    if (!running) return;
+    running = 0;
+    stats.running = 0;
+
+    SharedData_t state;
+    SharedData_Snapshot(&state);
+    header.count = (uint16_t)ring_count;
+    header.dropped = stats.dropped;
+    header.final_position = state.current_position;
+    header.final_velocity = state.current_velocity;
+    header.final_reflectors = state.reflector_count;
+
+    uint16_t crc = Telemetry_Crc16((const uint8_t *)&header, offsetof(FlightRecHeader_t, crc));
+    for (uint32_t i = 0; i < ring_count; i++) {
+        crc = Telemetry_Crc16Update(crc, (const uint8_t *)FlightRecorder_At(i), sizeof(FlightRecord_t));
+    }
+    header.crc = crc;
+}
+
+// Konum, sayaç ve durum aynı yayından: IMU kesmesi araya yazsa da kopya tutarlı
+void FlightRecorder_Nav(uint8_t type, uint32_t time) {
+    if (!running) return;
+    SharedData_t state;
+    SharedData_Snapshot(&state);
+    FlightRecorder_Push(time, type, state.system_status, (uint16_t)state.reflector_count,
+                        state.current_position);
+}
+
+void FlightRecorder_State(uint32_t time, uint8_t from, uint8_t to, uint8_t source) {
+    if (!running) return;
+    SharedData_t state;
+    SharedData_Snapshot(&state);
+    FlightRecorder_Push(time, FLIGHTREC_STATE, to, (uint16_t)(from | (source << 8)), state.current_velocity);
+}
+
+void FlightRecorder_Brake(uint32_t onset, q16_t decel) {
+    FlightRecorder_Push(onset, FLIGHTREC_BRAKE, 0, 0, decel);
+}
+
+void FlightRecorder_Imu(const IMU_Data_t *imu, uint32_t timestamp) {
+    if (!running) return;
+    stats.imu_samples++;
+    if (imu_phase++ % FLIGHTREC_IMU_DIV != 0U) return;
+
+    // gyro_z Q16 -> Q8.8, ±128 dps'te doyar
+    int32_t gyro = imu->gyro_z_dps >> 8;
+    if (gyro > INT16_MAX) gyro = INT16_MAX;
+    if (gyro < INT16_MIN) gyro = INT16_MIN;
+    FlightRecorder_Push(timestamp, FLIGHTREC_IMU, 0, (uint16_t)(int16_t)gyro, imu->accel_x_g);
+}
+
+uint32_t FlightRecorder_ImageSize(void) {
+    return sizeof(FlightRecHeader_t) + ring_count * sizeof(FlightRecord_t);
+}
+
+uint32_t FlightRecorder_Read(uint32_t offset, uint8_t *out, uint32_t len) {
+    uint32_t size = FlightRecorder_ImageSize();
+    if (offset >= size) return 0;
+    if (len > size - offset) len = size - offset;
+
+    for (uint32_t n = 0; n < len; n++, offset++) {
+        if (offset < sizeof(FlightRecHeader_t)) {
+            out[n] = ((const uint8_t *)&header)[offset];
+        } else {
+            uint32_t rel = offset - sizeof(FlightRecHeader_t);
+            out[n] = ((const uint8_t *)FlightRecorder_At(rel / sizeof(FlightRecord_t)))[rel % sizeof(FlightRecord_t)];
+        }
+    }
+    return len;
+}
+
+void FlightRecorder_DumpStart(void) {
+    FlightRecorder_Stop();
+    dump_offset = UINT32_MAX;
+    dump_done = 0;
+}
+
+uint8_t FlightRecorder_DumpStep(void) {
+    // "FR oooo " + 2 hex/byte + " cccc\r\n". Satır fren logu gibi 0x00 ile
+    // biter: telemetri açıkken COBS alıcısı metni ayrı çerçeve sayıp atlar
+    char line[24U + 2U * FLIGHTREC_DUMP_CHUNK];
+    uint32_t size = FlightRecorder_ImageSize();
+
+    while (!dump_done && UART_LOG_BUF_SIZE - UartLog_Pending() >= sizeof(line)) {
+        int n;
+        if (dump_offset == UINT32_MAX) {
+            n = snprintf(line, sizeof(line), "FR BEGIN %lu\r\n", (unsigned long)size);
+            dump_offset = 0;
+        } else if (dump_offset >= size) {
+            n = snprintf(line, sizeof(line), "FR END\r\n");
+            dump_done = 1;
+        } else {
+            uint8_t chunk[FLIGHTREC_DUMP_CHUNK];
+            uint32_t len = FlightRecorder_Read(dump_offset, chunk, sizeof(chunk));
+            n = snprintf(line, sizeof(line), "FR %04lX ", (unsigned long)dump_offset);
+            for (uint32_t i = 0; i < len; i++) {
+                n += snprintf(&line[n], sizeof(line) - (size_t)n, "%02X", chunk[i]);
+            }
+            n += snprintf(&line[n], sizeof(line) - (size_t)n, " %04X\r\n",
+                          Telemetry_Crc16(chunk, (uint16_t)len));
+            dump_offset += len;
+        }
+        line[n++] = '\0';
+        UartLog_Write((const uint8_t *)line, (uint16_t)n);
+    }
+    return !dump_done;
+}
+
+uint8_t FlightRecorder_SaveFlash(void) {
+    FlightRecorder_Stop();
+
+    uint32_t size = FlightRecorder_ImageSize();
+    FLASH_EraseInitTypeDef erase = {0};
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = FLASH_BANK_1;
+    erase.PageAddress = FLIGHTREC_FLASH_ADDR;
+    erase.NbPages = FLIGHTREC_FLASH_PAGES;
+    uint32_t page_error = 0;
+
+    if (HAL_FLASH_Unlock() != HAL_OK) return 1;
+    uint8_t status = (HAL_FLASHEx_Erase(&erase, &page_error) == HAL_OK) ? 0U : 1U;
+
+    // F1 flash'ı yarım kelime yazar; WORD iki yarım kelime yazımıdır
+    for (uint32_t offset = 0; status == 0 && offset < size; offset += 4U) {
+        uint8_t word[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+        FlightRecorder_Read(offset, word, sizeof(word));
+        uint32_t data = (uint32_t)word[0] | ((uint32_t)word[1] << 8) |
+                        ((uint32_t)word[2] << 16) | ((uint32_t)word[3] << 24);
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, FLIGHTREC_FLASH_ADDR + offset, data) != HAL_OK) {
+            status = 1;
+        }
+    }
+    HAL_FLASH_Lock();
+    return status;
+}
+
+void FlightRecorder_GetStats(FlightRecStats_t *out) {
+    *out = stats;
+}
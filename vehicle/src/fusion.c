@@ -0,0 +1,262 @@
+// fusion.c
+#include "fusion.h"
+#include "fw_state.h"
+#include "profiler.h"
+#include <string.h>
+
+#define Q32_SCALE        4294967296.0f
+#define TICK_S           (1.0f / (float)FUSION_TICK_HZ)
+
+// Kovaryansın üst üçgeni (simetrik)
+enum { PP = 0, PV, PB, VV, VB, BB };
+
+typedef struct {
+    int64_t position_q32;
+    float var;
+    uint32_t timestamp;
+} FusionFix_t;
+
+FW_STATE uint8_t fusion_ready = 0;
+FW_STATE uint8_t fusion_sources = FUSION_SRC_OPTICAL | FUSION_SRC_EXTERNAL;
+
+FW_STATE int64_t pos_q32;        // m, Q32.32
+FW_STATE int64_t vel_q32;        // m/s, Q32.32
+FW_STATE float bias;             // m/s^2
+FW_STATE float P[6];
+FW_STATE float accel_mps2;       // Son IMU ivmesi (sapma düzeltmesiz), örnekler arası sabit
+FW_STATE uint32_t state_time;    // Durumun ait olduğu an
+
+FW_STATE FusionFix_t fix_queue[FUSION_FIX_QUEUE];
+FW_STATE uint8_t fix_pending = 0;
+FW_STATE uint8_t gate_rejects = 0;   // Art arda kapıda atılan düzeltme
+
+FW_STATE FusionStats_t stats;
+
+static void Fusion_Predict(float dt) {
+    // 1. Durum: sabit ivmeyle integrasyon
+    float a = accel_mps2 - bias;
+    float v = (float)vel_q32 * (1.0f / Q32_SCALE);
+    float dv = a * dt;
+    float dp = (v + 0.5f * dv) * dt;
+    pos_q32 += (int64_t)(dp * Q32_SCALE);
+    vel_q32 += (int64_t)(dv * Q32_SCALE);
+
+    // 2. Kovaryans: P = F P F' + Q, F = [1 T -h; 0 1 -T; 0 0 1], h = T^2/2
+    float T = dt;
+    float h = 0.5f * dt * dt;
+    float a11 = P[PP] + T * P[PV] - h * P[PB];
+    float a12 = P[PV] + T * P[VV] - h * P[VB];
+    float a13 = P[PB] + T * P[VB] - h * P[BB];
+    float a22 = P[VV] - T * P[VB];
+    float a23 = P[VB] - T * P[BB];
+
+    P[PP] = a11 + T * a12 - h * a13;
+    P[PV] = a12 - T * a13;
+    P[PB] = a13;
+    P[VV] = a22 - T * a23;
+    P[VB] = a23;
+
+    // Sürekli beyaz ivme gürültüsü + sapma rastgele yürüyüşü
+    float qa = FUSION_ACCEL_PSD * T;
+    P[PP] += qa * T * T * (1.0f / 3.0f);
+    P[PV] += qa * T * 0.5f;
+    P[VV] += qa;
+    P[BB] += FUSION_BIAS_PSD * T;
+
+    stats.predicts++;
+}
+
+static void Fusion_AdvanceTo(uint32_t timestamp) {
+    int32_t dticks = (int32_t)(timestamp - state_time);
+    if (dticks <= 0) return;
+
+    float dt = (float)dticks * TICK_S;
+    if (dt > FUSION_MAX_DT_S) {
+        // IMU kopmuş: ivme bilinmiyor, sabit hız varsay (belirsizlik yine büyür)
+        stats.gaps++;
+        accel_mps2 = bias;
+        Fusion_Predict(dt);
+
+        // Sabit ama bilinmeyen ivme: konum a*dt^2/2, hız a*dt kadar belirsiz
+        float sa = FUSION_GAP_ACCEL_STD * dt;
+        P[PP] += 0.25f * sa * sa * dt * dt;
+        P[PV] += 0.5f * sa * sa * dt;
+        P[VV] += sa * sa;
+        state_time = timestamp;
+        return;
+    }
+    Fusion_Predict(dt);
+    state_time = timestamp;
+}
+
+// Ölçüm anı durum anından lag saniye önceyse H = [1, -lag, 0]
+static void Fusion_Update(const FusionFix_t *fix, float lag) {
+    float v = (float)vel_q32 * (1.0f / Q32_SCALE);
+    float r = (float)(fix->position_q32 - pos_q32) * (1.0f / Q32_SCALE) + lag * v;
+
+    // İnovasyon kapısı: normalize inovasyon karesi r^2 / S
+    float s = P[PP] - 2.0f * lag * P[PV] + lag * lag * P[VV] + fix->var;
+    float nis = r * r / s;
+    if (nis > FUSION_GATE_CHI2) {
+        if (++gate_rejects < FUSION_GATE_MAX_REJECTS) {
+            stats.rejected_fixes++;
+            return;
+        }
+        // Tahmin bozulmuş: konum belirsizliği inovasyon kadar büyütülür,
+        // düzeltme konumu neredeyse tamamen devralır
+        stats.forced_gate++;
+        P[PP] += r * r;
+    } else if (nis > stats.max_nis) {
+        stats.max_nis = nis;
+    }
+    gate_rejects = 0;
+
+    float ph0 = P[PP] - lag * P[PV];
+    float ph1 = P[PV] - lag * P[VV];
+    float ph2 = P[PB] - lag * P[VB];
+    float inv_s = 1.0f / (ph0 - lag * ph1 + fix->var);
+
+    float k0 = ph0 * inv_s;
+    float k1 = ph1 * inv_s;
+    float k2 = ph2 * inv_s;
+
+    pos_q32 += (int64_t)(k0 * r * Q32_SCALE);
+    vel_q32 += (int64_t)(k1 * r * Q32_SCALE);
+    bias += k2 * r;
+
+    P[PP] -= k0 * ph0;
+    P[PV] -= k0 * ph1;
+    P[PB] -= k0 * ph2;
+    P[VV] -= k1 * ph1;
+    P[VB] -= k1 * ph2;
+    P[BB] -= k2 * ph2;
+
+    stats.fixes++;
+}
+
+static void Fusion_PopFix(void) {
+    for (uint8_t i = 1; i < fix_pending; i++) {
+        fix_queue[i - 1] = fix_queue[i];
+    }
+    fix_pending--;
+}
+
+static void Fusion_Publish(void) {
+    NavEstimate_t nav;
+    nav.position = (q16_t)(pos_q32 >> 16);
+    nav.velocity = (q16_t)(vel_q32 >> 16);
+    nav.accel_bias = (q16_t)(bias * 65536.0f);
+    memcpy(nav.cov, P, sizeof(P));
+    nav.timestamp = state_time;
+    nav.fix_count = stats.fixes;
+
+    uint32_t key = SharedData_WriteBegin();
+    VehicleState.nav = nav;
+    SharedData_WriteEnd(key);
+}
+
+void Fusion_Init(q16_t position, uint32_t timestamp) {
+    pos_q32 = (int64_t)position << 16;
+    vel_q32 = 0;
+    bias = 0.0f;
+    accel_mps2 = 0.0f;
+    state_time = timestamp;
+
+    memset(P, 0, sizeof(P));
+    P[PP] = FUSION_INIT_POS_STD * FUSION_INIT_POS_STD;
+    P[VV] = FUSION_INIT_VEL_STD * FUSION_INIT_VEL_STD;
+    P[BB] = FUSION_INIT_BIAS_STD * FUSION_INIT_BIAS_STD;
+
+    fix_pending = 0;
+    gate_rejects = 0;
+    memset(&stats, 0, sizeof(stats));
+    fusion_ready = 1;
+    Fusion_Publish();
+}
+
+void Fusion_ImuSample(const IMU_Data_t *imu, uint32_t timestamp) {
+    if (!fusion_ready) return;
+
+    if ((int32_t)(timestamp - state_time) <= 0) {
+        stats.stale_samples++;
+        return;
+    }
+    PROFILE_BEGIN(PROF_FUSION_IMU);
+
+    // Örneğin ivmesi bir önceki örnekten bu yana geçen aralık için kullanılır
+    accel_mps2 = (float)imu->accel_x_g * (FUSION_G / 65536.0f);
+
+    // Aradaki düzeltmeler kendi anlarında uygulanır
+    while (fix_pending > 0 && (int32_t)(fix_queue[0].timestamp - timestamp) <= 0) {
+        Fusion_AdvanceTo(fix_queue[0].timestamp);
+        Fusion_Update(&fix_queue[0], 0.0f);
+        Fusion_PopFix();
+    }
+    Fusion_AdvanceTo(timestamp);
+    Fusion_Publish();
+    PROFILE_END(PROF_FUSION_IMU);
+}
+
+void Fusion_PositionFix(uint8_t source, q16_t position, q16_t std, uint32_t timestamp) {
+    if (!fusion_ready) return;
+    if (!(source & fusion_sources)) {
+        stats.ignored_fixes++;
+        return;
+    }
+
+    float std_m = (float)std * (1.0f / 65536.0f);
+    FusionFix_t fix = { (int64_t)position << 16, std_m * std_m, timestamp };
+
+    int32_t lag = (int32_t)(state_time - timestamp);
+    if (lag >= 0) {
+        // IMU bu anı geçmiş: tahmini geri taşımadan, gecikmeyle telafi et
+        stats.late_fixes++;
+        Fusion_Update(&fix, (float)lag * TICK_S);
+        Fusion_Publish();
+        return;
+    }
+
+    if (fix_pending == FUSION_FIX_QUEUE) {
+        // IMU örneği gelmiyor: en eski düzeltmeyi son ivmeyle ilerleyip uygula
+        stats.forced_fixes++;
+        Fusion_AdvanceTo(fix_queue[0].timestamp);
+        Fusion_Update(&fix_queue[0], 0.0f);
+        Fusion_PopFix();
+        Fusion_Publish();
+    }
+    fix_queue[fix_pending++] = fix;
+}
+
+void Fusion_ZeroVelocity(void) {
+    if (!fusion_ready) return;
+
+    // H = [0, 1, 0], r = 0 - v
+    float r = -(float)vel_q32 * (1.0f / Q32_SCALE);
+    float hp = P[PV], hv = P[VV], hb = P[VB];
+    float inv_s = 1.0f / (hv + FUSION_ZUPT_STD * FUSION_ZUPT_STD);
+    float k0 = hp * inv_s;
+    float k1 = hv * inv_s;
+    float k2 = hb * inv_s;
+
+    pos_q32 += (int64_t)(k0 * r * Q32_SCALE);
+    vel_q32 += (int64_t)(k1 * r * Q32_SCALE);
+    bias += k2 * r;
+
+    P[PP] -= k0 * hp;
+    P[PV] -= k0 * hv;
+    P[PB] -= k0 * hb;
+    P[VV] -= k1 * hv;
+    P[VB] -= k1 * hb;
+    P[BB] -= k2 * hb;
+
+    stats.zero_velocity++;
+    Fusion_Publish();
+}
+
+void Fusion_SetSources(uint8_t mask) {
+    fusion_sources = mask;
+}
+
+void Fusion_GetStats(FusionStats_t *out) {
+    *out = stats;
+}
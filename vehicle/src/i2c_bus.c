@@ -0,0 +1,323 @@
+// i2c_bus.c
+#include "i2c_bus.h"
+#include "fw_state.h"
+#include "profiler.h"
+#include <string.h>
+
+// Hat durumu
+#define BUS_IDLE         0U
+#define BUS_ACTIVE       1U   // HAL işlemi sürüyor (bitiş kesmesi bekleniyor)
+#define BUS_RECOVER      2U   // Hat hatası: Poll kurtarır (active tekrar bekliyor olabilir)
+#define BUS_OFFLINE      3U   // Art arda hata: offline_until'e kadar kapalı
+
+typedef struct {
+    I2CBusXfer_t xfer;
+    uint8_t wbuf[I2C_BUS_WRITE_MAX];
+    uint32_t queued_at;       // Kuyruğa giriş (bus_clock)
+} I2CBusSlot_t;
+
+FW_STATE I2C_HandleTypeDef *bus_hi2c = NULL;
+FW_STATE uint32_t (*bus_clock)(void) = NULL;
+
+FW_STATE I2CBusDeviceStats_t devices[I2C_BUS_MAX_DEVICES];
+FW_STATE uint8_t device_count = 0;
+
+// Öncelik sınıfı başına halka
+FW_STATE I2CBusSlot_t queue[I2C_BUS_PRIORITIES][I2C_BUS_QUEUE_DEPTH];
+FW_STATE uint8_t queue_head[I2C_BUS_PRIORITIES];
+FW_STATE uint8_t queue_count[I2C_BUS_PRIORITIES];
+
+FW_STATE I2CBusSlot_t active;               // Hattaki (veya tekrar bekleyen) işlem
+FW_STATE uint8_t active_valid = 0;
+FW_STATE uint32_t active_deadline = 0;      // HAL_GetTick
+FW_STATE volatile uint8_t bus_state = BUS_IDLE;
+FW_STATE uint8_t dispatching = 0;           // Sahibin callback'i sürüyor: Submit hattı başlatmaz
+
+FW_STATE uint8_t fail_streak = 0;           // Art arda başarısız deneme
+FW_STATE uint32_t backoff_ms = I2C_BUS_BACKOFF_MS;
+FW_STATE uint32_t offline_since = 0;
+FW_STATE uint32_t offline_until = 0;
+
+FW_STATE I2CBusStats_t stats;
+
+uint32_t I2CBus_Now(void) {
+    return bus_clock ? bus_clock() : HAL_GetTick();
+}
+
+void I2CBus_Init(I2C_HandleTypeDef *hi2c, uint32_t (*clock)(void)) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bus_hi2c = hi2c;
+    bus_clock = clock;
+    memset(queue_head, 0, sizeof(queue_head));
+    memset(queue_count, 0, sizeof(queue_count));
+    active_valid = 0;
+    bus_state = BUS_IDLE;
+    dispatching = 0;
+    fail_streak = 0;
+    backoff_ms = I2C_BUS_BACKOFF_MS;
+    device_count = 0;
+    stats = (I2CBusStats_t){0};
+    __set_PRIMASK(primask);
+}
+
+uint8_t I2CBus_AddDevice(uint16_t addr, const char *name) {
+    if (device_count >= I2C_BUS_MAX_DEVICES) return I2C_BUS_NO_DEVICE;
+    devices[device_count] = (I2CBusDeviceStats_t){0};
+    devices[device_count].addr = addr;
+    devices[device_count].name = name;
+    return device_count++;
+}
+
+uint8_t I2CBus_FindDevice(uint16_t addr) {
+    for (uint8_t i = 0; i < device_count; i++) {
+        if (devices[i].addr == addr) return i;
+    }
+    return I2C_BUS_NO_DEVICE;
+}
+
+// İşlem süresinin iki katı + pay, ms: adres, register, tekrar adres, veri byte'ları x 9 bit
+static uint32_t I2CBus_TimeoutMs(uint16_t len) {
+    uint32_t bits = ((uint32_t)len + 4U) * 9U;
+    return (2U * bits * 1000U + I2C_BUS_HZ - 1U) / I2C_BUS_HZ + I2C_BUS_TIMEOUT_PAD_MS;
+}
+
+// En yüksek öncelikli sınıfın en eskisini active'e alır (kritik bölgede)
+static uint8_t I2CBus_Pop(void) {
+    for (uint8_t p = 0; p < I2C_BUS_PRIORITIES; p++) {
+        if (queue_count[p] == 0U) continue;
+        active = queue[p][queue_head[p]];
+        queue_head[p] = (uint8_t)((queue_head[p] + 1U) & (I2C_BUS_QUEUE_DEPTH - 1U));
+        queue_count[p]--;
+
+        I2CBusDeviceStats_t *dev = &devices[active.xfer.device];
+        uint32_t wait = I2CBus_Now() - active.queued_at;
+        if (wait > dev->max_wait) dev->max_wait = wait;
+        active_valid = 1;
+        return 1;
+    }
+    return 0;
+}
+
+static HAL_StatusTypeDef I2CBus_Launch(void) {
+    const I2CBusXfer_t *x = &active.xfer;
+    uint16_t addr = devices[x->device].addr;
+
+    active_deadline = HAL_GetTick() + I2CBus_TimeoutMs(x->len);
+    stats.transfers++;
+    if (x->write) {
+        return HAL_I2C_Mem_Write_IT(bus_hi2c, addr, x->reg, I2C_MEMADD_SIZE_8BIT, active.wbuf, x->len);
+    }
+    if (x->len >= 2U) {
+        return HAL_I2C_Mem_Read_DMA(bus_hi2c, addr, x->reg, I2C_MEMADD_SIZE_8BIT, x->data, x->len);
+    }
+    return HAL_I2C_Mem_Read_IT(bus_hi2c, addr, x->reg, I2C_MEMADD_SIZE_8BIT, x->data, x->len);
+}
+
+// active'i bitirir, sahibinin callback'ini çağırır. Callback içinden gelen
+// Submit'ler yalnız kuyruğa girer; sıradaki işlemi çağıran başlatır.
+static void I2CBus_Finish(uint8_t status) {
+    I2CBusXfer_t x = active.xfer;
+    active_valid = 0;
+    if (status == I2C_BUS_OK) {
+        devices[x.device].completed++;
+    } else {
+        devices[x.device].errors++;
+    }
+    if (x.done != NULL) {
+        dispatching = 1;
+        x.done(status, x.ctx);
+        dispatching = 0;
+    }
+}
+
+static void I2CBus_GoOffline(uint8_t status) {
+    uint32_t now = HAL_GetTick();
+    bus_state = BUS_OFFLINE;
+    offline_since = now;
+    offline_until = now + backoff_ms;
+    backoff_ms = (2U * backoff_ms > I2C_BUS_BACKOFF_MAX_MS) ? I2C_BUS_BACKOFF_MAX_MS : 2U * backoff_ms;
+    fail_streak = 0;
+    stats.offline++;
+
+    if (active_valid) I2CBus_Finish(status);
+    // Bekleyenler çalıştırılmadan biter; callback'lerden gelen yeni istekler reddedilir
+    while (I2CBus_Pop()) {
+        I2CBus_Finish(I2C_BUS_ERR_OFFLINE);
+    }
+}
+
+// Bir deneme başarısız: tekrar hakkı varsa active korunur, yoksa biter.
+// recover: çevre birimi/hat kurtarılmadan yeni işlem başlatılmaz.
+static void I2CBus_AttemptFailed(uint8_t status, uint8_t recover) {
+    if (++fail_streak >= I2C_BUS_FAIL_LIMIT) {
+        I2CBus_GoOffline(status);
+        return;
+    }
+    bus_state = recover ? BUS_RECOVER : BUS_IDLE;
+    if (active.xfer.retries > 0U) {
+        active.xfer.retries--;
+        devices[active.xfer.device].retries++;
+    } else {
+        I2CBus_Finish(status);
+    }
+}
+
+// Hat boşsa sıradakini (önce tekrar bekleyen active) başlatır
+static void I2CBus_StartNext(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    while (bus_state == BUS_IDLE && !dispatching && (active_valid || I2CBus_Pop())) {
+        bus_state = BUS_ACTIVE;
+        if (I2CBus_Launch() == HAL_OK) break;
+        // Çevre birimi işlemi almadı (BUSY takılı): kurtarma Poll'da
+        stats.bus_errors++;
+        I2CBus_AttemptFailed(I2C_BUS_ERR_BUS, 1);
+    }
+    __set_PRIMASK(primask);
+}
+
+uint8_t I2CBus_Submit(const I2CBusXfer_t *xfer) {
+    if (xfer->device >= device_count) return 1;
+    I2CBusDeviceStats_t *dev = &devices[xfer->device];
+    if (xfer->priority >= I2C_BUS_PRIORITIES || xfer->len == 0U || xfer->retries > I2C_BUS_MAX_RETRIES ||
+        (xfer->write && xfer->len > I2C_BUS_WRITE_MAX)) {
+        dev->dropped++;
+        return 1;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t p = xfer->priority;
+    if (bus_hi2c == NULL || bus_state == BUS_OFFLINE || queue_count[p] >= I2C_BUS_QUEUE_DEPTH) {
+        dev->dropped++;
+        __set_PRIMASK(primask);
+        return 1;
+    }
+
+    I2CBusSlot_t *slot = &queue[p][(queue_head[p] + queue_count[p]) & (I2C_BUS_QUEUE_DEPTH - 1U)];
+    slot->xfer = *xfer;
+    if (xfer->write) memcpy(slot->wbuf, xfer->data, xfer->len);
+    slot->queued_at = I2CBus_Now();
+    queue_count[p]++;
+    dev->queued++;
+
+    uint32_t depth = 0;
+    for (uint8_t i = 0; i < I2C_BUS_PRIORITIES; i++) depth += queue_count[i];
+    if (depth > stats.max_depth) stats.max_depth = depth;
+
+    I2CBus_StartNext();
+    __set_PRIMASK(primask);
+    return 0;
+}
+
+static void I2CBus_Spin(void) {
+    for (volatile uint32_t i = 0; i < I2C_BUS_RECOVERY_SPIN; i++) {
+    }
+}
+
+// Çevre birimini kapatıp SCL'yi elle saatler: yarım byte'ta kalmış bir köle
+// SDA'yı bırakır. Süre sınırlı: en çok I2C_BUS_RECOVERY_CLOCKS darbe + STOP.
+// HAL_I2C_Init, F1'in takılı BUSY bayrağını da SWRST ile temizler.
+static uint8_t I2CBus_Recover(void) {
+    GPIO_InitTypeDef gpio = {0};
+
+    HAL_I2C_DeInit(bus_hi2c);
+    HAL_GPIO_WritePin(I2C_BUS_GPIO_PORT, I2C_BUS_SCL_PIN | I2C_BUS_SDA_PIN, GPIO_PIN_SET);
+    gpio.Pin = I2C_BUS_SCL_PIN | I2C_BUS_SDA_PIN;
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(I2C_BUS_GPIO_PORT, &gpio);
+
+    for (uint32_t i = 0; i < I2C_BUS_RECOVERY_CLOCKS &&
+                         HAL_GPIO_ReadPin(I2C_BUS_GPIO_PORT, I2C_BUS_SDA_PIN) == GPIO_PIN_RESET; i++) {
+        HAL_GPIO_WritePin(I2C_BUS_GPIO_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_RESET);
+        I2CBus_Spin();
+        HAL_GPIO_WritePin(I2C_BUS_GPIO_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_SET);
+        I2CBus_Spin();
+    }
+    // STOP: SCL yüksekken SDA düşükten yükseğe
+    HAL_GPIO_WritePin(I2C_BUS_GPIO_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_RESET);
+    I2CBus_Spin();
+    HAL_GPIO_WritePin(I2C_BUS_GPIO_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_SET);
+    I2CBus_Spin();
+
+    uint8_t released = HAL_GPIO_ReadPin(I2C_BUS_GPIO_PORT, I2C_BUS_SDA_PIN) == GPIO_PIN_SET;
+    stats.recoveries++;
+    return (HAL_I2C_Init(bus_hi2c) == HAL_OK && released) ? 0U : 1U;
+}
+
+void I2CBus_Poll(void) {
+    if (bus_hi2c == NULL) return;
+    uint32_t now = HAL_GetTick();
+
+    // Hata yolları callback çağırır: sahipler kesme bağlamındaki gibi kesilmeden çalışsın
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (bus_state == BUS_ACTIVE && (int32_t)(now - active_deadline) > 0) {
+        // Geç gelen bitiş kesmesi artık BUS_ACTIVE görmez, yok sayılır
+        stats.timeouts++;
+        I2CBus_AttemptFailed(I2C_BUS_ERR_TIMEOUT, 1);
+    }
+    if (bus_state == BUS_OFFLINE && (int32_t)(now - offline_until) >= 0) {
+        stats.offline_ms += now - offline_since;
+        bus_state = BUS_RECOVER;
+    }
+    __set_PRIMASK(primask);
+
+    // RECOVER'da hattı kimse kullanmaz (Submit yalnız kuyruğa atar), kesmeler açık
+    if (bus_state == BUS_RECOVER) {
+        if (I2CBus_Recover() == 0U) {
+            bus_state = BUS_IDLE;
+        } else {
+            primask = __get_PRIMASK();
+            __disable_irq();
+            if (++fail_streak >= I2C_BUS_FAIL_LIMIT) I2CBus_GoOffline(I2C_BUS_ERR_BUS);
+            __set_PRIMASK(primask);
+        }
+    }
+    I2CBus_StartNext();
+}
+
+void I2CBus_RxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c != bus_hi2c || bus_state != BUS_ACTIVE) return;
+    PROFILE_BEGIN(PROF_I2C_BUS);
+    fail_streak = 0;
+    backoff_ms = I2C_BUS_BACKOFF_MS;
+    bus_state = BUS_IDLE;
+    I2CBus_Finish(I2C_BUS_OK);
+    I2CBus_StartNext();
+    PROFILE_END(PROF_I2C_BUS);
+}
+
+void I2CBus_TxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    I2CBus_RxCpltCallback(hi2c);
+}
+
+void I2CBus_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    if (hi2c != bus_hi2c || bus_state != BUS_ACTIVE) return;
+    PROFILE_BEGIN(PROF_I2C_BUS);
+    if (HAL_I2C_GetError(hi2c) == HAL_I2C_ERROR_AF) {
+        // Adres/veri NACK: HAL STOP üretti, hat sağlam
+        stats.nacks++;
+        I2CBus_AttemptFailed(I2C_BUS_ERR_NACK, 0);
+    } else {
+        stats.bus_errors++;
+        I2CBus_AttemptFailed(I2C_BUS_ERR_BUS, 1);
+    }
+    I2CBus_StartNext();
+    PROFILE_END(PROF_I2C_BUS);
+}
+
+uint8_t I2CBus_DeviceCount(void) {
+    return device_count;
+}
+
+void I2CBus_GetDeviceStats(uint8_t device, I2CBusDeviceStats_t *out) {
+    if (device < device_count) *out = devices[device];
+}
+
+void I2CBus_GetStats(I2CBusStats_t *out) {
+    *out = stats;
+}
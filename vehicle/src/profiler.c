@@ -0,0 +1,216 @@
+// profiler.c
+#include "profiler.h"
+#include "fw_state.h"
+
+#ifdef PROFILER_ENABLE
+
+#include "stm32f1xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef PROFILER_HOST_CLOCK
+#include <time.h>
+#else
+// Linker betiği (STM32F103 CubeMX .ld): yığın tepesi ve ayrılan yığın boyu
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+#endif
+
+static const char *const probe_names[PROFILER_PROBES] = {
+    "IC_Capture", "SoftwareEdge", "CalcPosVel", "IMU_DMA", "IMU_INT", "Fusion_Imu", "Brake_Update", "Analog_DMA",
+    "EventLog_Imu", "ImuFilter", "I2cBus", "SharedWrite",
+};
+
+typedef struct {
+    uint8_t id;
+    uint32_t start;
+    uint32_t nested;   // Bu probe açıkken biten iç probeların toplam süresi
+} ProfilerFrame_t;
+
+FW_STATE ProfilerProbe_t probes[PROFILER_PROBES];
+FW_STATE uint32_t budgets[PROFILER_PROBES];   // Döngü, 0: bütçe yok
+FW_STATE ProfilerFrame_t open_frames[PROFILER_MAX_DEPTH];
+FW_STATE uint8_t depth = 0;
+FW_STATE uint32_t unbalanced = 0;   // Begin'i olmayan ya da sırası bozuk End
+
+#ifdef PROFILER_HOST_CLOCK
+FW_STATE uintptr_t stack_top = 0;
+FW_STATE uintptr_t stack_lowest = 0;
+
+static uint32_t Profiler_Cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return (uint32_t)(ns * (PROFILER_CLOCK_HZ / 1000000U) / 1000U);
+}
+
+// Host'ta yığın boyanamaz: probe anındaki yığın derinliği örneklenir
+static void Profiler_SampleStack(void) {
+    uint8_t marker;
+    uintptr_t sp = (uintptr_t)&marker;
+    if (stack_lowest == 0 || sp < stack_lowest) stack_lowest = sp;
+}
+#else
+static uint32_t Profiler_Cycles(void) {
+    return DWT->CYCCNT;
+}
+
+#define Profiler_SampleStack()   ((void)0)
+#endif
+
+static uint8_t Profiler_Bucket(uint32_t cycles) {
+    // CLZ tek komut: log2
+    uint32_t k = 31U - (uint32_t)__builtin_clz(cycles | 1U);
+    return (k >= PROFILER_HIST_BUCKETS) ? (uint8_t)(PROFILER_HIST_BUCKETS - 1U) : (uint8_t)k;
+}
+
+void Profiler_Reset(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(probes, 0, sizeof(probes));
+    unbalanced = 0;
+    __set_PRIMASK(primask);
+}
+
+void Profiler_Init(void) {
+#ifdef PROFILER_HOST_CLOCK
+    uint8_t marker;
+    stack_top = (uintptr_t)&marker;
+    stack_lowest = stack_top;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Yığının henüz kullanılmayan kısmını desenle doldur (şimdiki SP'nin
+    // 64 byte altına kadar: bu fonksiyonun kendi çerçevesi bozulmasın)
+    uint32_t *p = (uint32_t *)((uint32_t)&_estack - (uint32_t)&_Min_Stack_Size);
+    uint32_t *sp = (uint32_t *)(__get_MSP() - 64U);
+    while (p < sp) {
+        *p++ = PROFILER_STACK_PAINT;
+    }
+#endif
+    depth = 0;
+    budgets[PROF_SHARED_WRITE] = PROFILER_SHARED_WRITE_BUDGET;
+    Profiler_Reset();
+}
+
+void Profiler_Begin(uint8_t id) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (depth < PROFILER_MAX_DEPTH) {
+        open_frames[depth].id = id;
+        open_frames[depth].nested = 0;
+        open_frames[depth].start = Profiler_Cycles();
+    }
+    depth++;   // Derinlik aşılsa da sayılır: End'ler dengeli kalsın
+    Profiler_SampleStack();
+    __set_PRIMASK(primask);
+}
+
+void Profiler_End(uint8_t id) {
+    uint32_t now = Profiler_Cycles();
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (depth == 0) {
+        unbalanced++;
+        __set_PRIMASK(primask);
+        return;
+    }
+    depth--;
+
+    if (depth < PROFILER_MAX_DEPTH && id < PROFILER_PROBES && open_frames[depth].id == id) {
+        uint32_t dt = now - open_frames[depth].start;
+        uint32_t nested = open_frames[depth].nested;
+        ProfilerProbe_t *p = &probes[id];
+
+        if (p->count == 0 || dt < p->min) p->min = dt;
+        if (dt > p->max) p->max = dt;
+        p->total += dt;
+        p->count++;
+        p->hist[Profiler_Bucket(dt)]++;
+        if (nested > 0) {
+            p->preempted++;
+            if (nested > p->max_preempt) p->max_preempt = nested;
+        }
+        if (budgets[id] != 0U && dt - nested > budgets[id]) p->over_budget++;
+
+        // Dıştaki probe bu süre boyunca kesilmiş oldu
+        if (depth > 0 && depth <= PROFILER_MAX_DEPTH) {
+            open_frames[depth - 1U].nested += dt;
+        }
+    } else if (depth < PROFILER_MAX_DEPTH) {
+        unbalanced++;
+    }
+    __set_PRIMASK(primask);
+}
+
+void Profiler_SetBudget(uint8_t id, uint32_t cycles) {
+    if (id < PROFILER_PROBES) budgets[id] = cycles;
+}
+
+uint8_t Profiler_GetProbe(uint8_t id, ProfilerProbe_t *out) {
+    if (id >= PROFILER_PROBES) return 0;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *out = probes[id];
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+uint32_t Profiler_StackHighWater(void) {
+#ifdef PROFILER_HOST_CLOCK
+    return (uint32_t)(stack_top - stack_lowest);
+#else
+    // Desenin bozulduğu en derin kelimeyi alttan yukarı ara
+    const uint32_t *bottom = (const uint32_t *)((uint32_t)&_estack - (uint32_t)&_Min_Stack_Size);
+    const uint32_t *p = bottom;
+    while (p < &_estack && *p == PROFILER_STACK_PAINT) {
+        p++;
+    }
+    return (uint32_t)&_estack - (uint32_t)p;
+#endif
+}
+
+void Profiler_Dump(void) {
+    const uint32_t per_us = PROFILER_CLOCK_HZ / 1000000U;
+
+    printf("\n--- PROFİL (%lu MHz döngü) ---\n", PROFILER_CLOCK_HZ / 1000000U);
+    for (uint8_t i = 0; i < PROFILER_PROBES; i++) {
+        ProfilerProbe_t p;
+        Profiler_GetProbe(i, &p);
+        if (p.count == 0) {
+            printf("%-14s -\n", probe_names[i]);
+            continue;
+        }
+        uint32_t mean = (uint32_t)(p.total / p.count);
+        printf("%-14s n=%-8lu min %6lu ort %6lu maks %7lu döngü (maks %lu us) | kesilen %lu, en çok +%lu döngü\n",
+               probe_names[i], p.count, p.min, mean, p.max, p.max / per_us, p.preempted, p.max_preempt);
+        if (budgets[i] != 0U) {
+            printf("  bütçe %lu döngü: aşan %lu%s\n", budgets[i], p.over_budget,
+                   p.over_budget > 0U ? "  <-- BÜTÇE AŞILDI" : "");
+        }
+
+        printf("  log2:");
+        for (uint8_t k = 0; k < PROFILER_HIST_BUCKETS; k++) {
+            if (p.hist[k] == 0) continue;
+            if (k == PROFILER_HIST_BUCKETS - 1U) {
+                printf(" >=%lu:%lu", 1UL << k, p.hist[k]);
+            } else {
+                printf(" <%lu:%lu", 1UL << (k + 1U), p.hist[k]);
+            }
+        }
+        printf("\n");
+    }
+#ifdef PROFILER_HOST_CLOCK
+    printf("Yığın: probelarda görülen en derin %lu byte | dengesiz probe %lu\n",
+           Profiler_StackHighWater(), unbalanced);
+#else
+    printf("Yığın: en yüksek kullanım %lu / %lu byte | dengesiz probe %lu\n",
+           Profiler_StackHighWater(), (uint32_t)&_Min_Stack_Size, unbalanced);
+#endif
+    printf("-----------------------------\n");
+}
+
+#endif
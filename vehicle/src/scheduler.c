@@ -0,0 +1,189 @@
+// scheduler.c
+#include "scheduler.h"
+#include "fw_state.h"
+#include "stm32f1xx_hal.h"
+#include <stddef.h>
+#include <stdio.h>
+
+FW_STATE const SchedulerTask_t *sched_tasks = NULL;
+FW_STATE uint8_t sched_count = 0;
+FW_STATE uint32_t (*sched_clock)(void) = NULL;
+
+FW_STATE uint32_t next_release[SCHEDULER_MAX_TASKS];
+FW_STATE SchedulerTaskStats_t task_stats[SCHEDULER_MAX_TASKS];
+FW_STATE SchedulerStats_t stats;
+FW_STATE uint32_t sched_tick = 0;   // Son işlenen tick
+FW_STATE uint32_t sched_last_clock = 0;
+
+FW_STATE volatile uint32_t sched_events = 0;              // Bekleyen olaylar (bit n-1: olay n)
+FW_STATE uint32_t post_time[SCHEDULER_MAX_EVENTS];        // İlk gönderilişin saati
+
+static void Scheduler_Run(uint8_t i) {
+    uint32_t t0 = sched_clock();
+    sched_tasks[i].run();
+    uint32_t dt = sched_clock() - t0;
+
+    task_stats[i].runs++;
+    task_stats[i].last = dt;
+    if (dt > task_stats[i].wcet) task_stats[i].wcet = dt;
+}
+
+void Scheduler_Init(const SchedulerTask_t *tasks, uint8_t count, uint32_t (*clock)(void)) {
+    if (count > SCHEDULER_MAX_TASKS) count = SCHEDULER_MAX_TASKS;
+    sched_tasks = tasks;
+    sched_count = count;
+    sched_clock = clock;
+    stats = (SchedulerStats_t){0};
+    sched_events = 0;
+    sched_last_clock = clock();
+
+    // İlk salınımlar bir sonraki tick'ten itibaren
+    sched_tick = HAL_GetTick();
+    for (uint8_t i = 0; i < count; i++) {
+        next_release[i] = sched_tick + 1U + tasks[i].offset_ms;
+        task_stats[i] = (SchedulerTaskStats_t){0};
+    }
+}
+
+void Scheduler_Post(uint8_t event) {
+    if (event == SCHEDULER_NO_EVENT || event > SCHEDULER_MAX_EVENTS) return;
+    uint32_t bit = 1UL << (event - 1U);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!(sched_events & bit)) {
+        post_time[event - 1U] = sched_clock();
+        sched_events |= bit;
+    }
+    __set_PRIMASK(primask);
+}
+
+uint32_t Scheduler_PendingEvents(void) {
+    return sched_events;
+}
+
+// Yeni tick ve bekleyen olay yoksa bir sonraki kesmeye kadar uyu. Kontrol
+// ile WFI arasında gelen kesme kaçmasın diye kesmeler kapalıyken uyunur:
+// bekleyen kesme WFI'dan yine uyandırır, işleyicisi __enable_irq'da çalışır.
+static void Scheduler_Sleep(void) {
+#if SCHEDULER_SLEEP
+    __disable_irq();
+    if (sched_events == 0U && HAL_GetTick() == sched_tick) {
+        uint32_t t0 = sched_clock();
+        __WFI();
+        stats.idle += sched_clock() - t0;
+        stats.wakeups++;
+    }
+    __enable_irq();
+#endif
+}
+
+// Olay görevleri: gönderilen olay başına bir kez, tablo sırasıyla
+static void Scheduler_RunEvents(void) {
+    uint32_t posted[SCHEDULER_MAX_EVENTS];
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t pending = sched_events;
+    sched_events = 0;
+    for (uint8_t e = 0; e < SCHEDULER_MAX_EVENTS; e++) {
+        posted[e] = post_time[e];
+    }
+    __set_PRIMASK(primask);
+    if (pending == 0U) return;
+
+    for (uint8_t e = 0; e < SCHEDULER_MAX_EVENTS; e++) {
+        if (pending & (1UL << e)) stats.events++;
+    }
+    for (uint8_t i = 0; i < sched_count; i++) {
+        uint8_t event = sched_tasks[i].event;
+        if (sched_tasks[i].period_ms != 0 || event == SCHEDULER_NO_EVENT || event > SCHEDULER_MAX_EVENTS) continue;
+        if (!(pending & (1UL << (event - 1U)))) continue;
+
+        uint32_t latency = sched_clock() - posted[event - 1U];
+        task_stats[i].latency_sum += latency;
+        if (latency > task_stats[i].max_latency) task_stats[i].max_latency = latency;
+        Scheduler_Run(i);
+    }
+}
+
+void Scheduler_Dispatch(void) {
+    Scheduler_Sleep();
+
+    // 1. Olaylar tick'ten önce: 1 kHz görevi kesmenin kuyruğa attığını görür
+    Scheduler_RunEvents();
+
+    // 2. Yeni tick. Arka plan görevi uzun sürdüyse arada tick'ler görülmemiş olabilir.
+    uint32_t now = HAL_GetTick();
+    if (now != sched_tick) {
+        if (now - sched_tick > 1U) stats.missed_ticks += now - sched_tick - 1U;
+        sched_tick = now;
+        stats.ticks++;
+
+        uint32_t frame_start = sched_clock();
+        for (uint8_t i = 0; i < sched_count; i++) {
+            uint32_t period = sched_tasks[i].period_ms;
+            if (period == 0) continue;
+
+            int32_t late = (int32_t)(now - next_release[i]);
+            if (late < 0) continue;
+
+            // Gecikmeyle kaçırılan salınımlar telafi edilmez: atlanır ve sayılır
+            uint32_t skipped = (uint32_t)late / period;
+            task_stats[i].overruns += skipped;
+            next_release[i] += (skipped + 1U) * period;
+            if ((uint32_t)late > task_stats[i].max_lateness) task_stats[i].max_lateness = (uint32_t)late;
+
+            Scheduler_Run(i);
+        }
+
+        uint32_t frame = sched_clock() - frame_start;
+        if (frame > stats.max_frame) stats.max_frame = frame;
+        if (HAL_GetTick() != now) stats.frame_overruns++;
+    }
+
+    // 3. Arka plan: uyanış başına bir tur
+    for (uint8_t i = 0; i < sched_count; i++) {
+        if (sched_tasks[i].period_ms == 0 && sched_tasks[i].event == SCHEDULER_NO_EVENT) Scheduler_Run(i);
+    }
+    stats.background_runs++;
+
+    uint32_t clock = sched_clock();
+    stats.elapsed += clock - sched_last_clock;
+    sched_last_clock = clock;
+}
+
+void Scheduler_GetStats(SchedulerStats_t *out) {
+    *out = stats;
+}
+
+uint8_t Scheduler_GetTaskStats(uint8_t index, SchedulerTaskStats_t *out) {
+    if (index >= sched_count) return 0;
+    *out = task_stats[index];
+    return 1;
+}
+
+void Scheduler_Print(void) {
+    const uint32_t per_us = SCHEDULER_CLOCK_HZ / 1000000U;
+
+    printf("\n--- ZAMANLAYICI ---\n");
+    printf("Tick: %lu | görülmeyen %lu | çerçeve taşması %lu | en uzun çerçeve %lu us | arka plan %lu\n",
+           stats.ticks, stats.missed_ticks, stats.frame_overruns, stats.max_frame / per_us,
+           stats.background_runs);
+    uint32_t idle_permille = stats.elapsed ? (uint32_t)(stats.idle * 1000U / stats.elapsed) : 0U;
+    printf("Uyku: %lu uyanış | olay %lu | boşta %%%lu.%lu\n", stats.wakeups, stats.events,
+           idle_permille / 10U, idle_permille % 10U);
+    for (uint8_t i = 0; i < sched_count; i++) {
+        const SchedulerTaskStats_t *s = &task_stats[i];
+        if (sched_tasks[i].period_ms == 0 && sched_tasks[i].event != SCHEDULER_NO_EVENT) {
+            printf("%-12s olay %u | çalışma %8lu | WCET %6lu us | uyanıştan başlamaya ort %lu us, maks %lu us\n",
+                   sched_tasks[i].name, sched_tasks[i].event, s->runs, s->wcet / per_us,
+                   (unsigned long)(s->runs ? s->latency_sum / s->runs / per_us : 0U), s->max_latency / per_us);
+            continue;
+        }
+        printf("%-12s %4u ms | çalışma %8lu | WCET %6lu us | son %6lu us | atlanan %lu | en geç %lu ms\n",
+               sched_tasks[i].name, sched_tasks[i].period_ms, s->runs, s->wcet / per_us,
+               s->last / per_us, s->overruns, s->max_lateness);
+    }
+    printf("-------------------\n");
+}
@@ -1 +1,192 @@
+// encoder.c
+#include "encoder.h"
+#include "fw_state.h"
+#include "shared_data.h"
 
+FW_STATE TIM_HandleTypeDef *enc_htim = NULL;
+FW_STATE TIM_HandleTypeDef *edge_htim = NULL;
+FW_STATE volatile int32_t enc_wraps = 0;   // 16-bit sayacın üst kısmı (işaretli)
+
+// Hesap durumu
+FW_STATE int64_t count_now = 0;       // 64-bit sayım (son örnek)
+FW_STATE int64_t ref_count = 0;       // M/T penceresinin başındaki kenar
+FW_STATE uint32_t ref_time = 0;
+FW_STATE uint32_t last_edge_time = 0; // Son görülen A kenarı
+FW_STATE uint16_t last_edge_raw = 0;  // TIM2 CCR2'nin son okunan değeri
+FW_STATE uint8_t have_ref = 0;
+FW_STATE uint8_t have_sample = 0;
+FW_STATE q16_t velocity = 0;
+FW_STATE uint8_t publish_div = 0;
+FW_STATE int64_t still_count = 0;     // Duruş tespitinin dayanak sayımı
+FW_STATE uint32_t still_since = 0;    // Sayımın dayanak etrafında kaldığı ilk an
+FW_STATE uint32_t sample_time = 0;    // Son örnek anı
+FW_STATE EncoderStats_t stats;
+
+void Encoder_Reset(void) {
+    count_now = 0;
+    ref_count = 0;
+    ref_time = 0;
+    last_edge_time = 0;
+    last_edge_raw = 0;
+    have_ref = 0;
+    have_sample = 0;
+    velocity = 0;
+    publish_div = 0;
+    still_count = 0;
+    still_since = 0;
+    sample_time = 0;
+    stats = (EncoderStats_t){0};
+}
+
+void Encoder_Init(TIM_HandleTypeDef *enc, TIM_HandleTypeDef *ic) {
+    enc_htim = enc;
+    edge_htim = ic;
+    enc_wraps = 0;
+    Encoder_Reset();
+
+    // Kenar zamanı: kesmesiz yakalama, CCR2 son kenarda kalır
+    TIM_IC_InitTypeDef sConfigIC = {0};
+    sConfigIC.ICPolarity = TIM_ICPOLARITY_RISING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+    sConfigIC.ICFilter = 0;
+    HAL_TIM_IC_ConfigChannel(ic, &sConfigIC, ENCODER_EDGE_CHANNEL);
+    HAL_TIM_IC_Start(ic, ENCODER_EDGE_CHANNEL);
+
+    // Enkoder: CC1/CC2 açılınca CCR1 TI1 kenarındaki sayımı tutar
+    __HAL_TIM_CLEAR_FLAG(enc, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(enc, TIM_IT_UPDATE);
+    HAL_TIM_Encoder_Start(enc, TIM_CHANNEL_ALL);
+}
+
+void Encoder_OverflowCallback(TIM_HandleTypeDef *htim) {
+    if (htim != enc_htim) return;
+    if (__HAL_TIM_IS_TIM_COUNTING_DOWN(htim)) {
+        enc_wraps--;
+    } else {
+        enc_wraps++;
+    }
+}
+
+void Encoder_Update(uint32_t now) {
+    if (enc_htim == NULL) return;
+
+    EncoderRaw_t raw;
+    uint16_t check;
+
+    // Taşma kesmesi ya da yeni kenar okuma arasına girerse tekrar oku
+    do {
+        raw.wraps = enc_wraps;
+        raw.count = (uint16_t)__HAL_TIM_GET_COUNTER(enc_htim);
+        raw.edge_count = (uint16_t)HAL_TIM_ReadCapturedValue(enc_htim, ENCODER_COUNT_CHANNEL);
+        raw.edge_time = (uint16_t)HAL_TIM_ReadCapturedValue(edge_htim, ENCODER_EDGE_CHANNEL);
+        check = (uint16_t)__HAL_TIM_GET_COUNTER(enc_htim);
+    } while (raw.wraps != enc_wraps || check != raw.count);
+
+    // Taşma bekliyor ama henüz sayılmadı: sayaç sınırı yeni geçti
+    if (__HAL_TIM_GET_FLAG(enc_htim, TIM_FLAG_UPDATE)) {
+        if (__HAL_TIM_IS_TIM_COUNTING_DOWN(enc_htim)) {
+            if (raw.count > 0x8000U) raw.wraps--;
+        } else if (raw.count < 0x8000U) {
+            raw.wraps++;
+        }
+    }
+
+    raw.now = now;
+    Encoder_Sample(&raw);
+}
+
+// Sayım farkı / süre -> m/s (Q16)
+static q16_t Encoder_Velocity(int64_t counts, uint32_t ticks) {
+    int64_t v = (counts * ENCODER_WHEEL_CIRC * (int64_t)ENCODER_TICK_HZ) / ((int64_t)ENCODER_CPR * ticks);
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < -INT32_MAX) return -INT32_MAX;
+    return (q16_t)v;
+}
+
+void Encoder_Sample(const EncoderRaw_t *raw) {
+    // 1. Sayımı 64 bit'e genişlet. Yakalama register'ı değiştiyse son
+    //    örnekten beri (< 8.2 ms) yeni kenar var: kenar sayımı ve zamanı
+    //    şimdiye göre genişletilir. Değişmediyse eski kenar geçerli.
+    int64_t count = (int64_t)raw->wraps * 65536 + raw->count;
+
+    if (have_sample) {
+        int64_t step = count - count_now;
+        uint32_t step_abs = (uint32_t)((step < 0) ? -step : step);
+        if (step_abs > stats.max_step) stats.max_step = step_abs;
+    } else {
+        // Başlangıçta yakalama register'ındaki değer eski olabilir; kenar sayılmaz
+        last_edge_raw = raw->edge_time;
+    }
+    uint8_t new_edge = raw->edge_time != last_edge_raw;
+    last_edge_raw = raw->edge_time;
+    if (!have_sample || count > still_count + ENCODER_STILL_COUNTS || count < still_count - ENCODER_STILL_COUNTS) {
+        still_count = count;
+        still_since = raw->now;
+    }
+    sample_time = raw->now;
+    count_now = count;
+    have_sample = 1;
+    stats.samples++;
+
+    // 2. M/T: pencere en az ENCODER_MT_WINDOW ve iki ucu da kenar
+    if (new_edge) {
+        int64_t edge_count = count - (int16_t)(raw->count - raw->edge_count);
+        uint32_t edge_time = raw->now - (uint16_t)((uint16_t)raw->now - raw->edge_time);
+        last_edge_time = edge_time;
+        if (!have_ref) {
+            ref_count = edge_count;
+            ref_time = edge_time;
+            have_ref = 1;
+        } else if (edge_time - ref_time >= ENCODER_MT_WINDOW) {
+            velocity = Encoder_Velocity(edge_count - ref_count, edge_time - ref_time);
+            ref_count = edge_count;
+            ref_time = edge_time;
+            stats.mt_updates++;
+        }
+    }
+
+    // 3. Kenar gecikiyorsa hız en fazla "bir kenar / geçen süre" olabilir
+    uint32_t since = raw->now - last_edge_time;
+    if (have_ref && since >= ENCODER_STOP_TICKS) {
+        velocity = 0;
+        have_ref = 0;
+        stats.stops++;
+    } else if (have_ref && since > 0) {
+        q16_t bound = Encoder_Velocity(ENCODER_COUNTS_PER_EDGE, since);
+        if (velocity > bound) {
+            velocity = bound;
+            stats.bounded++;
+        } else if (velocity < -bound) {
+            velocity = -bound;
+            stats.bounded++;
+        }
+    }
+
+    // 4. Sabit hızda yayınla
+    if (++publish_div >= ENCODER_PUBLISH_DIV) {
+        publish_div = 0;
+        q16_t distance, v;
+        Encoder_Get(&distance, &v);
+
+        uint32_t key = SharedData_WriteBegin();
+        VehicleState.encoder_distance = distance;
+        VehicleState.encoder_velocity = v;
+        VehicleState.encoder_time = raw->now;
+        SharedData_WriteEnd(key);
+    }
+}
+
+uint8_t Encoder_IsStill(void) {
+    return have_sample && sample_time - still_since >= ENCODER_STILL_TICKS;
+}
+
+void Encoder_Get(q16_t *distance, q16_t *v) {
+    int64_t d = (count_now * ENCODER_WHEEL_CIRC) / (int64_t)ENCODER_CPR;
+    *distance = (d > INT32_MAX) ? INT32_MAX : (d < -INT32_MAX) ? -INT32_MAX : (q16_t)d;
+    *v = velocity;
+}
+
+void Encoder_GetStats(EncoderStats_t *out) {
+    *out = stats;
+}
@@ -3,102 +3,522 @@
  
 
 #include "sensors/imu.h"
+#include "fw_state.h"
+#include "sensors/imu_filter.h"
 #include "shared_data.h"
+#include "profiler.h"
+#include "i2c_bus.h"
 
 // --- Global Değişkenler ---
-static I2C_HandleTypeDef *mpu_i2c;      // I2C handler'ı globalde tutuyoruz
-static uint8_t dma_rx_buffer[14];       // DMA'nın veriyi dolduracağı ham buffer
-static volatile uint8_t dma_busy = 0;   // Çakışmayı önlemek için bayrak
+FW_STATE uint8_t mpu_dev = I2C_BUS_NO_DEVICE;    // I2CBus cihaz kimliği
+FW_STATE volatile uint8_t mpu_state = MPU6050_STATE_OFF;
+FW_STATE uint8_t who_am_i;
+FW_STATE uint8_t dma_rx_buffer[14];       // DMA'nın veriyi dolduracağı ham buffer
+FW_STATE volatile uint8_t read_pending = 0;   // Okuma kuyrukta / hatta: yenisi eklenmez
+FW_STATE volatile uint8_t seq_failed = 0;     // Yazma dizisinde hata (son adım değerlendirir)
+
+// --- FIFO modu ---
+#define FIFO_PHASE_IDLE      0
+#define FIFO_PHASE_COUNT     1   // FIFO_COUNTH/L okunuyor
+#define FIFO_PHASE_DATA      2   // FIFO_R_W burst okunuyor
+
+#define FIFO_RESYNC_REQUEST  1   // Ana döngü sıfırlama dizisini kuyruğa atar
+#define FIFO_RESYNC_BUSY     2   // Sıfırlama yazmaları kuyrukta
+
+#define FIFO_BUF_FREE        0
+#define FIFO_BUF_FILLING     1
+#define FIFO_BUF_READY       2
+
+FW_STATE volatile uint8_t fifo_mode = 0;
+FW_STATE volatile uint8_t fifo_phase = FIFO_PHASE_IDLE;
+FW_STATE volatile uint8_t fifo_resync = 0;          // FIFO_RESYNC_*: sıfırlama isteği / sürüyor
+FW_STATE uint8_t fifo_requested = 0;                // Kurulum bitmeden FIFO_Start çağrıldı
+FW_STATE uint8_t fifo_count_raw[2];
+FW_STATE uint8_t fifo_buf[2][MPU6050_FIFO_BATCH * MPU6050_SAMPLE_SIZE]; // Ping-pong
+FW_STATE volatile uint8_t fifo_buf_state[2];
+FW_STATE uint32_t fifo_buf_seq[2];                  // Tampondaki ilk örneğin FIFO sırası
+FW_STATE uint8_t fifo_buf_n[2];
+FW_STATE uint8_t fifo_fill_idx = 0;                 // ISR'nin dolduracağı tampon
+FW_STATE uint8_t fifo_proc_idx = 0;                 // Ana döngünün işleyeceği tampon
+FW_STATE volatile uint32_t fifo_dr_count = 0;       // DATA_RDY kesme sayısı
+FW_STATE uint32_t fifo_dr_ts[MPU6050_TS_HISTORY];   // INT zaman damgaları (dr_count mod N)
+FW_STATE uint32_t fifo_dr_at_count = 0;             // FIFO_COUNT okuması başındaki dr_count
+FW_STATE uint32_t fifo_dr_at_burst = 0;             // Son burst başlangıcındaki dr_count
+FW_STATE uint32_t fifo_read_seq = 0;                // Reset'ten beri FIFO'dan istenen örnek
+FW_STATE uint32_t fifo_backlog = 0;                 // Son sayımda okunamayıp FIFO'da kalan
+FW_STATE uint32_t fifo_dr_base = 0;                 // FIFO sırası -> dr numarası farkı
+FW_STATE uint32_t fifo_dr_epoch = 0;                // Sıfırlama callback'indeki dr_count
+FW_STATE uint8_t fifo_epoch_valid = 0;              // İlk sıfırlama bitti (öncesi kayıp sayılmaz)
+FW_STATE uint8_t fifo_base_valid = 0;
+FW_STATE MPU6050_FifoStats_t fifo_stats;
+
+typedef struct {
+    uint8_t reg;
+    uint8_t value;
+} MPU6050_RegWrite_t;
+
+static uint8_t MPU6050_FIFO_QueueReset(void);
+static void MPU6050_Convert(const uint8_t *raw, int16_t *counts, IMU_Data_t *out);
+static void MPU6050_Publish(const IMU_Data_t *raw, const int16_t *counts, uint32_t raw_time,
+                            const IMU_Data_t *filtered, uint32_t filtered_time);
+
+_Static_assert(sizeof(VehicleState.imu_raw_counts) == MPU6050_RAW_AXES * sizeof(int16_t),
+               "imu_raw_counts register sırasındaki tüm eksenleri tutmalı");
 
 // --- Ölçeklendirme Faktörleri (Scale Factors) ---
-// MPU6050 Datasheet'e göre:
-// ±2g  -> 16384 LSB/g
-// ±4g  -> 8192  LSB/g
-// ±8g  -> 4096  LSB/g  <-- Hyperloop için seçtiğimiz
-// ±16g -> 2048  LSB/g
-static const float ACCEL_SCALE = 4096.0f; 
+// Bölme yerine derleme zamanında hesaplanan Q16 çarpanlar kullanılır
+// (FPU yok; her örnekte 7 yazılım float bölmesi yerine tamsayı çarpma).
+// İvme hassasiyeti 2'nin kuvveti: 2^(14 - AFS_SEL) LSB/g -> Q16 için sola kaydırma
+#define ACCEL_Q16_MUL        (1 << (2 + MPU6050_ACCEL_FS_SEL))
+// Jiroskop: Q16(1/LSB) * 2^16 -> q16_mul_int ile ham * (1/LSB)
+#define GYRO_RECIP_Q32       ((int32_t)(4294967296.0 / MPU6050_GYRO_LSB_PER_DPS + 0.5))
+#define TEMP_RECIP_Q32       ((int32_t)(4294967296.0 / MPU6050_TEMP_LSB_PER_C + 0.5))
+#define TEMP_OFFSET_Q16      Q16_FROM_FLOAT(MPU6050_TEMP_OFFSET_C)
+
+// Register yazmalarını sırayla kuyruğa atar (aynı öncelik sınıfında sıra
+// korunur). Ara adımların hatası seq_failed'e yazılır, son adımın callback'i
+// dizinin sonucunu değerlendirir.
+static void MPU6050_SeqStepDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    if (status != I2C_BUS_OK) seq_failed = 1;
+}
 
-// ±250dps -> 131.0 LSB/dps
-static const float GYRO_SCALE  = 131.0f;
+static uint8_t MPU6050_WriteSeq(const MPU6050_RegWrite_t *seq, uint32_t n, I2CBusDone_t last_done) {
+    seq_failed = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint8_t value = seq[i].value;   // Kuyruk yazma verisini kopyalar
+        I2CBusXfer_t x = {
+            .device = mpu_dev, .priority = I2C_BUS_PRIO_NORMAL, .write = 1, .retries = 3,
+            .reg = seq[i].reg, .len = 1, .data = &value,
+            .done = (i + 1U == n) ? last_done : MPU6050_SeqStepDone,
+        };
+        if (I2CBus_Submit(&x) != 0) {
+            // Kuyruğa girenler bitince son adım gelmeyecek: sonucu çağıran bildirir
+            seq_failed = 1;
+            return 1;
+        }
+    }
+    return 0;
+}
 
-uint8_t MPU6050_Init(I2C_HandleTypeDef *hi2c) {
-    uint8_t check;
-    uint8_t data;
+static void MPU6050_SetError(uint8_t error) {
+    uint32_t key = SharedData_WriteBegin();
+    VehicleState.imu_error_flag = error;
+    SharedData_WriteEnd(key);
+}
 
-    mpu_i2c = hi2c; // Handler'ı kaydet
+static void MPU6050_InitFailed(void) {
+    mpu_state = MPU6050_STATE_ERROR;
+    fifo_mode = 0;
+    MPU6050_SetError(1); // Hata bayrağını kaldır
+}
 
-    // 1. Sensör Kontrolü (WHO_AM_I)
-    if (HAL_I2C_Mem_Read(mpu_i2c, MPU6050_ADDR, REG_WHO_AM_I, 1, &check, 1, 100) != HAL_OK) {
-        VehicleState.imu_error_flag = 1; // Hata bayrağını kaldır
-        return 1;
+static void MPU6050_ConfigDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    if (status != I2C_BUS_OK || seq_failed) {
+        MPU6050_InitFailed();
+        return;
     }
+    mpu_state = MPU6050_STATE_READY;
+    MPU6050_SetError(0); // Hata yok
+    if (fifo_requested) {
+        fifo_requested = 0;
+        fifo_mode = 1;
+        if (MPU6050_FIFO_QueueReset() != 0) fifo_resync = FIFO_RESYNC_REQUEST;
+    }
+}
 
-    if (check == 0x68) {
-        // 2. Uyandırma
-        data = 0;
-        HAL_I2C_Mem_Write(mpu_i2c, MPU6050_ADDR, REG_PWR_MGMT_1, 1, &data, 1, 100);
+static void MPU6050_WhoAmIDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    if (status != I2C_BUS_OK || who_am_i != 0x68) {
+        MPU6050_InitFailed(); // Sensör yok / ID uyuşmadı
+        return;
+    }
 
-        // 3. Örnekleme Hızı (1kHz)
-        data = 0x07;
-        HAL_I2C_Mem_Write(mpu_i2c, MPU6050_ADDR, REG_SMPLRT_DIV, 1, &data, 1, 100);
+    static const MPU6050_RegWrite_t config[] = {
+        { REG_PWR_MGMT_1, 0x00 },                                 // Uyandırma
+        { REG_SMPLRT_DIV, 0x07 },                                 // Örnekleme hızı (1kHz)
+        // Register 0x1C bit 4:3 = AFS_SEL. AFS_SEL=2 -> 0x10, yani ±8g.
+        { REG_ACCEL_CONFIG, (uint8_t)(MPU6050_ACCEL_FS_SEL << 3) },
+        { REG_GYRO_CONFIG, (uint8_t)(MPU6050_GYRO_FS_SEL << 3) }, // bit 4:3 = FS_SEL
+    };
+    if (MPU6050_WriteSeq(config, sizeof(config) / sizeof(config[0]), MPU6050_ConfigDone) != 0) {
+        MPU6050_InitFailed();
+    }
+}
 
-        // --- DEĞİŞİKLİK 1: Config Ayarı (±8g) ---
-        // Register 0x1C'ye 0x10 (Binary: 00010000) yazıyoruz.
-        // Bit 4 ve 3 '10' olunca AFS_SEL=2 olur, yani ±8g.
-        data = 0x10; 
-        HAL_I2C_Mem_Write(mpu_i2c, MPU6050_ADDR, REG_ACCEL_CONFIG, 1, &data, 1, 100);
+uint8_t MPU6050_Init(void) {
+    mpu_dev = I2CBus_FindDevice(MPU6050_ADDR);
+    if (mpu_dev == I2C_BUS_NO_DEVICE) mpu_dev = I2CBus_AddDevice(MPU6050_ADDR, "MPU6050");
+    ImuFilter_Init();
 
-        // 5. Jiroskop Ayarı (±250 dps)
-        data = 0x00;
-        HAL_I2C_Mem_Write(mpu_i2c, MPU6050_ADDR, REG_GYRO_CONFIG, 1, &data, 1, 100);
+    read_pending = 0;
+    fifo_mode = 0;
+    fifo_requested = 0;
+    fifo_resync = 0;
+    fifo_phase = FIFO_PHASE_IDLE;
+    fifo_dr_count = 0;
+    fifo_epoch_valid = 0;
+    mpu_state = MPU6050_STATE_INIT;
 
-        VehicleState.imu_error_flag = 0; // Hata yok
-        return 0;
-    } 
-    
-    return 1; // Sensör ID uyuşmadı
+    // 1. Sensör Kontrolü (WHO_AM_I); gerisi callback zincirinde
+    I2CBusXfer_t x = {
+        .device = mpu_dev, .priority = I2C_BUS_PRIO_NORMAL, .retries = 3,
+        .reg = REG_WHO_AM_I, .len = 1, .data = &who_am_i, .done = MPU6050_WhoAmIDone,
+    };
+    if (mpu_dev == I2C_BUS_NO_DEVICE || I2CBus_Submit(&x) != 0) {
+        MPU6050_InitFailed();
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t MPU6050_GetState(void) {
+    return mpu_state;
+}
+
+// Çevrim ve filtre ISR'de (I2CBus bitiş callback'i)
+static void MPU6050_ReadDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    if (status != I2C_BUS_OK) {
+        read_pending = 0;
+        fifo_stats.read_errors++;
+        return;
+    }
+
+    // Örnek anı: okuma bu kesmede bitti (görev saatine göre değil)
+    uint32_t timestamp = I2CBus_Now();
+    PROFILE_BEGIN(PROF_IMU_DMA);
+    IMU_Data_t data, filtered;
+    int16_t counts[MPU6050_RAW_AXES];
+    MPU6050_Convert(dma_rx_buffer, counts, &data);
+    read_pending = 0; // Tampon çevrildi, bir sonraki okuma eklenebilir
+    fifo_stats.samples++;
+    PROFILE_END(PROF_IMU_DMA);
+
+    // Filtre kendi probesiyle ölçülür (iç içe probe kesme sayılırdı)
+    uint8_t ready = ImuFilter_Process(&data, &filtered);
+    MPU6050_Publish(&data, counts, timestamp, ready ? &filtered : NULL, timestamp);
 }
 
-// --- DEĞİŞİKLİK 2: DMA Okuma Tetikleyicisi ---
 void MPU6050_Start_DMA_Read(void) {
-    // Eğer DMA hala bir önceki işi bitirmediyse yeni emir verme
-    if (dma_busy) return;
+    if (fifo_mode || mpu_state != MPU6050_STATE_READY) return; // FIFO modunda okumaları INT kesmesi başlatır
+
+    // Önceki okuma hâlâ kuyrukta ya da hatta: o okuma en taze örneği getirir
+    if (read_pending) {
+        fifo_stats.dropped_reads++;
+        return;
+    }
+
+    // Eski örneği tekrar okumak anlamsız: hata olursa bir sonraki tetik dener
+    I2CBusXfer_t x = {
+        .device = mpu_dev, .priority = I2C_BUS_PRIO_HIGH, .retries = 0,
+        .reg = REG_ACCEL_XOUT_H, .len = sizeof(dma_rx_buffer), .data = dma_rx_buffer, .done = MPU6050_ReadDone,
+    };
+    read_pending = 1;
+    if (I2CBus_Submit(&x) != 0) {
+        read_pending = 0;
+        fifo_stats.dropped_reads++;
+    }
+}
+
+void MPU6050_FromRaw(const int16_t *raw, IMU_Data_t *out) {
+    out->accel_x_g = raw[0] * ACCEL_Q16_MUL;
+    out->accel_y_g = raw[1] * ACCEL_Q16_MUL;
+    out->accel_z_g = raw[2] * ACCEL_Q16_MUL;
+
+    out->gyro_x_dps = q16_mul_int(raw[4], GYRO_RECIP_Q32);
+    out->gyro_y_dps = q16_mul_int(raw[5], GYRO_RECIP_Q32);
+    out->gyro_z_dps = q16_mul_int(raw[6], GYRO_RECIP_Q32);
+
+    out->temp_c = q16_mul_int(raw[3], TEMP_RECIP_Q32) + TEMP_OFFSET_Q16;
+}
+
+// 14 byte ham örnek (big-endian) -> sayımlar ve Q16.16 fiziksel birimler
+static void MPU6050_Convert(const uint8_t *raw, int16_t *counts, IMU_Data_t *out) {
+    // Byte birleştirme (register sırası: ivme, sıcaklık, jiroskop)
+    for (uint32_t i = 0; i < MPU6050_RAW_AXES; i++) {
+        counts[i] = (int16_t)(raw[2 * i] << 8 | raw[2 * i + 1]);
+    }
+    MPU6050_FromRaw(counts, out);
+}
+
+// Ham örnek (sayımlarıyla) her zaman, filtreli örnek (NULL değilse) çıkış
+// hızında yayınlanır; ikisi de kendi örnek anıyla
+static void MPU6050_Publish(const IMU_Data_t *raw, const int16_t *counts, uint32_t raw_time,
+                            const IMU_Data_t *filtered, uint32_t filtered_time) {
+    uint32_t key = SharedData_WriteBegin();
+    VehicleState.imu_raw = *raw;
+    for (uint32_t i = 0; i < MPU6050_RAW_AXES; i++) VehicleState.imu_raw_counts[i] = counts[i];
+    VehicleState.imu_raw_seq++;
+    VehicleState.imu_raw_time = raw_time;
+    if (filtered != NULL) {
+        VehicleState.imu = *filtered;
+        VehicleState.imu_seq++;
+        VehicleState.imu_time = filtered_time;
+        VehicleState.imu_time_ms = HAL_GetTick();
+    }
+    SharedData_WriteEnd(key);
+}
+
+// ============= FIFO MODU =============
+// Akış: INT (DATA_RDY) -> zaman damgası geçmişe, MPU6050_FIFO_BATCH örnek
+// birikince FIFO_COUNT okunur (DMA, 2 byte) -> bekleyen tam örnekler boş
+// ping-pong tamponuna FIFO_R_W'den tek burst ile okunur -> ana döngü
+// MPU6050_FIFO_Process ile toplu çevirir.
+//
+// Zaman damgaları: FIFO bir kuyruk olduğu için reset sonrası okunan k. örnek,
+// k + fifo_dr_base numaralı INT'te üretilmiştir. fifo_dr_base, sırasında INT
+// gelmeyen her FIFO_COUNT okumasında (dr_count - okunan - bekleyen) olarak
+// yeniden hesaplanır; böylece reset anındaki yarış ve kaçırılan INT'ler
+// kendiliğinden düzelir.
+
+static void MPU6050_FIFO_CountDone(uint8_t status, void *ctx);
+static void MPU6050_FIFO_BurstDone(uint8_t status, void *ctx);
 
-    dma_busy = 1; // Meşgul bayrağını çek
+static void MPU6050_FIFO_StartBurst(void) {
+    if (fifo_phase != FIFO_PHASE_IDLE || fifo_resync) return;
+    if (fifo_buf_state[fifo_fill_idx] != FIFO_BUF_FREE) return; // Ana döngü geride, örnekler FIFO'da bekler
 
-    // Non-blocking okuma başlat. Veriler dma_rx_buffer'a dolacak.
-    HAL_I2C_Mem_Read_DMA(mpu_i2c, MPU6050_ADDR, REG_ACCEL_XOUT_H, 1, dma_rx_buffer, 14);
+    fifo_dr_at_count = fifo_dr_count;
+    fifo_dr_at_burst = fifo_dr_count;
+    fifo_phase = FIFO_PHASE_COUNT;
+    I2CBusXfer_t x = {
+        .device = mpu_dev, .priority = I2C_BUS_PRIO_HIGH, .retries = 1,
+        .reg = REG_FIFO_COUNTH, .len = 2, .data = fifo_count_raw, .done = MPU6050_FIFO_CountDone,
+    };
+    if (I2CBus_Submit(&x) != 0) {
+        fifo_phase = FIFO_PHASE_IDLE;
+        fifo_stats.dropped_reads++;  // Bir sonraki INT'te tekrar denenir
+    }
 }
 
-// --- DEĞİŞİKLİK 3: Callback ve SharedData Entegrasyonu ---
-// Bu fonksiyon, okuma bittiğinde HAL_I2C_MemRxCpltCallback içinden çağrılmalı.
-void MPU6050_DMA_Callback(void) {
-    int16_t raw_ax, raw_ay, raw_az;
-    int16_t raw_temp;
-    int16_t raw_gx, raw_gy, raw_gz;
+static void MPU6050_FIFO_CountDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    fifo_phase = FIFO_PHASE_IDLE;
+    if (status != I2C_BUS_OK) {
+        fifo_stats.read_errors++;    // Örnekler FIFO'da kalır, sonraki INT'te sayılır
+        return;
+    }
+    PROFILE_BEGIN(PROF_IMU_DMA);
+    uint32_t bytes = ((uint32_t)fifo_count_raw[0] << 8) | fifo_count_raw[1];
+
+    // Taşmada FIFO dolu kalır ve örnek hizası kaybolur: sıfırlamak tek çare.
+    // Neredeyse doluysa da burst sürerken taşıp okunan örnekleri kaydırabilir.
+    if (bytes > (MPU6050_FIFO_MAX_SAMPLES - 2U) * MPU6050_SAMPLE_SIZE ||
+        (bytes % MPU6050_SAMPLE_SIZE) != 0U) {
+        fifo_stats.fifo_overflows++;
+        fifo_resync = FIFO_RESYNC_REQUEST;
+        PROFILE_END(PROF_IMU_DMA);
+        return;
+    }
+
+    uint32_t avail = bytes / MPU6050_SAMPLE_SIZE;
+    if (avail > fifo_stats.max_backlog) fifo_stats.max_backlog = avail;
+
+    uint32_t base = fifo_dr_count - (fifo_read_seq + avail);
+    if (fifo_dr_count == fifo_dr_at_count) {
+        if (fifo_base_valid && base != fifo_dr_base) fifo_stats.ts_resyncs++;
+        if (!fifo_base_valid && fifo_epoch_valid) {
+            // Sıfırlama yazması sürerken gelen INT'ler: örneği silindiyse
+            // kayıp (base > epoch), sıfırlamadan sonra FIFO'ya girdiyse
+            // ResetDone'da fazladan sayılmıştı (base < epoch)
+            fifo_stats.lost_samples += base - fifo_dr_epoch;
+        }
+        fifo_dr_base = base;
+        fifo_base_valid = 1;
+    } else if (!fifo_base_valid) {
+        // Okuma sırasında INT geldi: yeni örneğin sayıma girdiğini varsay,
+        // ilk temiz okumada doğrulanır
+        fifo_dr_base = base;
+    }
+    if (avail == 0U) {
+        PROFILE_END(PROF_IMU_DMA);
+        return;
+    }
 
-    // 1. Byte Birleştirme
-    raw_ax = (int16_t)(dma_rx_buffer[0] << 8 | dma_rx_buffer[1]);
-    raw_ay = (int16_t)(dma_rx_buffer[2] << 8 | dma_rx_buffer[3]);
-    raw_az = (int16_t)(dma_rx_buffer[4] << 8 | dma_rx_buffer[5]);
-    raw_temp = (int16_t)(dma_rx_buffer[6] << 8 | dma_rx_buffer[7]);
-    raw_gx = (int16_t)(dma_rx_buffer[8] << 8 | dma_rx_buffer[9]);
-    raw_gy = (int16_t)(dma_rx_buffer[10] << 8 | dma_rx_buffer[11]);
-    raw_gz = (int16_t)(dma_rx_buffer[12] << 8 | dma_rx_buffer[13]);
+    // Burst FIFO'dan örnek çeker: yarıda kalırsa hiza kaybolur, tekrar yok
+    uint32_t n = (avail < MPU6050_FIFO_BATCH) ? avail : MPU6050_FIFO_BATCH;
+    uint8_t idx = fifo_fill_idx;
+    I2CBusXfer_t x = {
+        .device = mpu_dev, .priority = I2C_BUS_PRIO_HIGH, .retries = 0,
+        .reg = REG_FIFO_R_W, .len = (uint16_t)(n * MPU6050_SAMPLE_SIZE), .data = fifo_buf[idx],
+        .done = MPU6050_FIFO_BurstDone,
+    };
+    if (I2CBus_Submit(&x) != 0) {
+        fifo_stats.dropped_reads++;
+        PROFILE_END(PROF_IMU_DMA);
+        return;
+    }
+    fifo_buf_seq[idx] = fifo_read_seq;
+    fifo_buf_n[idx] = (uint8_t)n;
+    fifo_buf_state[idx] = FIFO_BUF_FILLING;
+    fifo_read_seq += n;
+    fifo_backlog = avail - n;
+    fifo_phase = FIFO_PHASE_DATA;
+    PROFILE_END(PROF_IMU_DMA);
+}
 
-    // 2. Fiziksel Çevrim ve SharedData'ya Yazma
-    // Burada struct'ın içine erişiyoruz: VehicleState.imu...
-    VehicleState.imu.accel_x_g = raw_ax / ACCEL_SCALE;
-    VehicleState.imu.accel_y_g = raw_ay / ACCEL_SCALE;
-    VehicleState.imu.accel_z_g = raw_az / ACCEL_SCALE;
+static void MPU6050_FIFO_BurstDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    uint8_t idx = fifo_fill_idx;
+    fifo_phase = FIFO_PHASE_IDLE;
+    if (status != I2C_BUS_OK) {
+        // Kaç byte'ın FIFO'dan çekildiği bilinmiyor: sayım hizası için sıfırla
+        fifo_stats.read_errors++;
+        fifo_stats.lost_samples += fifo_buf_n[idx];
+        fifo_buf_state[idx] = FIFO_BUF_FREE;
+        fifo_resync = FIFO_RESYNC_REQUEST;
+        return;
+    }
+    fifo_buf_state[idx] = FIFO_BUF_READY;
+    fifo_fill_idx ^= 1U;
+    fifo_stats.bursts++;
 
-    VehicleState.imu.gyro_x_dps = raw_gx / GYRO_SCALE;
-    VehicleState.imu.gyro_y_dps = raw_gy / GYRO_SCALE;
-    VehicleState.imu.gyro_z_dps = raw_gz / GYRO_SCALE;
+    // Son sayımda FIFO'da kalan örnek varsa eşiği beklemeden devam et
+    if (fifo_backlog > 0U) {
+        MPU6050_FIFO_StartBurst();
+    }
+}
 
-    VehicleState.imu.temp_c = (raw_temp / 340.0f) + 36.53f;
+// USER_CTRL yazması FIFO'yu boşalttı: okuma durumu sıfırlanır (ISR bağlamı)
+static void MPU6050_FIFO_ResetDone(uint8_t status, void *ctx) {
+    (void)ctx;
+    if (status != I2C_BUS_OK || seq_failed) {
+        fifo_resync = FIFO_RESYNC_REQUEST;   // Ana döngü yeniden dener
+        return;
+    }
+    if (fifo_epoch_valid) {
+        // INT'i gelmiş ama okunmamış örnekler sıfırlamayla gitti. Temiz sayım
+        // gelmeden sıfırlandıysa base, önceki sıfırlamadaki dr_count'tur.
+        uint32_t base = fifo_base_valid ? fifo_dr_base : fifo_dr_epoch;
+        fifo_stats.lost_samples += fifo_dr_count - base - fifo_read_seq;
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+        if (fifo_buf_state[i] == FIFO_BUF_READY) fifo_stats.lost_samples += fifo_buf_n[i];
+    }
+    fifo_read_seq = 0;
+    fifo_backlog = 0;
+    fifo_base_valid = 0;
+    fifo_dr_at_burst = fifo_dr_count;
+    fifo_dr_epoch = fifo_dr_count;
+    fifo_epoch_valid = 1;
+    fifo_fill_idx = 0;
+    fifo_proc_idx = 0;
+    fifo_buf_state[0] = FIFO_BUF_FREE;
+    fifo_buf_state[1] = FIFO_BUF_FREE;
+    fifo_resync = 0;
+}
 
-    VehicleState.last_update_time = HAL_GetTick(); // Zaman damgası ekledik
+// FIFO'yu boşaltan yazma dizisini kuyruğa atar. Dizi bitene kadar
+// (fifo_resync != 0) burst başlatılmaz ve Process tampon işlemez. INT
+// sıfırlama boyunca açık kalır: yazmalar arasına başka cihazın işlemi
+// girebildiği için kapatılsaydı aradaki örnekler INT'siz FIFO'ya girer ve
+// zaman damgası eşlemesi kayardı.
+static uint8_t MPU6050_FIFO_QueueReset(void) {
+    static const MPU6050_RegWrite_t reset[] = {
+        { REG_INT_PIN_CFG, 0x00 },                   // INT: aktif yüksek, push-pull, 50 us darbe
+        { REG_FIFO_EN, MPU6050_FIFO_EN_ALL },
+        { REG_INT_ENABLE, MPU6050_INT_DATA_RDY_EN },
+        { REG_USER_CTRL, MPU6050_USER_FIFO_EN | MPU6050_USER_FIFO_RESET },
+    };
+    fifo_resync = FIFO_RESYNC_BUSY;
+    if (MPU6050_WriteSeq(reset, sizeof(reset) / sizeof(reset[0]), MPU6050_FIFO_ResetDone) != 0) {
+        fifo_resync = FIFO_RESYNC_REQUEST;
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t MPU6050_FIFO_Start(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t state = mpu_state;
+    if (state == MPU6050_STATE_INIT) {
+        fifo_requested = 1;   // Kurulum yazmaları bitince açılır
+    } else if (state == MPU6050_STATE_READY && !fifo_mode && !read_pending) {
+        fifo_dr_count = 0;
+        fifo_epoch_valid = 0;
+        fifo_phase = FIFO_PHASE_IDLE;
+        fifo_mode = 1;
+        if (MPU6050_FIFO_QueueReset() != 0) fifo_resync = FIFO_RESYNC_REQUEST;
+    } else if (!fifo_mode) {
+        state = MPU6050_STATE_ERROR;
+    }
+    __set_PRIMASK(primask);
+    return (state == MPU6050_STATE_ERROR) ? 1U : 0U;
+}
+
+void MPU6050_INT_Callback(uint32_t timestamp) {
+    if (!fifo_mode) return;
+    PROFILE_BEGIN(PROF_IMU_INT);
+
+    fifo_dr_ts[fifo_dr_count & (MPU6050_TS_HISTORY - 1U)] = timestamp;
+    fifo_dr_count++;
+
+    if (fifo_dr_count - fifo_dr_at_burst >= MPU6050_FIFO_BATCH) {
+        MPU6050_FIFO_StartBurst();
+    }
+    PROFILE_END(PROF_IMU_INT);
+}
+
+uint32_t MPU6050_FIFO_Process(IMU_Sample_t *out, uint32_t max) {
+    uint32_t count = 0;
+
+    if (!fifo_mode) return 0;
+
+    if (fifo_resync) {
+        // Burst bitene kadar bekle; sıfırlama yazmaları kuyruktayken tampon işlenmez
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        if (fifo_resync == FIFO_RESYNC_REQUEST && fifo_phase == FIFO_PHASE_IDLE) {
+            (void)MPU6050_FIFO_QueueReset();
+        }
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    while (fifo_buf_state[fifo_proc_idx] == FIFO_BUF_READY) {
+        uint8_t idx = fifo_proc_idx;
+        uint32_t n = fifo_buf_n[idx];
+        if (out != NULL && max - count < n) break;
+
+        IMU_Sample_t sample;
+        IMU_Data_t filtered;
+        uint32_t filtered_time = 0;
+        uint8_t ready = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            MPU6050_Convert(&fifo_buf[idx][i * MPU6050_SAMPLE_SIZE], sample.counts, &sample.data);
+            sample.seq = fifo_buf_seq[idx] + i + fifo_dr_base;
+            sample.timestamp = fifo_dr_ts[sample.seq & (MPU6050_TS_HISTORY - 1U)];
+            sample.has_filtered = ImuFilter_Process(&sample.data, &sample.filtered);
+            if (sample.has_filtered) {
+                filtered = sample.filtered;
+                filtered_time = sample.timestamp;
+                ready = 1;
+            }
+            if (out != NULL) out[count] = sample;
+            count++;
+        }
+
+        MPU6050_Publish(&sample.data, sample.counts, sample.timestamp, ready ? &filtered : NULL, filtered_time);
+        fifo_stats.samples += n;
+
+        __DMB();
+        fifo_buf_state[idx] = FIFO_BUF_FREE;
+        fifo_proc_idx ^= 1U;
+
+        // Tampon boşaldı: iki tampon da doluyken FIFO'da bekleyenleri çek
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        if (fifo_dr_count - fifo_dr_at_burst >= MPU6050_FIFO_BATCH || fifo_backlog > 0U) {
+            MPU6050_FIFO_StartBurst();
+        }
+        __set_PRIMASK(primask);
+    }
+    return count;
+}
 
-    dma_busy = 0; // İşlem bitti, bayrağı indir
+void MPU6050_GetFifoStats(MPU6050_FifoStats_t *stats) {
+    *stats = fifo_stats;
 }
@@ -0,0 +1,143 @@
+// imu_filter.c
+#include "sensors/imu_filter.h"
+#include "fw_state.h"
+#include "profiler.h"
+#include <string.h>
+
+#if IMU_FILTER_DECIM == 1U
+#define CIC_SHIFT            0U
+#elif IMU_FILTER_DECIM == 2U
+#define CIC_SHIFT            (1U * IMU_FILTER_CIC_ORDER)
+#elif IMU_FILTER_DECIM == 4U
+#define CIC_SHIFT            (2U * IMU_FILTER_CIC_ORDER)
+#else
+#define CIC_SHIFT            (3U * IMU_FILTER_CIC_ORDER)
+#endif
+
+// Q16 giriş en çok ±2^24 (jiroskop tam ölçeği, ham 32767 * 500); CIC kazancı
+// 2^CIC_SHIFT ile birlikte işaretli 32 bite sığmalı
+_Static_assert(25U + CIC_SHIFT <= 32U, "CIC çıkışı 32 bite sığmıyor");
+
+#define COEF_FRAC_MASK       ((1UL << IMU_FILTER_COEF_SHIFT) - 1U)
+
+typedef struct {
+    int32_t x1, x2;           // Son iki giriş (Q16)
+    int32_t y1, y2;           // Son iki çıkış (Q16)
+    uint32_t err;             // Hata geri beslemesi: son çıkıştan kesilen alt bitler (Q30)
+} ImuBiquadState_t;
+
+FW_STATE ImuBiquadState_t biquad[IMU_FILTER_AXES][IMU_FILTER_SECTIONS];
+#if IMU_FILTER_DECIM > 1U
+FW_STATE uint32_t cic_int[IMU_FILTER_AXES][IMU_FILTER_CIC_ORDER];   // Modüler (taşma beklenir)
+FW_STATE uint32_t cic_comb[IMU_FILTER_AXES][IMU_FILTER_CIC_ORDER];  // Tarak gecikmeleri
+FW_STATE uint32_t cic_phase = 0;
+FW_STATE uint32_t cic_warmup = 0;   // Atılacak çıkış: CIC belleği sıfırla başlar
+#endif
+FW_STATE uint8_t primed = 0;
+FW_STATE ImuFilterStats_t stats;
+
+#if IMU_FILTER_DECIM > 1U
+// Tarak katları (çıkış hızında), kazanç R^N yuvarlayarak geri alınır
+static inline int32_t ImuFilter_Comb(uint32_t a) {
+    uint32_t acc = cic_int[a][IMU_FILTER_CIC_ORDER - 1U];
+    for (uint32_t k = 0; k < IMU_FILTER_CIC_ORDER; k++) {
+        uint32_t prev = cic_comb[a][k];
+        cic_comb[a][k] = acc;
+        acc -= prev;
+    }
+    return (int32_t)(acc + (1UL << (CIC_SHIFT - 1U))) >> CIC_SHIFT;
+}
+#endif
+
+void ImuFilter_Init(void) {
+    memset(biquad, 0, sizeof(biquad));
+#if IMU_FILTER_DECIM > 1U
+    memset(cic_int, 0, sizeof(cic_int));
+    memset(cic_comb, 0, sizeof(cic_comb));
+    cic_phase = 0;
+    // Çıkış m, son N * (R - 1) + 1 girişin FIR'ı: ilk N - 1 çıkış başlangıçtaki sıfırları içerir
+    cic_warmup = IMU_FILTER_CIC_ORDER - 1U;
+#endif
+    primed = 0;
+    stats = (ImuFilterStats_t){0};
+    Profiler_SetBudget(PROF_IMU_FILTER, IMU_FILTER_CYCLE_BUDGET);
+}
+
+uint8_t ImuFilter_Process(const IMU_Data_t *in, IMU_Data_t *out) {
+    PROFILE_BEGIN(PROF_IMU_FILTER);
+    const q16_t x_in[IMU_FILTER_AXES] = {
+        in->accel_x_g, in->accel_y_g, in->accel_z_g, in->gyro_x_dps, in->gyro_y_dps, in->gyro_z_dps
+    };
+    int32_t v[IMU_FILTER_AXES];
+    stats.inputs++;
+
+#if IMU_FILTER_DECIM > 1U
+    // İntegratörler her örnekte
+    for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) {
+        uint32_t acc = (uint32_t)x_in[a];
+        for (uint32_t k = 0; k < IMU_FILTER_CIC_ORDER; k++) {
+            cic_int[a][k] += acc;
+            acc = cic_int[a][k];
+        }
+    }
+    if (++cic_phase < IMU_FILTER_DECIM) {
+        PROFILE_END(PROF_IMU_FILTER);
+        return 0;
+    }
+    cic_phase = 0;
+    if (cic_warmup > 0U) {
+        for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) {
+            (void)ImuFilter_Comb(a);
+        }
+        cic_warmup--;
+        PROFILE_END(PROF_IMU_FILTER);
+        return 0;
+    }
+#endif
+
+    // Çıkış hızında: tarak katları + biquad'lar, altı eksen tek döngüde
+    for (uint32_t a = 0; a < IMU_FILTER_AXES; a++) {
+#if IMU_FILTER_DECIM > 1U
+        int32_t x = ImuFilter_Comb(a);
+#else
+        int32_t x = x_in[a];
+#endif
+        const ImuBiquad_t *c = imu_filter_coef[a < 3U ? 0U : 1U];
+        ImuBiquadState_t *s = biquad[a];
+        if (!primed) {
+            // Kararlı durum: DC kazancı 1 olduğu için x sabitken çıkış x kalır
+            for (uint32_t k = 0; k < IMU_FILTER_SECTIONS; k++) {
+                s[k] = (ImuBiquadState_t){ x, x, x, x, 0 };
+            }
+        }
+        for (uint32_t k = 0; k < IMU_FILTER_SECTIONS; k++) {
+            int64_t sum = (int64_t)c[k].b0 * x + (int64_t)c[k].b1 * s[k].x1 + (int64_t)c[k].b2 * s[k].x2 +
+                          (int64_t)c[k].a1 * s[k].y1 + (int64_t)c[k].a2 * s[k].y2 + s[k].err;
+            int32_t y = (int32_t)(sum >> IMU_FILTER_COEF_SHIFT);
+            s[k].err = (uint32_t)sum & COEF_FRAC_MASK;
+            s[k].x2 = s[k].x1;
+            s[k].x1 = x;
+            s[k].y2 = s[k].y1;
+            s[k].y1 = y;
+            x = y;
+        }
+        v[a] = x;
+    }
+
+    primed = 1;
+
+    out->accel_x_g = v[0];
+    out->accel_y_g = v[1];
+    out->accel_z_g = v[2];
+    out->gyro_x_dps = v[3];
+    out->gyro_y_dps = v[4];
+    out->gyro_z_dps = v[5];
+    out->temp_c = in->temp_c;
+    stats.outputs++;
+    PROFILE_END(PROF_IMU_FILTER);
+    return 1;
+}
+
+void ImuFilter_GetStats(ImuFilterStats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,20 @@
+// imu_filter_coef.c
+// ÜRETİLMİŞ DOSYA, elle düzenlemeyin: make -C vehicle/host (host/imu_filter_gen.c)
+// Giriş 1000 Hz -> 2. derece Butterworth, 1000 Hz çıkış
+// ivme      50 Hz: kesimde -3.01 dB, 200 Hz'de -26.5 dB | gecikme 4.46 ms | beyaz gürültü RMS x0.331
+// jiroskop 100 Hz: kesimde -3.01 dB, 400 Hz'de -39.1 dB | gecikme 2.18 ms | beyaz gürültü RMS x0.463
+#include "imu_filter.h"
+
+#if IMU_FILTER_DECIM != 1 || IMU_FILTER_SECTIONS != 1 || IMU_FILTER_ACCEL_HZ != 50 || IMU_FILTER_GYRO_HZ != 100
+#error "imu_filter_coef.c imu_filter.h ile uyuşmuyor: make -C vehicle/host ile yeniden üretin"
+#endif
+
+// { b0, b1, b2, a1, a2 }, Q2.30, 1000 Hz'de
+const ImuBiquad_t imu_filter_coef[IMU_FILTER_GROUPS][IMU_FILTER_SECTIONS] = {
+    {   // ivme
+        {    21564350,    43128698,    21564350,  1676130396,  -688645970 },
+    },
+    {   // jiroskop
+        {    72429549,   144859097,    72429549,  1227265970,  -443242341 },
+    },
+};
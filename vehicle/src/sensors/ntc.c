@@ -1 +1,85 @@
+// ntc.c
+#include "ntc.h"
+#include "fw_state.h"
+#include "shared_data.h"
 
+// Motordaki yuvalar; hepsi aynı anda kaydedildiği için pencereleri ortak
+FW_STATE int8_t slots[NTC_CHANNELS];
+FW_STATE uint32_t processed_updates = 0;
+FW_STATE uint8_t overtemp_mask = 0;
+FW_STATE NtcStats_t stats;
+
+uint8_t NTC_Init(void) {
+    static const uint32_t channels[NTC_CHANNELS] = NTC_ADC_CHANNEL_LIST;
+
+    processed_updates = 0;
+    overtemp_mask = 0;
+    stats = (NtcStats_t){0};
+
+    AnalogChannelConfig_t config = {0};
+    config.sample_time = NTC_SAMPLE_TIME;
+    config.filter = ANALOG_FILTER_AVERAGE;
+    config.decimation_log2 = NTC_DECIMATION_LOG2;
+    for (uint8_t ch = 0; ch < NTC_CHANNELS; ch++) {
+        config.channel = channels[ch];
+        slots[ch] = Analog_Register(&config);
+        if (slots[ch] < 0) return 1;
+    }
+    return 0;
+}
+
+q16_t NTC_CodeToTemp(uint16_t code) {
+    uint32_t i = (uint32_t)code >> NTC_TABLE_SHIFT;
+    int32_t frac = (int32_t)(code & ((1U << NTC_TABLE_SHIFT) - 1U));
+    int32_t t0 = ntc_table[i];
+    int32_t dt = ntc_table[i + 1U] - t0;
+    // Uç parçalarda dt çok büyük olabilir: çarpım 64 bit (M3'te tek SMULL)
+    return (q16_t)(t0 + (int32_t)(((int64_t)dt * frac) >> NTC_TABLE_SHIFT));
+}
+
+uint8_t NTC_Process(void) {
+    AnalogBlock_t block;
+    uint16_t code[NTC_CHANNELS];
+
+    Analog_Read(&block);
+    uint32_t updates = block.updates[slots[0]];
+    if (updates == processed_updates) return 0;
+
+    stats.missed += updates - processed_updates - 1U;
+    processed_updates = updates;
+    for (uint8_t ch = 0; ch < NTC_CHANNELS; ch++) code[ch] = block.value[slots[ch]];
+
+    q16_t temp[NTC_CHANNELS];
+    uint8_t fault = 0;
+    for (uint8_t ch = 0; ch < NTC_CHANNELS; ch++) {
+        uint8_t bit = (uint8_t)(1U << ch);
+        if (code[ch] < NTC_CODE_SHORT || code[ch] > NTC_CODE_OPEN) {
+            // Arızalı kanalın sıcaklığı anlamsız: son geçerli değer kalır, bayrak değişmez
+            fault |= bit;
+            temp[ch] = VehicleState.ntc_temp_c[ch];
+            continue;
+        }
+        temp[ch] = NTC_CodeToTemp(code[ch]);
+
+        if (!(overtemp_mask & bit) && temp[ch] >= NTC_OVERTEMP_C) {
+            overtemp_mask |= bit;
+            stats.overtemp_events++;
+        } else if ((overtemp_mask & bit) && temp[ch] < NTC_OVERTEMP_CLEAR_C) {
+            overtemp_mask &= (uint8_t)~bit;
+        }
+    }
+
+    uint32_t key = SharedData_WriteBegin();
+    for (uint8_t ch = 0; ch < NTC_CHANNELS; ch++) VehicleState.ntc_temp_c[ch] = temp[ch];
+    VehicleState.ntc_overtemp = overtemp_mask;
+    VehicleState.ntc_fault = fault;
+    VehicleState.ntc_time = block.time[slots[0]];
+    SharedData_WriteEnd(key);
+
+    stats.processed++;
+    return 1;
+}
+
+void NTC_GetStats(NtcStats_t *out) {
+    *out = stats;
+}
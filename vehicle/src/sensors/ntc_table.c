@@ -0,0 +1,46 @@
+// ntc_table.c
+// ÜRETİLMİŞ DOSYA, elle düzenlemeyin: make -C vehicle/host (host/ntc_table_gen.c)
+// R25 10000 ohm, beta 3950 K, seri direnç 10000 ohm, 256 parça
+// Ara değer hatası (-40..125 °C): en çok 0.066 °C
+#include "ntc.h"
+
+#if NTC_R25_OHM != 10000 || NTC_BETA_K != 3950 || NTC_R_SERIES_OHM != 10000 || NTC_TABLE_BITS != 8
+#error "ntc_table.c ntc.h ile uyuşmuyor: make -C vehicle/host ile yeniden üretin"
+#endif
+
+// Eleman i: 16 bit kod i << 8, °C (Q16.16)
+const q16_t ntc_table[NTC_TABLE_SIZE] = {
+    /*   0 */  13107200,  13107200,  12843876,  11435314,  10504781,   9818659,   9279402,   8837448,
+    /*   8 */   8464353,   8142359,   7859680,   7608110,   7381725,   7176111,   6987900,   6814464,
+    /*  16 */   6653715,   6503970,   6363853,   6232225,   6108133,   5990772,   5879457,   5773599,
+    /*  24 */   5672690,   5576288,   5484006,   5395502,   5310476,   5228660,   5149815,   5073729,
+    /*  32 */   5000207,   4929078,   4860184,   4793383,   4728545,   4665552,   4604294,   4544674,
+    /*  40 */   4486598,   4429983,   4374752,   4320831,   4268154,   4216660,   4166289,   4116990,
+    /*  48 */   4068710,   4021403,   3975026,   3929537,   3884897,   3841070,   3798022,   3755720,
+    /*  56 */   3714135,   3673236,   3632998,   3593393,   3554399,   3515992,   3478149,   3440851,
+    /*  64 */   3404076,   3367807,   3332026,   3296715,   3261857,   3227438,   3193442,   3159856,
+    /*  72 */   3126665,   3093856,   3061417,   3029335,   2997600,   2966200,   2935125,   2904364,
+    /*  80 */   2873907,   2843745,   2813869,   2784270,   2754940,   2725870,   2697052,   2668478,
+    /*  88 */   2640142,   2612036,   2584154,   2556488,   2529031,   2501779,   2474724,   2447860,
+    /*  96 */   2421183,   2394685,   2368363,   2342209,   2316221,   2290391,   2264716,   2239191,
+    /* 104 */   2213810,   2188570,   2163466,   2138494,   2113649,   2088927,   2064325,   2039838,
+    /* 112 */   2015462,   1991194,   1967030,   1942965,   1918998,   1895123,   1871338,   1847639,
+    /* 120 */   1824023,   1800486,   1777025,   1753637,   1730319,   1707067,   1683879,   1660751,
+    /* 128 */   1637680,   1614663,   1591698,   1568781,   1545910,   1523081,   1500291,   1477538,
+    /* 136 */   1454819,   1432131,   1409471,   1386836,   1364224,   1341631,   1319054,   1296492,
+    /* 144 */   1273941,   1251397,   1228860,   1206324,   1183789,   1161250,   1138705,   1116150,
+    /* 152 */   1093584,   1071003,   1048404,   1025783,   1003139,    980468,    957766,    935031,
+    /* 160 */    912259,    889448,    866593,    843692,    820741,    797737,    774675,    751554,
+    /* 168 */    728368,    705114,    681788,    658387,    634906,    611342,    587690,    563945,
+    /* 176 */    540104,    516162,    492113,    467955,    443680,    419286,    394765,    370113,
+    /* 184 */    345324,    320393,    295313,    270078,    244682,    219118,    193380,    167459,
+    /* 192 */    141350,    115043,     88531,     61805,     34857,      7677,    -19743,    -47416,
+    /* 200 */    -75349,   -103556,   -132047,   -160835,   -189932,   -219353,   -249110,   -279220,
+    /* 208 */   -309698,   -340561,   -371827,   -403515,   -435645,   -468238,   -501318,   -534909,
+    /* 216 */   -569037,   -603730,   -639018,   -674934,   -711512,   -748791,   -786811,   -825617,
+    /* 224 */   -865257,   -905783,   -947253,   -989730,  -1033285,  -1077993,  -1123941,  -1171222,
+    /* 232 */  -1219944,  -1270224,  -1322197,  -1376015,  -1431852,  -1489907,  -1550411,  -1613632,
+    /* 240 */  -1679885,  -1749544,  -1823059,  -1900973,  -1983958,  -2072853,  -2168728,  -2272982,
+    /* 248 */  -2387487,  -2514842,  -2658804,  -2825123,  -3023277,  -3270716,  -3604480,  -3604480,
+    /* 256 */  -3604480,
+};
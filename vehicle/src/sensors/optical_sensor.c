@@ -1,125 +1,593 @@
 #include "optical_sensor.h"
+#include "fw_state.h"
+#include "edge_queue.h"
+#include "fusion.h"
+#include "tunnel_map.h"
+#include "strip_decoder.h"
+#include "velocity_fit.h"
+#include "profiler.h"
+#include "flight_recorder.h"
+#include "event_log.h"
 #include <stdio.h>
 #include <math.h>
 
-extern SharedData_t VehicleState;
+FW_STATE uint32_t last_edge_time = 0;      // Son kenarın yakalama zamanı (IC tick)
+FW_STATE uint32_t last_marker_time = 0;    // Bir önceki işaretin kenar zamanı
+FW_STATE q16_t last_marker_pos = 0;        // Bir önceki işaretin konumu
+FW_STATE uint8_t have_last_marker = 0;
+FW_STATE uint8_t last_marker_reflector = 0; // Önceki işaret reflektör (şerit konumu sayım kaymasıyla yanlış olabilir)
+FW_STATE uint16_t marker_index = 0;        // Sıradaki beklenen işaret (TunnelMap indeksi)
+FW_STATE uint8_t current_zone = TUNNEL_ZONE_NONE; // Son işaretin bölgesi
+FW_STATE uint32_t zone_entries = 0;        // Şerit bölgesine giriş sayısı
+FW_STATE OpticalMarkerStats_t marker_stats;
 
-static uint32_t last_interrupt_time = 0;
-static uint32_t last_reflector_time = 0;
-static float last_reflector_position = 0.0f;
-static uint8_t special_zone_flag = 0; // 0: normal, 1: son 100m işareti, 2: son 48m işareti
-static uint8_t info_strip_count = 0;
+// Kenar kapısı tahmini: reflektörden başlayan son aralığın ortalama hızı
+// (aralık ortasına ait) ve son iki böyle aralık arasındaki ivme
+FW_STATE q16_t gate_ref_velocity = 0;
+FW_STATE uint32_t gate_ref_time = 0;       // Referans aralığın orta anı (IC tick)
+FW_STATE q16_t gate_accel = 0;             // m/s^2
+FW_STATE uint8_t gate_refs = 0;            // Görülen referans aralık (2: ivme de biliniyor)
+FW_STATE uint8_t gate_rejects = 0;         // Art arda reddedilen kenar
+FW_STATE uint32_t gate_brake_onset = 0;    // Frenin tuttuğu an (IC tick)
+FW_STATE q16_t gate_brake_decel = 0;       // m/s^2, 0: fren komut edilmedi
+
+// Hız: son işaretlere en küçük kareler uydurması; nokta azken veya artık
+// büyükken iki noktalı dist/dt
+FW_STATE VelFit_t vel_fit;
+FW_STATE OpticalVelocity_t vel_info;
+
+// --- Giriş yakalama ---
+FW_STATE TIM_HandleTypeDef *ic_htim = NULL;
+FW_STATE volatile uint32_t ic_overflow_count = 0; // 16-bit sayacın üst yarısı
+
+// ISR sadece zaman damgasını kuyruğa atar, hesaplama OpticalSensor_Process'te
+FW_STATE EdgeQueue_t edge_queue;
+
+static void OpticalSensor_HandleEdge(uint32_t timestamp);
+static void OpticalSensor_ApplyStripFix(const StripFix_t *fix);
+static uint8_t OpticalSensor_PollStrips(uint32_t now);
+static uint8_t OpticalSensor_Gate(uint32_t timestamp, uint16_t *index);
+static q16_t OpticalSensor_PredictTravel(uint32_t timestamp);
 
 void OpticalSensor_Init(void) {
+    // Harita main'de flash bloğundan kurulmadıysa varsayılan pist
+    if (TunnelMap_Count() == 0) {
+        TunnelMap_Init(NULL);
+    }
+    
+    uint32_t key = SharedData_WriteBegin();
     VehicleState.reflector_count = 0;
-    VehicleState.current_position = TUNNEL_START_OFFSET; // 5m'de başla
-    VehicleState.current_velocity = 0.0f;
-    VehicleState.last_update_time = 0;
+    VehicleState.current_position = TunnelMap_Params()->start_offset; // Kapsül alanında başla
+    VehicleState.current_velocity = 0;
+    VehicleState.optical_time_ms = 0;
     VehicleState.system_status = SYS_READY;
+    SharedData_WriteEnd(key);
+    
+    last_edge_time = 0;
+    last_marker_time = 0;
+    last_marker_pos = 0;
+    have_last_marker = 0;
+    last_marker_reflector = 0;
+    marker_index = 0;
+    current_zone = TUNNEL_ZONE_NONE;
+    zone_entries = 0;
+    marker_stats = (OpticalMarkerStats_t){0};
+    gate_ref_velocity = 0;
+    gate_ref_time = 0;
+    gate_accel = 0;
+    gate_refs = 0;
+    gate_rejects = 0;
+    gate_brake_onset = 0;
+    gate_brake_decel = 0;
+    VelFit_Init(&vel_fit);
+    vel_info = (OpticalVelocity_t){0};
+    StripDecoder_Init();
+    
+    EdgeQueue_Init(&edge_queue);
+    
+    // Kayıt optik durumla birlikte sıfırlanır: oynatma buradan başlar
+    FlightRecorder_Start(OpticalSensor_GetTimestamp());
+}
+
+void OpticalSensor_IC_Start(TIM_HandleTypeDef *htim) {
+    ic_htim = htim;
+    ic_overflow_count = 0;
+    HAL_TIM_Base_Start_IT(htim);                    // Taşma -> üst 16 bit
+    HAL_TIM_IC_Start_IT(htim, OPTICAL_IC_CHANNEL);  // Kenar -> yakalama
+}
+
+void OpticalSensor_IC_OverflowCallback(TIM_HandleTypeDef *htim) {
+    if (htim != ic_htim) return;
+    ic_overflow_count++;
+}
+
+void OpticalSensor_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    if (htim != ic_htim || htim->Channel != OPTICAL_IC_ACTIVE_CH) return;
+    PROFILE_BEGIN(PROF_OPTICAL_CAPTURE);
+
+    uint32_t capture = HAL_TIM_ReadCapturedValue(htim, OPTICAL_IC_CHANNEL);
+    uint32_t high = ic_overflow_count;
+
+    // CC ve update aynı kesmede bekliyorsa: yakalama taşmadan sonra olduysa
+    // (değer küçük) henüz sayılmamış taşmayı ekle
+    if (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE) && capture < 0x8000U) {
+        high++;
+    }
+
+    EdgeQueue_Push(&edge_queue, (high << 16) | capture);
+    PROFILE_END(PROF_OPTICAL_CAPTURE);
+}
+
+uint32_t OpticalSensor_GetTimestamp(void) {
+    if (ic_htim == NULL) {
+        return HAL_GetTick() * (OPTICAL_IC_TICK_HZ / 1000U);
+    }
+
+    uint32_t high, count;
+    do {
+        high = ic_overflow_count;
+        count = __HAL_TIM_GET_COUNTER(ic_htim);
+    } while (high != ic_overflow_count);
+
+    if (__HAL_TIM_GET_FLAG(ic_htim, TIM_FLAG_UPDATE) && count < 0x8000U) {
+        high++;
+    }
+    return (high << 16) | count;
+}
+
+// Kenarı uydurma penceresine ekler. Çözüm double: yazma bölgesinden önce
+// çağrılır. @return 1: uydurma geçerli, *velocity en yeni noktadaki hız
+static uint8_t OpticalSensor_UpdateFit(uint32_t timestamp, q16_t position, q16_t *velocity) {
+    VelFitResult_t fit;
+    VelFit_Add(&vel_fit, timestamp, position);
+    vel_info.fitted = 0;
+    if (!VelFit_Solve(&vel_fit, &fit)) return 0;
     
-    last_interrupt_time = 0;
-    last_reflector_time = 0;
-    last_reflector_position = FIRST_REFLECTOR_DIST; // İlk beklenen reflektör konumu
-    special_zone_flag = 0;
-    info_strip_count = 0;
+    vel_info.accel = fit.accel;
+    vel_info.residual = fit.residual;
+    vel_info.points = fit.points;
+    if (fit.residual > VELFIT_MAX_RESIDUAL || fit.velocity < 0) {
+        vel_info.rejected++;
+        return 0;
+    }
+    *velocity = fit.velocity;
+    vel_info.fitted = 1;
+    return 1;
 }
 
-void OpticalSensor_CalculatePositionVelocity(void) {
-    uint32_t now = HAL_GetTick();
+void OpticalSensor_CalculatePositionVelocity(OpticalUpdate_t *out) {
+    PROFILE_BEGIN(PROF_OPTICAL_CALC);
+    uint32_t now = last_edge_time;
+    const TunnelMarker_t *marker = TunnelMap_Marker(marker_index);
+    out->has_velocity = 0;
     
-    // 1. Zaman farkı ve hız hesaplama
-    if (last_reflector_time != 0) {
-        float dt = (float)(now - last_reflector_time) / 1000.0f; // saniye
-        if (dt > 0.001f) { // Sıfıra bölme koruması
-            float dist = 0.0f;
+    // 1. Hız: önceki işaretten bu yana harita mesafesi / süre
+    //    (reflektörde 4 m, şerit bölgesinde şerit aralığının katı)
+    if (have_last_marker) {
+        uint32_t dt_ticks = now - last_marker_time; // IC tick
+        if (dt_ticks > 0) { // Sıfıra bölme koruması
+            q16_t dist = marker->position - last_marker_pos;
             
-            if (special_zone_flag == 0) {
-                dist = REFLECTOR_SPACING; // Normal 4m
-            } else if (special_zone_flag == 1 || special_zone_flag == 2) {
-                dist = INFO_STRIP_SPACING; // Özel bölgede 5 cm
-            }
+            // v = dist * f_tick / dt_ticks: kenar başına tek 64/32 bölme
+            uint64_t v = ((uint64_t)(uint32_t)dist * OPTICAL_IC_TICK_HZ) / dt_ticks;
+            vel_info.two_point = (v > INT32_MAX) ? INT32_MAX : (q16_t)v;
             
-            VehicleState.current_velocity = dist / dt;
+            // Kapı tahmini: aralık hızı aralığın ortasına aittir, ivme iki
+            // aralığın orta anları arasından. Sadece reflektörden başlayan
+            // aralıklar: kısa şerit aralıkları ve düzeltilmemiş şerit sayımı
+            // tahmini bozar
+            if (last_marker_reflector) {
+                uint32_t mid = last_marker_time + dt_ticks / 2U;
+                int32_t span = (int32_t)(mid - gate_ref_time);
+                if (gate_refs > 0 && span > 0) {
+                    int64_t a = ((int64_t)(vel_info.two_point - gate_ref_velocity) *
+                                 OPTICAL_IC_TICK_HZ) / span;
+                    if (a > OPTICAL_GATE_MAX_ACCEL) a = OPTICAL_GATE_MAX_ACCEL;
+                    if (a < -OPTICAL_GATE_MAX_ACCEL) a = -OPTICAL_GATE_MAX_ACCEL;
+                    gate_accel = (q16_t)a;
+                }
+                gate_ref_velocity = vel_info.two_point;
+                gate_ref_time = mid;
+                if (gate_refs < 2U) gate_refs++;
+            }
+            out->velocity = vel_info.two_point;
+            out->has_velocity = 1;
         }
     }
     
-    // 2. Konum güncelleme
-    // Reflektör sayısına göre konum hesapla
-    if (VehicleState.reflector_count == 0) {
-        VehicleState.current_position = FIRST_REFLECTOR_DIST;
-    } else {
-        // Normalde 4m ilerle, ama özel bölgedeyse farklı
-        if (special_zone_flag == 0) {
-            VehicleState.current_position = FIRST_REFLECTOR_DIST + (VehicleState.reflector_count * REFLECTOR_SPACING);
-        } else {
-            // Özel bölgede konum, bölge başlangıcı + (info_strip_count * 0.05)
-            float zone_start = (special_zone_flag == 1) ? LAST_100M_MARK_START : LAST_48M_MARK_START;
-            VehicleState.current_position = zone_start + (info_strip_count * INFO_STRIP_SPACING);
+    // 2. Konum ve bölge doğrudan tablodan
+    out->position = marker->position;
+    out->reflector_count = marker->reflector_seq;
+    if (marker->zone != TUNNEL_ZONE_NONE && marker->zone != current_zone) {
+        zone_entries++;
+    }
+    current_zone = marker->zone;
+    
+    // 3. Son güncelleme zamanı
+    marker_index++;
+    last_marker_time = now;
+    last_marker_pos = marker->position;
+    have_last_marker = 1;
+    last_marker_reflector = (marker->type == TUNNEL_MARKER_REFLECTOR);
+    PROFILE_END(PROF_OPTICAL_CALC);
+}
+
+// Sonucu okuyuculara tek seferde görünür yapar. Hesap ve kayıt bölgeden
+// önce/sonra: kesmeler yalnız hazır değerler saklanırken kapalı
+static void OpticalSensor_Publish(const OpticalUpdate_t *update, uint8_t status) {
+    uint32_t time_ms = HAL_GetTick();
+    uint32_t key = SharedData_WriteBegin();
+    VehicleState.current_position = update->position;
+    if (update->has_velocity) VehicleState.current_velocity = update->velocity;
+    VehicleState.reflector_count = update->reflector_count;
+    VehicleState.optical_time_ms = time_ms;
+    VehicleState.system_status = status;
+    SharedData_WriteEnd(key);
+}
+
+// Kenar işleme ve kaydı: kuyruktan ya da yazılımla üretilen kenar
+static void OpticalSensor_Edge(uint32_t timestamp) {
+    OpticalSensor_HandleEdge(timestamp);
+    FlightRecorder_Nav(FLIGHTREC_EDGE, timestamp);
+    EventLog_Event(EVLOG_EV_EDGE, timestamp, (int32_t)VehicleState.reflector_count);
+}
+
+// Yazılımla üretilen kenar (otomatik simülasyon, self-test). Kuyruğa
+// yazmaz: tek üreticisi yakalama kesmesi. Tüketici bağlamında çalışır,
+// önce kuyrukta bekleyen yakalamalar işlenir (sıra korunur)
+void OpticalSensor_SoftwareEdge(void) {
+    OpticalSensor_Process();
+    
+    PROFILE_BEGIN(PROF_OPTICAL_SOFT);
+    OpticalSensor_Edge(OpticalSensor_GetTimestamp());
+    PROFILE_END(PROF_OPTICAL_SOFT);
+}
+
+uint32_t OpticalSensor_Process(void) {
+    EdgeEvent_t ev;
+    uint32_t processed = 0;
+    
+    // Kuyrukta ne varsa sırayla işle (en fazla kuyruk boyu kadar, ISR yeni
+    // olay eklemeye devam etse bile ana döngü burada takılmasın)
+    while (processed < EDGE_QUEUE_SIZE && EdgeQueue_Pop(&edge_queue, &ev)) {
+        OpticalSensor_Edge(ev.timestamp);
+        processed++;
+    }
+    
+    // Sonraki kenarı beklemeden biten şerit grubunu çöz. Tek kenarlı grubun
+    // kapanması da kaydedilir: sonraki kenar o grubun şeridi sayılmaz
+    uint32_t now = OpticalSensor_GetTimestamp();
+    if (OpticalSensor_PollStrips(now)) {
+        FlightRecorder_Nav(FLIGHTREC_STRIP, now);
+    }
+    return processed;
+}
+
+// @return 1: açık grup kapandı (çözülmüş olması gerekmez)
+static uint8_t OpticalSensor_PollStrips(uint32_t now) {
+    if (!StripDecoder_Pending()) return 0;
+    
+    StripFix_t fix;
+    if (StripDecoder_Poll(now, &fix)) {
+        OpticalSensor_ApplyStripFix(&fix);
+    }
+    return !StripDecoder_Pending();
+}
+
+void OpticalSensor_ReplayEdge(uint32_t timestamp) {
+    OpticalSensor_HandleEdge(timestamp);
+}
+
+uint8_t OpticalSensor_ReplayStrip(uint32_t now) {
+    return OpticalSensor_PollStrips(now);
+}
+
+void OpticalSensor_GetMarkerStats(OpticalMarkerStats_t *stats) {
+    *stats = marker_stats;
+}
+
+// Çözülen şerit grubu: konumu grubun mutlak konumuna, işaret indeksini grubun
+// arkasına hizala (kenar sayımı kaymışsa burada düzelir)
+static void OpticalSensor_ApplyStripFix(const StripFix_t *fix) {
+    marker_stats.last_confidence = fix->confidence;
+    if (fix->zone == TUNNEL_ZONE_NONE || fix->confidence < STRIP_MIN_CONFIDENCE) return;
+    
+    // Kapı tahmini çalışıyorsa grup, izlenen konumun bir reflektör aralığı
+    // yakınında olmalı; uzaktaki grupla eşleşme (çok şerit kaybı) yanlıştır
+    if (gate_refs >= 2U && have_last_marker) {
+        q16_t expected = last_marker_pos + OpticalSensor_PredictTravel(fix->timestamp);
+        q16_t err = (fix->position > expected) ? fix->position - expected : expected - fix->position;
+        if (err > (q16_t)(((int64_t)TunnelMap_Params()->reflector_pitch * OPTICAL_GATE_WINDOW) >> 16)) {
+            marker_stats.strip_rejected++;
+            return;
         }
     }
     
-    // 3. Özel bölge kontrolü
-    if (VehicleState.current_position >= LAST_100M_MARK_START && 
-        VehicleState.current_position < (LAST_100M_MARK_START + 4.0f)) {
-        special_zone_flag = 1;
-    } else if (VehicleState.current_position >= LAST_48M_MARK_START && 
-               VehicleState.current_position < (LAST_48M_MARK_START + 4.0f)) {
-        special_zone_flag = 2;
-    } else {
-        special_zone_flag = 0;
-        info_strip_count = 0;
+    if (marker_index != fix->next_marker) {
+        marker_stats.strip_resyncs++;
+        // Penceredeki işaretlere yanlış konum verilmiş: uydurma gruptan başlar
+        VelFit_Reset(&vel_fit);
+        VelFit_Add(&vel_fit, fix->timestamp, fix->position);
     }
+    marker_index = fix->next_marker;
+    last_marker_time = fix->timestamp;
+    last_marker_pos = fix->position;
+    have_last_marker = 1;
+    last_marker_reflector = 0;
+    current_zone = fix->zone;
     
-    // 4. Son güncelleme zamanı
-    last_reflector_time = now;
-    VehicleState.last_update_time = now;
+    // Durum yalnız ana döngüde yazılır (burası ve fren denetçisi): bölge dışında okunabilir
+    OpticalUpdate_t update = {
+        .position = fix->position,
+        .velocity = fix->velocity,
+        .reflector_count = TunnelMap_Marker(fix->next_marker - 1U)->reflector_seq,
+        .has_velocity = 1,
+    };
+    OpticalSensor_Publish(&update, VehicleState.system_status);
     
-    // DEBUG: Her reflektörde UART'a yaz
-#ifdef DEBUG_MODE
-    printf("[OPTICAL] Reflektör: %lu, Konum: %.2fm, Hız: %.2fm/s, Durum: %d\n", 
-           VehicleState.reflector_count, 
-           VehicleState.current_position, 
-           VehicleState.current_velocity,
-           special_zone_flag);
-#endif
+    marker_stats.strip_fixes++;
+    
+    // Güven düştükçe ölçüm belirsizliği büyür
+    q16_t std = (q16_t)(((int64_t)FUSION_REFLECTOR_STD * 100) / fix->confidence);
+    Fusion_PositionFix(FUSION_SRC_OPTICAL, fix->position, std, fix->timestamp);
+}
+
+void OpticalSensor_GetVelocity(OpticalVelocity_t *out) {
+    *out = vel_info;
+    out->updates = vel_fit.updates;
+    out->rebuilds = vel_fit.rebuilds;
+    out->restarts = vel_fit.restarts;
 }
 
-void OpticalSensor_EXTI_Callback(uint16_t GPIO_Pin) {
-    if (GPIO_Pin != OPTICAL_SENSOR_PIN) return;
+void OpticalSensor_GetQueueStats(uint32_t *overflow_count, uint32_t *high_water, uint32_t *producer_faults) {
+    *overflow_count = edge_queue.overflow_count;
+    *high_water = edge_queue.high_water;
+    *producer_faults = edge_queue.producer_faults;
+}
+
+void OpticalSensor_SetBraking(uint32_t onset, q16_t decel) {
+    gate_brake_onset = onset;
+    gate_brake_decel = decel;
+    FlightRecorder_Brake(onset, decel);
+}
+
+// Referans hızın ivmeyle t anına taşınması (fren tutmadan önceki model).
+// İvme en fazla OPTICAL_GATE_ACCEL_HORIZON ileri taşınır (kayıp işaretli
+// uzun boşlukta kapsül seyir hızına ulaşmış olabilir).
+static int64_t OpticalSensor_GateVelocity(uint32_t t) {
+    int32_t age = (int32_t)(t - gate_ref_time);
+    if (age > (int32_t)OPTICAL_GATE_ACCEL_HORIZON) age = (int32_t)OPTICAL_GATE_ACCEL_HORIZON;
+    return gate_ref_velocity + ((int64_t)gate_accel * age) / OPTICAL_IC_TICK_HZ;
+}
+
+// Son işaretten bu yana tahmini yol: referans hız, ivmeyle [son işaret, şimdi]
+// aralığının ortasına taşınır. Fren tuttuktan sonraki kısım denetçinin
+// yavaşlamasıyla (ölçülmeden nominal) doğrusal azalan hızla, durunca 0:
+// frenlerken görülmeyen reflektör de kat edilen yoldan çıkarılabilir.
+// İvme henüz bilinmiyorsa (ilk üç işaret) veya kapsül durmuş görünüyorsa 0.
+static q16_t OpticalSensor_PredictTravel(uint32_t timestamp) {
+    if (gate_refs < 2U || !have_last_marker) return 0;
+    
+    uint32_t onset = gate_brake_onset;
+    q16_t decel = gate_brake_decel;
+    uint8_t braking = decel > 0 && (int32_t)(timestamp - onset) > 0;
+    uint32_t start = last_marker_time;
+    int64_t travel = 0;
+    
+    // 1. Fren tutmadan önceki kısım: aralık ortasındaki hızla
+    uint32_t pre_end = timestamp;
+    if (braking) pre_end = ((int32_t)(onset - start) > 0) ? onset : start;
+    uint32_t pre_ticks = pre_end - start;
+    if (pre_ticks > 0) {
+        int64_t v = OpticalSensor_GateVelocity(start + pre_ticks / 2U);
+        if (v > 0) travel = (v * pre_ticks) / OPTICAL_IC_TICK_HZ;
+    }
+    
+    // 2. Frenleme: tutma anındaki hızdan doğrusal azalma. Referans aralık
+    //    tutmadan sonraysa (ivmesi frenden) hız referanstan geri taşınır
+    if (braking) {
+        int64_t v_onset;
+        if ((int32_t)(gate_ref_time - onset) > 0) {
+            v_onset = gate_ref_velocity + ((int64_t)decel * (gate_ref_time - onset)) / OPTICAL_IC_TICK_HZ;
+        } else {
+            v_onset = OpticalSensor_GateVelocity(onset);
+        }
+        int64_t v_a = v_onset - ((int64_t)decel * (pre_end - onset)) / OPTICAL_IC_TICK_HZ;
+        int64_t v_b = v_onset - ((int64_t)decel * (timestamp - onset)) / OPTICAL_IC_TICK_HZ;
+        if (v_a > 0) {
+            if (v_b >= 0) {
+                travel += ((v_a + v_b) * (int64_t)(timestamp - pre_end)) / (2 * (int64_t)OPTICAL_IC_TICK_HZ);
+            } else {
+                travel += (v_a * v_a) / (2 * (int64_t)decel); // Aralık içinde durdu: v^2 / 2a
+            }
+        }
+    }
+    return (travel > INT32_MAX) ? INT32_MAX : (q16_t)travel;
+}
+
+// Kenar kapısı. Adaylar: sıradaki reflektörler ve şerit gruplarının ilk
+// şeridi (grup içi şeritleri patlama tarafı sayar). Tahmini yola en yakın
+// aday penceresi içindeyse kabul edilir, *index ona ayarlanır.
+// @return 1: kabul, 0: parazit
+static uint8_t OpticalSensor_Gate(uint32_t timestamp, uint16_t *index) {
+    *index = marker_index;
+    q16_t travel = OpticalSensor_PredictTravel(timestamp);
+    if (travel <= 0) return 1;
     
-    uint32_t now = HAL_GetTick();
+    q16_t best_err = INT32_MAX;
+    q16_t best_dist = 0;
+    for (uint16_t i = marker_index; ; i++) {
+        const TunnelMarker_t *m = TunnelMap_Marker(i);
+        if (m == NULL) break;
+        if (m->type == TUNNEL_MARKER_STRIP && m->zone_index > 0) continue;
+        
+        q16_t dist = m->position - last_marker_pos;
+        q16_t err = (travel > dist) ? travel - dist : dist - travel;
+        if (err >= best_err) break; // Adaylar konuma göre sıralı: hata büyümeye başladı
+        *index = i;
+        best_err = err;
+        best_dist = dist;
+    }
+    
+    q16_t window = (q16_t)(((int64_t)best_dist * OPTICAL_GATE_WINDOW) >> 16);
+    if (best_err > window) {
+        // Tahmin bozulduysa (ör. ani fren) kapı kendini kilitlemesin
+        if (++gate_rejects < OPTICAL_GATE_MAX_REJECTS) {
+            marker_stats.gate_rejected++;
+            return 0;
+        }
+        marker_stats.gate_reacquired++;
+    }
+    gate_rejects = 0;
+    return 1;
+}
+
+// Son işaretten bu yana kaç şerit aralığı gidildi (son hızla, en az 1)
+static uint32_t OpticalSensor_StripSteps(uint32_t timestamp, const TunnelMarker_t *marker) {
+    q16_t pitch = marker->position - last_marker_pos;
+    if (pitch <= 0 || VehicleState.current_velocity <= 0) return 1;
     
-    // Debounce (20ms'den kısa tetiklemeleri yok say)
-    if (now - last_interrupt_time < 20) return;
-    last_interrupt_time = now;
+    uint64_t travel = ((uint64_t)(uint32_t)VehicleState.current_velocity * (timestamp - last_marker_time)) /
+                      OPTICAL_IC_TICK_HZ;
+    uint32_t steps = (uint32_t)((travel + (uint32_t)pitch / 2U) / (uint32_t)pitch);
+    return (steps == 0) ? 1U : steps;
+}
+
+static void OpticalSensor_HandleEdge(uint32_t timestamp) {
+    // Kısa parazit donanımda süzülür (OPTICAL_IC_FILTER); yanlış yerdeki
+    // kenarları aşağıdaki kapı ayıklar
+    last_edge_time = timestamp;
     
     // TEST NOKTASI 1: Sensör sinyali alındı
     HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13); // LED toggle
     
-    // Özel bölgede miyiz? (5cm aralıklı şeritler)
-    if (special_zone_flag > 0) {
-        info_strip_count++;
-        // Özel bölgede her 5cm'de bir kesme gelir, ama biz her 5cm'de konum hesaplamak istemiyoruz
-        // Burada sadece sayıyoruz, asıl konum hesaplama ayrı thread'de yapılacak
+    // Uzun aralıkla gelen kenar önceki şerit grubunu kapatır; sayım kaymışsa
+    // bu kenar işlenmeden önce indeks hizalanır
+    StripFix_t fix;
+    if (StripDecoder_Edge(timestamp, VehicleState.current_velocity, &fix)) {
+        OpticalSensor_ApplyStripFix(&fix);
+    }
+    
+    // Her kenar tablodaki sıradaki işarettir (reflektör ya da şerit)
+    const TunnelMarker_t *marker = TunnelMap_Marker(marker_index);
+    if (marker == NULL) {
+        marker_stats.unmapped_edges++;
+        return;
+    }
+    
+    // Şerit patlaması sürerken harita reflektör bekliyorsa sayım kaymıştır:
+    // kenarı işaret saymadan bekle, grup çözülünce hizalanır
+    if (StripDecoder_InBurst() && marker->type != TUNNEL_MARKER_STRIP) {
+        marker_stats.held_edges++;
+        return;
+    }
+    
+    // Uzun aralıkla gelen kenar grubun ortasındaki bir şerit olamaz: grubun
+    // kalanı görülmedi (ve grup çözülemedi), sayımı grubun arkasına taşı
+    while (marker != NULL && marker->type == TUNNEL_MARKER_STRIP && marker->zone_index > 0 &&
+           !StripDecoder_InBurst()) {
+        marker_stats.skipped_strips++;
+        marker = TunnelMap_Marker(++marker_index);
+    }
+    if (marker == NULL) {
+        marker_stats.unmapped_edges++;
         return;
     }
     
-    // Normal reflektör say
-    VehicleState.reflector_count++;
+    // Uzun aralıkla gelen kenar: beklenen yerde mi? Parazitse sayılmaz,
+    // birkaç işaret ilerideyse aradakiler görülmemiş sayılır
+    // Atlanan işaretle veya pencere dışında kabul edilen kenarın kimliği
+    // kesin değil: füzyona daha büyük belirsizlikle gider
+    q16_t fix_std = FUSION_REFLECTOR_STD;
+    if (!StripDecoder_InBurst()) {
+        uint16_t index;
+        uint32_t reacquired = marker_stats.gate_reacquired;
+        if (!OpticalSensor_Gate(timestamp, &index)) {
+            StripDecoder_Discard();
+            return;
+        }
+        if (marker_stats.gate_reacquired != reacquired) fix_std = FUSION_REACQUIRED_STD;
+        while (marker_index < index) {
+            if (TunnelMap_Marker(marker_index++)->type == TUNNEL_MARKER_REFLECTOR) {
+                marker_stats.gate_inferred++;
+                if (fix_std < FUSION_INFERRED_STD) fix_std = FUSION_INFERRED_STD;
+            } else {
+                marker_stats.skipped_strips++;
+            }
+        }
+        marker = TunnelMap_Marker(marker_index);
+    }
+    
+    // Grup içinde kayıp/birleşik şerit: aralığı son hızla şerit adımına
+    // yuvarla, sayımı aynı grup içinde o kadar ilerlet
+    if (marker->type == TUNNEL_MARKER_STRIP && marker->zone_index > 0 && StripDecoder_InBurst()) {
+        uint32_t steps = OpticalSensor_StripSteps(timestamp, marker);
+        while (steps-- > 1U) {
+            const TunnelMarker_t *next = TunnelMap_Marker(marker_index + 1U);
+            if (next == NULL || next->zone != marker->zone || next->zone_index == 0) break;
+            marker = next;
+            marker_index++;
+            marker_stats.skipped_strips++;
+        }
+    }
+    
+    // Uydurma: pencere dolmadan da (>= VELFIT_MIN_POINTS) iki noktadan az
+    // gürültülü
+    q16_t fit_velocity = 0;
+    uint8_t fitted = OpticalSensor_UpdateFit(timestamp, marker->position, &fit_velocity);
     
     // Konum ve hız hesapla
-    OpticalSensor_CalculatePositionVelocity();
+    marker_stats.gate_accepted++;
+    OpticalUpdate_t update;
+    OpticalSensor_CalculatePositionVelocity(&update);
+    if (fitted) {
+        update.velocity = fit_velocity;
+        update.has_velocity = 1;
+    }
     
-    // Sistem durumunu güncelle
-    if (VehicleState.current_position >= (186.0f - 10.0f)) { // Son 10m kala
-        VehicleState.system_status = SYS_BRAKING;
-    } else if (VehicleState.current_position > TUNNEL_START_OFFSET) {
-        VehicleState.system_status = SYS_RUNNING;
+    // Sistem durumunu güncelle (fren kararı brake_supervisor'da). Durumu
+    // yalnız ana döngü yazar: karar bölge dışında verilir
+    uint8_t from = VehicleState.system_status;
+    uint8_t status = from;
+    if (from != SYS_BRAKING && from != SYS_RUNNING && update.position > TunnelMap_Params()->start_offset) {
+        status = SYS_RUNNING;
+    }
+    
+    // Konum, hız ve durum okuyuculara tek seferde görünür
+    OpticalSensor_Publish(&update, status);
+    if (status != from) {
+        FlightRecorder_State(timestamp, from, status, FLIGHTREC_SRC_OPTICAL);
+    }
+    
+    // DEBUG: Her reflektörde UART'a yaz
+#ifdef DEBUG_MODE
+    printf("[OPTICAL] Reflektör: %lu, Konum: %.2fm, Hız: %.2fm/s, Bölge: %d\n", 
+           VehicleState.reflector_count, 
+           Q16_TO_FLOAT(VehicleState.current_position), 
+           Q16_TO_FLOAT(VehicleState.current_velocity),
+           current_zone);
+#endif
+    
+    // Reflektör konumu füzyon için mutlak düzeltme (kenar anıyla); şeritler
+    // grup olarak çözülünce tek düzeltme verir
+    if (marker->type == TUNNEL_MARKER_REFLECTOR) {
+        Fusion_PositionFix(FUSION_SRC_OPTICAL, marker->position, fix_std, timestamp);
     }
 }
 
 // ============= GERÇEK SENSÖR TEST FONKSİYONU (GÜNCELLENMİŞ) =============
-void OpticalSensor_RealTest(void) {
+// Zamanlayıcının test görevinden 100 Hz'de adımlanır; durum adımlar arasında burada
+FW_STATE struct {
+    uint32_t last_print_time;
+    uint32_t start_time;
+    q16_t max_velocity;
+    float test_speed_mps;
+    float time_between_reflectors;
+    uint32_t last_simulated_interrupt;
+    uint8_t interrupt_ready;
+} real_test;
+
+void OpticalSensor_RealTestStart(void) {
     printf("\n=== GERÇEK SENSÖR TESTİ BAŞLATILIYOR ===\n");
     printf("Bu test sensör sinyallerini simüle eder.\n");
     printf("Her reflektörde LED yanıp sönecek ve konum/hız hesaplanacak.\n");
@@ -131,151 +599,162 @@ void OpticalSensor_RealTest(void) {
     // Başlangıçta LED'i sıfırla
     HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
     
-    uint32_t last_print_time = HAL_GetTick();
-    uint32_t start_time = HAL_GetTick();
-    float max_velocity = 0.0f;
-    uint8_t test_running = 1;
-    uint8_t received_char = 0;
+    real_test.last_print_time = HAL_GetTick();
+    real_test.start_time = HAL_GetTick();
+    real_test.max_velocity = 0;
     
     // 2. TEST PARAMETRELERİ
-    float test_speed_mps = 8.0f; // Test hızı: 8 m/s
-    float time_between_reflectors = REFLECTOR_SPACING / test_speed_mps * 1000.0f; // ms cinsinden
-    uint32_t last_simulated_interrupt = 0;
-    uint8_t interrupt_ready = 1;
+    real_test.test_speed_mps = 8.0f; // Test hızı: 8 m/s
+    const TunnelParams_t *map = TunnelMap_Params();
+    real_test.time_between_reflectors = Q16_TO_FLOAT(TunnelMap_Marker(0)->position - map->start_offset) /
+                                        real_test.test_speed_mps * 1000.0f; // ms cinsinden
+    real_test.last_simulated_interrupt = 0;
+    real_test.interrupt_ready = 1;
     
     printf("Test parametreleri:\n");
-    printf("- Hız: %.1f m/s\n", test_speed_mps);
-    printf("- Reflektörler arası süre: %.0f ms\n", time_between_reflectors);
-    printf("- Tünel uzunluğu: 186 m\n");
-    printf("- İlk reflektör: %.1f m\n", FIRST_REFLECTOR_DIST);
+    printf("- Hız: %.1f m/s\n", real_test.test_speed_mps);
+    printf("- Reflektörler arası süre: %.0f ms\n", real_test.time_between_reflectors);
+    printf("- Tünel uzunluğu: %.0f m\n", Q16_TO_FLOAT(map->end_position));
+    printf("- İlk reflektör: %.1f m\n", Q16_TO_FLOAT(map->reflector_first));
     printf("\nTest başlıyor...\n");
-    
-    // 3. TEST DÖNGÜSÜ - Gerçek sensör sinyallerini simüle et
-    while (test_running) {
-        uint32_t current_time = HAL_GetTick();
-        
-        // A) SİMÜLE EDİLMİŞ SENSÖR KESMELERİ
-        if (interrupt_ready && (current_time - last_simulated_interrupt > time_between_reflectors)) {
-            // Sensör kesmesini simüle et (EXTI_Callback'i çağır)
-            printf("\n[SENSÖR SİNYALİ] Reflektör #%lu algılandı!\n", VehicleState.reflector_count + 1);
-            
-            // Gerçek EXTI callback fonksiyonunu çağır (simüle edilmiş)
-            OpticalSensor_EXTI_Callback(OPTICAL_SENSOR_PIN);
-            
-            // Hız ve konum hesaplaması yap (CalculatePositionVelocity zaten callback içinde çağrılıyor)
-            // Ama debug için burada da çağıralım
-            OpticalSensor_CalculatePositionVelocity();
-            
-            last_simulated_interrupt = current_time;
-            
-            // Özel bölge kontrolü - zamanı değiştir
-            if (VehicleState.current_position >= LAST_100M_MARK_START && 
-                VehicleState.current_position < (LAST_100M_MARK_START + 4.0f)) {
-                // Son 100m işaretinde 5cm aralıklı şeritler
-                time_between_reflectors = 0.05f / test_speed_mps * 1000.0f;
-                printf("  [ÖZEL BÖLGE] Son 100m işaretine girildi! (5cm aralık)\n");
-            }
-            else if (VehicleState.current_position >= LAST_48M_MARK_START && 
-                     VehicleState.current_position < (LAST_48M_MARK_START + 4.0f)) {
-                // Son 48m işaretinde 5cm aralıklı şeritler
-                time_between_reflectors = 0.05f / test_speed_mps * 1000.0f;
-                printf("  [ÖZEL BÖLGE] Son 48m işaretine girildi! (5cm aralık)\n");
-            }
-            else {
-                // Normal bölgede 4m aralık
-                time_between_reflectors = REFLECTOR_SPACING / test_speed_mps * 1000.0f;
-            }
-        }
-        
-        // B) EKRAN ÇIKTISI (her 200ms'de bir)
-        if (current_time - last_print_time > 200) {
-            printf("Konum: %6.2fm | Hız: %5.2fm/s | Reflektör: %3lu | Durum: %d",
-                   VehicleState.current_position,
-                   VehicleState.current_velocity,
-                   VehicleState.reflector_count,
-                   VehicleState.system_status);
-            
-            // Özel bölge bilgisi
-            if (special_zone_flag == 1) {
-                printf(" [SON 100M]");
-            } else if (special_zone_flag == 2) {
-                printf(" [SON 48M]");
-            }
-            
-            printf("          \r"); // Satırı temizle
-            
-            last_print_time = current_time;
-            
-            // Maksimum hızı takip et
-            if (VehicleState.current_velocity > max_velocity) {
-                max_velocity = VehicleState.current_velocity;
-            }
-            
-            // Tünel sonuna ulaşıldı mı?
-            if (VehicleState.current_position >= 186.0f) {
-                printf("\n\nTÜNEL SONUNA ULAŞILDI!\n");
-                test_running = 0;
-            }
-        }
-        
-        // C) KULLANICI GİRİŞİ KONTROLÜ (testi durdurmak için)
-        // Not: HAL_UART_Receive için huart1 tanımlı olmalı
-        #ifdef USE_UART_INPUT
-        if (HAL_UART_Receive(&huart1, &received_char, 1, 10) == HAL_OK) {
-            if (received_char == 'q' || received_char == 'Q') {
-                printf("\n\nTest kullanıcı tarafından durduruldu.\n");
-                test_running = 0;
-            } else if (received_char == 's') {
-                // Hızı değiştir
-                test_speed_mps += 2.0f;
-                if (test_speed_mps > 20.0f) test_speed_mps = 4.0f;
-                printf("\nHız değiştirildi: %.1f m/s\n", test_speed_mps);
-                time_between_reflectors = REFLECTOR_SPACING / test_speed_mps * 1000.0f;
-            }
-        }
-        #endif
-        
-        // Küçük bir bekleme (CPU'yu meşgul etmemek için)
-        HAL_Delay(10);
-    }
-    
+}
+
+static void OpticalSensor_RealTestSummary(void) {
     // 4. TEST ÖZETİ
-    uint32_t test_duration = HAL_GetTick() - start_time;
+    uint32_t test_duration = HAL_GetTick() - real_test.start_time;
     printf("\n\n=== TEST ÖZETİ ===\n");
     printf("Test süresi: %.1f saniye\n", test_duration / 1000.0f);
-    printf("Son konum: %.2f m\n", VehicleState.current_position);
-    printf("Maksimum hız: %.2f m/s\n", max_velocity);
+    printf("Son konum: %.2f m\n", Q16_TO_FLOAT(VehicleState.current_position));
+    printf("Maksimum hız: %.2f m/s\n", Q16_TO_FLOAT(real_test.max_velocity));
     printf("Toplam reflektör: %lu\n", VehicleState.reflector_count);
     
     if (VehicleState.reflector_count > 0) {
-        float avg_speed = VehicleState.current_position / (test_duration / 1000.0f);
+        float avg_speed = Q16_TO_FLOAT(VehicleState.current_position) / (test_duration / 1000.0f);
         printf("Ortalama hız: %.2f m/s\n", avg_speed);
         
         // Teorik vs gerçek hız karşılaştırması
-        printf("Teorik hız: %.2f m/s\n", test_speed_mps);
-        printf("Hata oranı: %.1f%%\n", fabs((test_speed_mps - avg_speed) / test_speed_mps * 100.0f));
+        printf("Teorik hız: %.2f m/s\n", real_test.test_speed_mps);
+        printf("Hata oranı: %.1f%%\n", fabs((real_test.test_speed_mps - avg_speed) / real_test.test_speed_mps * 100.0f));
     }
     
     // 5. TÜM FONKSİYONLARIN ÇALIŞTIĞINI GÖSTEREN DEBUG
     printf("\n=== FONKSİYON TEST SONUÇLARI ===\n");
     printf("1. OpticalSensor_Init() - %s\n", (VehicleState.system_status == SYS_READY) ? "OK" : "FAIL");
-    printf("2. OpticalSensor_EXTI_Callback() - %s\n", (VehicleState.reflector_count > 0) ? "OK" : "FAIL");
+    printf("2. OpticalSensor_SoftwareEdge() - %s\n", (VehicleState.reflector_count > 0) ? "OK" : "FAIL");
     printf("3. OpticalSensor_CalculatePositionVelocity() - %s\n", (VehicleState.current_velocity > 0) ? "OK" : "FAIL");
-    printf("4. Debounce kontrolü - %s\n", "OK (20ms kontrolü)");
-    printf("5. Özel bölge tespiti - %s\n", (special_zone_flag > 0 || VehicleState.current_position > 97.0f) ? "OK" : "N/A");
+    printf("4. Kenar kapısı - OK (red %lu, çıkarılan reflektör %lu)\n", marker_stats.gate_rejected,
+           marker_stats.gate_inferred);
+    printf("5. Özel bölge tespiti - %s\n", (zone_entries > 0) ? "OK" : "N/A");
     printf("6. Sistem durum güncellemesi - %s\n", (VehicleState.system_status == SYS_RUNNING || 
                                                    VehicleState.system_status == SYS_BRAKING) ? "OK" : "FAIL");
     
     OpticalSensor_DebugOutput();
 }
 
+uint8_t OpticalSensor_RealTestStep(void) {
+    uint32_t current_time = HAL_GetTick();
+    uint8_t test_running = 1;
+    
+    // A) SİMÜLE EDİLMİŞ SENSÖR KESMELERİ
+    if (real_test.interrupt_ready &&
+        (current_time - real_test.last_simulated_interrupt > real_test.time_between_reflectors)) {
+        // Sensör kesmesini simüle et: kenar kuyruğu atlanır, konum/hız hemen hesaplanır
+        printf("\n[SENSÖR SİNYALİ] Reflektör #%lu algılandı!\n", VehicleState.reflector_count + 1);
+        OpticalSensor_SoftwareEdge();
+        
+        real_test.last_simulated_interrupt = current_time;
+        
+        // Sıradaki işarete kalan mesafe tablodan - zamanı değiştir
+        const TunnelMarker_t *next = TunnelMap_Marker(marker_index);
+        if (next != NULL) {
+            real_test.time_between_reflectors = Q16_TO_FLOAT(next->position - VehicleState.current_position) /
+                                                real_test.test_speed_mps * 1000.0f;
+        } else {
+            real_test.interrupt_ready = 0; // Son işaret geçildi
+        }
+        if (current_zone != TUNNEL_ZONE_NONE && TunnelMap_Marker(marker_index - 1U)->zone_index == 0) {
+            printf("  [ÖZEL BÖLGE] %s işaretine girildi! (%.0f ms aralık)\n",
+                   (current_zone == TUNNEL_ZONE_LAST_100M) ? "Son 100m" : "Son 48m",
+                   real_test.time_between_reflectors);
+        }
+    }
+    
+    // B) EKRAN ÇIKTISI (her 200ms'de bir)
+    if (current_time - real_test.last_print_time > 200) {
+        printf("Konum: %6.2fm | Hız: %5.2fm/s | Reflektör: %3lu | Durum: %d",
+               Q16_TO_FLOAT(VehicleState.current_position),
+               Q16_TO_FLOAT(VehicleState.current_velocity),
+               VehicleState.reflector_count,
+               VehicleState.system_status);
+        
+        // Özel bölge bilgisi
+        if (current_zone == TUNNEL_ZONE_LAST_100M) {
+            printf(" [SON 100M]");
+        } else if (current_zone == TUNNEL_ZONE_LAST_48M) {
+            printf(" [SON 48M]");
+        }
+        
+        printf("          \r"); // Satırı temizle
+        
+        real_test.last_print_time = current_time;
+        
+        // Maksimum hızı takip et
+        if (VehicleState.current_velocity > real_test.max_velocity) {
+            real_test.max_velocity = VehicleState.current_velocity;
+        }
+        
+        // Tünel sonuna ulaşıldı mı?
+        if (!real_test.interrupt_ready) {
+            printf("\n\nTÜNEL SONUNA ULAŞILDI!\n");
+            test_running = 0;
+        }
+    }
+    
+    // C) KULLANICI GİRİŞİ KONTROLÜ (testi durdurmak için)
+    // Not: HAL_UART_Receive için huart1 tanımlı olmalı; zaman aşımı 0, adım beklemez
+    #ifdef USE_UART_INPUT
+    uint8_t received_char = 0;
+    if (HAL_UART_Receive(&huart1, &received_char, 1, 0) == HAL_OK) {
+        if (received_char == 'q' || received_char == 'Q') {
+            printf("\n\nTest kullanıcı tarafından durduruldu.\n");
+            test_running = 0;
+        } else if (received_char == 's') {
+            // Hızı değiştir
+            real_test.test_speed_mps += 2.0f;
+            if (real_test.test_speed_mps > 20.0f) real_test.test_speed_mps = 4.0f;
+            printf("\nHız değiştirildi: %.1f m/s\n", real_test.test_speed_mps);
+            real_test.time_between_reflectors = Q16_TO_FLOAT(TunnelMap_Params()->reflector_pitch) /
+                                                real_test.test_speed_mps * 1000.0f;
+        }
+    }
+    #endif
+    
+    if (!test_running) {
+        OpticalSensor_RealTestSummary();
+    }
+    return test_running;
+}
+
 void OpticalSensor_DebugOutput(void) {
     printf("\n--- OPTICAL SENSOR DEBUG ---\n");
     printf("Reflektör Sayısı: %lu\n", VehicleState.reflector_count);
-    printf("Güncel Konum: %.2f m\n", VehicleState.current_position);
-    printf("Güncel Hız: %.2f m/s\n", VehicleState.current_velocity);
+    printf("Güncel Konum: %.2f m\n", Q16_TO_FLOAT(VehicleState.current_position));
+    printf("Güncel Hız: %.2f m/s (%s; iki nokta %.2f m/s)\n", Q16_TO_FLOAT(VehicleState.current_velocity),
+           vel_info.fitted ? "uydurma" : "iki nokta", Q16_TO_FLOAT(vel_info.two_point));
+    printf("Hız uydurması: %u işaret, ivme %.2f m/s^2, artık %.1f mm | reddedilen %lu | yeniden kurulum %lu/%lu\n",
+           vel_info.points, Q16_TO_FLOAT(vel_info.accel), Q16_TO_FLOAT(vel_info.residual) * 1000.0f,
+           vel_info.rejected, vel_fit.rebuilds, vel_fit.updates);
     printf("Sistem Durumu: %d\n", VehicleState.system_status);
-    printf("Özel Bölge Flag: %d\n", special_zone_flag);
-    printf("Bilgi Şerit Sayacı: %d\n", info_strip_count);
+    printf("Bölge: %d (giriş %lu)\n", current_zone, zone_entries);
+    printf("İşaret: %u/%u (harita dışı kenar %lu, bekletilen %lu)\n", marker_index, TunnelMap_Count(),
+           marker_stats.unmapped_edges, marker_stats.held_edges);
+    printf("Kenar kapısı: kabul %lu, red %lu, çıkarılan reflektör %lu, yeniden yakalama %lu\n",
+           marker_stats.gate_accepted, marker_stats.gate_rejected, marker_stats.gate_inferred,
+           marker_stats.gate_reacquired);
+    printf("Şerit düzeltmesi: %lu (hizalama %lu, tahminle çelişen %lu, son güven %u)\n",
+           marker_stats.strip_fixes, marker_stats.strip_resyncs, marker_stats.strip_rejected,
+           marker_stats.last_confidence);
+    printf("Kenar Kuyruğu: taşma %lu, en yüksek doluluk %lu/%u, üretici çakışması %lu\n",
+           edge_queue.overflow_count, edge_queue.high_water, EDGE_QUEUE_SIZE, edge_queue.producer_faults);
     printf("---------------------------\n");
 }
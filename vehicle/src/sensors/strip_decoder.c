@@ -0,0 +1,174 @@
+// strip_decoder.c
+#include "strip_decoder.h"
+#include "fw_state.h"
+#include "optical_sensor.h"
+#include "tunnel_map.h"
+
+FW_STATE uint32_t burst_ts[STRIP_MAX_EDGES];
+FW_STATE uint8_t burst_n = 0;
+FW_STATE uint8_t burst_overflow = 0;
+FW_STATE uint8_t in_burst = 0;
+FW_STATE q16_t burst_velocity = 0;   // Patlama başındaki hız: grup boyunca eşik sabit kalır
+
+FW_STATE StripDecoderStats_t stats;
+
+// STRIP_BURST_GAP'i bu hızla kaç tick'te alırız. Hız henüz yoksa (ilk iki
+// işaret) aralık mesafeye çevrilemez, kenarlar gruplanmaz.
+static uint32_t StripDecoder_GapTicks(q16_t velocity) {
+    if (velocity <= 0) return 0;
+    uint64_t t = ((uint64_t)(uint32_t)STRIP_BURST_GAP * OPTICAL_IC_TICK_HZ) / (uint32_t)velocity;
+    return (t > STRIP_IDLE_TICKS) ? STRIP_IDLE_TICKS : (uint32_t)t;
+}
+
+static uint8_t StripDecoder_Decode(StripFix_t *fix) {
+    q16_t velocity = burst_velocity;
+    uint32_t dt[STRIP_MAX_EDGES - 1];
+    uint32_t sorted[STRIP_MAX_EDGES - 1];
+    uint8_t n = burst_n;
+
+    // 1. Aralıklar ve medyan (tek şerit aralığı); kenar sayısı küçük, eklemeli sıralama
+    for (uint8_t i = 0; i + 1U < n; i++) {
+        dt[i] = burst_ts[i + 1] - burst_ts[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > dt[i]) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = dt[i];
+    }
+    uint32_t median = sorted[(n - 2U) / 2U];
+    if (median == 0) median = 1;
+
+    // 2. Her aralık kaç şerit aralığı: fazlası kayıp ya da birleşik şerit
+    uint32_t steps = 0;
+    uint8_t irregular = burst_overflow;
+    for (uint8_t i = 0; i + 1U < n; i++) {
+        uint32_t k = (dt[i] + median / 2U) / median;
+        if (k == 0) k = 1;
+        uint32_t expect = k * median;
+        uint32_t err = (dt[i] > expect) ? dt[i] - expect : expect - dt[i];
+        if (err * 4U > median) irregular = 1;
+        steps += k;
+    }
+    uint32_t span = steps + 1U;   // Kayıplarla birlikte şerit sayısı
+
+    // 3. En yakın sayılı grup; eşitlik belirsizdir
+    const TunnelParams_t *map = TunnelMap_Params();
+    uint8_t best = 0xFF;
+    uint32_t best_diff = UINT32_MAX;
+    uint8_t ambiguous = 0;
+    for (uint8_t z = 0; z < map->zone_count; z++) {
+        uint32_t count = map->zones[z].count;
+        uint32_t diff = (span > count) ? span - count : count - span;
+        if (diff < best_diff) {
+            best = z;
+            best_diff = diff;
+            ambiguous = 0;
+        } else if (diff == best_diff) {
+            ambiguous = 1;
+        }
+    }
+
+    fix->edges = n;
+    fix->missing = (uint8_t)(steps - (n - 1U));
+    fix->timestamp = burst_ts[n - 1U];
+    fix->zone = TUNNEL_ZONE_NONE;
+    fix->confidence = 0;
+    stats.bursts++;
+    stats.missing += fix->missing;
+
+    if (best == 0xFF || ambiguous || best_diff * 2U > map->zones[best].count) {
+        stats.rejected++;
+        return 1;
+    }
+
+    const TunnelZoneParams_t *zone = &map->zones[best];
+    uint32_t burst_ticks = burst_ts[n - 1U] - burst_ts[0];
+    uint64_t v = (burst_ticks > 0) ?
+                 ((uint64_t)(uint32_t)zone->pitch * steps * OPTICAL_IC_TICK_HZ) / burst_ticks : 0;
+
+    // Şerit hızı mevcut tahminle çok farklıysa bu bir şerit grubu değil
+    if (velocity > 0 && (v * 2U < (uint32_t)velocity || v > 2U * (uint64_t)(uint32_t)velocity)) {
+        irregular = 1;
+    }
+
+    int32_t confidence = 100 - (int32_t)(fix->missing * STRIP_PENALTY_MISSING) -
+                         (int32_t)(best_diff * STRIP_PENALTY_COUNT) - (irregular ? (int32_t)STRIP_PENALTY_IRREGULAR : 0);
+
+    // İlk görülen kenar grubun ilk şeridi varsayılır; fazla kenar grubun sonunda kırpılır
+    uint32_t last = (steps < zone->count) ? steps : zone->count - 1U;
+
+    fix->zone = zone->id;
+    fix->slot = best;
+    fix->confidence = (confidence < 0) ? 0 : (uint8_t)confidence;
+    fix->position = zone->start + (q16_t)last * zone->pitch;
+    fix->velocity = (v > INT32_MAX) ? INT32_MAX : (q16_t)v;
+    fix->next_marker = TunnelMap_ZoneFirstMarker(best) + zone->count;
+
+    if (fix->confidence >= STRIP_MIN_CONFIDENCE) {
+        stats.decoded++;
+    } else {
+        stats.rejected++;
+    }
+    return 1;
+}
+
+void StripDecoder_Init(void) {
+    burst_n = 0;
+    burst_overflow = 0;
+    in_burst = 0;
+    burst_velocity = 0;
+    stats = (StripDecoderStats_t){0};
+}
+
+uint8_t StripDecoder_Edge(uint32_t timestamp, q16_t velocity, StripFix_t *fix) {
+    if (burst_n > 0 && timestamp - burst_ts[burst_n - 1U] < StripDecoder_GapTicks(burst_velocity)) {
+        in_burst = 1;
+        if (burst_n < STRIP_MAX_EDGES) {
+            burst_ts[burst_n++] = timestamp;
+        } else if (!burst_overflow) {
+            burst_overflow = 1;
+            stats.overflow++;
+        }
+        return 0;
+    }
+
+    uint8_t done = (burst_n >= 2U) ? StripDecoder_Decode(fix) : 0;
+    in_burst = 0;
+    burst_overflow = 0;
+    burst_ts[0] = timestamp;
+    burst_n = 1;
+    burst_velocity = velocity;
+    return done;
+}
+
+uint8_t StripDecoder_InBurst(void) {
+    return in_burst;
+}
+
+uint8_t StripDecoder_Pending(void) {
+    return burst_n > 0;
+}
+
+void StripDecoder_Discard(void) {
+    if (burst_n == 1U) {
+        burst_n = 0;
+        in_burst = 0;
+    }
+}
+
+uint8_t StripDecoder_Poll(uint32_t now, StripFix_t *fix) {
+    if (burst_n == 0 || now - burst_ts[burst_n - 1U] < StripDecoder_GapTicks(burst_velocity)) {
+        return 0;
+    }
+
+    uint8_t done = (burst_n >= 2U) ? StripDecoder_Decode(fix) : 0;
+    burst_n = 0;
+    burst_overflow = 0;
+    in_burst = 0;
+    return done;
+}
+
+void StripDecoder_GetStats(StripDecoderStats_t *out) {
+    *out = stats;
+}
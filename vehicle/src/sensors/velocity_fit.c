@@ -0,0 +1,309 @@
+// velocity_fit.c
+#include "velocity_fit.h"
+#include "optical_sensor.h"
+
+#define VELFIT_TIME_LIMIT  (1LL << VELFIT_TIME_BITS)
+#define VELFIT_DISP_LIMIT  (1LL << VELFIT_DISP_BITS)
+#define VELFIT_FRAC        32U    // Çözümdeki bölümlerin kesir biti
+#define VELFIT_FRAC2_MAX   90U    // a2 ölçeği üst sınırı (kaydırmalar <= 126)
+#define VELFIT_ACCEL_BITS  48      // 2 * tick Hz^2 bit uzunluğu üst sınırı
+#define VELFIT_TICK_RECIP  (((1ULL << 40) + OPTICAL_IC_TICK_HZ / 2U) / OPTICAL_IC_TICK_HZ) // 2^40 / tick Hz
+
+// 1/k, Q31 (yukarı yuvarlı): küçük bölenler için çarpma
+#define VELFIT_RECIP(k)    ((uint32_t)((0x80000000ULL + (k) - 1U) / (k)))
+static const uint32_t velfit_recip[VELFIT_WINDOW + 1U] = {
+    0, VELFIT_RECIP(1U), VELFIT_RECIP(2U), VELFIT_RECIP(3U), VELFIT_RECIP(4U),
+#if VELFIT_WINDOW > 4U
+    VELFIT_RECIP(5U),
+#endif
+#if VELFIT_WINDOW > 5U
+    VELFIT_RECIP(6U),
+#endif
+#if VELFIT_WINDOW > 6U
+    VELFIT_RECIP(7U),
+#endif
+#if VELFIT_WINDOW > 7U
+    VELFIT_RECIP(8U),
+#endif
+};
+
+static int64_t VelFit_DivSmall(int64_t x, uint32_t k) {
+    return q64_mul_shift(x, velfit_recip[k], 31U);
+}
+
+static uint8_t VelFit_Index(const VelFit_t *f, uint8_t age) {
+    // age 0: en eski nokta
+    return (uint8_t)((f->head + VELFIT_WINDOW - f->n + age) % VELFIT_WINDOW);
+}
+
+// Çerçeve içi zaman: 2^shift tick birime yuvarlanmış (başlangıçtan önce negatif)
+static int64_t VelFit_Time(const VelFit_t *f, uint32_t t) {
+    int64_t dt = (int32_t)(t - f->t0);
+    if (f->shift == 0U) return dt;
+    return (dt + (1LL << (f->shift - 1U))) >> f->shift;
+}
+
+// Zamanın birime yuvarlanmasından kalan tick'ler boyunca son hızla alınan
+// yol düşülür: nokta yuvarlanmış anın konumuna taşınır. Çerçeve kaydırması
+// başlangıcı birimin katı kadar taşıdığı için kalan yalnız birim değişince
+// (yeniden kurulum) değişir
+static q16_t VelFit_Correct(const VelFit_t *f, uint32_t t, q16_t x) {
+    if (f->shift == 0U) return x;
+    int64_t dt = (int32_t)(t - f->t0);
+    int64_t rem = dt - (VelFit_Time(f, t) << f->shift);
+    return x - (q16_t)q64_mul_shift((int64_t)f->pred_velocity * rem, (int64_t)VELFIT_TICK_RECIP, 40U);
+}
+
+// Noktanın katkısını toplamlara ekler (sign = 1) veya çıkarır (sign = -1).
+// Tam sayı: çıkarma eklemeyi birebir geri alır
+static void VelFit_Accumulate(VelFit_t *f, uint8_t i, int64_t sign) {
+    int64_t u = VelFit_Time(f, f->t[i]);
+    int64_t d = (int64_t)f->xc[i] - f->x0;
+    int64_t uu = u * u;
+
+    f->s.u += sign * u;
+    f->s.uu += sign * uu;
+    f->s.u3 += sign * uu * u;
+    f->s.u4 += sign * uu * uu;
+    f->s.d += sign * d;
+    f->s.ud += sign * u * d;
+    f->s.uud += sign * uu * d;
+}
+
+// n noktanın toplamlarını c birim ileri, e (Q16) yukarı taşır: u' = u - c,
+// d' = d - e. Binom açılımıyla kesin; ara çarpımlar int64'ü aşabilir ama
+// sonuçlar sığar: işaretsiz (mod 2^64) aritmetik yeterli
+static void VelFit_Translate(VelFitSums_t *s, uint64_t n, int64_t c, int64_t e) {
+    uint64_t uc = (uint64_t)c, ue = (uint64_t)e;
+    uint64_t c2 = uc * uc, c3 = c2 * uc;
+    uint64_t s1 = (uint64_t)s->u, s2 = (uint64_t)s->uu, s3 = (uint64_t)s->u3, s4 = (uint64_t)s->u4;
+    uint64_t sd = (uint64_t)s->d, sud = (uint64_t)s->ud, suud = (uint64_t)s->uud;
+
+    uint64_t t1 = s1 - n * uc;
+    uint64_t t2 = s2 - 2U * uc * s1 + n * c2;
+    s->u4 = (int64_t)(s4 - 4U * uc * s3 + 6U * c2 * s2 - 4U * c3 * s1 + n * c2 * c2);
+    s->u3 = (int64_t)(s3 - 3U * uc * s2 + 3U * c2 * s1 - n * c3);
+    s->uu = (int64_t)t2;
+    s->u = (int64_t)t1;
+    s->uud = (int64_t)(suud - 2U * uc * sud + c2 * sd - ue * t2);
+    s->ud = (int64_t)(sud - uc * sd - ue * t1);
+    s->d = (int64_t)(sd - n * ue);
+}
+
+// Çerçeveyi en yeni noktaya kur: pencere süresi çerçeve sınırının yarısından
+// kısa olacak en küçük birim, toplamlar baştan. Pencere konumda
+// VELFIT_DISP_BITS'e sığmıyorsa (uzun kayıp) eski noktalar atılır
+static void VelFit_Rebuild(VelFit_t *f) {
+    uint8_t k = VelFit_Index(f, f->n - 1U);
+    while (f->n > 1U) {
+        int64_t span = (int64_t)f->x[k] - f->x[VelFit_Index(f, 0)];
+        if (span > -VELFIT_DISP_LIMIT && span < VELFIT_DISP_LIMIT) break;
+        f->n--;
+    }
+
+    uint32_t span = f->t[k] - f->t[VelFit_Index(f, 0)];
+    f->t0 = f->t[k];
+    f->x0 = f->x[k];
+    f->shift = 0;
+    while ((span >> f->shift) >= (uint32_t)(VELFIT_TIME_LIMIT / 2)) f->shift++;
+
+    f->s = (VelFitSums_t){0};
+    for (uint8_t i = 0; i < f->n; i++) {
+        uint8_t j = VelFit_Index(f, i);
+        f->xc[j] = VelFit_Correct(f, f->t[j], f->x[j]);
+        VelFit_Accumulate(f, j, 1);
+    }
+    f->rebuilds++;
+}
+
+// Son çözümün timestamp anı için konum öngörüsünden sapma (m, Q16)
+static int64_t VelFit_Deviation(const VelFit_t *f, uint32_t timestamp, q16_t position) {
+    uint8_t k = VelFit_Index(f, f->n - 1U);
+    uint64_t ticks = (uint32_t)(timestamp - f->t[k]);
+    uint64_t dt_q16 = (ticks << 16) / OPTICAL_IC_TICK_HZ;
+    if (dt_q16 > INT32_MAX) dt_q16 = INT32_MAX;
+
+    int64_t dt = (int64_t)dt_q16;
+    int64_t v_dt = ((int64_t)f->pred_velocity * dt) >> 16;
+    int64_t a_dt2 = ((((int64_t)f->pred_accel * dt) >> 16) * dt) >> 17; // a*dt^2/2
+    int64_t dev = (int64_t)position - ((int64_t)f->x[k] + v_dt + a_dt2);
+    return (dev < 0) ? -dev : dev;
+}
+
+void VelFit_Init(VelFit_t *f) {
+    *f = (VelFit_t){0};
+}
+
+void VelFit_Reset(VelFit_t *f) {
+    f->head = 0;
+    f->n = 0;
+    f->pred_valid = 0;
+}
+
+void VelFit_Add(VelFit_t *f, uint32_t timestamp, q16_t position) {
+    uint8_t rebuild = 0;
+
+    // İvme değişti: eski rejimin noktaları atılır, son nokta kalır
+    if (f->pred_valid && f->n > 1U && VelFit_Deviation(f, timestamp, position) > VELFIT_BREAK) {
+        f->n = 1;
+        f->restarts++;
+        rebuild = 1;
+    }
+    f->pred_valid = 0;
+
+    if (f->n == VELFIT_WINDOW) {
+        VelFit_Accumulate(f, VelFit_Index(f, 0), -1);
+        f->n--;
+    }
+
+    // Pencere çerçeveye sığmıyor (yavaşlama, uzun boşluk) ya da çerçeveye
+    // göre çok kısaldı (hızlanma, birim kaba kalır): birim yeniden seçilir
+    if (f->n > 0U && !rebuild) {
+        int64_t u = VelFit_Time(f, timestamp);
+        int64_t span = u - VelFit_Time(f, f->t[VelFit_Index(f, 0)]);
+        int64_t d = (int64_t)position - f->x0;
+        rebuild = span >= VELFIT_TIME_LIMIT || (f->shift > 0U && span < VELFIT_TIME_LIMIT / 16) ||
+                  d <= -VELFIT_DISP_LIMIT || d >= VELFIT_DISP_LIMIT;
+
+        // Yeni nokta çerçeveden taşıyor: başlangıç ona kaydırılır (kayıpsız)
+        if (!rebuild && u >= VELFIT_TIME_LIMIT) {
+            VelFit_Translate(&f->s, f->n, u, d);
+            f->t0 += (uint32_t)u << f->shift;
+            f->x0 += (q16_t)d;
+        }
+    }
+
+    uint8_t i = f->head;
+    f->t[i] = timestamp;
+    f->x[i] = position;
+    f->head = (uint8_t)((f->head + 1U) % VELFIT_WINDOW);
+    f->n++;
+    f->updates++;
+
+    if (rebuild || f->n == 1U) {
+        VelFit_Rebuild(f);
+        return;
+    }
+    f->xc[i] = VelFit_Correct(f, timestamp, position);
+    VelFit_Accumulate(f, i, 1);
+}
+
+static q16_t VelFit_Saturate(int64_t v) {
+    if (v >= INT32_MAX) return INT32_MAX;
+    if (v <= INT32_MIN) return INT32_MIN;
+    return (q16_t)v;
+}
+
+// |x| bit uzunluğu (0 için 0)
+static uint32_t VelFit_Bits(int64_t x) {
+    uint64_t ux = (x < 0) ? 0U - (uint64_t)x : (uint64_t)x;
+    return ux ? 64U - (uint32_t)__builtin_clzll(ux) : 0U;
+}
+
+// Tam sayı karekök (bit bit, 32 adım)
+static uint32_t VelFit_Sqrt(uint64_t x) {
+    uint64_t root = 0, bit = 1ULL << 62;
+    while (bit > x) bit >>= 2;
+    while (bit != 0U) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+// Artıkların RMS'i (n - 3 serbestlik), noktalarda 2^32 ölçekli: toplamlardan
+// sum d^2 - a1*sum tau*d - ... farkı büyük sayıların küçük farkı olurdu.
+// s ortalamaya taşınmış toplamlar, tam sayı ortalama (um, dm) ile
+static q16_t VelFit_Residual(const VelFit_t *f, const VelFitSums_t *s, uint32_t n, int64_t um, int64_t dm,
+                             int64_t c2, int64_t a1, int64_t r, int64_t a2, uint32_t f2) {
+    int64_t tm = VelFit_DivSmall(s->u << VELFIT_FRAC, n);   // kalan ortalamalar, 2^32 ölçekli
+    int64_t ym = VelFit_DivSmall(s->d << VELFIT_FRAC, n);
+    int64_t c = q64_mul_shift(c2, (int64_t)velfit_recip[n] << 1, 0);      // c2/n
+    uint64_t sse = 0;
+
+    for (uint8_t i = 0; i < n; i++) {
+        uint8_t j = VelFit_Index(f, i);
+        int64_t tau = ((VelFit_Time(f, f->t[j]) - um) << VELFIT_FRAC) - tm;
+        int64_t y = (((int64_t)f->xc[j] - f->x0 - dm) << VELFIT_FRAC) - ym;
+        int64_t p2 = q64_mul_shift(tau, tau, VELFIT_FRAC) - q64_mul_shift(r, tau, VELFIT_FRAC) - c;
+        int64_t e = y - q64_mul_shift(a1, tau, VELFIT_FRAC) - q64_mul_shift(a2, p2, f2);
+
+        // Q16 + 8 kesir biti; 2^27'de (8 m) kırpılır, kareler taşmaz
+        e = (e + (1LL << 23)) >> 24;
+        if (e > (1LL << 27)) e = 1LL << 27;
+        if (e < -(1LL << 27)) e = -(1LL << 27);
+        sse += (uint64_t)(e * e);
+    }
+    return (q16_t)((VelFit_Sqrt((uint64_t)VelFit_DivSmall((int64_t)sse, n - 3U)) + 128U) >> 8);
+}
+
+uint8_t VelFit_Solve(VelFit_t *f, VelFitResult_t *out) {
+    if (f->n < 3U) return 0;
+    const uint32_t n = f->n;
+
+    // Toplamlar pencerenin tam sayı ortalamasına taşınır (kesin): kalan
+    // ortalama yarım birimden küçük, merkezleme düzeltmeleri küçük sayılarla
+    VelFitSums_t s = f->s;
+    int64_t um = VelFit_DivSmall(s.u, n), dm = VelFit_DivSmall(s.d, n);
+    VelFit_Translate(&s, n, um, dm);
+
+    // Merkezlenmiş momentler (tau = u - ort.); küçük bölenlerle çarpmanın
+    // bağıl hatası < 2^-30
+    int64_t s1 = s.u, s1s1 = s.u * s.u;
+    int64_t c2 = s.uu - VelFit_DivSmall(s1s1, n);
+    int64_t c3 = s.u3 - VelFit_DivSmall(3 * s1 * s.uu, n) + VelFit_DivSmall(VelFit_DivSmall(2 * s1s1 * s1, n), n);
+    int64_t c4 = s.u4 - VelFit_DivSmall(4 * s1 * s.u3, n) +
+                 VelFit_DivSmall(VelFit_DivSmall(6 * s1s1 * s.uu, n), n) -
+                 VelFit_DivSmall(VelFit_DivSmall(VelFit_DivSmall(3 * s1s1 * s1s1, n), n), n);
+    int64_t cd1 = s.ud - VelFit_DivSmall(s1 * s.d, n);                                   // sum tau*d
+    int64_t cd2 = s.uud - VelFit_DivSmall(2 * s1 * s.ud, n) +
+                  VelFit_DivSmall(VelFit_DivSmall(s1s1 * s.d, n), n) - VelFit_DivSmall(c2 * s.d, n); // sum (tau^2 - c2/n)*d
+    int64_t e4 = c4 - VelFit_DivSmall(c2 * c2, n);                                       // sum (tau^2 - c2/n)^2
+    if (c2 <= 0) return 0;
+
+    // Dik taban: p2 = tau^2 - r*tau - c2/n, r = c3/c2. Katsayılar
+    // a1 = sum tau*d / c2, a2 = sum p2*d / sum p2^2; a1 ve r 2^32 ölçekli
+    q64_recip_t rc2 = q64_recip((uint64_t)c2);
+    int64_t a1 = q64_mul_shift(cd1, rc2.m, rc2.s - VELFIT_FRAC);
+    int64_t r = q64_mul_shift(c3, rc2.m, rc2.s - VELFIT_FRAC);
+    int64_t g = e4 - q64_mul_shift(c3, r, VELFIT_FRAC);                                  // sum p2^2 = det / c2
+    int64_t h = cd2 - q64_mul_shift(cd1, r, VELFIT_FRAC);                                // sum p2*d
+    if (g <= 0) return 0;
+
+    // a2 ivmeyle orantılı, çok küçük olabilir: ölçek büyüklüğüne göre
+    // seçilir (|a2| < 2^61). 1/g'nin kendi ölçeğinden büyük olamaz; orada
+    // kalan çözünürlük ivmede 2^-30 LSB'den ince
+    q64_recip_t rg = q64_recip((uint64_t)g);
+    int32_t mag = (int32_t)VelFit_Bits(h) - (int32_t)(rg.s - 31U);
+    uint32_t f2 = (mag >= 60) ? 0U : (mag <= 60 - (int32_t)VELFIT_FRAC2_MAX) ? VELFIT_FRAC2_MAX : (uint32_t)(60 - mag);
+    if (f2 > rg.s) f2 = rg.s;
+    int64_t a2 = q64_mul_shift(h, rg.m, rg.s - f2);
+
+    // En yeni noktada eğim a1 + a2*(2*tau - r); birim: Q16 m / (2^shift tick).
+    // tau = u - ortalama: tam sayı ortalamadan kalan s1/n de düşülür (2*tau, 2^32 ölçekli)
+    uint32_t newest = f->t[VelFit_Index(f, f->n - 1U)];
+    int64_t tau2 = ((VelFit_Time(f, newest) - um) << (VELFIT_FRAC + 1U)) - VelFit_DivSmall(s1 << (VELFIT_FRAC + 1U), n);
+    int64_t slope = a1 + q64_mul_shift(a2, tau2 - r, f2);
+
+    // İvme 2*a2*(tick Hz / 2^shift)^2; Q16 aralığını aşan sonuç doyurulur
+    uint32_t as = f2 + 2U * f->shift;
+    if ((int32_t)VelFit_Bits(a2) + VELFIT_ACCEL_BITS > (int32_t)as + 31) {
+        out->accel = (a2 < 0) ? INT32_MIN : INT32_MAX;
+    } else {
+        out->accel = VelFit_Saturate(q64_mul_shift(a2, 2LL * OPTICAL_IC_TICK_HZ * OPTICAL_IC_TICK_HZ, as));
+    }
+    out->velocity = VelFit_Saturate(q64_mul_shift(slope, OPTICAL_IC_TICK_HZ, VELFIT_FRAC + f->shift));
+    out->residual = (n > 3U) ? VelFit_Residual(f, &s, n, um, dm, c2, a1, r, a2, f2) : 0;
+    out->points = f->n;
+
+    // Üç nokta eğriyi belirler ama denetlenemez: yalnız öngörü olarak kullanılır
+    f->pred_velocity = out->velocity;
+    f->pred_accel = out->accel;
+    f->pred_valid = out->residual <= VELFIT_MAX_RESIDUAL;
+    return f->n >= VELFIT_MIN_POINTS;
+}
@@ -1,4 +1,53 @@
 // shared_data.c
 #include "shared_data.h"
+#include "fw_state.h"
+#include "profiler.h"
+#include "stm32f1xx_hal.h"
+#include <string.h>
 
-SharedData_t VehicleState = {0}; // Başlangıç değerleri sıfır
+FW_THREAD_LOCAL SharedData_t VehicleState = {0}; // Başlangıç değerleri sıfır
+
+// Tek: yazma sürüyor, çift: kararlı. Nesil = state_seq / 2
+FW_STATE volatile uint32_t state_seq = 0;
+
+uint32_t SharedData_WriteBegin(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    PROFILE_BEGIN(PROF_SHARED_WRITE);
+    state_seq++;
+    __DMB();  // Sayaç, alanlardan önce görünür olmalı
+    return primask;
+}
+
+void SharedData_WriteEnd(uint32_t key) {
+    __DMB();  // Alanlar, sayaçtan önce görünür olmalı
+    state_seq++;
+    PROFILE_END(PROF_SHARED_WRITE);
+    __set_PRIMASK(key);
+}
+
+uint32_t SharedData_Snapshot(SharedData_t *out) {
+    uint32_t start, end;
+    do {
+        // Yazar kesme kapattığı için tek çekirdekte tek değer görülmez;
+        // yine de yarım yazmayı kopyalamamak için bekle
+        do {
+            start = state_seq;
+        } while (start & 1U);
+        __DMB();
+        memcpy(out, (const void *)&VehicleState, sizeof(*out));
+        __DMB();
+        end = state_seq;
+    } while (start != end);
+    return start >> 1;
+}
+
+uint32_t SharedData_Generation(void) {
+    return state_seq >> 1;
+}
+
+void SharedData_Reset(void) {
+    uint32_t key = SharedData_WriteBegin();
+    memset((void *)&VehicleState, 0, sizeof(VehicleState));
+    SharedData_WriteEnd(key);
+}
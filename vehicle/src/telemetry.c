@@ -0,0 +1,163 @@
+// telemetry.c
+#include "telemetry.h"
+#include "fw_state.h"
+#include "uart_log.h"
+#include "stm32f1xx_hal.h"
+
+FW_STATE uint16_t telemetry_seq = 0;
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), 4-bit tablo: 32 byte flash,
+// byte başına iki adım
+static const uint16_t crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t Telemetry_Crc16(const uint8_t *data, uint16_t len) {
+    return Telemetry_Crc16Update(0xFFFF, data, len);
+}
+
+uint16_t Telemetry_Crc16Update(uint16_t crc, const uint8_t *data, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+// --- Little-endian yardımcıları ---
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int16_t clamp_i16(int32_t v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+void Telemetry_FromState(const SharedData_t *state, uint16_t seq, uint32_t time_ms, TelemetryPacket_t *pkt) {
+    pkt->version = TELEMETRY_VERSION;
+    pkt->seq = seq;
+    pkt->time_ms = time_ms;
+    pkt->position_mm = q16_to_scaled(state->current_position, 1000);
+    pkt->velocity_mm_s = q16_to_scaled(state->current_velocity, 1000);
+    pkt->reflector_count = (uint16_t)state->reflector_count;
+    pkt->system_status = state->system_status;
+    pkt->error_flags = state->imu_error_flag ? TELEMETRY_ERR_IMU : 0U;
+
+    pkt->accel_mg[0] = clamp_i16(q16_to_scaled(state->imu.accel_x_g, 1000));
+    pkt->accel_mg[1] = clamp_i16(q16_to_scaled(state->imu.accel_y_g, 1000));
+    pkt->accel_mg[2] = clamp_i16(q16_to_scaled(state->imu.accel_z_g, 1000));
+    pkt->gyro_cdps[0] = clamp_i16(q16_to_scaled(state->imu.gyro_x_dps, 100));
+    pkt->gyro_cdps[1] = clamp_i16(q16_to_scaled(state->imu.gyro_y_dps, 100));
+    pkt->gyro_cdps[2] = clamp_i16(q16_to_scaled(state->imu.gyro_z_dps, 100));
+    pkt->temp_cc = clamp_i16(q16_to_scaled(state->imu.temp_c, 100));
+}
+
+uint16_t Telemetry_Encode(const TelemetryPacket_t *pkt, uint8_t *frame) {
+    uint8_t raw[TELEMETRY_PACKET_SIZE];
+
+    // 1. Serileştirme
+    raw[0] = pkt->version;
+    put_u16(&raw[1], pkt->seq);
+    put_u32(&raw[3], pkt->time_ms);
+    put_u32(&raw[7], (uint32_t)pkt->position_mm);
+    put_u32(&raw[11], (uint32_t)pkt->velocity_mm_s);
+    put_u16(&raw[15], pkt->reflector_count);
+    raw[17] = pkt->system_status;
+    raw[18] = pkt->error_flags;
+    for (uint8_t i = 0; i < 3; i++) {
+        put_u16(&raw[19 + 2 * i], (uint16_t)pkt->accel_mg[i]);
+        put_u16(&raw[25 + 2 * i], (uint16_t)pkt->gyro_cdps[i]);
+    }
+    put_u16(&raw[31], (uint16_t)pkt->temp_cc);
+    put_u16(&raw[33], Telemetry_Crc16(raw, TELEMETRY_PACKET_SIZE - 2U));
+
+    // 2. COBS: her 0x00 yerine bir sonraki sıfıra olan mesafe yazılır
+    uint16_t out = 1;
+    uint16_t code_pos = 0;
+    uint8_t code = 1;
+    for (uint16_t i = 0; i < TELEMETRY_PACKET_SIZE; i++) {
+        if (raw[i] == 0) {
+            frame[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        } else {
+            frame[out++] = raw[i];
+            code++;
+        }
+    }
+    frame[code_pos] = code;
+    frame[out++] = 0x00;   // Çerçeve ayracı
+    return out;
+}
+
+uint8_t Telemetry_Decode(const uint8_t *frame, uint16_t len, TelemetryPacket_t *pkt) {
+    uint8_t raw[TELEMETRY_PACKET_SIZE];
+    uint16_t n = 0;
+    uint16_t i = 0;
+
+    // 1. COBS çözme
+    while (i < len) {
+        uint8_t code = frame[i++];
+        if (code == 0) return TELEMETRY_ERR_FRAMING;
+        for (uint8_t k = 1; k < code; k++) {
+            if (i >= len || n >= TELEMETRY_PACKET_SIZE || frame[i] == 0) return TELEMETRY_ERR_FRAMING;
+            raw[n++] = frame[i++];
+        }
+        if (code < 0xFF && i < len) {
+            if (n >= TELEMETRY_PACKET_SIZE) return TELEMETRY_ERR_FRAMING;
+            raw[n++] = 0x00;
+        }
+    }
+    if (n != TELEMETRY_PACKET_SIZE) return TELEMETRY_ERR_FRAMING;
+
+    // 2. Doğrulama
+    if (Telemetry_Crc16(raw, TELEMETRY_PACKET_SIZE - 2U) != get_u16(&raw[33])) return TELEMETRY_ERR_CRC;
+    if (raw[0] != TELEMETRY_VERSION) return TELEMETRY_ERR_VERSION;
+
+    // 3. Alanlar
+    pkt->version = raw[0];
+    pkt->seq = get_u16(&raw[1]);
+    pkt->time_ms = get_u32(&raw[3]);
+    pkt->position_mm = (int32_t)get_u32(&raw[7]);
+    pkt->velocity_mm_s = (int32_t)get_u32(&raw[11]);
+    pkt->reflector_count = get_u16(&raw[15]);
+    pkt->system_status = raw[17];
+    pkt->error_flags = raw[18];
+    for (uint8_t k = 0; k < 3; k++) {
+        pkt->accel_mg[k] = (int16_t)get_u16(&raw[19 + 2 * k]);
+        pkt->gyro_cdps[k] = (int16_t)get_u16(&raw[25 + 2 * k]);
+    }
+    pkt->temp_cc = (int16_t)get_u16(&raw[31]);
+    return TELEMETRY_OK;
+}
+
+void Telemetry_Send(void) {
+    SharedData_t snapshot;
+    TelemetryPacket_t pkt;
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+
+    SharedData_Snapshot(&snapshot);
+
+    Telemetry_FromState(&snapshot, telemetry_seq++, HAL_GetTick(), &pkt);
+    uint16_t len = Telemetry_Encode(&pkt, frame);
+    UartLog_Write(frame, len);
+}
@@ -0,0 +1,147 @@
+// tunnel_map.c
+#include "tunnel_map.h"
+#include "fw_state.h"
+#include "telemetry.h"
+#include <stddef.h>
+
+// 186 m test tüneli: 5 m kapsül alanı, 11 m'den itibaren 4 m'de bir
+// reflektör, son 100 m ve son 48 m işaretlerinde 5 cm aralıklı şeritler
+static const TunnelParams_t tunnel_default = {
+    .magic = TUNNEL_MAP_MAGIC,
+    .version = TUNNEL_MAP_VERSION,
+    .length = sizeof(TunnelParams_t),
+    .start_offset = Q16_FROM_FLOAT(5.0f),
+    .end_position = Q16_FROM_FLOAT(186.0f),
+    .stop_margin = Q16_FROM_FLOAT(1.0f),
+    .reflector_first = Q16_FROM_FLOAT(11.0f),
+    .reflector_pitch = Q16_FROM_FLOAT(4.0f),
+    .zone_count = 2,
+    .zones = {
+        { Q16_FROM_FLOAT(97.0f),  Q16_FROM_FLOAT(0.05f), 10, TUNNEL_ZONE_LAST_100M, 0 },
+        { Q16_FROM_FLOAT(149.0f), Q16_FROM_FLOAT(0.05f), 5,  TUNNEL_ZONE_LAST_48M,  0 },
+    },
+};
+
+FW_STATE TunnelParams_t map_params;
+FW_STATE TunnelMarker_t map_markers[TUNNEL_MAP_MAX_MARKERS];
+FW_STATE uint16_t map_count = 0;
+FW_STATE uint16_t map_zone_first[TUNNEL_MAP_MAX_ZONES];
+
+static uint16_t TunnelMap_Crc(const TunnelParams_t *params) {
+    return Telemetry_Crc16((const uint8_t *)params, offsetof(TunnelParams_t, crc));
+}
+
+// Reflektör dizisi ile şerit gruplarını konum sırasında birleştirir
+static uint8_t TunnelMap_Build(const TunnelParams_t *p) {
+    if (p->reflector_pitch <= 0 || p->zone_count > TUNNEL_MAP_MAX_ZONES ||
+        p->end_position <= p->start_offset || p->stop_margin < 0) {
+        return TUNNEL_MAP_ERR_GEOMETRY;
+    }
+
+    q16_t reflector = p->reflector_first;
+    uint16_t zone = 0;
+    uint16_t strip = 0;
+    q16_t prev = p->start_offset;
+    uint16_t n = 0;
+    uint16_t reflectors = 0;
+    uint16_t zone_first[TUNNEL_MAP_MAX_ZONES] = {0};
+
+    for (;;) {
+        uint8_t have_reflector = reflector < p->end_position;
+        uint8_t have_strip = zone < p->zone_count;
+        if (!have_reflector && !have_strip) break;
+
+        TunnelMarker_t m;
+        q16_t strip_pos = 0;
+        if (have_strip) {
+            if (p->zones[zone].count == 0 || p->zones[zone].pitch <= 0) return TUNNEL_MAP_ERR_GEOMETRY;
+            strip_pos = p->zones[zone].start + (q16_t)strip * p->zones[zone].pitch;
+        }
+
+        if (have_strip && (!have_reflector || strip_pos < reflector)) {
+            m.position = strip_pos;
+            m.type = TUNNEL_MARKER_STRIP;
+            m.zone = p->zones[zone].id;
+            m.zone_index = strip;
+            if (strip == 0) zone_first[zone] = n;
+            if (++strip == p->zones[zone].count) {
+                zone++;
+                strip = 0;
+            }
+        } else {
+            m.position = reflector;
+            m.type = TUNNEL_MARKER_REFLECTOR;
+            m.zone = TUNNEL_ZONE_NONE;
+            m.zone_index = 0;
+            reflector += p->reflector_pitch;
+            reflectors++;
+        }
+        m.reflector_seq = reflectors;
+        m.reserved = 0;
+
+        // Çakışan işaret sayaçla ayırt edilemez; tünel dışı işaret olamaz
+        if (m.position <= prev || m.position >= p->end_position || n == TUNNEL_MAP_MAX_MARKERS) {
+            return TUNNEL_MAP_ERR_GEOMETRY;
+        }
+        map_markers[n++] = m;
+        prev = m.position;
+    }
+
+    map_params = *p;
+    map_count = n;
+    for (uint8_t z = 0; z < TUNNEL_MAP_MAX_ZONES; z++) {
+        map_zone_first[z] = zone_first[z];
+    }
+    return TUNNEL_MAP_OK;
+}
+
+uint8_t TunnelMap_Init(const TunnelParams_t *params) {
+    uint8_t status = TUNNEL_MAP_ERR_MISSING;
+
+    if (params != NULL) {
+        if (params->magic != TUNNEL_MAP_MAGIC || params->version != TUNNEL_MAP_VERSION ||
+            params->length != sizeof(TunnelParams_t)) {
+            status = TUNNEL_MAP_ERR_HEADER;
+        } else if (params->crc != TunnelMap_Crc(params)) {
+            status = TUNNEL_MAP_ERR_CRC;
+        } else {
+            status = TunnelMap_Build(params);
+        }
+    }
+
+    if (status != TUNNEL_MAP_OK) {
+        TunnelMap_Build(&tunnel_default);
+    }
+    return status;
+}
+
+void TunnelMap_Seal(TunnelParams_t *params) {
+    params->magic = TUNNEL_MAP_MAGIC;
+    params->version = TUNNEL_MAP_VERSION;
+    params->length = sizeof(TunnelParams_t);
+    params->crc = TunnelMap_Crc(params);
+}
+
+const TunnelParams_t *TunnelMap_Default(void) {
+    return &tunnel_default;
+}
+
+const TunnelParams_t *TunnelMap_Params(void) {
+    return &map_params;
+}
+
+const TunnelMarker_t *TunnelMap_Marker(uint16_t index) {
+    return (index < map_count) ? &map_markers[index] : NULL;
+}
+
+uint16_t TunnelMap_Count(void) {
+    return map_count;
+}
+
+uint16_t TunnelMap_ZoneFirstMarker(uint8_t slot) {
+    return (slot < TUNNEL_MAP_MAX_ZONES) ? map_zone_first[slot] : 0;
+}
+
+q16_t TunnelMap_StopLimit(void) {
+    return map_params.end_position - map_params.stop_margin;
+}
@@ -0,0 +1,112 @@
+// uart_log.c
+#include "uart_log.h"
+#include "fw_state.h"
+#include <string.h>
+
+#define UART_LOG_MASK   (UART_LOG_BUF_SIZE - 1U)
+
+#if (UART_LOG_BUF_SIZE & UART_LOG_MASK) != 0
+#error "UART_LOG_BUF_SIZE 2'nin kuvveti olmalı"
+#endif
+
+FW_STATE UART_HandleTypeDef *log_uart = NULL;
+FW_STATE uint8_t tx_ring[UART_LOG_BUF_SIZE];
+
+// İndeksler serbest sayar; fark doluluğu verir
+FW_STATE volatile uint32_t ring_head = 0;     // Yazma (Write)
+FW_STATE volatile uint32_t ring_tail = 0;     // Serbest bırakılan (gönderilmiş)
+FW_STATE volatile uint32_t dma_len = 0;       // Uçuştaki DMA parçası (0: boşta)
+FW_STATE volatile uint32_t dma_released = 0;  // Half callback'te bırakılan kısım
+
+FW_STATE UartLogStats_t log_stats;
+
+// Kesmeler kapalıyken çağrılır
+static void UartLog_StartDMA(void) {
+    uint32_t pending = ring_head - ring_tail;
+    if (dma_len != 0 || pending == 0 || log_uart == NULL) return;
+
+    // Halkanın sonuna kadar olan bitişik kısım gönderilir, kalanı sonraki turda
+    uint32_t start = ring_tail & UART_LOG_MASK;
+    uint32_t chunk = UART_LOG_BUF_SIZE - start;
+    if (chunk > pending) chunk = pending;
+
+    dma_len = chunk;
+    dma_released = 0;
+    if (HAL_UART_Transmit_DMA(log_uart, &tx_ring[start], (uint16_t)chunk) != HAL_OK) {
+        dma_len = 0;    // Bir sonraki Write tekrar dener
+        return;
+    }
+    log_stats.dma_transfers++;
+}
+
+void UartLog_Init(UART_HandleTypeDef *huart) {
+    log_uart = huart;
+    ring_head = 0;
+    ring_tail = 0;
+    dma_len = 0;
+    dma_released = 0;
+    memset(&log_stats, 0, sizeof(log_stats));
+}
+
+uint8_t UartLog_Write(const uint8_t *data, uint16_t len) {
+    if (len == 0) return 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t used = ring_head - ring_tail;
+    if (len > UART_LOG_BUF_SIZE - used) {
+        log_stats.dropped_msgs++;
+        log_stats.dropped_bytes += len;
+        __set_PRIMASK(primask);
+        return 1;
+    }
+
+    // Sarmalı kopya: en fazla iki memcpy
+    uint32_t start = ring_head & UART_LOG_MASK;
+    uint32_t first = UART_LOG_BUF_SIZE - start;
+    if (first > len) first = len;
+    memcpy(&tx_ring[start], data, first);
+    memcpy(&tx_ring[0], data + first, len - first);
+    ring_head += len;
+
+    log_stats.written_bytes += len;
+    if (used + len > log_stats.high_water) {
+        log_stats.high_water = used + len;
+    }
+
+    UartLog_StartDMA();
+    __set_PRIMASK(primask);
+    return 0;
+}
+
+void UartLog_TxHalfCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart != log_uart || dma_len == 0) return;
+
+    // İlk yarı hatta çıktı; o bölge yeni mesajlara açılabilir
+    uint32_t half = dma_len / 2U;
+    ring_tail += half - dma_released;
+    dma_released = half;
+}
+
+void UartLog_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart != log_uart || dma_len == 0) return;
+
+    ring_tail += dma_len - dma_released;
+    dma_len = 0;
+    dma_released = 0;
+
+    // Bu sırada birikenleri hemen gönder
+    UartLog_StartDMA();
+}
+
+uint32_t UartLog_Pending(void) {
+    return ring_head - ring_tail;
+}
+
+void UartLog_GetStats(UartLogStats_t *stats) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = log_stats;
+    __set_PRIMASK(primask);
+}